@@ -0,0 +1,157 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// 读取时间戳计数器（x86 为TSC参考周期，其他平台返回0表示不可用）
+inline uint64_t readCycleCounter() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// 单个基准测试的测量结果
+struct BenchResult {
+    std::string name;         // 测试名称（如 "huffman.compress"）
+    std::string corpus;       // 语料名称（如 "text"）
+    uint64_t bytes = 0;       // 每次迭代处理的字节数
+    int reps = 0;             // 迭代次数
+    double bestSeconds = 0;   // 最快一次耗时
+    double medianSeconds = 0; // 中位数耗时
+    double cyclesPerByte = 0; // 最快一次的周期/字节（不可用时为0）
+
+    double mbPerSec() const {
+        return bestSeconds > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / bestSeconds : 0;
+    }
+};
+
+/*
+ * 重复执行 body 并计时
+ * @param setup 每次迭代前执行、不计入耗时（如清理上一次的输出）
+ * @param body 被测代码，返回false表示执行失败
+ */
+inline bool measure(BenchResult& result, int reps,
+                    const std::function<void()>& setup, const std::function<bool()>& body) {
+    std::vector<double> seconds;
+    uint64_t bestCycles = 0;
+    for (int i = 0; i < reps; ++i) {
+        if (setup) setup();
+        const uint64_t c0 = readCycleCounter();
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool ok = body();
+        const auto t1 = std::chrono::steady_clock::now();
+        const uint64_t c1 = readCycleCounter();
+        if (!ok) return false;
+        const double s = std::chrono::duration<double>(t1 - t0).count();
+        if (seconds.empty() || s < *std::min_element(seconds.begin(), seconds.end())) {
+            bestCycles = c1 - c0;
+        }
+        seconds.push_back(s);
+    }
+    std::sort(seconds.begin(), seconds.end());
+    result.reps = reps;
+    result.bestSeconds = seconds.front();
+    result.medianSeconds = seconds[seconds.size() / 2];
+    result.cyclesPerByte = result.bytes > 0 ? static_cast<double>(bestCycles) / result.bytes : 0;
+    return true;
+}
+
+// ===== 合成语料 =====
+// 均匀随机字节（不可压缩）
+inline std::vector<char> makeRandomCorpus(size_t size, uint32_t seed = 42) {
+    std::vector<char> data(size);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < size; i += 4) {
+        const uint32_t v = rng();
+        for (size_t k = 0; k < 4 && i + k < size; ++k) {
+            data[i + k] = static_cast<char>(v >> (8 * k));
+        }
+    }
+    return data;
+}
+
+// 类文本数据（按近似英文词频生成单词与标点）
+inline std::vector<char> makeTextCorpus(size_t size, uint32_t seed = 42) {
+    static const char* words[] = {
+        "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be",
+        "by", "on", "not", "he", "this", "are", "or", "his", "from", "at", "which", "but", "have",
+        "backup", "file", "system", "data", "archive", "restore", "compress", "block", "record",
+        "2025-10-29", "INFO", "ERROR", "{\"id\":", "\"name\":", "path=/var/lib/data", "0x7f3a",
+    };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    std::mt19937 rng(seed);
+    // 近似Zipf分布：靠前的词出现得更多
+    std::discrete_distribution<size_t> pick([&] {
+        std::vector<double> w(wordCount);
+        for (size_t i = 0; i < wordCount; ++i) w[i] = 1.0 / (i + 1);
+        return std::discrete_distribution<size_t>(w.begin(), w.end());
+    }());
+    std::vector<char> data;
+    data.reserve(size);
+    size_t lineLen = 0;
+    while (data.size() < size) {
+        const char* w = words[pick(rng)];
+        data.insert(data.end(), w, w + strlen(w));
+        lineLen += strlen(w);
+        if (lineLen > 72) {
+            data.push_back('\n');
+            lineLen = 0;
+        } else {
+            data.push_back((rng() % 11 == 0) ? ',' : ' ');
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+// 全零数据
+inline std::vector<char> makeZeroCorpus(size_t size) {
+    return std::vector<char>(size, 0);
+}
+
+// 写入文件
+inline bool writeCorpusFile(const std::string& path, const std::vector<char>& data) {
+    fs::create_directories(fs::path(path).parent_path());
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write(data.data(), data.size());
+    return static_cast<bool>(out);
+}
+
+// 生成大量小文件组成的目录树，返回总字节数
+inline uint64_t makeSmallFilesTree(const std::string& root, size_t fileCount, uint32_t seed = 7) {
+    std::mt19937 rng(seed);
+    const std::vector<char> text = makeTextCorpus(1 << 20, seed);
+    uint64_t total = 0;
+    for (size_t i = 0; i < fileCount; ++i) {
+        // 每个目录放32个文件，文件大小 1KB~8KB
+        const std::string dir = root + "/dir" + std::to_string(i / 32);
+        const size_t size = 1024 + rng() % (7 * 1024);
+        const size_t offset = rng() % (text.size() - size);
+        std::vector<char> data(text.begin() + offset, text.begin() + offset + size);
+        if (!writeCorpusFile(dir + "/file" + std::to_string(i) + ".txt", data)) return 0;
+        total += size;
+    }
+    return total;
+}
+
+#endif // BENCH_UTILS_H
@@ -0,0 +1,361 @@
+// 性能基准测试入口：测量各编解码器与备份流水线各阶段的吞吐（MB/s）与周期/字节
+// 用法：bench_app [--size MB] [--reps N] [--files N] [--filter 子串] [--json 输出路径]
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <ctime>
+#include <nlohmann/json.hpp>
+
+#include "benchUtils.h"
+#include "CRC32.h"
+#include "CHash.h"
+#include "HuffmanCompress.h"
+#include "FSECompress.h"
+#include "CHistogram.h"
+#include "CFilter.h"
+#include "CReedSolomon.h"
+#include "Huffman4XCompress.h"
+#include "BWTCompress.h"
+#include "LongRangeCompress.h"
+#include "SimpleXOREncrypt.h"
+#include "myPack.h"
+#include "CBackup.h"
+
+struct BenchOptions {
+    size_t sizeMB = 16;         // 单文件语料大小
+    int reps = 3;               // 每项测试的迭代次数
+    size_t smallFiles = 2000;   // 小文件目录树的文件数
+    std::string filter;         // 仅运行名称包含该子串的测试
+    std::string jsonPath;       // JSON结果输出路径（为空则不输出）
+};
+
+static bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (arg == "--size") options.sizeMB = std::stoul(next());
+        else if (arg == "--reps") options.reps = std::max(1, std::stoi(next()));
+        else if (arg == "--files") options.smallFiles = std::stoul(next());
+        else if (arg == "--filter") options.filter = next();
+        else if (arg == "--json") options.jsonPath = next();
+        else {
+            std::cerr << "Usage: bench_app [--size MB] [--reps N] [--files N] [--filter substr] [--json path]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+class BenchRunner {
+public:
+    BenchRunner(const BenchOptions& options, const std::string& workDir)
+        : m_options(options), m_workDir(workDir) {}
+
+    // 运行单个测试，名称不匹配过滤条件时跳过
+    void run(const std::string& name, const std::string& corpus, uint64_t bytes,
+             const std::function<void()>& setup, const std::function<bool()>& body) {
+        const std::string fullName = name + "/" + corpus;
+        if (!m_options.filter.empty() && fullName.find(m_options.filter) == std::string::npos) return;
+        BenchResult result;
+        result.name = name;
+        result.corpus = corpus;
+        result.bytes = bytes;
+        if (!measure(result, m_options.reps, setup, body)) {
+            std::cerr << "Error: Benchmark " << fullName << " failed" << std::endl;
+            return;
+        }
+        std::cout << std::left << std::setw(32) << fullName << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1) << result.mbPerSec() << " MB/s"
+                  << std::setw(12) << std::setprecision(2) << result.cyclesPerByte << " cyc/B"
+                  << std::setw(12) << std::setprecision(4) << result.bestSeconds << " s" << std::endl;
+        m_results.push_back(result);
+    }
+
+    const std::vector<BenchResult>& results() const { return m_results; }
+    std::string path(const std::string& name) const { return (fs::path(m_workDir) / name).string(); }
+
+private:
+    BenchOptions m_options;
+    std::string m_workDir;
+    std::vector<BenchResult> m_results;
+};
+
+// 单文件语料：CRC32、XXH3-128、Huffman、XOR
+static void benchCodecs(BenchRunner& runner, const std::string& corpus, const std::vector<char>& data) {
+    const uint64_t bytes = data.size();
+    const std::string src = runner.path(corpus + ".bin");
+    writeCorpusFile(src, data);
+
+    // CRC32（纯内存）
+    const std::vector<uint8_t> raw(data.begin(), data.end());
+    volatile uint32_t sink = 0;
+    runner.run("crc32", corpus, bytes, nullptr, [&] { sink = CRC32::calculate(raw); return true; });
+
+    // 条目内容哈希（纯内存）
+    volatile uint64_t hashSink = 0;
+    runner.run("xxh3_128", corpus, bytes, nullptr, [&] {
+        hashSink = CXXHash128::hash(raw.data(), raw.size()).low;
+        return true;
+    });
+
+    // 字节频率统计（纯内存）
+    CHistogram::Counts histogram{};
+    runner.run(std::string("histogram.") + CHistogram::kernelName(CHistogram::activeKernel()), corpus, bytes, nullptr, [&] {
+        CHistogram::count(raw.data(), raw.size(), histogram);
+        return true;
+    });
+
+    // 纠删码校验分片（纯内存，16+2 个分片）
+    {
+        const CReedSolomon coder(16, 2);
+        const size_t shardSize = (raw.size() + 15) / 16;
+        std::vector<uint8_t> shardBuffer(shardSize * 18, 0);
+        std::copy(raw.begin(), raw.end(), shardBuffer.begin());
+        std::vector<uint8_t*> shards(18);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            shards[i] = shardBuffer.data() + i * shardSize;
+        }
+        runner.run(std::string("rs16+2.") + CReedSolomon::kernelName(CReedSolomon::activeKernel()), corpus, bytes,
+                   nullptr, [&] {
+            coder.encode(shards.data(), shards.data() + 16, shardSize);
+            return true;
+        });
+    }
+
+    // 压缩前过滤器正向/逆向变换（纯内存）
+    for (const char* spec : {"delta:4", "zrle", "x86"}) {
+        CFilterChain chain;
+        CFilterChain::parse(spec, chain);
+        std::vector<uint8_t> filtered, restored;
+        const std::string name = std::string("filter.") + spec;
+        runner.run(name + ".encode", corpus, bytes, nullptr, [&] {
+            filtered.clear();
+            chain.encode(raw.data(), raw.size(), filtered);
+            return true;
+        });
+        runner.run(name + ".decode", corpus, bytes, nullptr, [&] {
+            restored.clear();
+            return chain.decode(filtered.data(), filtered.size(), restored);
+        });
+    }
+
+    // Huffman 压缩/解压（文件到文件）
+    HuffmanCompress huffman;
+    std::string compressed;
+    runner.run("huffman.compress", corpus, bytes, nullptr, [&] {
+        compressed = huffman.compressFile(src);
+        return !compressed.empty();
+    });
+    if (!compressed.empty()) {
+        const std::string restored = runner.path(corpus + ".huff.out");
+        runner.run("huffman.decompress", corpus, bytes, nullptr, [&] {
+            return huffman.decompressFile(compressed, restored);
+        });
+        fs::remove(restored);
+        fs::remove(compressed);
+    }
+
+    // 四路 Huffman 压缩/解压（文件到文件）
+    Huffman4XCompress huf4x;
+    runner.run("huffman4x.compress", corpus, bytes, nullptr, [&] {
+        compressed = huf4x.compressFile(src);
+        return !compressed.empty();
+    });
+    if (!compressed.empty()) {
+        const std::string restored = runner.path(corpus + ".huf4x.out");
+        runner.run("huffman4x.decompress", corpus, bytes, nullptr, [&] {
+            return huf4x.decompressFile(compressed, restored);
+        });
+        fs::remove(restored);
+        fs::remove(compressed);
+    }
+
+    // FSE 压缩/解压（文件到文件）
+    FSECompress fse;
+    runner.run("fse.compress", corpus, bytes, nullptr, [&] {
+        compressed = fse.compressFile(src);
+        return !compressed.empty();
+    });
+    if (!compressed.empty()) {
+        const std::string restored = runner.path(corpus + ".fse.out");
+        runner.run("fse.decompress", corpus, bytes, nullptr, [&] {
+            return fse.decompressFile(compressed, restored);
+        });
+        fs::remove(restored);
+        fs::remove(compressed);
+    }
+
+    // BWT 压缩/解压（文件到文件，全部硬件线程）
+    BWTCompress bwt;
+    runner.run("bwt.compress", corpus, bytes, nullptr, [&] {
+        compressed = bwt.compressFile(src);
+        return !compressed.empty();
+    });
+    if (!compressed.empty()) {
+        const std::string restored = runner.path(corpus + ".bwt.out");
+        runner.run("bwt.decompress", corpus, bytes, nullptr, [&] {
+            return bwt.decompressFile(compressed, restored);
+        });
+        fs::remove(restored);
+        fs::remove(compressed);
+    }
+
+    // 长距离匹配 + Huffman 压缩/解压（文件到文件）
+    LongRangeCompress longRange;
+    runner.run("longrange.compress", corpus, bytes, nullptr, [&] {
+        compressed = longRange.compressFile(src);
+        return !compressed.empty();
+    });
+    if (!compressed.empty()) {
+        const std::string restored = runner.path(corpus + ".lrm.out");
+        runner.run("longrange.decompress", corpus, bytes, nullptr, [&] {
+            return longRange.decompressFile(compressed, restored);
+        });
+        fs::remove(restored);
+        fs::remove(compressed);
+    }
+
+    // XOR 加密/解密
+    SimpleXOREncrypt xorEncrypt;
+    const std::string key = "bench-key-0123456789";
+    std::string encrypted;
+    runner.run("xor.encrypt", corpus, bytes, nullptr, [&] {
+        encrypted = xorEncrypt.encryptFile(src, key);
+        return !encrypted.empty();
+    });
+    if (!encrypted.empty()) {
+        const std::string decrypted = runner.path(corpus + ".enc.out");
+        runner.run("xor.decrypt", corpus, bytes, nullptr, [&] {
+            return xorEncrypt.decryptFile(encrypted, decrypted, key);
+        });
+        fs::remove(decrypted);
+        fs::remove(encrypted);
+    }
+    fs::remove(src);
+}
+
+// 打包与端到端备份/还原
+static void benchPipeline(BenchRunner& runner, const std::string& corpus, const std::string& srcRoot, uint64_t bytes) {
+    // 收集文件列表（与 doBackup 相同的先根遍历）
+    auto config = std::make_shared<CConfig>(srcRoot, runner.path("repo_" + corpus));
+    config->setRecursiveSearch(true);
+    const std::vector<std::string> files = collectFilesToBackup(srcRoot, config);
+
+    myPack packer;
+    const std::string packDir = runner.path("pack_" + corpus);
+    const std::string unpackDir = runner.path("unpack_" + corpus);
+    std::string packed;
+    runner.run("pack.pack", corpus, bytes,
+               [&] { fs::remove_all(packDir); fs::create_directories(packDir); },
+               [&] { packed = packer.pack(files, packDir); return !packed.empty(); });
+    if (!packed.empty()) {
+        runner.run("pack.unpack", corpus, bytes,
+                   [&] { fs::remove_all(unpackDir); fs::create_directories(unpackDir); },
+                   [&] { return packer.unpack(packed, unpackDir); });
+    }
+    fs::remove_all(packDir);
+    fs::remove_all(unpackDir);
+
+    // 按条目压缩，小文件使用训练字典
+    myPack dictPacker;
+    dictPacker.setEntryCompression("Huffman4X");
+    dictPacker.setDictionaryEnabled(true);
+    runner.run("pack.dictionary.pack", corpus, bytes,
+               [&] { fs::remove_all(packDir); fs::create_directories(packDir); },
+               [&] { packed = dictPacker.pack(files, packDir); return !packed.empty(); });
+    if (!packed.empty()) {
+        runner.run("pack.dictionary.unpack", corpus, bytes,
+                   [&] { fs::remove_all(unpackDir); fs::create_directories(unpackDir); },
+                   [&] { return dictPacker.unpack(packed, unpackDir); });
+    }
+    fs::remove_all(packDir);
+    fs::remove_all(unpackDir);
+
+    // 按条目压缩，按实测的压缩与写出速度逐块选择算法
+    myPack adaptivePacker;
+    adaptivePacker.setEntryCompression("Huffman4X");
+    adaptivePacker.setAdaptiveCompression(true, 9);
+    runner.run("pack.adaptive.pack", corpus, bytes,
+               [&] { fs::remove_all(packDir); fs::create_directories(packDir); },
+               [&] { packed = adaptivePacker.pack(files, packDir); return !packed.empty(); });
+    fs::remove_all(packDir);
+
+    // 按条目 BWT 压缩：每批若干块并行编码
+    myPack bwtPacker;
+    bwtPacker.setEntryCompression("BWT");
+    runner.run("pack.bwt.pack", corpus, bytes,
+               [&] { fs::remove_all(packDir); fs::create_directories(packDir); },
+               [&] { packed = bwtPacker.pack(files, packDir); return !packed.empty(); });
+    fs::remove_all(packDir);
+
+    // 端到端：打包 + Huffman 压缩 + XOR 加密
+    const std::string repoDir = runner.path("repo_" + corpus);
+    const std::string restoreDir = runner.path("restore_" + corpus);
+    config->setPackingEnabled(true).setPackType("Basic")
+          .setCompressionEnabled(true).setCompressionType("Huffman")
+          .setEncryptionEnabled(true).setEncryptType("SimXOR").setEncryptionKey("bench-key");
+    std::string archive;
+    CBackup backup;
+    runner.run("pipeline.backup", corpus, bytes,
+               [&] { fs::remove_all(repoDir); fs::create_directories(repoDir); },
+               [&] { archive = backup.doBackup(config); return !archive.empty(); });
+    if (!archive.empty()) {
+        BackupEntry entry(fs::path(srcRoot).filename().string(), srcRoot, repoDir,
+                          fs::path(archive).filename().string(), "", true, true, true);
+        runner.run("pipeline.recover", corpus, bytes,
+                   [&] { fs::remove_all(restoreDir); fs::create_directories(restoreDir); },
+                   [&] { return backup.doRecovery(entry, restoreDir, "bench-key"); });
+    }
+    fs::remove_all(repoDir);
+    fs::remove_all(restoreDir);
+}
+
+static bool writeJson(const std::string& path, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    nlohmann::json j;
+    j["schema"] = 1;
+    j["timestamp"] = static_cast<int64_t>(std::time(nullptr));
+    j["options"] = {{"size_mb", options.sizeMB}, {"reps", options.reps}, {"small_files", options.smallFiles}};
+    j["results"] = nlohmann::json::array();
+    for (const auto& r : results) {
+        j["results"].push_back({{"name", r.name}, {"corpus", r.corpus}, {"bytes", r.bytes},
+                                {"reps", r.reps}, {"best_seconds", r.bestSeconds},
+                                {"median_seconds", r.medianSeconds}, {"mb_per_s", r.mbPerSec()},
+                                {"cycles_per_byte", r.cyclesPerByte}});
+    }
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Error: Failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+    out << j.dump(2) << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) return 1;
+
+    const std::string workDir = (fs::temp_directory_path() / ("bench_app_" + std::to_string(std::time(nullptr)))).string();
+    fs::create_directories(workDir);
+    BenchRunner runner(options, workDir);
+
+    const size_t size = options.sizeMB * 1024 * 1024;
+    benchCodecs(runner, "random", makeRandomCorpus(size));
+    benchCodecs(runner, "text", makeTextCorpus(size));
+    benchCodecs(runner, "zeros", makeZeroCorpus(size));
+
+    // 目录树语料：大量小文件 / 单个大文本文件
+    const std::string treeRoot = runner.path("tree_src");
+    const uint64_t treeBytes = makeSmallFilesTree(treeRoot, options.smallFiles);
+    benchPipeline(runner, "small-files", treeRoot, treeBytes);
+    const std::string bigRoot = runner.path("big_src");
+    writeCorpusFile(bigRoot + "/big.txt", makeTextCorpus(size));
+    benchPipeline(runner, "text", bigRoot, size);
+
+    bool ok = true;
+    if (!options.jsonPath.empty()) {
+        ok = writeJson(options.jsonPath, options, runner.results());
+    }
+    fs::remove_all(workDir);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#ifndef BWT_COMPRESS_H
+#define BWT_COMPRESS_H
+
+#include "CBlockCompress.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * @brief 块排序（bzip2 类）编码：BWT + MTF + 零串游程编码 + FSE
+ * @description BWT 把上下文相同的字节聚到一起，MTF 把它们变成以0为主的小整数，
+ *  零串用 RUNA/RUNB 双射二进制计数，最后按 64KB 分段交给 FseCodec 熵编码。
+ *  后缀数组用 SA-IS 线性时间构造。
+ *  块格式：模式（1字节） 原始长度（4字节） 之后按模式不同：
+ *   - Raw：原始数据；
+ *   - Bwt：主索引（4字节） 符号数（4字节） 若干 FseCodec 块。
+ */
+class BwtCodec {
+public:
+    static constexpr size_t kEntropySegment = 64 * 1024;  // 熵编码分段，使频率表贴近局部分布
+    static constexpr size_t kMaxBlockSize = (size_t(1) << 24) - 1;  // 逆变换用24位行号
+
+    enum class BlockMode : uint8_t {
+        Raw = 0,
+        Bwt = 1,
+    };
+
+    // 编码一块数据，追加到 out 末尾
+    static void compressBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out);
+
+    // 解码 src 开头的一块数据，追加到 out 末尾；consumed 返回该块占用的字节数。
+    // maxLen 为原始长度的上限（容器的分块大小），块头记录的长度超出时视为损坏，不分配内存
+    static bool decompressBlock(const uint8_t* src, size_t srcLen, size_t maxLen, std::vector<uint8_t>& out,
+                                size_t& consumed);
+
+    // 构造后缀数组（SA-IS）：s 中的值在 [0, upper]，结果按后缀字典序给出起始位置，较短的前缀在前
+    static std::vector<int32_t> suffixArray(const std::vector<int32_t>& s, int32_t upper);
+
+    // BWT 正变换：返回去掉结束符后的变换结果，primary 为结束符所在的行
+    static std::vector<uint8_t> forward(const uint8_t* src, size_t len, uint32_t& primary);
+
+    // BWT 逆变换；primary 不合法时返回 false
+    static bool inverse(const std::vector<uint8_t>& bwt, uint32_t primary, std::vector<uint8_t>& out);
+};
+
+/*
+ * @brief BWT 压缩器：文件头之后是若干 BwtCodec 块，默认用全部硬件线程并行编码各块
+ */
+class BWTCompress : public CBlockCompress {
+public:
+    static constexpr size_t kBlockSize = 1024 * 1024;  // 逆变换的行表（4字节/行）可留在 L2 缓存附近
+
+    explicit BWTCompress(unsigned threads = 0) : CBlockCompress(kBlockSize, threads) {}
+
+    CompressType getCompressType() const override { return CompressType::BWT; }
+    std::string getCompressTypeName() const override { return "BWT"; }
+
+protected:
+    void encodeBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const override {
+        BwtCodec::compressBlock(src, len, out);
+    }
+    bool decodeBlock(const uint8_t* src, size_t srcLen, size_t blockSize, std::vector<uint8_t>& out,
+                     size_t& consumed) const override {
+        return BwtCodec::decompressBlock(src, srcLen, blockSize, out, consumed);
+    }
+    std::string getFileExtension() const override { return ".bwt"; }
+};
+
+#endif // BWT_COMPRESS_H
@@ -0,0 +1,67 @@
+#ifndef CADAPTIVELEVEL_H
+#define CADAPTIVELEVEL_H
+
+#include <array>
+#include <cstdint>
+
+#include "ICompress.h"
+
+/*
+ * @brief 自适应压缩级别：按任务中实测的压缩速度与写出速度，为每一块选择压缩算法
+ * @description 级别 0 为不压缩，1~4 依次为 Huffman4X、FSE、LongRange、BWT，越高越慢、压缩率越高。
+ *  打包是串行的，每个原始字节的耗时约为 压缩耗时 + 压缩率 × 写出耗时（读取耗时与级别无关）。
+ *  各级别以指数滑动平均记录每字节的压缩耗时与压缩率，写出记录每字节耗时，
+ *  每块选择估计耗时最小的级别：目标设备慢（NAS）时多压缩以少写出，CPU 跟不上（NVMe）时降级，
+ *  最低级别仍然更慢时部分块不压缩。
+ *  只有当前级别的数据是最新的，因此相邻级别尚未测量时立即试探一块，之后每 kProbeInterval 块
+ *  轮流试探上下相邻的级别，以便在数据或设备速度变化时重新选择。
+ */
+class CAdaptiveLevel {
+public:
+    static constexpr int kMaxLevel = 4;
+    static constexpr unsigned kProbeInterval = 16;  // 每隔多少块试探一次相邻级别
+    static constexpr double kSmoothing = 0.3;       // 滑动平均中新测量值的权重
+    static constexpr double kSwitchMargin = 0.05;   // 估计耗时至少低这么多才更换级别，避免来回切换
+
+    // maxLevel 为可以使用的最高级别，startLevel 为还没有测量数据时使用的级别
+    explicit CAdaptiveLevel(int maxLevel = kMaxLevel, int startLevel = 1);
+
+    // 级别对应的压缩算法（级别 0 为 None）
+    static CompressType codecForLevel(int level);
+    // 配置中的压缩级别（1~9）对应的最高级别
+    static int maxLevelForConfig(int compressionLevel);
+
+    // 下一块使用的级别
+    int nextLevel();
+
+    // 上报一块的压缩结果：原始长度、存放长度（没有变小时等于原始长度）与压缩耗时
+    void recordCompress(int level, uint64_t rawBytes, uint64_t storedBytes, uint64_t nanos);
+    // 上报写出的字节数与耗时；耗时应包含数据同步到设备的时间，只写入页缓存的耗时反映不出设备速度
+    void recordWrite(uint64_t bytes, uint64_t nanos);
+
+    // 每个原始字节的估计耗时（纳秒），该级别尚未测量时返回负数
+    double estimateCost(int level) const;
+
+    int getLevel() const { return m_level; }
+    int getMaxLevel() const { return m_maxLevel; }
+    // 各级别处理过的块数
+    const std::array<uint64_t, kMaxLevel + 1>& getBlockCounts() const { return m_blockCounts; }
+
+private:
+    struct LevelStats {
+        double nanosPerByte = 0;  // 每个原始字节的压缩耗时
+        double ratio = 1;         // 存放长度 / 原始长度
+        bool measured = false;
+    };
+
+    int m_maxLevel;
+    int m_level;
+    std::array<LevelStats, kMaxLevel + 1> m_stats;
+    double m_writeNanosPerByte = 0;
+    bool m_writeMeasured = false;
+    uint64_t m_blocks = 0;
+    bool m_probeUp = true;
+    std::array<uint64_t, kMaxLevel + 1> m_blockCounts{};
+};
+
+#endif // CADAPTIVELEVEL_H
@@ -8,6 +8,8 @@
 #include <set>  
 #include <fstream>
 #include <iostream>
+#include <future>
+#include <atomic>
 
 #include "CConfig.h"
 #include "CBackupRecorder.h"
@@ -15,8 +17,20 @@
 #include "PackFactory.h"  
 #include "CompressFactory.h"
 #include "EncryptFactory.h"
+#include "CRateLimiter.h"
+#include "CMetrics.h"
+#include "CCopyEngine.h"
+#include "CDeltaEngine.h"
 namespace fs = std::filesystem; 
 
+// 单个备份的校验结果
+struct VerifyResult {
+    std::string backupName;  // 记录中的备份文件名
+    bool ok = false;
+    uint64_t bytes = 0;      // 读取的备份数据量（字节）
+    double seconds = 0;      // 校验耗时
+};
+
 
 
 class CBackup {
@@ -33,9 +47,32 @@ public:
     // 恢复相关（带密码参数，用于GUI）
     bool doRecovery(const BackupEntry& entry, const std::string& destDir, const std::string& password);
 
+    // 校验相关：把备份依次经过解密、解压、解包校验的流水线（各阶段并行，经内存管道相连），
+    // 检查各层的 CRC 与包内每个条目的内容哈希，不写出任何文件；加密的备份需要密码
+    bool doVerify(const BackupEntry& entry, const std::string& password, VerifyResult* result = nullptr);
+    // 并发校验多个备份（threads 为 0 时使用硬件线程数），返回每个备份的结果，并记录总吞吐量
+    std::vector<VerifyResult> verifyBackups(const std::vector<BackupEntry>& entries, const std::string& password,
+                                            unsigned threads = 0);
+
+    // 设置读取源文件时的I/O限速器（由调度器为每个任务设置，为空表示不限速）
+    void setRateLimiter(std::shared_ptr<CRateLimiter> limiter) { rateLimiter = std::move(limiter); }
+
+    // 启用/禁用各阶段统计（配置中启用统计时，doBackup 会自动启用）
+    void setMetricsEnabled(bool enabled) { metrics->setEnabled(enabled); }
+    // 获取统计对象，任务执行中可从其他线程实时查询，结束后可调用 toJson 生成报告
+    std::shared_ptr<CMetrics> getMetrics() const { return metrics; }
 
 private:
+    std::string runBackup(const std::shared_ptr<CConfig>& config);
+    // 快照模式的镜像备份，返回新快照目录
+    std::string runSnapshotBackup(const std::vector<PackSource>& sources, const std::shared_ptr<CConfig>& config,
+                                  const std::string& destinationRoot);
+    // 校验一个备份，不重置统计
+    bool runVerify(const BackupEntry& entry, const std::string& password, VerifyResult& result);
+
     std::set<std::string> createdDirs;  // 用于记录已创建的目录，避免重复创建
+    std::shared_ptr<CRateLimiter> rateLimiter;  // I/O限速器
+    std::shared_ptr<CMetrics> metrics;          // 各阶段统计
 
 };
 
@@ -46,6 +83,18 @@ bool WriteFile(const std::string& filePath, std::vector<char>& buffer);
 bool CopyFileBinary(const std::string& srcPath, const std::string& destPath);
 // 新增：收集需要备份的文件列表
 std::vector<std::string> collectFilesToBackup(const std::string& rootPath, const std::shared_ptr<CConfig>& config);
+// 并发遍历多个源根，为每个源分配唯一的包内前缀
+std::vector<PackSource> collectSourcesToBackup(const std::vector<std::string>& rootPaths, const std::shared_ptr<CConfig>& config);
+// 找到目标根目录下最近一次的快照目录（不存在时返回空字符串）
+std::string findLatestSnapshot(const std::string& destinationRoot);
+// 删除快照前调用：其他快照中以该快照内文件为基准的差量条目重建为完整文件
+bool detachSnapshotDeltas(const std::string& destinationRoot, const std::string& snapshotName);
+
+// 快照目录名前缀（后接时间戳）与快照内的清单文件名
+inline constexpr const char* SNAPSHOT_DIR_PREFIX = "snapshot_";
+inline constexpr const char* SNAPSHOT_MANIFEST_NAME = ".snapshot_manifest.json";
+// 差量基准的签名缓存目录（位于目标根目录下，按 快照名/条目名 存放）
+inline constexpr const char* DELTA_SIGNATURE_DIR_NAME = ".delta_signatures";
 
 
 #endif //CBACKUP_H
\ No newline at end of file
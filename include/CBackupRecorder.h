@@ -90,13 +90,20 @@ public:
     // 根据备份时间查找条目
     std::vector<BackupEntry> findBackupRecordsByBackupTime(const std::string& startime, const std::string& endTime) const;
 
+    // 与上面两个查找相同，但只返回匹配记录的下标，不拷贝条目（用于大量记录的界面列表）
+    std::vector<size_t> findBackupRecordIndicesByFileName(const std::string& queryFileName) const;
+    std::vector<size_t> findBackupRecordIndicesByBackupTime(const std::string& startime, const std::string& endTime) const;
+
+    // 记录集合的版本号，每次增删改、重新加载后递增，调用方可据此判断缓存是否失效
+    uint64_t getRevision() const;
+
     // 获取备份条目的全局索引
     size_t getBackupRecordIndex(const BackupEntry& entry) const;
 
-    // 根据索引删除备份记录
+    // 根据索引删除备份记录及其备份文件；备份无法删除（如快照仍被差量引用）时保留记录并返回 false
     bool deleteBackupRecord(size_t index);
 
-    // 根据备份记录删除条目
+    // 根据备份记录删除条目，备份无法删除时同样保留记录
     bool deleteBackupRecord(const BackupEntry& entry);
 
     // 修改备份记录
@@ -117,6 +124,7 @@ private:
     std::vector<BackupEntry> backupRecords; // 备份记录容器
     std::string recorderFilePath; // 备份记录文件路径
     bool autoSaveEnabled; // 是否自动保存,默认为false
+    uint64_t revision = 0; // 记录集合的版本号
 };
 
 #endif
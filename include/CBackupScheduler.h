@@ -0,0 +1,114 @@
+#ifndef CBACKUPSCHEDULER_H
+#define CBACKUPSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+#include "CConfig.h"
+#include "CBackupRecorder.h"
+#include "CRateLimiter.h"
+
+// 备份任务状态
+enum class JobStatus : uint8_t {
+    Pending = 0,    // 排队中
+    Running = 1,    // 执行中
+    Succeeded = 2,  // 执行成功
+    Failed = 3,     // 执行失败
+};
+
+// 单个备份任务描述
+struct BackupJob {
+    std::shared_ptr<CConfig> config;   // 任务配置
+    std::chrono::system_clock::time_point deadline = std::chrono::system_clock::time_point::max(); // 截止时间，越早越先执行
+    int priority = 0;                  // 截止时间相同时的优先级，越大越先执行
+    unsigned threads = 1;              // 任务占用的工作线程数
+    uint64_t ioBytesPerSec = 0;        // 任务的I/O带宽上限（字节/秒，0为不限）
+    uint64_t memoryBytes = 0;          // 任务预估的内存占用（字节，用于准入控制，0为不计）
+};
+
+// 备份任务执行结果
+struct JobResult {
+    size_t jobId = 0;                  // 任务编号（submit 的返回值）
+    JobStatus status = JobStatus::Pending;
+    std::string destPath;              // 备份结果路径（成功时）
+    std::string errorMessage;          // 错误信息（失败时）
+    std::chrono::system_clock::time_point startTime;
+    std::chrono::system_clock::time_point finishTime;
+    bool missedDeadline = false;       // 是否在截止时间之后才完成
+    std::string metricsReport;         // 各阶段统计报告（JSON，配置启用统计时才有）
+};
+
+/*
+ * @brief 备份任务调度器，负责并发执行多个备份任务
+ * @description 任务按截止时间（EDF）排序，截止时间相同再按优先级、提交顺序排序。
+ *  调度器维护全局的线程、内存额度，只有队首任务所需额度可以满足时才会启动，
+ *  避免大任务被小任务持续插队；全局I/O带宽通过共享的父限速器约束，
+ *  每个任务再拥有各自的限速器。
+ */
+class CBackupScheduler {
+public:
+    /**
+     * @param maxThreads 全局线程额度（默认为CPU核心数）
+     * @param maxIoBytesPerSec 全局I/O带宽上限（字节/秒，0为不限）
+     * @param maxMemoryBytes 全局内存额度（字节，0为不限）
+     */
+    explicit CBackupScheduler(unsigned maxThreads = std::thread::hardware_concurrency(),
+                              uint64_t maxIoBytesPerSec = 0, uint64_t maxMemoryBytes = 0);
+    ~CBackupScheduler();
+
+    CBackupScheduler(const CBackupScheduler&) = delete;
+    CBackupScheduler& operator=(const CBackupScheduler&) = delete;
+
+    // 提交任务，返回任务编号；配置会被深拷贝，调用方后续修改不影响任务
+    size_t submit(const BackupJob& job);
+
+    // 执行所有已提交的任务，阻塞直到全部完成（执行期间仍可继续 submit）
+    void runAll();
+
+    // 设置备份记录器，任务成功后自动添加记录（为空则不记录）
+    void setRecorder(CBackupRecorder* recorder);
+
+    // 查询任务状态
+    JobStatus getJobStatus(size_t jobId) const;
+
+    // 获取所有任务的结果（按任务编号排序）
+    std::vector<JobResult> getResults() const;
+
+    // 获取排队中的任务数量
+    size_t getPendingCount() const;
+
+private:
+    struct PendingJob {
+        size_t id;
+        BackupJob job;
+    };
+
+    // 判断 a 是否应排在 b 之前
+    static bool runsBefore(const PendingJob& a, const PendingJob& b);
+    // 判断任务所需额度当前能否满足（调用方需持有锁）
+    bool hasCapacity(const BackupJob& job) const;
+    // 工作线程入口
+    void runJob(PendingJob pending);
+
+    unsigned m_maxThreads;
+    uint64_t m_maxMemoryBytes;
+    std::shared_ptr<CRateLimiter> m_globalLimiter;  // 全局限速器
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<PendingJob> m_pending;   // 排队中的任务
+    std::vector<JobResult> m_results;    // 下标即任务编号
+    std::vector<std::thread> m_workers;  // 已启动的工作线程
+    unsigned m_usedThreads = 0;          // 已占用的线程额度
+    uint64_t m_usedMemory = 0;           // 已占用的内存额度
+    size_t m_running = 0;                // 正在执行的任务数
+    CBackupRecorder* m_recorder = nullptr;
+};
+
+#endif // CBACKUPSCHEDULER_H
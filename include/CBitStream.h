@@ -0,0 +1,116 @@
+#ifndef CBITSTREAM_H
+#define CBITSTREAM_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/*
+ * @brief 熵编码用的比特流：正向写入、逆向读取
+ * @description 写入端先写入的位放在低位，关闭时追加一个值为1的结束标记；
+ *  读取端从末尾字节最高的1位开始向前读，最先读到的是最后写入的位。
+ *  因此编码器逆序编码符号，解码器即可按原始顺序输出。
+ */
+class CBitWriter {
+public:
+    explicit CBitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    // 写入 value 的低 nbBits 位（nbBits <= 32）
+    void write(uint64_t value, unsigned nbBits) {
+        m_acc |= (value & mask(nbBits)) << m_accBits;
+        m_accBits += nbBits;
+        if (m_accBits >= 32) {
+            for (int i = 0; i < 4; ++i) {
+                m_out.push_back(static_cast<uint8_t>(m_acc));
+                m_acc >>= 8;
+            }
+            m_accBits -= 32;
+        }
+    }
+
+    // 写入结束标记并刷出剩余的位
+    void close() {
+        write(1, 1);
+        while (m_accBits > 0) {
+            m_out.push_back(static_cast<uint8_t>(m_acc));
+            m_acc >>= 8;
+            m_accBits = m_accBits > 8 ? m_accBits - 8 : 0;
+        }
+    }
+
+    static uint64_t mask(unsigned nbBits) { return (uint64_t(1) << nbBits) - 1; }
+
+private:
+    std::vector<uint8_t>& m_out;
+    uint64_t m_acc = 0;
+    unsigned m_accBits = 0;
+};
+
+class CBitReader {
+public:
+    // 定位到结束标记之前；末尾字节为0（没有结束标记）时返回 false
+    bool init(const uint8_t* data, size_t len) {
+        m_data = data;
+        m_len = len;
+        m_bitPos = 0;
+        m_overflow = false;
+        if (len == 0 || data[len - 1] == 0) {
+            return false;
+        }
+        unsigned top = 0;
+        for (uint8_t b = data[len - 1]; b >>= 1;) {
+            ++top;
+        }
+        m_bitPos = (len - 1) * 8 + top;
+        return true;
+    }
+
+    // 查看接下来的 nbBits 位（nbBits <= 32），剩余不足时低位补0
+    uint32_t peek(unsigned nbBits) const {
+        if (nbBits <= m_bitPos) {
+            return load(m_bitPos - nbBits, nbBits);
+        }
+        return load(0, static_cast<unsigned>(m_bitPos)) << (nbBits - m_bitPos);
+    }
+
+    void skip(unsigned nbBits) {
+        if (nbBits > m_bitPos) {
+            m_overflow = true;
+            m_bitPos = 0;
+            return;
+        }
+        m_bitPos -= nbBits;
+    }
+
+    uint32_t read(unsigned nbBits) {
+        const uint32_t v = peek(nbBits);
+        skip(nbBits);
+        return v;
+    }
+
+    // 所有位恰好读完且没有越界
+    bool finished() const { return m_bitPos == 0 && !m_overflow; }
+
+private:
+    // 取出 [pos, pos + nbBits) 的位
+    uint32_t load(size_t pos, unsigned nbBits) const {
+        const size_t byte = pos >> 3;
+        uint64_t v = 0;
+        if (byte + 8 <= m_len) {
+            std::memcpy(&v, m_data + byte, 8);  // 小端平台直接加载
+        } else {
+            for (size_t i = 0; byte + i < m_len; ++i) {
+                v |= uint64_t(m_data[byte + i]) << (8 * i);
+            }
+        }
+        return static_cast<uint32_t>((v >> (pos & 7)) & CBitWriter::mask(nbBits));
+    }
+
+    const uint8_t* m_data = nullptr;
+    size_t m_len = 0;
+    size_t m_bitPos = 0;
+    bool m_overflow = false;
+};
+
+#endif // CBITSTREAM_H
@@ -0,0 +1,66 @@
+#ifndef CBLOCKCOMPRESS_H
+#define CBLOCKCOMPRESS_H
+
+#include "ICompress.h"
+#include "CRC32.h"
+#include "CMetrics.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 分块压缩文件头
+struct BlockHead {
+    uint8_t isCompress;         // 是否压缩，固定为0x21，1字节
+    CompressType compressType;  // 压缩算法类型，1字节
+    uint16_t reserved;          // 保留，2字节
+    uint32_t blockSize;         // 分块大小，4字节
+    uint64_t originalSize;      // 原始大小，8字节
+    uint32_t crc32;             // CRC32校验值，4字节
+    uint32_t padding;           // 对齐，4字节
+};  // 24字节
+
+/*
+ * @brief 按固定大小分块、每块独立编码的压缩器基类
+ * @description 文件与内存数据格式相同：文件头之后是若干 [块长度（4字节） 块数据]。
+ *  每块自带编码表，压缩时只需顺序读一遍源数据，内存占用与文件大小无关。
+ *  块之间互不依赖，线程数大于1时每次读入一批块并行编码/解码，再按顺序写出。
+ *  子类只需实现单块的编码与解码（须可重入）。
+ */
+class CBlockCompress : public ICompress {
+public:
+    // threads 为 0 时使用全部硬件线程
+    explicit CBlockCompress(size_t blockSize, unsigned threads = 1) : m_blockSize(blockSize) {
+        setThreadCount(threads);
+    }
+
+    // 输出到 sourcePath + 扩展名，返回压缩后的文件路径
+    std::string compressFile(const std::string& sourcePath) override;
+    bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    bool decompressStream(std::istream& in, std::ostream& out, const std::string& sourceName) override;
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    size_t getBlockSize() const { return m_blockSize; }
+    void setThreadCount(unsigned threads);
+    unsigned getThreadCount() const { return m_threads; }
+
+protected:
+    // 编码一块数据，追加到 out 末尾
+    virtual void encodeBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const = 0;
+    // 解码一块数据，追加到 out 末尾；consumed 返回该块占用的字节数。
+    // blockSize 为文件头记录的分块大小，解出的数据不能超过它
+    virtual bool decodeBlock(const uint8_t* src, size_t srcLen, size_t blockSize, std::vector<uint8_t>& out,
+                             size_t& consumed) const = 0;
+    // 压缩文件的扩展名（含点号）
+    virtual std::string getFileExtension() const = 0;
+
+private:
+    BlockHead makeHead() const;
+    bool checkHead(const BlockHead& header) const;
+
+    size_t m_blockSize;
+    unsigned m_threads = 1;
+};
+
+#endif // CBLOCKCOMPRESS_H
@@ -0,0 +1,53 @@
+#ifndef CCODECPOLICY_H
+#define CCODECPOLICY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ICompress.h"
+
+/*
+ * @brief 按条目选择压缩算法：已经压缩过的数据（图片、视频、压缩包等）直接原样存放
+ * @description 依次检查：
+ *  1. 文件过小，压缩头开销大于收益；
+ *  2. 已知的压缩格式扩展名（jpg/mp4/zip/gz 等）；
+ *  3. 文件头的魔数（扩展名不可信时仍能识别）；
+ *  4. 抽样计算字节熵，高于阈值说明编码后几乎不会变小。
+ *  命中任意一条时返回 CompressType::None，否则返回首选算法。
+ */
+class CCodecPolicy {
+public:
+    static constexpr size_t kSampleWindow = 16 * 1024;  // 每个抽样窗口的大小（头、中、尾各一个）
+    static constexpr uint64_t kMinCompressSize = 256;   // 小于此大小的文件不压缩
+
+    explicit CCodecPolicy(CompressType preferred = CompressType::Huffman, double entropyThreshold = 7.5);
+
+    // 为文件选择压缩算法；size 为需要存放的数据长度
+    CompressType choose(const std::string& path, uint64_t size) const;
+
+    // 只按大小与扩展名初选（上面的第 1、2 条），不读取文件；内容由调用方读入后再用 chooseForData 判断
+    CompressType preselect(const std::string& path, uint64_t size) const;
+
+    // 为一段已读入的数据选择压缩算法（不检查扩展名）
+    CompressType chooseForData(const char* data, size_t len) const;
+
+    // 字节熵（位/字节，0~8）
+    static double entropy(const char* data, size_t len);
+    // 扩展名是否属于已压缩格式（不区分大小写）
+    static bool isCompressedExtension(const std::string& path);
+    // 数据开头是否为已压缩格式的魔数
+    static bool hasCompressedMagic(const char* data, size_t len);
+
+    CompressType getPreferred() const { return m_preferred; }
+    double getEntropyThreshold() const { return m_entropyThreshold; }
+
+private:
+    // 读取头、中、尾三个抽样窗口
+    static bool readSample(const std::string& path, uint64_t size, std::vector<char>& sample);
+
+    CompressType m_preferred;
+    double m_entropyThreshold;
+};
+
+#endif // CCODECPOLICY_H
@@ -11,6 +11,7 @@
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
+#include <cstdint>
 /**
  * @brief 配置类，负责存储和管理备份系统的所有配置项
  * @details 涵盖源路径、目标路径、文件筛选、备份行为（打包/压缩/加密）等配置，提供完整的 setter/getter 接口
@@ -163,6 +164,19 @@ public:
      * @return 打包类型（const 引用，避免拷贝）
      */
     const std::string& getPackType() const;
+
+    /**
+     * 设置打包时是否对内容相同的文件去重（只存放一份内容）
+     * @param value true=启用，false=禁用（默认true）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setDeduplicationEnabled(bool value);
+
+    /**
+     * 获取打包时是否去重
+     * @return true=启用，false=禁用
+     */
+    bool isDeduplicationEnabled() const;
     
     /**
      * 设置是否启用压缩（如gzip压缩）
@@ -192,6 +206,7 @@ public:
     
     /**
      * 设置压缩级别（1-9，级别越高压缩率越高但速度越慢）
+     * 自适应压缩时决定可以使用的最慢算法：1-2 Huffman4X，3-4 FSE，5-7 LongRange，8-9 BWT
      * @param level 压缩级别（1-9，默认1）
      * @return 返回自身引用，支持链式调用
      * @throw std::invalid_argument 若级别超出1-9范围
@@ -203,6 +218,49 @@ public:
      * @return 压缩级别（1-9）
      */
     int getCompressionLevel() const;
+
+    /**
+     * 设置打包压缩时是否自适应地选择压缩级别
+     * 任务中实测压缩与写出速度，写出慢时提高级别，压缩跟不上时降低级别或部分块不压缩
+     * @param value true=启用，false=禁用（默认false）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setAdaptiveCompressionEnabled(bool value);
+
+    /**
+     * 获取打包压缩时是否自适应地选择压缩级别
+     * @return true=启用，false=禁用
+     */
+    bool isAdaptiveCompressionEnabled() const;
+
+    /**
+     * 设置打包压缩时是否为小文件训练共享字典
+     * 从包内的小文件中抽样训练字典，字典在包内只存放一份，每个小文件以它为前缀独立压缩
+     * @param value true=启用，false=禁用（默认false）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setDictionaryEnabled(bool value);
+
+    /**
+     * 获取打包压缩时是否为小文件训练共享字典
+     * @return true=启用，false=禁用
+     */
+    bool isDictionaryEnabled() const;
+
+    /**
+     * 设置打包压缩前的过滤器链
+     * 如 "delta:4"（按 4 字节步长差分）、"zrle"（0 字节游程）、"x86"（可执行文件的跳转地址），可用逗号串联；
+     * "auto" 表示按各文件内容自动选择
+     * @param value 过滤器链描述（默认为空，不过滤）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setFilterChain(const std::string& value);
+
+    /**
+     * 获取打包压缩前的过滤器链
+     * @return 过滤器链描述，为空表示不过滤
+     */
+    std::string getFilterChain() const;
     
     /**
      * 设置是否启用加密（备份文件加密存储）
@@ -242,6 +300,139 @@ public:
      * @return 加密类型（const 引用，避免拷贝）
      */
     const std::string& getEncryptType() const;
+
+    /**
+     * 设置是否启用快照模式（仅对非打包的镜像备份生效）
+     * 每次备份生成一个新的快照目录，未变化的文件硬链接到上一次快照，只拷贝变化的文件
+     * @param enable true=启用，false=禁用（默认false）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setSnapshotEnabled(bool enable);
+
+    /**
+     * 获取是否启用快照模式
+     * @return true=启用，false=禁用
+     */
+    bool isSnapshotEnabled() const;
+
+    /**
+     * 设置快照模式是否按内容校验值判断文件是否变化
+     * 默认只比较大小和修改时间；启用后还会比较上一次快照清单中记录的CRC32（需要读取源文件）
+     * @param enable true=启用，false=禁用（默认false）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setSnapshotCompareHash(bool enable);
+
+    /**
+     * 获取快照模式是否按内容校验值判断文件是否变化
+     * @return true=启用，false=禁用
+     */
+    bool isSnapshotCompareHash() const;
+
+    /**
+     * 设置快照模式是否对变化的大文件只保存差量
+     * 对上一版本计算块签名（rsync式弱+强校验），新快照中只保存复用旧数据/插入新数据的指令流，
+     * 恢复时由基准版本与差量重建。签名缓存在目标根目录下，不必每次重新计算
+     * @param enable true=启用，false=禁用（默认false）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setDeltaEnabled(bool enable);
+
+    /**
+     * 获取快照模式是否对变化的大文件只保存差量
+     * @return true=启用，false=禁用
+     */
+    bool isDeltaEnabled() const;
+
+    /**
+     * 设置按差量保存的最小文件大小，小于该值的文件仍完整拷贝
+     * @param bytes 字节数（默认16MB）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setDeltaMinSize(uint64_t bytes);
+
+    /**
+     * 获取按差量保存的最小文件大小
+     * @return 字节数
+     */
+    uint64_t getDeltaMinSize() const;
+
+    /**
+     * 设置是否为打包生成的归档附带 Reed-Solomon 校验文件（归档路径 + .bkpar）
+     * 长期存放中归档出现位翻转或坏扇区时，还原前按校验文件就地修复
+     * @param enable true=启用，false=禁用（默认false）
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setParityEnabled(bool enable);
+
+    /**
+     * 获取是否生成校验文件
+     * @return true=启用，false=禁用
+     */
+    bool isParityEnabled() const;
+
+    /**
+     * 设置校验文件的分片比例：每 dataShards 个数据分片生成 parityShards 个校验分片，
+     * 同一条带内最多可修复 parityShards 个损坏的分片，空间开销为 parityShards / dataShards
+     * @param dataShards 数据分片数（默认16）
+     * @param parityShards 校验分片数（默认2）
+     * @return 返回自身引用，支持链式调用
+     * @throw std::invalid_argument 若分片数为0或两者之和超过255
+     */
+    CConfig& setParityShards(unsigned dataShards, unsigned parityShards);
+
+    /**
+     * 获取每个条带的数据分片数
+     * @return 数据分片数
+     */
+    unsigned getParityDataShards() const;
+
+    /**
+     * 获取每个条带的校验分片数
+     * @return 校验分片数
+     */
+    unsigned getParityShards() const;
+
+    // ===== 性能配置接口（并发/资源限制） =====
+    /**
+     * 设置单个备份任务可使用的工作线程数
+     * @param count 线程数（至少为1，默认1）
+     * @return 返回自身引用，支持链式调用
+     * @throw std::invalid_argument 若线程数为0
+     */
+    CConfig& setThreadCount(unsigned count);
+
+    /**
+     * 获取单个备份任务可使用的工作线程数
+     * @return 线程数（>=1）
+     */
+    unsigned getThreadCount() const;
+
+    /**
+     * 设置是否统计各阶段耗时与吞吐（默认关闭）
+     * @param enable true=启用，false=禁用
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setMetricsEnabled(bool enable);
+
+    /**
+     * 获取是否统计各阶段耗时与吞吐
+     * @return true=启用，false=禁用
+     */
+    bool isMetricsEnabled() const;
+
+    /**
+     * 设置统计报告（JSON）的输出路径，为空则不写文件
+     * @param path 报告文件路径
+     * @return 返回自身引用，支持链式调用
+     */
+    CConfig& setMetricsReportPath(const std::string& path);
+
+    /**
+     * 获取统计报告的输出路径
+     * @return 报告文件路径（const 引用，避免拷贝）
+     */
+    const std::string& getMetricsReportPath() const;
     
     // ===== 高级配置接口（自定义选项） =====
     /**
@@ -307,12 +498,28 @@ private:
     // 备份行为配置
     bool m_enablePacking = false;              // 是否启用打包
     std::string m_packType = "tar";            // 打包类型（默认 tar）
+    bool m_enableDeduplication = true;         // 打包时是否去重
     bool m_enableCompression = false;          // 是否启用压缩
     std::string m_compressionType = "gzip";    // 压缩类型（默认 gzip）
     int m_compressionLevel = 1;                // 压缩级别（默认 1，1-9）
+    bool m_enableDictionary = false;           // 是否为小文件训练压缩字典
+    bool m_enableAdaptiveCompression = false;  // 是否自适应选择压缩级别
+    std::string m_filterChain;                 // 压缩前的过滤器链
     bool m_enableEncryption = false;           // 是否启用加密
     std::string m_encryptionKey;               // 加密密钥
     std::string m_encryptType = "SimXOR";      // 加密类型（默认 SimXOR）
+    bool m_enableSnapshot = false;             // 是否启用快照模式
+    bool m_snapshotCompareHash = false;        // 快照模式是否比较内容校验值
+    bool m_enableDelta = false;                // 快照模式是否对变化的大文件只保存差量
+    uint64_t m_deltaMinSize = 16ull << 20;     // 按差量保存的最小文件大小
+    bool m_enableParity = false;               // 是否为归档生成校验文件
+    unsigned m_parityDataShards = 16;          // 每个条带的数据分片数
+    unsigned m_parityShards = 2;               // 每个条带的校验分片数
+
+    // 性能配置
+    unsigned m_threadCount = 1;                // 工作线程数（默认 1）
+    bool m_enableMetrics = false;              // 是否统计各阶段耗时
+    std::string m_metricsReportPath;           // 统计报告输出路径
     
     // 高级配置
     std::map<std::string, std::string> m_customOptions; // 自定义键值对配置
@@ -0,0 +1,59 @@
+#ifndef CCOPYENGINE_H
+#define CCOPYENGINE_H
+
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include "CRateLimiter.h"
+
+// 实际使用的拷贝方式
+enum class CopyMethod : uint8_t {
+    None = 0,        // 尚未拷贝或拷贝失败
+    Reflink = 1,     // 写时复制文件系统上的引用拷贝（FICLONE），不复制数据块
+    KernelCopy = 2,  // 内核态拷贝（copy_file_range / CopyFileEx）
+    Sendfile = 3,    // sendfile
+    Buffered = 4,    // 用户态缓冲区分块拷贝
+};
+
+/*
+ * @brief 文件拷贝引擎，用于非打包的镜像备份
+ * @description 按以下顺序尝试，前一种方式不可用时自动退回下一种：
+ *  1. 源与目标在同一写时复制文件系统（btrfs/XFS 等）上时使用 FICLONE 引用拷贝；
+ *  2. copy_file_range，再退回 sendfile，数据不经过用户态；
+ *  3. 固定大小的用户态缓冲区分块读写。
+ *  任何方式的内存占用都与文件大小无关。非 Linux 平台上，Windows 使用 CopyFileEx，
+ *  其他平台直接使用缓冲区拷贝。
+ */
+class CCopyEngine {
+public:
+    static constexpr size_t kDefaultChunkSize = 8 * 1024 * 1024;  // 每次内核拷贝/限速的块大小
+
+    explicit CCopyEngine(size_t chunkSize = kDefaultChunkSize);
+
+    // 拷贝文件（覆盖已存在的目标），成功返回true
+    bool copyFile(const std::string& srcPath, const std::string& destPath);
+
+    // 是否允许引用拷贝（默认允许）
+    void setReflinkEnabled(bool enabled) { m_reflinkEnabled = enabled; }
+    // 是否允许内核态拷贝（copy_file_range/sendfile/CopyFileEx，默认允许）
+    void setKernelCopyEnabled(bool enabled) { m_kernelCopyEnabled = enabled; }
+    // 设置I/O限速器，每个块拷贝前申请额度（引用拷贝不产生数据I/O，不申请）
+    void setRateLimiter(std::shared_ptr<CRateLimiter> limiter) { m_rateLimiter = std::move(limiter); }
+
+    // 最近一次拷贝最终使用的方式
+    CopyMethod getLastMethod() const { return m_lastMethod; }
+
+    static const char* methodName(CopyMethod method);
+
+private:
+    bool copyBuffered(const std::string& srcPath, const std::string& destPath);
+
+    size_t m_chunkSize;
+    bool m_reflinkEnabled = true;
+    bool m_kernelCopyEnabled = true;
+    std::shared_ptr<CRateLimiter> m_rateLimiter;
+    CopyMethod m_lastMethod = CopyMethod::None;
+};
+
+#endif // CCOPYENGINE_H
@@ -0,0 +1,25 @@
+#ifndef CCPUFEATURES_H
+#define CCPUFEATURES_H
+
+// x86-64 上可以编译 SIMD 实现；CPU_TARGET_AVX2 标记只在运行时确认支持 AVX2 后才调用的函数
+// （MSVC 无需标记即可使用 AVX2 内建函数）
+#if defined(__x86_64__) || defined(_M_X64)
+#define CPU_HAS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define CPU_TARGET_AVX2
+#else
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/*
+ * @brief 运行时 CPU 特性检测，供各 SIMD 实现选择代码路径
+ */
+class CCpuFeatures {
+public:
+    // CPU 支持 AVX2 且操作系统会保存 YMM 寄存器；结果在首次调用时缓存
+    static bool hasAvx2();
+};
+
+#endif // CCPUFEATURES_H
@@ -0,0 +1,81 @@
+#ifndef CDELTA_ENGINE_H
+#define CDELTA_ENGINE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// 单个基准块的签名：弱校验用于滚动查找，强校验确认匹配
+struct DeltaBlockSignature {
+    uint32_t weak;    // rsync 式滚动校验（a | b << 16）
+    uint64_t strong;  // XXH64
+};
+
+// 基准文件的块签名
+struct DeltaSignature {
+    uint32_t blockSize = 0;
+    uint64_t baseSize = 0;
+    int64_t baseMtime = 0;  // 基准文件的修改时间，缓存据此判断是否失效
+    std::vector<DeltaBlockSignature> blocks;
+};
+
+// 差量文件头中的信息
+struct DeltaHeader {
+    std::string baseRef;      // 基准文件的引用（快照模式下为相对于目标根目录的路径）
+    uint64_t baseSize = 0;
+    uint64_t targetSize = 0;
+    uint32_t targetCrc32 = 0;
+};
+
+// 生成差量时的统计
+struct DeltaStats {
+    uint64_t copiedBytes = 0;    // 从基准文件复用的字节数
+    uint64_t insertedBytes = 0;  // 写入差量文件的新数据字节数
+    uint64_t deltaSize = 0;      // 差量文件大小
+};
+
+/*
+ * @brief rsync 式差量编码：对基准文件按块计算弱+强校验签名，在新文件上滚动查找匹配块，
+ *  只保存 COPY（基准偏移、长度）与 INSERT（新数据）指令流；恢复时由基准文件 + 差量重建。
+ * @description 差量文件格式：
+ *   魔数 "BKDL" 版本（1字节） 基准引用长度（2字节） 基准引用 基准大小（8字节）
+ *   目标大小（8字节） 目标CRC32（4字节） 之后为指令：
+ *   - 0x01 COPY：基准偏移（8字节） 长度（8字节）
+ *   - 0x02 INSERT：长度（4字节） 数据
+ *   - 0x00 END
+ *  新文件按缓冲区流式读取，内存占用与文件大小无关（签名表除外）。
+ */
+class CDeltaEngine {
+public:
+    static constexpr const char* kDeltaExtension = ".bkdelta";
+    static constexpr const char* kSignatureExtension = ".bksig";
+
+    // 按文件大小选择块大小：约为 sqrt(size)，限制在 [2KB, 256KB] 并按 1KB 对齐
+    static uint32_t chooseBlockSize(uint64_t fileSize);
+
+    // 计算基准文件的块签名；threads 为 0 时使用全部硬件线程，各线程读取文件的不同区段
+    static bool computeSignature(const std::string& basePath, uint32_t blockSize, DeltaSignature& signature,
+                                 unsigned threads = 0);
+
+    // 读取或计算签名：cachePath 中的签名与基准文件大小、修改时间一致时直接使用，否则重新计算并写回缓存
+    static bool loadOrComputeSignature(const std::string& basePath, const std::string& cachePath,
+                                       DeltaSignature& signature, unsigned threads = 0);
+
+    static bool saveSignature(const std::string& path, const DeltaSignature& signature);
+    static bool loadSignature(const std::string& path, DeltaSignature& signature);
+
+    // 以签名为基准为 targetPath 生成差量文件
+    static bool createDelta(const std::string& targetPath, const DeltaSignature& signature,
+                            const std::string& baseRef, const std::string& deltaPath, DeltaStats* stats = nullptr);
+
+    // 由基准文件与差量文件重建目标文件，校验大小与CRC32
+    static bool applyDelta(const std::string& basePath, const std::string& deltaPath, const std::string& outPath);
+
+    static bool readDeltaHeader(const std::string& deltaPath, DeltaHeader& header);
+
+    // 滚动弱校验（供测试与签名计算共用）
+    static uint32_t weakChecksum(const uint8_t* data, size_t len);
+};
+
+#endif // CDELTA_ENGINE_H
@@ -0,0 +1,78 @@
+#ifndef CFILTER_H
+#define CFILTER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// 过滤器类型（写入过滤器链头，数值不可更改）
+enum class FilterType : uint8_t {
+    Delta = 1,    // 按步长做字节差分：数值表、音频、图像等定长记录
+    ZeroRle = 2,  // 0 字节游程编码：零填充的页、稀疏表
+    X86 = 3,      // x86 CALL/JMP（E8/E9）的相对地址转为绝对地址：可执行文件
+};
+
+// 链中的一个过滤器；Delta 的 param 为步长（1~255），其余为 0
+struct FilterSpec {
+    FilterType type;
+    uint8_t param = 0;
+};
+
+// 流式过滤器：输入可以分成任意多段依次送入，输出追加到 out 末尾
+class IFilterStream {
+public:
+    virtual ~IFilterStream() = default;
+    virtual void update(const uint8_t* data, size_t len, std::vector<uint8_t>& out) = 0;
+    // 输出剩余的数据；解码时输入不完整或已损坏返回 false
+    virtual bool finish(std::vector<uint8_t>& out) = 0;
+};
+
+/*
+ * @brief 熵编码之前的可逆预处理：若干过滤器串成一条链，按顺序正向变换，解码时逆序还原
+ * @description 熵编码只看单字节的频率，数值表的相邻记录、零填充的页、可执行文件中指向同一函数
+ *  却各不相同的相对地址都无法被利用。过滤器把这些规律转成重复字节或更集中的分布：
+ *  - Delta：out[i] = in[i] - in[i - 步长]，还原时按步长做前缀和（步长为 1/2/4/8 及 16 以上时按 16 字节并行）；
+ *  - ZeroRle：连续 4 个 0 之后跟一个变长整数表示再重复的 0 的个数，较短的 0 原样保留；
+ *  - X86：E8/E9 之后高字节为 00/FF 的 32 位相对地址加上指令位置，调用同一函数的指令得到相同的字节。
+ *  各过滤器都是流式的，链按 kChunkSize 分段在各过滤器之间传递，中间数据留在缓存中。
+ *  用 SSE2 跳过不含 0 / 不含 E8、E9 的 16 字节段。
+ *  链头格式：过滤器数（1字节） 之后每个过滤器 类型（1字节） 参数（1字节）
+ */
+class CFilterChain {
+public:
+    static constexpr size_t kChunkSize = 64 * 1024;
+    static constexpr size_t kMaxFilters = 4;
+
+    CFilterChain() = default;
+    explicit CFilterChain(std::vector<FilterSpec> filters) : m_filters(std::move(filters)) {}
+
+    // 解析 "delta:4,zrle,x86" 形式的描述（delta 不写步长时为1）；空字符串表示不过滤
+    static bool parse(const std::string& text, CFilterChain& chain);
+    std::string toString() const;
+
+    // 按数据内容选择过滤器：可执行文件头 -> X86；差分后字节熵明显下降 -> Delta；长串的 0 -> ZeroRle
+    static CFilterChain detect(const uint8_t* data, size_t len);
+
+    bool empty() const { return m_filters.empty(); }
+    const std::vector<FilterSpec>& getFilters() const { return m_filters; }
+
+    // 正向变换（压缩前），结果追加到 out 末尾
+    void encode(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const;
+    // 逆变换（解压后），数据损坏时返回 false
+    bool decode(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const;
+
+    void writeHeader(std::vector<char>& out) const;
+    // 读取 src 开头的链头，consumed 返回链头的字节数
+    static bool readHeader(const uint8_t* src, size_t len, CFilterChain& chain, size_t& consumed);
+
+    // 单个过滤器的流式编码器、解码器；参数无效时返回空指针
+    static std::unique_ptr<IFilterStream> createEncoder(const FilterSpec& spec);
+    static std::unique_ptr<IFilterStream> createDecoder(const FilterSpec& spec);
+
+private:
+    std::vector<FilterSpec> m_filters;
+};
+
+#endif // CFILTER_H
@@ -0,0 +1,90 @@
+#ifndef CHASH_H
+#define CHASH_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * @brief XXH64 非加密哈希，用于快速判断内容是否相同（去重等）
+ * @description 与 xxHash 参考实现的 XXH64 输出一致。支持一次性计算与分段流式计算。
+ */
+class CXXHash64 {
+public:
+    explicit CXXHash64(uint64_t seed = 0);
+
+    // 重新开始计算
+    void reset(uint64_t seed = 0);
+    // 追加数据
+    void update(const void* data, size_t len);
+    // 得到当前已追加数据的哈希值（不影响继续追加）
+    uint64_t digest() const;
+
+    // 一次性计算
+    static uint64_t hash(const void* data, size_t len, uint64_t seed = 0);
+    static uint64_t hash(const std::vector<char>& data, uint64_t seed = 0) {
+        return hash(data.data(), data.size(), seed);
+    }
+
+    // 计算文件内容的哈希，读取失败时返回false
+    static bool hashFile(const std::string& path, uint64_t& result, uint64_t seed = 0);
+
+private:
+    uint64_t m_seed;
+    uint64_t m_acc[4];
+    uint8_t m_buffer[32];
+    size_t m_bufferSize;
+    uint64_t m_totalLen;
+};
+
+// 128 位哈希值
+struct Hash128 {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const Hash128& other) const { return !(*this == other); }
+    bool operator<(const Hash128& other) const {
+        return high != other.high ? high < other.high : low < other.low;
+    }
+    // 32 位十六进制，高 64 位在前（与 xxhsum -H2 的输出一致）
+    std::string toHex() const;
+};
+
+/*
+ * @brief XXH3-128 非加密哈希，用于包内逐条目的内容校验与去重
+ * @description 与 xxHash 参考实现的 XXH3_128bits（种子为 0、默认密钥）输出一致。
+ *  长输入每 64 字节一个条带，由 8 路 64 位累加器处理，x64 上用 SSE2 每次处理两路；
+ *  速度为 XXH64 的数倍，128 位输出使不同内容碰撞的概率可以忽略。支持一次性计算与分段流式计算。
+ */
+class CXXHash128 {
+public:
+    CXXHash128();
+
+    // 重新开始计算
+    void reset();
+    // 追加数据
+    void update(const void* data, size_t len);
+    // 得到当前已追加数据的哈希值（不影响继续追加）
+    Hash128 digest() const;
+
+    // 一次性计算
+    static Hash128 hash(const void* data, size_t len);
+    static Hash128 hash(const std::vector<char>& data) {
+        return hash(data.data(), data.size());
+    }
+
+    // 计算文件内容的哈希，读取失败时返回false
+    static bool hashFile(const std::string& path, Hash128& result);
+
+private:
+    alignas(16) uint64_t m_acc[8];
+    uint8_t m_buffer[256];       // 尚未处理的数据；总长不超过 256 时保存全部输入
+    uint8_t m_lastStripe[64];    // 最近处理的 64 字节，缓冲区不足一个条带时用于拼出最后一个条带
+    size_t m_bufferSize;
+    size_t m_stripesInBlock;     // 当前块内已处理的条带数
+    uint64_t m_totalLen;
+};
+
+#endif // CHASH_H
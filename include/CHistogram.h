@@ -0,0 +1,39 @@
+#ifndef CHISTOGRAM_H
+#define CHISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+enum class HistogramKernel {
+    Scalar,    // 4 张交错的 32 位子表
+    Avx2Runs,  // 同 Scalar，另用 AVX2 每 32 字节比较一次，整段为同一字节时一次计入；计数本身不是向量化的
+};
+
+/*
+ * @brief 字节频率统计，供 Huffman、FSE、熵采样与按条目选择编码器共用
+ * @description 连续相同的字节若都累加到同一个计数器，每次自增都要等上一次的写回，
+ *  日志与数据库页中的长串重复字节因此会退化为每字节一次存储转发延迟。
+ *  这里把相邻字节分散到 4 张子表，最后再合并。支持 AVX2 的 CPU 上额外走长串快速路径：
+ *  先用一次向量比较判断 32 字节是否为同一字节，是则直接加 32，否则仍按标量逐字节计数，
+ *  因此只对零页、填充等长串有收益。运行时检测 CPU 选择实现。
+ */
+class CHistogram {
+public:
+    using Counts = std::array<uint64_t, 256>;
+
+    // 统计 data 中各字节的出现次数，累加到 counts
+    static void count(const uint8_t* data, size_t len, Counts& counts);
+    static void count(const char* data, size_t len, Counts& counts) {
+        count(reinterpret_cast<const uint8_t*>(data), len, counts);
+    }
+
+    // 使用指定实现统计；CPU 不支持该实现时返回 false 且不修改 counts
+    static bool countWith(HistogramKernel kernel, const uint8_t* data, size_t len, Counts& counts);
+
+    // 当前 CPU 上 count() 使用的实现
+    static HistogramKernel activeKernel();
+    static const char* kernelName(HistogramKernel kernel);
+};
+
+#endif // CHISTOGRAM_H
@@ -0,0 +1,114 @@
+#ifndef CLOGGER_H
+#define CLOGGER_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <cstdint>
+
+// 日志级别
+enum class LogLevel : uint8_t {
+    Debug = 0,    // 逐文件的诊断信息（默认关闭）
+    Info = 1,     // 常规进度信息
+    Warning = 2,  // 警告
+    Error = 3,    // 错误
+    Off = 4,      // 关闭所有输出
+};
+
+/*
+ * @brief 分级异步日志（全局单例）
+ * @description 调用方只把消息放入固定容量的环形缓冲区，由后台线程批量写出，
+ *  写出时每批只刷新一次输出流，不会在数据处理路径上等待控制台。
+ *  缓冲区满时丢弃新的 Debug/Info 消息并计数，下一批写出时报告丢弃的条数；
+ *  Warning/Error 从不丢弃，缓冲区满时等待后台线程取走当前消息。
+ *  Info/Debug 写到 std::cout，Warning/Error 写到 std::cerr。
+ *  请使用 LOG_DEBUG/LOG_INFO/LOG_WARN/LOG_ERROR 宏，级别未启用时不会格式化消息。
+ */
+class CLogger {
+public:
+    // 输出函数（默认写到标准输出/标准错误）
+    using Sink = std::function<void(LogLevel, const std::string&)>;
+
+    static constexpr size_t kDefaultCapacity = 8192;
+
+    static CLogger& instance();
+
+    // 设置/获取最低输出级别（默认 Info）
+    void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return m_level.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= getLevel() && level != LogLevel::Off; }
+
+    // 放入一条消息；缓冲区满时丢弃 Debug/Info，Warning/Error 等待到有空间为止
+    void log(LogLevel level, std::string message);
+
+    // 等待此前放入的消息全部写出（交互式提示前、测试中使用）
+    void flush();
+
+    // 替换输出函数，传入空函数恢复默认输出
+    void setSink(Sink sink);
+
+    // 累计丢弃的消息条数
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    static const char* levelName(LogLevel level);
+
+    CLogger(const CLogger&) = delete;
+    CLogger& operator=(const CLogger&) = delete;
+
+private:
+    struct Entry {
+        LogLevel level = LogLevel::Info;
+        std::string message;
+    };
+
+    explicit CLogger(size_t capacity = kDefaultCapacity);
+    ~CLogger();
+
+    // 后台线程入口
+    void run();
+    // 写出一批消息
+    void write(std::vector<Entry>& batch, uint64_t dropped);
+
+    std::atomic<LogLevel> m_level{LogLevel::Info};
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;          // 通知后台线程有新消息
+    std::condition_variable m_flushedCv;   // 通知 flush 调用方已写出
+    std::condition_variable m_spaceCv;     // 通知等待空间的 Warning/Error 调用方
+    std::vector<Entry> m_ring;             // 环形缓冲区
+    size_t m_head = 0;                     // 下一条待写出消息的位置
+    size_t m_size = 0;                     // 缓冲区中的消息数
+    uint64_t m_enqueued = 0;               // 累计放入的消息数
+    uint64_t m_written = 0;                // 累计写出的消息数
+    uint64_t m_reportedDropped = 0;        // 已报告的丢弃条数
+    bool m_stop = false;
+
+    std::mutex m_sinkMutex;
+    Sink m_sink;
+
+    std::thread m_worker;
+};
+
+// 仅在级别启用时才格式化消息，用法：LOG_INFO("Packing " << count << " files");
+#define LOG_AT(level, expr) \
+    do { \
+        CLogger& logger_ = CLogger::instance(); \
+        if (logger_.isEnabled(level)) { \
+            std::ostringstream logStream_; \
+            logStream_ << expr; \
+            logger_.log(level, logStream_.str()); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(expr) LOG_AT(LogLevel::Debug, expr)
+#define LOG_INFO(expr) LOG_AT(LogLevel::Info, expr)
+#define LOG_WARN(expr) LOG_AT(LogLevel::Warning, expr)
+#define LOG_ERROR(expr) LOG_AT(LogLevel::Error, expr)
+
+#endif // CLOGGER_H
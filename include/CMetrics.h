@@ -0,0 +1,156 @@
+#ifndef CMETRICS_H
+#define CMETRICS_H
+
+#include <string>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 备份流水线的各个阶段
+enum class Stage : uint8_t {
+    Walk = 0,        // 遍历源目录
+    Read = 1,        // 读取源文件
+    Pack = 2,        // 打包（包含其中的读写）
+    Compress = 3,    // 压缩
+    Encrypt = 4,     // 加密
+    Write = 5,       // 写出（镜像拷贝、包内容写入）
+    Unpack = 6,      // 解包
+    Decompress = 7,  // 解压
+    Decrypt = 8,     // 解密
+    Verify = 9,      // 校验（不写出文件）
+    Parity = 10,     // 生成或检查纠删码校验文件
+    Count = 11,
+};
+
+/*
+ * @brief 轻量级性能统计：各阶段耗时/字节数/文件数计数，以及单文件耗时直方图
+ * @description 所有计数均为原子变量，任务执行过程中可随时读取（实时查询），
+ *  任务结束后通过 toJson 输出结构化报告。
+ *  各组件通过线程局部的“当前统计对象”上报数据（见 Bind），未绑定或未启用时
+ *  CStageTimer 只做一次指针判断，不读取时钟，开销可以忽略。
+ *  阶段耗时为包含关系：例如 Pack 的耗时包含了其中 Read/Write 的耗时。
+ */
+class CMetrics {
+public:
+    static constexpr size_t kStageCount = static_cast<size_t>(Stage::Count);
+    // 单文件耗时直方图：第 i 个桶统计耗时在 [2^i, 2^(i+1)) 微秒内的文件数
+    static constexpr size_t kHistogramBuckets = 32;
+
+    // 某个阶段的统计快照
+    struct StageSnapshot {
+        uint64_t nanos = 0;   // 累计耗时（纳秒）
+        uint64_t bytes = 0;   // 累计字节数
+        uint64_t files = 0;   // 累计文件数
+        uint64_t calls = 0;   // 计时次数
+    };
+
+    CMetrics() { reset(); }
+
+    CMetrics(const CMetrics&) = delete;
+    CMetrics& operator=(const CMetrics&) = delete;
+
+    // 启用/禁用统计
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // 上报数据
+    void addTime(Stage stage, uint64_t nanos);
+    void addBytes(Stage stage, uint64_t bytes);
+    void addFiles(Stage stage, uint64_t files = 1);
+    void recordFileLatency(uint64_t nanos);
+
+    // 清空所有计数
+    void reset();
+
+    // 读取统计（任务执行中也可调用）
+    StageSnapshot getStage(Stage stage) const;
+    std::array<uint64_t, kHistogramBuckets> getLatencyHistogram() const;
+    double getElapsedSeconds() const;
+
+    // 生成JSON格式的报告
+    std::string toJson() const;
+
+    // 阶段名称
+    static const char* stageName(Stage stage);
+
+    // 获取当前线程绑定的统计对象（未绑定或未启用时返回nullptr）
+    static CMetrics* current();
+
+    // RAII：在当前线程上绑定统计对象，析构时恢复之前的绑定
+    class Bind {
+    public:
+        explicit Bind(CMetrics* metrics);
+        ~Bind();
+        Bind(const Bind&) = delete;
+        Bind& operator=(const Bind&) = delete;
+    private:
+        CMetrics* m_previous;
+    };
+
+private:
+    struct StageCounters {
+        std::atomic<uint64_t> nanos;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> files;
+        std::atomic<uint64_t> calls;
+    };
+
+    std::atomic<bool> m_enabled{true};
+    std::array<StageCounters, kStageCount> m_stages;
+    std::array<std::atomic<uint64_t>, kHistogramBuckets> m_latency;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+/*
+ * @brief 作用域计时器：构造时开始计时，析构时把耗时计入对应阶段
+ * @note 未绑定统计对象时不读取时钟
+ */
+class CStageTimer {
+public:
+    explicit CStageTimer(Stage stage, CMetrics* metrics = CMetrics::current())
+        : m_stage(stage), m_metrics(metrics) {
+        if (m_metrics) m_start = std::chrono::steady_clock::now();
+    }
+    ~CStageTimer() {
+        if (m_metrics) {
+            m_metrics->addTime(m_stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count()));
+        }
+    }
+    CStageTimer(const CStageTimer&) = delete;
+    CStageTimer& operator=(const CStageTimer&) = delete;
+
+    // 计入本阶段处理的字节数/文件数
+    void addBytes(uint64_t bytes) { if (m_metrics) m_metrics->addBytes(m_stage, bytes); }
+    void addFiles(uint64_t files = 1) { if (m_metrics) m_metrics->addFiles(m_stage, files); }
+
+private:
+    Stage m_stage;
+    CMetrics* m_metrics;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/*
+ * @brief 单文件耗时计时器：析构时把耗时计入直方图
+ */
+class CFileLatencyTimer {
+public:
+    explicit CFileLatencyTimer(CMetrics* metrics = CMetrics::current()) : m_metrics(metrics) {
+        if (m_metrics) m_start = std::chrono::steady_clock::now();
+    }
+    ~CFileLatencyTimer() {
+        if (m_metrics) {
+            m_metrics->recordFileLatency(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count()));
+        }
+    }
+    CFileLatencyTimer(const CFileLatencyTimer&) = delete;
+    CFileLatencyTimer& operator=(const CFileLatencyTimer&) = delete;
+
+private:
+    CMetrics* m_metrics;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // CMETRICS_H
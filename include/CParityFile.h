@@ -0,0 +1,49 @@
+#ifndef CPARITYFILE_H
+#define CPARITYFILE_H
+
+#include <cstdint>
+#include <string>
+
+// 检查或修复的结果
+struct ParityReport {
+    uint64_t stripes = 0;               // 条带数
+    uint64_t damagedShards = 0;         // 哈希不符的分片（含校验文件中的校验分片）
+    uint64_t repairedShards = 0;        // 已重建并写回的分片
+    uint64_t unrecoverableStripes = 0;  // 损坏分片多于校验分片数、无法修复的条带
+};
+
+/*
+ * @brief 归档文件旁的 Reed-Solomon 校验文件（归档路径 + .bkpar），用于修复长期存放中的位翻转与坏扇区
+ * @description 归档按 shardSize 切成数据分片，每 dataShards 个为一个条带（最后一个条带不足部分按 0 补齐），
+ *  每个条带生成 parityShards 个校验分片；条带内任意 parityShards 个分片损坏都可以重建。
+ *  每个分片（含校验分片）记录 XXH3-128，据此定位损坏的分片。校验文件格式：
+ *   魔数 "BKPR" 版本（1字节） 数据分片数（1字节） 校验分片数（1字节） 分片大小（4字节） 归档大小（8字节）
+ *   分片哈希表：逐条带，先数据分片后校验分片，每个 16 字节（低 64 位在前）
+ *   以上内容的 XXH3-128（16字节）
+ *   逐条带的校验分片
+ *  头或哈希表本身损坏时校验文件不可用。归档大小与记录不符（被截断或追加）时按记录的大小修复。
+ */
+class CParityFile {
+public:
+    static constexpr const char* kParityExtension = ".bkpar";
+
+    static std::string parityPath(const std::string& archivePath) { return archivePath + kParityExtension; }
+
+    // 按归档大小选择分片大小：约为 archiveSize / dataShards，按 64 字节对齐，限制在 [64B, 64KB]
+    static uint32_t chooseShardSize(uint64_t archiveSize, unsigned dataShards);
+
+    // 为归档生成校验文件，返回校验文件路径；失败时返回空字符串且不留下校验文件
+    static std::string create(const std::string& archivePath, unsigned dataShards, unsigned parityShards);
+
+    // 只检查不修改：归档与校验分片全部完好时返回 true
+    static bool check(const std::string& archivePath, ParityReport& report);
+
+    // 检查并就地重建归档与校验文件中损坏的分片：最终全部完好时返回 true；
+    // 校验文件不存在或不可用、或有条带无法修复时返回 false
+    static bool repair(const std::string& archivePath, ParityReport* report = nullptr);
+
+private:
+    static bool scan(const std::string& archivePath, ParityReport& report, bool writeBack);
+};
+
+#endif // CPARITYFILE_H
@@ -0,0 +1,40 @@
+#ifndef CRATELIMITER_H
+#define CRATELIMITER_H
+
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+/*
+ * @brief 令牌桶限速器，用于限制备份任务的I/O带宽
+ * @description 每秒补充 bytesPerSec 个令牌，桶容量为一秒的额度；
+ *  acquire 会在令牌不足时睡眠等待。可以指定父限速器（全局限速），
+ *  此时一次申请需要同时满足自身与父限速器的额度。
+ *  bytesPerSec 为0表示不限速（仍然会转发给父限速器）。
+ */
+class CRateLimiter {
+public:
+    explicit CRateLimiter(uint64_t bytesPerSec, std::shared_ptr<CRateLimiter> parent = nullptr);
+
+    // 申请 bytes 字节的额度，额度不足时阻塞
+    void acquire(uint64_t bytes);
+
+    // 获取限速值（字节/秒，0为不限速）
+    uint64_t getRate() const { return m_bytesPerSec; }
+
+    // 获取累计通过的字节数
+    uint64_t getTotalBytes() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t m_bytesPerSec;                  // 限速值
+    std::shared_ptr<CRateLimiter> m_parent;  // 父限速器（全局）
+    mutable std::mutex m_mutex;
+    double m_tokens;                         // 当前令牌数
+    Clock::time_point m_lastRefill;          // 上次补充令牌的时间
+    uint64_t m_totalBytes = 0;               // 累计字节数
+};
+
+#endif // CRATELIMITER_H
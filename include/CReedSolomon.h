@@ -0,0 +1,60 @@
+#ifndef CREEDSOLOMON_H
+#define CREEDSOLOMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class GaloisKernel {
+    Scalar,  // 256x256 乘法表逐字节查表
+    Avx2,    // 按高低 4 位拆成两张 16 项表，每次 32 字节用 vpshufb 查表
+};
+
+/*
+ * @brief GF(2^8) 上的系统 Reed-Solomon 纠删码：dataShards 个数据分片生成 parityShards 个校验分片，
+ *  任意 parityShards 个分片损坏（已知位置）都可由其余分片重建
+ * @description 生成多项式 x^8+x^4+x^3+x^2+1（0x11D）。校验矩阵为 Cauchy 矩阵
+ *  a[r][c] = 1 / ((dataShards + r) ^ c)，其任意方阵子矩阵可逆，因此单位矩阵与它上下拼接后
+ *  任取 dataShards 行都可逆。编码与重建的主循环都是 dst ^= c * src（mulAdd），
+ *  支持 AVX2 的 CPU 上每次处理 32 字节。运行时检测 CPU 选择实现。
+ */
+class CReedSolomon {
+public:
+    static constexpr unsigned kMaxShards = 255;
+
+    // 分片数不合法（为 0 或总数超过 kMaxShards）时抛出 std::invalid_argument
+    CReedSolomon(unsigned dataShards, unsigned parityShards);
+
+    unsigned getDataShards() const { return m_dataShards; }
+    unsigned getParityShards() const { return m_parityShards; }
+
+    // 由 data 中的 dataShards 个分片计算 parity 中的 parityShards 个分片，每个分片 len 字节
+    void encode(const uint8_t* const* data, uint8_t* const* parity, size_t len) const;
+
+    // shards 依次为数据分片与校验分片，present[i] 标记第 i 个分片是否完好；
+    // 重建全部缺失的分片。完好的分片少于 dataShards 个时返回 false，不修改任何分片
+    bool reconstruct(uint8_t* const* shards, const std::vector<bool>& present, size_t len) const;
+
+    // GF(2^8) 运算
+    static uint8_t mul(uint8_t a, uint8_t b);
+    static uint8_t inverse(uint8_t a);  // a 不能为 0
+
+    // dst[i] ^= c * src[i]
+    static void mulAdd(uint8_t c, const uint8_t* src, uint8_t* dst, size_t len);
+    // 使用指定实现计算；CPU 不支持该实现时返回 false 且不修改 dst
+    static bool mulAddWith(GaloisKernel kernel, uint8_t c, const uint8_t* src, uint8_t* dst, size_t len);
+
+    // 当前 CPU 上 mulAdd() 使用的实现
+    static GaloisKernel activeKernel();
+    static const char* kernelName(GaloisKernel kernel);
+
+private:
+    // 编码矩阵的第 row 行：row < dataShards 时为单位行，否则为校验矩阵的第 row - dataShards 行
+    std::vector<uint8_t> matrixRow(unsigned row) const;
+
+    unsigned m_dataShards;
+    unsigned m_parityShards;
+    std::vector<uint8_t> m_parityMatrix;  // parityShards 行 x dataShards 列
+};
+
+#endif // CREEDSOLOMON_H
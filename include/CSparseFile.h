@@ -0,0 +1,44 @@
+#ifndef CSPARSEFILE_H
+#define CSPARSEFILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 文件中的一段数据区间（区间之外为空洞，读出为0）
+struct FileExtent {
+    uint64_t offset;
+    uint64_t length;
+
+    bool operator==(const FileExtent& other) const {
+        return offset == other.offset && length == other.length;
+    }
+};
+
+/*
+ * @brief 稀疏文件工具：探测文件中的数据区间，以及按区间写回并保留空洞
+ * @description 优先使用 SEEK_DATA/SEEK_HOLE 向文件系统查询空洞；文件系统不支持
+ *  （把整个文件报告为一个数据区间）但实际占用的磁盘块少于文件长度时，退回按块扫描全零块。
+ *  非 Linux 平台上不做探测，整个文件视为一个数据区间。
+ */
+class CSparseFile {
+public:
+    static constexpr uint64_t kBlockSize = 4096;  // 全零块扫描的粒度
+
+    // 返回文件的数据区间（按偏移升序且互不相邻）；size 为文件长度，失败时返回覆盖整个文件的单个区间
+    static std::vector<FileExtent> mapDataExtents(const std::string& path, uint64_t size);
+
+    // 按块扫描全零块得到的数据区间（不依赖文件系统支持）
+    static std::vector<FileExtent> scanZeroBlocks(const std::string& path, uint64_t size);
+
+    // 区间是否覆盖了整个文件（即文件不含空洞）
+    static bool isDense(const std::vector<FileExtent>& extents, uint64_t size);
+
+    // 区间的数据总长度
+    static uint64_t dataLength(const std::vector<FileExtent>& extents);
+
+    // 将文件长度设置为 size，超出已写入部分的内容成为空洞
+    static bool setLength(const std::string& path, uint64_t size);
+};
+
+#endif // CSPARSEFILE_H
@@ -0,0 +1,80 @@
+#ifndef CSTREAMPIPE_H
+#define CSTREAMPIPE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+/*
+ * @brief 有界的内存管道：一个线程向 writer() 写入，另一个线程从 reader() 读出
+ * @description 写入的数据攒满 chunkSize 字节（或写端结束）后作为一块交给读端，最多缓存 maxChunks 块，
+ *  缓存满时写端等待，因此内存占用与经过的数据量无关。用于把按流处理的各阶段（解密、解压、校验）
+ *  串成流水线而不落地中间文件。
+ *  写端结束后调用 closeWrite，读端读完剩余数据后遇到文件尾；读端提前放弃时调用 closeRead，
+ *  之后的写入失败（写端流进入错误状态），写端不会因缓存满而一直等待。
+ */
+class CStreamPipe {
+public:
+    explicit CStreamPipe(size_t chunkSize = 1024 * 1024, size_t maxChunks = 4);
+    CStreamPipe(const CStreamPipe&) = delete;
+    CStreamPipe& operator=(const CStreamPipe&) = delete;
+
+    std::ostream& writer() { return m_writer; }
+    std::istream& reader() { return m_reader; }
+
+    // 写端结束：交出尚未满一块的数据
+    void closeWrite();
+    // 读端放弃：丢弃未读的数据
+    void closeRead();
+
+    // 读端：不消耗数据地复制开头最多 len 字节（等待第一块到达），返回复制的字节数
+    size_t peek(char* dest, size_t len);
+
+private:
+    class WriteBuffer : public std::streambuf {
+    public:
+        WriteBuffer(CStreamPipe& pipe, size_t chunkSize);
+    protected:
+        int_type overflow(int_type ch) override;
+        int sync() override;
+    private:
+        friend class CStreamPipe;
+        bool flushChunk();
+        CStreamPipe& m_pipe;
+        std::vector<char> m_chunk;
+    };
+
+    class ReadBuffer : public std::streambuf {
+    public:
+        explicit ReadBuffer(CStreamPipe& pipe) : m_pipe(pipe) {}
+        size_t peek(char* dest, size_t len);
+    protected:
+        int_type underflow() override;
+    private:
+        CStreamPipe& m_pipe;
+        std::vector<char> m_chunk;
+    };
+
+    // 交出一块；读端已放弃时返回 false
+    bool push(std::vector<char>& chunk);
+    // 取出下一块；写端已结束且没有剩余数据时返回 false
+    bool pop(std::vector<char>& chunk);
+
+    size_t m_maxChunks;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<std::vector<char>> m_chunks;
+    bool m_writeClosed = false;
+    bool m_readClosed = false;
+    WriteBuffer m_writeBuffer;
+    ReadBuffer m_readBuffer;
+    std::ostream m_writer;
+    std::istream m_reader;
+};
+
+#endif // CSTREAMPIPE_H
@@ -8,6 +8,11 @@
 #include <algorithm>
 #include "ICompress.h"  // 依赖ICompress抽象类
 #include "HuffmanCompress.h"
+#include "FSECompress.h"
+#include "Huffman4XCompress.h"
+#include "BWTCompress.h"
+#include "LongRangeCompress.h"
+#include "DictCompress.h"
 
 // 压缩工厂类：负责责创建不同类型的压缩器实例
 class CompressFactory {
@@ -0,0 +1,105 @@
+#ifndef DICT_COMPRESS_H
+#define DICT_COMPRESS_H
+
+#include "ICompress.h"
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * @brief 为小文件训练的共享字典：一段常见内容 + 各类符号的静态 Huffman 码表
+ * @description 小文件单独压缩时，LZ 匹配找不到可以引用的历史，每个文件还要各自存放码表，
+ *  压缩率很差。字典从一批样本中训练得到，在包内只存放一份：
+ *  - 内容：多个样本中反复出现的片段（简化的 COVER 算法：统计 8 字节片段出现在多少个样本中，
+ *    每个区间选出得分最高的一段），作为每个文件之前的预置历史，最常用的片段放在末尾（距离最近）；
+ *  - 码表：用字典对样本做一遍 LZ 解析，统计字面量、字面量长度、匹配长度、匹配距离的分布，
+ *    得到限长的范式 Huffman 码长，压缩时不再为每个文件存放码表。
+ *  字典构造后只读，可以被多个线程同时使用。
+ *  序列化格式：魔数 "BKDC" 版本（1字节） 内容长度（4字节） 内容 各码表的码长（每个符号4位）
+ */
+class CDictionary {
+public:
+    static constexpr size_t kDefaultMaxSize = 64 * 1024;
+    static constexpr unsigned kLiteralCodes = 256;
+    static constexpr unsigned kLengthCodes = 44;   // 字面量长度与匹配长度：0~15 直接表示，之后按 2 的幂分段
+    static constexpr unsigned kOffsetCodes = 32;   // 匹配距离按 2 的幂分段
+    static constexpr unsigned kMaxCodeLen = 11;
+
+    enum Table { Literal = 0, LiteralLength = 1, MatchLength = 2, Offset = 3, TableCount = 4 };
+
+    // 一个码表：编码用码字与码长，解码用 2^tableLog 项的查表（符号 << 4 | 码长）
+    struct SymbolTable {
+        std::array<uint8_t, 256> lengths{};
+        std::array<uint16_t, 256> codes{};
+        unsigned tableLog = 0;
+        std::vector<uint16_t> decode;
+    };
+
+    // 从样本训练字典，内容不超过 maxSize 字节；没有样本时返回空指针
+    static std::shared_ptr<const CDictionary> train(const std::vector<std::vector<char>>& samples,
+                                                    size_t maxSize = kDefaultMaxSize);
+
+    // 从序列化数据恢复，数据损坏时返回空指针
+    static std::shared_ptr<const CDictionary> deserialize(const char* data, size_t len);
+    void serialize(std::vector<char>& out) const;
+
+    // 字典标识（内容与码长的哈希），压缩数据中记录它，解压时确认使用的是同一个字典
+    uint32_t getId() const { return m_id; }
+    const std::vector<uint8_t>& getContent() const { return m_content; }
+    const SymbolTable& getTable(Table table) const { return m_tables[table]; }
+
+    // 字典内容的 4 字节哈希链（预先建好，压缩时只读）
+    static constexpr unsigned kHashLog = 15;
+    const std::vector<uint32_t>& getHashHead() const { return m_hashHead; }
+    const std::vector<uint32_t>& getHashChain() const { return m_hashChain; }
+
+private:
+    CDictionary() = default;
+    // 由码长生成码字、解码表、哈希链与标识；码长无效时返回 false
+    bool finalize();
+
+    std::vector<uint8_t> m_content;
+    std::array<SymbolTable, TableCount> m_tables;
+    std::vector<uint32_t> m_hashHead;   // 哈希 -> 位置 + 1（0 表示空）
+    std::vector<uint32_t> m_hashChain;  // 位置 -> 同一哈希的前一个位置 + 1
+    uint32_t m_id = 0;
+
+    friend class DictCompress;
+};
+
+/*
+ * @brief 以训练字典为前缀的 LZ + 静态 Huffman 压缩器，用于包内的小文件
+ * @description 每个文件独立压缩（匹配可以引用字典内容），因此可以按任意顺序、并行地压缩和解压。
+ *  数据格式：模式（1字节，0=原样，1=字典编码） 字典标识（4字节） 原始长度（变长整数）
+ *   字典编码时再有 序列数（变长整数） 比特流；比特流中每个序列依次为
+ *   字面量长度码、字面量、匹配长度码、距离码（各自带附加位），序列之后是剩余的字面量。
+ *  没有设置字典时无法压缩（compressData 返回 false，包内该块原样存放）。
+ */
+class DictCompress : public ICompress {
+public:
+    static constexpr size_t kMinMatch = 4;
+    static constexpr unsigned kSearchDepth = 16;  // 每个位置在文件内、字典内各最多比较的候选数
+
+    DictCompress() = default;
+    explicit DictCompress(std::shared_ptr<const CDictionary> dictionary) : m_dictionary(std::move(dictionary)) {}
+
+    CompressType getCompressType() const override { return CompressType::Dictionary; }
+    std::string getCompressTypeName() const override { return "Dictionary"; }
+    // 整个文件读入内存压缩，输出到 sourcePath + ".dict"；解压需要同一个字典
+    std::string compressFile(const std::string& sourcePath) override;
+    bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    bool decompressStream(std::istream& in, std::ostream& out, const std::string& sourceName) override;
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    void setDictionary(std::shared_ptr<const CDictionary> dictionary) { m_dictionary = std::move(dictionary); }
+    const std::shared_ptr<const CDictionary>& getDictionary() const { return m_dictionary; }
+
+private:
+    std::shared_ptr<const CDictionary> m_dictionary;
+};
+
+#endif // DICT_COMPRESS_H
@@ -0,0 +1,65 @@
+#ifndef FSE_COMPRESS_H
+#define FSE_COMPRESS_H
+
+#include "CBlockCompress.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * @brief 表驱动的非对称数字系统（tANS/FSE）熵编码核心，按块编码
+ * @description 每块独立统计频率并归一化到 2^tableLog，编码与解码都只查表、移位，
+ *  没有逐位遍历树。使用 4 个交错的状态轮流编码相邻符号，解码时 4 条依赖链互不等待。
+ *  块格式：模式（1字节） 原始长度（4字节） 之后按模式不同：
+ *   - Raw：原始数据；
+ *   - Rle：重复的单个字节；
+ *   - Fse：tableLog（1字节） 最大符号（1字节） 归一化频率（变长整数）* (最大符号+1)
+ *          比特流长度（4字节） 比特流（逆序读取，末尾字节最高的1位为结束标记）。
+ *  编码结果不比原始数据小时自动存为 Raw。LZ 类编码器可以直接用它编码字面量或长度序列。
+ */
+class FseCodec {
+public:
+    static constexpr unsigned kMaxTableLog = 11;  // 最大 2048 个状态，解码表可以放进 L1 缓存
+    static constexpr unsigned kMinTableLog = 5;
+    static constexpr unsigned kStates = 4;        // 交错的状态数
+
+    enum class BlockMode : uint8_t {
+        Raw = 0,
+        Rle = 1,
+        Fse = 2,
+    };
+
+    // 编码一块数据，追加到 out 末尾（块长度须小于 4GB）
+    static void compressBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out);
+
+    // 解码 src 开头的一块数据，追加到 out 末尾；consumed 返回该块占用的字节数。
+    // maxLen 为原始长度的上限（容器的分块大小），块头记录的长度超出时视为损坏，不分配内存
+    static bool decompressBlock(const uint8_t* src, size_t srcLen, size_t maxLen, std::vector<uint8_t>& out,
+                                size_t& consumed);
+};
+
+/*
+ * @brief FSE 压缩器：文件头之后是若干 FseCodec 块
+ */
+class FSECompress : public CBlockCompress {
+public:
+    static constexpr size_t kBlockSize = 128 * 1024;  // 分块大小，块越小频率表越贴近局部分布
+
+    FSECompress() : CBlockCompress(kBlockSize) {}
+
+    CompressType getCompressType() const override { return CompressType::FSE; }
+    std::string getCompressTypeName() const override { return "FSE"; }
+
+protected:
+    void encodeBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const override {
+        FseCodec::compressBlock(src, len, out);
+    }
+    bool decodeBlock(const uint8_t* src, size_t srcLen, size_t blockSize, std::vector<uint8_t>& out,
+                     size_t& consumed) const override {
+        return FseCodec::decompressBlock(src, srcLen, blockSize, out, consumed);
+    }
+    std::string getFileExtension() const override { return ".fse"; }
+};
+
+#endif // FSE_COMPRESS_H
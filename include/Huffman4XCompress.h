@@ -0,0 +1,72 @@
+#ifndef HUFFMAN4X_COMPRESS_H
+#define HUFFMAN4X_COMPRESS_H
+
+#include "CBlockCompress.h"
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * @brief 四路交错的 Huffman 块编码（HuffmanCompress 的格式变体）
+ * @description 每块使用限长（最长 kMaxCodeLen 位）的范式 Huffman 编码，只存储码长；
+ *  块内数据均分为 4 段，各自编码成独立的比特流，块头中的跳转表记录每条流的长度。
+ *  解码时按码长查表，一次循环从 4 条流各解出一个符号，4 条依赖链互不等待。
+ *  块格式：模式（1字节） 原始长度（4字节） 之后按模式不同：
+ *   - Raw：原始数据；
+ *   - Rle：重复的单个字节；
+ *   - Huffman：最大符号（1字节） 码长（每个符号4位） 跳转表（4 * 4字节） 4条比特流。
+ */
+class Huffman4XCodec {
+public:
+    static constexpr unsigned kMaxCodeLen = 11;  // 解码表最多 2048 项
+    static constexpr unsigned kStreams = 4;
+
+    enum class BlockMode : uint8_t {
+        Raw = 0,
+        Rle = 1,
+        Huffman = 2,
+    };
+
+    // 编码一块数据，追加到 out 末尾（块长度须小于 4GB）
+    static void compressBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out);
+
+    // 解码 src 开头的一块数据，追加到 out 末尾；consumed 返回该块占用的字节数。
+    // maxLen 为原始长度的上限（容器的分块大小），块头记录的长度超出时视为损坏，不分配内存
+    static bool decompressBlock(const uint8_t* src, size_t srcLen, size_t maxLen, std::vector<uint8_t>& out,
+                                size_t& consumed);
+
+    // 由频率（下标不超过 maxSymbol）构造码长不超过 maxLen 的 Huffman 码，频率为0的符号码长为0
+    static void buildCodeLengths(std::array<uint32_t, 256> counts, unsigned maxSymbol, unsigned maxLen,
+                                 std::array<uint8_t, 256>& lengths);
+
+    // 按码长分配范式编码（同码长内按符号升序），tableLog 返回最长码长；码长不满足 Kraft 等式时返回 false
+    static bool assignCanonicalCodes(const std::array<uint8_t, 256>& lengths, unsigned maxSymbol,
+                                     unsigned& tableLog, std::array<uint16_t, 256>& codes);
+};
+
+/*
+ * @brief 四路 Huffman 压缩器：文件头之后是若干 Huffman4XCodec 块
+ */
+class Huffman4XCompress : public CBlockCompress {
+public:
+    static constexpr size_t kBlockSize = 128 * 1024;
+
+    Huffman4XCompress() : CBlockCompress(kBlockSize) {}
+
+    CompressType getCompressType() const override { return CompressType::Huffman4X; }
+    std::string getCompressTypeName() const override { return "Huffman4X"; }
+
+protected:
+    void encodeBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const override {
+        Huffman4XCodec::compressBlock(src, len, out);
+    }
+    bool decodeBlock(const uint8_t* src, size_t srcLen, size_t blockSize, std::vector<uint8_t>& out,
+                     size_t& consumed) const override {
+        return Huffman4XCodec::decompressBlock(src, srcLen, blockSize, out, consumed);
+    }
+    std::string getFileExtension() const override { return ".huf4x"; }
+};
+
+#endif // HUFFMAN4X_COMPRESS_H
@@ -3,6 +3,7 @@
 
 #include "ICompress.h"
 #include "CRC32.h"
+#include "CMetrics.h"
 #include <string>
 #include <filesystem>
 #include <fstream>
@@ -35,13 +36,18 @@ struct Head{
     uint8_t isCompress; // 是否压缩，0x21为压缩，0x20为不压缩，1字节
     CompressType compressType; // 压缩算法类型，固定为1字节
     uint8_t validBits; // 最后一个字节的有效位，1字节
-    uint8_t reservedBits; // 填充位，用于填充到字节边界，1字节
+    uint8_t reservedBits; // 格式标志（HUFF_FLAG_*），旧版本恒为0，1字节
     uint32_t headerSize; // 头大小， 4字节
     uint32_t freqTableSize;   // 词频表大小，4字节
     uint64_t originalSize; // 原始文件大小, 8字节
     uint32_t crc32; // CRC32校验值，4字节
 };  // 24字节
 
+// 分块格式：每块自带词频表，源数据只读一遍；块序列以原始长度为0的块结束，之后是原始大小（8字节）与CRC32（4字节）
+inline constexpr uint8_t HUFF_FLAG_BLOCKED = 0x01;
+// 分块格式的块大小
+inline constexpr size_t HUFF_TABLE_BLOCK_SIZE = 1024 * 1024;
+
 class HuffmanCompress : public ICompress {
 public:
     CompressType getCompressType() const override { return CompressType::Huffman; }
@@ -49,8 +55,26 @@ public:
     // 直接原地覆盖压缩，返回压缩后的文件路径
     std::string compressFile(const std::string& sourcePath) override;
     bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    bool decompressStream(std::istream& in, std::ostream& out, const std::string& sourceName) override;
+    // 内存数据的格式与文件格式相同：文件头 + 词频表 + 编码数据
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    // 单遍模式（默认开启）：compressFile 按块统计词频并立即编码，源文件只读一遍；
+    // 关闭时使用整文件词频表的旧格式，需要读两遍
+    void setSinglePass(bool enabled) { m_singlePass = enabled; }
+    bool isSinglePass() const { return m_singlePass; }
+    // 从流中读取一遍完成压缩（分块格式），输入可以是管道等不可回退的流；输出可回退时回填文件头
+    bool compressStream(std::istream& in, std::ostream& out);
 
 private:
+    // 两遍压缩：先统计整个文件的词频，再编码
+    std::string compressFileTwoPass(const std::string& sourcePath, const std::string& destPath);
+    // 解码分块格式文件头之后的块序列
+    static bool decompressBlocks(std::istream& in, std::ostream& out, const std::string& sourcePath);
+    // 按编码表把数据编码为比特（高位在前），返回最后一个字节中无效的位数
+    static uint8_t encodeBits(const uint8_t* data, size_t len, const std::array<std::vector<bool>, 256>& codes,
+                              std::vector<uint8_t>& out);
     //  统计字节形成的字符串词频（固定256个）
     static bool readFreqTable(const std::string& sourcePath, std::array<uint64_t, 256>& freqTable, uint64_t& originalSize);
     // 构造哈夫曼树
@@ -67,6 +91,8 @@ private:
         deleteHuffmanTree(node->right);
         delete node;
     }
+
+    bool m_singlePass = true;
 };
 
 
@@ -4,11 +4,18 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <istream>
+#include <ostream>
 
 enum class CompressType : uint8_t {
     None = 0,
     Huffman = 1,
     LZ77 = 2,
+    FSE = 3,
+    Huffman4X = 4,
+    BWT = 5,
+    LongRange = 6,
+    Dictionary = 7,
 };
 
 
@@ -24,17 +31,21 @@ public:
     // 解压缩文件（源路径→目标路径）
     virtual bool decompressFile(const std::string& sourcePath, const std::string& destPath) = 0;
 
+    // 按流解压：从 in 读取压缩文件格式的数据，把解压结果顺序写入 out，用于不落地的校验流水线；
+    // sourceName 只用于日志
+    virtual bool decompressStream(std::istream& in, std::ostream& out, const std::string& sourceName) = 0;
+
     // 获取压缩算法类型
     virtual CompressType getCompressType() const = 0;
 
     // 获取压缩算法名称
     virtual std::string getCompressTypeName() const = 0;
 
-    // // 压缩内存数据（源数据→目标数据）
-    // virtual bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
+    // 压缩内存数据（源数据→目标数据），用于包内按条目、按块压缩
+    virtual bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
 
-    // // 解压缩内存数据（源数据→目标数据）
-    // virtual bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
+    // 解压缩内存数据（源数据→目标数据）
+    virtual bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) = 0;
 
     // // 设置压缩级别（1-9，级别越高压缩率越高）
     // virtual void setCompressionLevel(int level) = 0;
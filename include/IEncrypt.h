@@ -3,6 +3,8 @@
 
 #include <string>
 #include <vector>
+#include <istream>
+#include <ostream>
 
 // 加密器类型枚举
 enum class EncryptType : uint8_t{
@@ -25,6 +27,10 @@ public:
     // 解密文件，将文件从源路径解压至目标路径
     virtual bool decryptFile(const std::string& sourcePath, const std::string& destPath, const std::string& key) = 0;
 
+    // 按流解密：从 in 读取加密数据（含文件头），把明文写入 out；sourceName 只用于日志
+    virtual bool decryptStream(std::istream& in, std::ostream& out, const std::string& key,
+                               const std::string& sourceName) = 0;
+
     // 获取加密器类型
     virtual EncryptType getEncryptType() const = 0;
 
@@ -4,6 +4,10 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <istream>
+
+#include "CRateLimiter.h"
 
 // 打包器类型枚举
 enum class PackType : uint8_t{
@@ -12,6 +16,13 @@ enum class PackType : uint8_t{
     Tar = 2,
 };
 
+// 打包源：一个源根目录及其下收集到的文件列表
+struct PackSource {
+    std::string rootPath;            // 源根路径（文件或目录）
+    std::string prefix;              // 包内存储前缀，为空时直接使用相对 rootPath 的路径
+    std::vector<std::string> files;  // 该源下需要打包的文件/目录（含根本身）
+};
+
 // IPack 抽象类 - 文件打包与解包接口
 class IPack {
 public:
@@ -20,14 +31,62 @@ public:
     // 打包：输入文件列表，输出打包目标路径（不含扩展名由具体实现决定）
     virtual std::string pack(const std::vector<std::string>& files, const std::string& destPath) = 0;
 
+    // 多源打包：将多个源一次性打包到同一个包中，每个源的条目存放在各自的前缀下
+    virtual std::string pack(const std::vector<PackSource>& sources, const std::string& destPath) = 0;
+
     // 解包：输入打包文件，输出解包目录
     virtual bool unpack(const std::string& srcPath, const std::string& destDir) = 0;
 
+    // 校验：从流中顺序读取打包数据（可以是解密、解压流水线的输出），检查各条目能否完整还原，不写出文件；
+    // srcPath 只用于日志
+    virtual bool verify(std::istream& in, const std::string& srcPath) = 0;
+
     // 获取打包器类型
     virtual PackType getPackType() const = 0;
 
     // 获取打包器类型名字
     virtual std::string getPackTypeName() const = 0;
+
+    // 设置读取源文件时使用的限速器（为空表示不限速）
+    virtual void setRateLimiter(std::shared_ptr<CRateLimiter> limiter) { m_rateLimiter = std::move(limiter); }
+
+    // 设置是否对包内内容相同的文件去重（默认启用）
+    virtual void setDeduplicationEnabled(bool enabled) { m_deduplicate = enabled; }
+
+    // 设置是否跟随符号链接打包其指向的内容（默认不跟随，按链接本身存放）
+    virtual void setFollowSymlinks(bool follow) { m_followSymlinks = follow; }
+
+    // 设置包内按条目压缩使用的首选算法（为空表示不压缩）；
+    // 已经压缩过的文件（按扩展名、魔数与抽样熵判断）仍原样存放
+    virtual void setEntryCompression(const std::string& compressType) { m_entryCompressType = compressType; }
+
+    // 设置是否为小文件训练共享字典（需要同时设置按条目压缩）；
+    // 字典在包内只存放一份，小文件各自独立地以它为前缀压缩
+    virtual void setDictionaryEnabled(bool enabled) { m_useDictionary = enabled; }
+
+    // 设置是否按实测的压缩与写出速度自适应地为每一块选择算法（需要同时设置按条目压缩）；
+    // compressionLevel（1-9）决定可以使用的最慢算法
+    virtual void setAdaptiveCompression(bool enabled, int compressionLevel = 9) {
+        m_adaptiveCompression = enabled;
+        m_compressionLevel = compressionLevel;
+    }
+
+    // 设置压缩前的过滤器链，如 "delta:4,zrle"；"auto" 表示按条目内容选择，为空表示不过滤
+    virtual void setEntryFilters(const std::string& filters) { m_entryFilters = filters; }
+
+    // 设置按条目压缩时同时编码的块数（线程数），0 表示按硬件线程数（最多 8 个）
+    virtual void setThreadCount(unsigned threads) { m_threadCount = threads; }
+
+protected:
+    std::shared_ptr<CRateLimiter> m_rateLimiter;  // I/O限速器
+    bool m_deduplicate = true;                    // 是否去重
+    bool m_followSymlinks = false;                // 是否跟随符号链接
+    std::string m_entryCompressType;              // 按条目压缩的首选算法
+    bool m_useDictionary = false;                 // 是否为小文件训练字典
+    std::string m_entryFilters;                   // 压缩前的过滤器链
+    bool m_adaptiveCompression = false;           // 是否自适应选择压缩级别
+    int m_compressionLevel = 9;                   // 自适应时可用的最高压缩级别（1-9）
+    unsigned m_threadCount = 0;                   // 同时编码的块数，0 表示按硬件线程数
 };
 
 #endif
\ No newline at end of file
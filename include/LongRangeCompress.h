@@ -0,0 +1,136 @@
+#ifndef LONG_RANGE_COMPRESS_H
+#define LONG_RANGE_COMPRESS_H
+
+#include "ICompress.h"
+#include "CBlockCompress.h"
+#include "HuffmanCompress.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// 一个序列：先输出 literalLength 个字面量，再从 distance 字节之前复制 matchLength 字节
+struct LongRangeSequence {
+    uint32_t literalLength;
+    uint32_t matchLength;  // 0 表示只有字面量（段尾）
+    uint64_t distance;
+};
+
+/*
+ * @brief 长距离匹配查找：在远大于常规 LZ 窗口的范围内找出重复的长片段（相隔数百MB的重复表、镜像块等）
+ * @description 对 64 字节窗口计算 gear 滚动哈希，只把哈希值满足采样条件的位置（平均每 64 字节一个，
+ *  由内容决定，与对齐无关）记入紧凑哈希表。表项 8 字节（48 位偏移 + 16 位校验），每桶 4 项，
+ *  桶满时淘汰最旧的一项；表的大小由内存预算决定，与输入大小无关。
+ *  命中后读回历史数据逐字节确认，再向前、向后扩展。
+ */
+class LongRangeMatcher {
+public:
+    static constexpr size_t kWindow = 64;          // 滚动哈希窗口
+    static constexpr size_t kMinMatch = 64;        // 最短匹配长度
+    static constexpr size_t kBucketSize = 4;
+    static constexpr unsigned kSampleLog = 6;      // 平均每 2^6 个位置采样一个
+    static constexpr size_t kMaxBackward = 4096;   // 向前扩展的上限
+
+    // 读取当前段之前 [offset, offset + len) 的历史数据，失败时返回 false
+    using HistoryReader = std::function<bool(uint64_t offset, uint8_t* dest, size_t len)>;
+
+    // memoryBudget 为哈希表可用的字节数（至少 64KB）
+    explicit LongRangeMatcher(size_t memoryBudget);
+
+    // 在位于输入 start 偏移处的 data 中查找匹配，输出覆盖整段的序列（最后一个只含字面量）。
+    // 匹配不越过段尾，但可以引用之前任意段的数据；各段须按顺序调用
+    void findMatches(const uint8_t* data, size_t len, uint64_t start, const HistoryReader& history,
+                     std::vector<LongRangeSequence>& sequences);
+
+    size_t getTableBytes() const { return m_table.size() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> m_table;
+    unsigned m_shift;              // 64 - 桶数的位数
+    std::vector<uint8_t> m_scratch;
+};
+
+/*
+ * @brief 长距离匹配 + 哈夫曼：先用 LongRangeMatcher 去掉远距离的重复片段，剩余字面量交给 HuffmanCompress
+ * @description 输入按 4MB 分段处理，段内匹配可以引用整个输入中更早的数据，解压时从已写出的
+ *  输出中读回。内存占用为哈希表（内存预算）加上一段的缓冲区，与输入大小无关。
+ *  格式：BlockHead 之后是若干 [段长度（4字节） 段数据]，段数据为：
+ *   原始长度（4字节） 序列字节数（4字节） 序列（变长整数：字面量数、匹配长度、匹配距离）
+ *   字面量模式（1字节，0=原样，1=Huffman） 字面量字节数（4字节） 字面量
+ *  适合整文件压缩（compressFile）；按块压缩的内存数据只能找到块内的重复，分块存放的数据流用 LongRangeStream。
+ */
+class LongRangeCompress : public ICompress {
+public:
+    static constexpr size_t kSegmentSize = 4 * 1024 * 1024;
+    static constexpr size_t kDefaultMemoryBudget = 64 * 1024 * 1024;
+
+    explicit LongRangeCompress(size_t memoryBudget = kDefaultMemoryBudget) : m_memoryBudget(memoryBudget) {}
+
+    CompressType getCompressType() const override { return CompressType::LongRange; }
+    std::string getCompressTypeName() const override { return "LongRange"; }
+    // 输出到 sourcePath + ".lrm"，返回压缩后的文件路径
+    std::string compressFile(const std::string& sourcePath) override;
+    bool decompressFile(const std::string& sourcePath, const std::string& destPath) override;
+    // 解压结果须可随机读回，经由临时文件输出
+    bool decompressStream(std::istream& in, std::ostream& out, const std::string& sourceName) override;
+    bool compressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+    bool decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) override;
+
+    // 哈希表的内存预算（字节）
+    void setMemoryBudget(size_t bytes) { m_memoryBudget = bytes; }
+    size_t getMemoryBudget() const { return m_memoryBudget; }
+
+private:
+    // 编码一段，追加到 out 末尾（含段长度）
+    void encodeSegment(const uint8_t* data, size_t len, uint64_t start, LongRangeMatcher& matcher,
+                       const LongRangeMatcher::HistoryReader& history, std::vector<uint8_t>& out);
+    // 解码一段（不含段长度），结果写入 out
+    bool decodeSegment(const uint8_t* src, size_t srcLen, uint64_t start,
+                       const LongRangeMatcher::HistoryReader& history, std::vector<uint8_t>& out);
+    // 解压 in 中的压缩数据到 destPath（解码时从中读回历史数据）
+    bool decompressTo(std::istream& in, const std::string& sourcePath, const std::string& destPath);
+
+    size_t m_memoryBudget;
+    HuffmanCompress m_literalCoder;
+
+    friend class LongRangeStream;
+};
+
+/*
+ * @brief 分块存放的数据流上的长距离匹配：各块分别编码、分别存放，但匹配可以引用之前各块的内容
+ * @description 编码端与解码端按顺序把每一块（不论该块用什么方式存放）追加到最近 window 字节的环形历史中，
+ *  匹配只引用窗口内的数据，两端的历史因此一致。编码端的匹配器在各块之间保留，哈希表按 sizeHint 限制大小。
+ *  块数据与 LongRangeCompress 的段数据格式相同（不含段长度），每块不超过 kSegmentSize。
+ *  流的偏移从 start 开始，start 之前的数据不可引用。
+ */
+class LongRangeStream {
+public:
+    // sizeHint 为流的预计总长度（0 表示未知），只影响编码端哈希表的大小
+    LongRangeStream(uint64_t start, size_t window, uint64_t sizeHint = 0);
+
+    // 编码下一块并追加到历史，out 为编码结果
+    void encodeBlock(const uint8_t* data, size_t len, std::vector<char>& out);
+    // 解码下一块并追加到历史，out 为原始数据；数据损坏或引用了窗口之外的数据时返回 false
+    bool decodeBlock(const char* src, size_t srcLen, std::vector<char>& out);
+    // 以其他方式存放的块只追加到历史
+    void append(const uint8_t* data, size_t len);
+
+    // 下一块在流中的偏移
+    uint64_t getPosition() const { return m_position; }
+
+private:
+    bool readHistory(uint64_t offset, uint8_t* dest, size_t len) const;
+
+    LongRangeCompress m_codec;
+    std::unique_ptr<LongRangeMatcher> m_matcher;  // 第一次编码时创建，解码端不需要
+    std::vector<uint8_t> m_ring;                  // 最近 m_window 字节，偏移 p 位于 (p - m_start) % m_window
+    std::vector<uint8_t> m_segment;
+    size_t m_window;
+    uint64_t m_start;
+    uint64_t m_position;
+    uint64_t m_sizeHint;
+};
+
+#endif // LONG_RANGE_COMPRESS_H
@@ -3,6 +3,7 @@
 
 #include "IEncrypt.h"
 #include "CRC32.h"
+#include "CMetrics.h"
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -30,6 +31,7 @@ public:
 
     // 解密文件
     bool decryptFile(const std::string& sourcePath, const std::string& destPath, const std::string& key) override;
+    bool decryptStream(std::istream& in, std::ostream& out, const std::string& key, const std::string& sourceName) override;
 };
 
 #endif
\ No newline at end of file
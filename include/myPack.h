@@ -2,6 +2,10 @@
 #define MYPACK_H
 
 #include "IPack.h"
+#include "CMetrics.h"
+#include "CSparseFile.h"
+#include "ICompress.h"
+#include "CHash.h"
 #include <string>
 #include <memory>
 #include <iostream>
@@ -12,7 +16,8 @@
 enum class FileType : uint8_t{
     Regular = 0,  // 普通文件
     Directory = 1,  // 目录文件
-    SymbolicLink = 2,  //后面是暂时预留的
+    SymbolicLink = 2,  // 符号链接，按链接本身存放（v2）
+    //后面是暂时预留的
     CharacterDevice = 3,
     BlockDevice = 4,
     FIFO = 5,
@@ -20,37 +25,113 @@ enum class FileType : uint8_t{
 };
 
 
+// 包格式版本（即包头第一个字节）
+inline constexpr uint8_t PACK_FORMAT_V1 = 0x01;  // 元信息不含标志位
+inline constexpr uint8_t PACK_FORMAT_V2 = 0x02;  // 元信息带标志位，可附加区间表
+inline constexpr uint8_t PACK_FORMAT_V3 = 0x03;  // 包头之后附带小文件共用的压缩字典
+
+// 条目标志位（v2）
+enum FileMetaFlags : uint16_t {
+    META_FLAG_SPARSE = 0x0001,  // 稀疏文件：元信息后附区间表，内容区只存放数据区间
+    META_FLAG_HARDLINK = 0x0002,  // 硬链接：内容与包内之前的某个条目相同，只记录该条目名
+    META_FLAG_DUPLICATE = 0x0004,  // 重复内容：offset 指向之前某个条目已存放的内容，本条目不再存放
+    META_FLAG_COMPRESSED = 0x0008,  // 内容按块压缩：元信息后附压缩算法与存放长度
+    META_FLAG_CHECKSUM = 0x0010,  // 元信息后附原始内容的 XXH3-128 哈希，解包时校验
+};
+
+// 压缩条目的块大小：每块单独编码，不可压缩的块原样存放
+inline constexpr size_t PACK_BLOCK_SIZE = 1024 * 1024;
+// 块算法字节中的标志：块数据先经过过滤器链，数据以过滤器链头开始
+inline constexpr uint8_t PACK_BLOCK_FILTERED = 0x80;
+// 块算法字节中的标志：LongRange 块的匹配可以引用本条目之前各块的原始内容（LongRangeStream），
+// 引用范围为条目中第一个这样的块起、最近 PACK_LONG_RANGE_WINDOW 字节
+inline constexpr uint8_t PACK_BLOCK_LINKED = 0x40;
+inline constexpr size_t PACK_LONG_RANGE_WINDOW = 128 * 1024 * 1024;
+
+// 字典压缩：不超过此大小的条目使用训练字典压缩
+inline constexpr uint64_t PACK_DICT_FILE_LIMIT = 64 * 1024;
+// 字典压缩：至少有这么多个小文件才训练字典（首选算法为 Dictionary 时不限）
+inline constexpr size_t PACK_DICT_MIN_SAMPLES = 8;
+// 字典压缩：训练样本的总大小上限，超出时按间隔抽取
+inline constexpr size_t PACK_DICT_SAMPLE_BUDGET = 8 * 1024 * 1024;
+
 // 定义元数据结构
 struct FileMeta{
     uint32_t nameLen;
     std::string name;
-    uint64_t size;
+    uint64_t size;      // 文件的逻辑长度
     uint64_t offset;
     FileType type;
+    uint16_t flags = 0;
+    std::vector<FileExtent> extents{};  // 稀疏文件的数据区间，区间之外为空洞
+    std::string linkTarget{};  // 符号链接的目标，或硬链接指向的包内条目名
+    CompressType codec = CompressType::None;  // 压缩条目使用的算法
+    uint64_t storedLength = 0;                // 压缩条目在内容区中的长度
+    Hash128 contentHash{};                    // 原始内容（稀疏文件为各数据区间依次相接）的哈希
+
+    // 需要存放的原始数据长度（稀疏文件只计数据区间）
+    uint64_t payloadSize() const {
+        return (flags & META_FLAG_SPARSE) ? CSparseFile::dataLength(extents) : size;
+    }
+
+    // 元信息中是否带有链接目标
+    bool hasLinkTarget() const {
+        return type == FileType::SymbolicLink || (flags & META_FLAG_HARDLINK);
+    }
+
+    // 内容区中实际存放的字节数
+    uint64_t storedSize() const {
+        if (hasLinkTarget() || (flags & META_FLAG_DUPLICATE)) {
+            return 0;
+        }
+        return (flags & META_FLAG_COMPRESSED) ? storedLength : payloadSize();
+    }
 };
 
 /*
  * @brief 基础打包器类，实现基本的文件打包与解包功能。
  * @description 打包文件格式为：
- *  1. 打包标志位（1字节），固定为0x01
+ *  1. 打包标志位（1字节），即格式版本：0x01、0x02 或 0x03
  *  2. 打包算法（1字节）
  *  3. 当前包包含的文件数量（4字节）
  *  4. 元数据区长度（4字节）
+ *     v3 在此之后追加：字典长度（4字节） 字典（CDictionary 序列化数据），供 Dictionary 算法的条目共用
  *  5. 文件元信息 : 文件名长度（4字节） 文件名(变长) 文件大小（8字节） 偏移量（8字节） 文件类型（1字节）
- *  6. 文件内容（按顺序排列）
+ *     v2 之后追加：标志位（2字节）；稀疏文件再追加 区间数（4字节） 区间（偏移8字节 长度8字节）*n；
+ *     符号链接与硬链接再追加 目标长度（4字节） 目标（变长），这类条目在内容区不占空间；
+ *     压缩条目再追加 压缩算法（1字节） 存放长度（8字节）；
+ *     带校验的条目最后追加 内容哈希（16字节，XXH3-128 低 64 位在前），按压缩、过滤之前的原始数据计算
+ *  6. 文件内容（按顺序排列），稀疏文件只存放各数据区间的内容；内容完全相同的文件只存放一份。
+ *     压缩条目的内容由若干块组成，每块为 算法（1字节） 原始长度（4字节） 存放长度（4字节） 数据，
+ *     压缩后没有变小的块以算法 None 原样存放；算法字节带 0x80 标志的块先经过过滤器链，
+ *     数据为 过滤器链头（见 CFilterChain） 过滤后再压缩的数据，解包时逆序还原
+ *  打包时写出 v2，训练了字典时写出 v3；解包兼容 v1。
 */
 //  haed + content   -->  文件夹结构（先根遍历） -->  root + 文件名
 // 获得path  -->  判断类型  --> 目录文件 -->  文件遍历  -->  |  文件list   -->  下游操作  
 
 class myPack : public IPack {
 public:
-    std::string myPack::pack(const std::vector<std::string>& files, const std::string& destPath) override;
+    // 单源打包：根目录取第一个文件的父目录
+    std::string pack(const std::vector<std::string>& files, const std::string& destPath) override;
+
+    // 多源打包：每个源的条目名为 前缀/相对源根的路径
+    std::string pack(const std::vector<PackSource>& sources, const std::string& destPath) override;
 
-    bool myPack::unpack(const std::string& srcPath, const std::string& destDir) override;
+    bool unpack(const std::string& srcPath, const std::string& destDir) override;
+
+    // 顺序读取包并解码每个条目、核对内容哈希，不写出文件；损坏的条目逐个记录日志
+    bool verify(std::istream& in, const std::string& srcPath) override;
 
     PackType getPackType() const override { return PackType::Basic; }
 
     std::string getPackTypeName() const override { return "Basic"; }
+
+private:
+    // 找出内容完全相同的普通文件：先按大小分组，再并发计算哈希确认。
+    // 返回每个条目对应的首个相同条目下标，不重复时为 SIZE_MAX
+    std::vector<size_t> findDuplicates(const std::vector<FileMeta>& metas,
+                                       const std::vector<std::string>& fullPaths, CMetrics* metrics);
 };
 
 
@@ -5,6 +5,7 @@
 #include <vector>
 #include <filesystem>
 #include <fstream>
+#include <random>
 
 namespace fs = std::filesystem;
 
@@ -47,6 +48,17 @@ inline bool ReadTestFile(const std::string& filePath, std::vector<char>& buffer)
     }
 }
 
+// 辅助函数：生成可复现的随机测试数据，同一 seed 得到相同内容；Container 可为 std::string 或字节数组
+template <typename Container = std::string>
+Container MakeRandomData(size_t size, unsigned seed) {
+    std::mt19937 rng(seed);
+    Container data(size, 0);
+    for (auto& b : data) {
+        b = static_cast<typename Container::value_type>(rng() & 0xFF);
+    }
+    return data;
+}
+
 // 辅助函数：清理测试文件
 inline void CleanupTestFile(const std::string& filePath) {
     try {
@@ -0,0 +1,343 @@
+#include "BWTCompress.h"
+#include "FSECompress.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+// MTF/游程编码后的符号：零串用 RUNA/RUNB 计数，其余名次 r 记为 r + 1；名次 254、255 用转义字节加名次
+constexpr uint8_t kRunA = 0;
+constexpr uint8_t kRunB = 1;
+constexpr uint8_t kEscape = 255;
+
+void appendU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+uint32_t loadU32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// 长度为 run 的零串写成双射二进制（低位在前，RUNA 表示1，RUNB 表示2）
+void emitZeroRun(uint32_t run, std::vector<uint8_t>& symbols) {
+    uint32_t pending = run - 1;
+    for (;;) {
+        symbols.push_back((pending & 1) ? kRunB : kRunA);
+        if (pending < 2) break;
+        pending = (pending - 2) / 2;
+    }
+}
+
+// MTF + 零串游程编码
+std::vector<uint8_t> mtfEncode(const std::vector<uint8_t>& bwt) {
+    std::array<uint8_t, 256> order;
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<uint8_t> symbols;
+    symbols.reserve(bwt.size() / 2);
+    uint32_t zeroRun = 0;
+    for (uint8_t c : bwt) {
+        if (order[0] == c) {
+            ++zeroRun;
+            continue;
+        }
+        if (zeroRun > 0) {
+            emitZeroRun(zeroRun, symbols);
+            zeroRun = 0;
+        }
+        unsigned rank = 1;
+        while (order[rank] != c) {
+            ++rank;
+        }
+        std::memmove(order.data() + 1, order.data(), rank);
+        order[0] = c;
+        if (rank < 254) {
+            symbols.push_back(static_cast<uint8_t>(rank + 1));
+        } else {
+            symbols.push_back(kEscape);
+            symbols.push_back(static_cast<uint8_t>(rank));
+        }
+    }
+    if (zeroRun > 0) {
+        emitZeroRun(zeroRun, symbols);
+    }
+    return symbols;
+}
+
+// 逆 MTF；结果长度不等于 expected 时返回 false
+bool mtfDecode(const std::vector<uint8_t>& symbols, size_t expected, std::vector<uint8_t>& bwt) {
+    std::array<uint8_t, 256> order;
+    std::iota(order.begin(), order.end(), 0);
+    bwt.clear();
+    bwt.reserve(expected);
+    uint64_t run = 0;
+    uint64_t weight = 1;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const uint8_t sym = symbols[i];
+        if (sym == kRunA || sym == kRunB) {
+            run += weight * (sym == kRunA ? 1 : 2);
+            weight <<= 1;
+            if (run > expected) return false;
+            continue;
+        }
+        if (run > 0) {
+            if (bwt.size() + run > expected) return false;
+            bwt.insert(bwt.end(), static_cast<size_t>(run), order[0]);
+            run = 0;
+            weight = 1;
+        }
+        unsigned rank = sym - 1u;
+        if (sym == kEscape) {
+            if (++i == symbols.size() || symbols[i] < 254) return false;
+            rank = symbols[i];
+        }
+        const uint8_t c = order[rank];
+        std::memmove(order.data() + 1, order.data(), rank);
+        order[0] = c;
+        if (bwt.size() == expected) return false;
+        bwt.push_back(c);
+    }
+    if (run > 0) {
+        if (bwt.size() + run > expected) return false;
+        bwt.insert(bwt.end(), static_cast<size_t>(run), order[0]);
+    }
+    return bwt.size() == expected;
+}
+
+}  // namespace
+
+// SA-IS：先按 LMS 子串诱导排序，子串不唯一时递归求解缩减后的问题
+std::vector<int32_t> BwtCodec::suffixArray(const std::vector<int32_t>& s, int32_t upper) {
+    const int32_t n = static_cast<int32_t>(s.size());
+    if (n == 0) return {};
+    if (n == 1) return {0};
+    if (n == 2) return s[0] < s[1] ? std::vector<int32_t>{0, 1} : std::vector<int32_t>{1, 0};
+
+    std::vector<int32_t> sa(n);
+    // ls[i]：后缀 i 是否为 S 型（比后一个后缀小）
+    std::vector<bool> ls(n);
+    for (int32_t i = n - 2; i >= 0; --i) {
+        ls[i] = (s[i] == s[i + 1]) ? ls[i + 1] : (s[i] < s[i + 1]);
+    }
+    // 各字符桶中 L 型与 S 型的起始位置
+    std::vector<int32_t> sumL(upper + 1), sumS(upper + 1);
+    for (int32_t i = 0; i < n; ++i) {
+        if (!ls[i]) {
+            ++sumS[s[i]];
+        } else {
+            ++sumL[s[i] + 1];
+        }
+    }
+    for (int32_t i = 0; i <= upper; ++i) {
+        sumS[i] += sumL[i];
+        if (i < upper) sumL[i + 1] += sumS[i];
+    }
+
+    auto induce = [&](const std::vector<int32_t>& lms) {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::vector<int32_t> buf(upper + 1);
+        std::copy(sumS.begin(), sumS.end(), buf.begin());
+        for (int32_t d : lms) {
+            if (d == n) continue;
+            sa[buf[s[d]]++] = d;
+        }
+        std::copy(sumL.begin(), sumL.end(), buf.begin());
+        sa[buf[s[n - 1]]++] = n - 1;
+        for (int32_t i = 0; i < n; ++i) {
+            const int32_t v = sa[i];
+            if (v >= 1 && !ls[v - 1]) {
+                sa[buf[s[v - 1]]++] = v - 1;
+            }
+        }
+        std::copy(sumL.begin(), sumL.end(), buf.begin());
+        for (int32_t i = n - 1; i >= 0; --i) {
+            const int32_t v = sa[i];
+            if (v >= 1 && ls[v - 1]) {
+                sa[--buf[s[v - 1] + 1]] = v - 1;
+            }
+        }
+    };
+
+    std::vector<int32_t> lmsMap(n + 1, -1);
+    std::vector<int32_t> lms;
+    for (int32_t i = 1; i < n; ++i) {
+        if (!ls[i - 1] && ls[i]) {
+            lmsMap[i] = static_cast<int32_t>(lms.size());
+            lms.push_back(i);
+        }
+    }
+    const int32_t m = static_cast<int32_t>(lms.size());
+    induce(lms);
+
+    if (m > 0) {
+        std::vector<int32_t> sortedLms;
+        sortedLms.reserve(m);
+        for (int32_t v : sa) {
+            if (lmsMap[v] != -1) sortedLms.push_back(v);
+        }
+        // 给 LMS 子串编号，相同的子串编号相同
+        std::vector<int32_t> recS(m);
+        int32_t recUpper = 0;
+        recS[lmsMap[sortedLms[0]]] = 0;
+        for (int32_t i = 1; i < m; ++i) {
+            int32_t l = sortedLms[i - 1];
+            int32_t r = sortedLms[i];
+            const int32_t endL = (lmsMap[l] + 1 < m) ? lms[lmsMap[l] + 1] : n;
+            const int32_t endR = (lmsMap[r] + 1 < m) ? lms[lmsMap[r] + 1] : n;
+            bool same = true;
+            if (endL - l != endR - r) {
+                same = false;
+            } else {
+                while (l < endL && s[l] == s[r]) {
+                    ++l;
+                    ++r;
+                }
+                if (l == n || s[l] != s[r]) same = false;
+            }
+            if (!same) ++recUpper;
+            recS[lmsMap[sortedLms[i]]] = recUpper;
+        }
+        const std::vector<int32_t> recSa = suffixArray(recS, recUpper);
+        for (int32_t i = 0; i < m; ++i) {
+            sortedLms[i] = lms[recSa[i]];
+        }
+        induce(sortedLms);
+    }
+    return sa;
+}
+
+std::vector<uint8_t> BwtCodec::forward(const uint8_t* src, size_t len, uint32_t& primary) {
+    // 末尾隐含一个最小的结束符：第0行是结束符开头的轮转，其最后一个字符为 src[len-1]
+    const std::vector<int32_t> sa = suffixArray(std::vector<int32_t>(src, src + len), 255);
+    std::vector<uint8_t> bwt;
+    bwt.reserve(len);
+    bwt.push_back(src[len - 1]);
+    primary = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (sa[i] == 0) {
+            primary = static_cast<uint32_t>(i + 1);  // 这一行的最后一个字符是结束符，不输出
+        } else {
+            bwt.push_back(src[sa[i] - 1]);
+        }
+    }
+    return bwt;
+}
+
+bool BwtCodec::inverse(const std::vector<uint8_t>& bwt, uint32_t primary, std::vector<uint8_t>& out) {
+    const size_t n = bwt.size();
+    if (primary == 0 || primary > n || n >= kMaxBlockSize) {
+        return false;
+    }
+    // 补回结束符后共 n + 1 行；LF 映射把第 i 行对应到其最后一个字符开头的那一行。
+    // 每项的高24位存 LF，低8位存该行的最后一个字符，逆变换每步只访问一次内存
+    std::array<uint32_t, 257> start{};
+    for (uint8_t c : bwt) {
+        ++start[c + 1];
+    }
+    start[0] = 1;  // 结束符占第0行
+    for (size_t c = 1; c < 257; ++c) {
+        start[c] += start[c - 1];
+    }
+    std::vector<uint32_t> links(n + 1);
+    links[primary] = 0;
+    for (size_t i = 0, row = 0; i < n; ++i, ++row) {
+        if (row == primary) ++row;
+        links[row] = (start[bwt[i]]++ << 8) | bwt[i];
+    }
+
+    const size_t outStart = out.size();
+    out.resize(outStart + n);
+    uint8_t* dst = out.data() + outStart;
+    uint32_t row = 0;
+    for (size_t k = n; k-- > 0;) {
+        if (row == primary) {
+            out.resize(outStart);
+            return false;
+        }
+        const uint32_t link = links[row];
+        dst[k] = static_cast<uint8_t>(link);
+        row = link >> 8;
+    }
+    if (row != primary) {
+        out.resize(outStart);
+        return false;
+    }
+    return true;
+}
+
+void BwtCodec::compressBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) {
+    const size_t blockStart = out.size();
+    auto writeRaw = [&]() {
+        out.resize(blockStart);
+        out.push_back(static_cast<uint8_t>(BlockMode::Raw));
+        appendU32(out, static_cast<uint32_t>(len));
+        out.insert(out.end(), src, src + len);
+    };
+    if (len < 64) {
+        writeRaw();
+        return;
+    }
+
+    uint32_t primary = 0;
+    const std::vector<uint8_t> symbols = mtfEncode(forward(src, len, primary));
+
+    out.push_back(static_cast<uint8_t>(BlockMode::Bwt));
+    appendU32(out, static_cast<uint32_t>(len));
+    appendU32(out, primary);
+    appendU32(out, static_cast<uint32_t>(symbols.size()));
+    for (size_t offset = 0; offset < symbols.size(); offset += kEntropySegment) {
+        FseCodec::compressBlock(symbols.data() + offset, std::min(kEntropySegment, symbols.size() - offset), out);
+        if (out.size() - blockStart >= 5 + len) {
+            writeRaw();
+            return;
+        }
+    }
+}
+
+bool BwtCodec::decompressBlock(const uint8_t* src, size_t srcLen, size_t maxLen, std::vector<uint8_t>& out,
+                               size_t& consumed) {
+    if (srcLen < 5) {
+        return false;
+    }
+    const BlockMode mode = static_cast<BlockMode>(src[0]);
+    const uint32_t len = loadU32(src + 1);
+    if (len > maxLen) {
+        return false;
+    }
+    size_t pos = 5;
+    if (mode == BlockMode::Raw) {
+        if (srcLen - pos < len) return false;
+        out.insert(out.end(), src + pos, src + pos + len);
+        consumed = pos + len;
+        return true;
+    }
+    if (mode != BlockMode::Bwt || srcLen - pos < 8) {
+        return false;
+    }
+    const uint32_t primary = loadU32(src + pos);
+    const uint32_t symbolCount = loadU32(src + pos + 4);
+    pos += 8;
+    // 每个原始字节至多产生两个符号
+    if (symbolCount > 2 * uint64_t(len)) {
+        return false;
+    }
+
+    std::vector<uint8_t> symbols;
+    symbols.reserve(symbolCount);
+    while (symbols.size() < symbolCount) {
+        size_t used = 0;
+        if (!FseCodec::decompressBlock(src + pos, srcLen - pos, symbolCount - symbols.size(), symbols, used)) {
+            return false;
+        }
+        pos += used;
+    }
+    std::vector<uint8_t> bwt;
+    if (symbols.size() != symbolCount || !mtfDecode(symbols, len, bwt) || !inverse(bwt, primary, out)) {
+        return false;
+    }
+    consumed = pos;
+    return true;
+}
@@ -0,0 +1,85 @@
+#include "CAdaptiveLevel.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr CompressType kLevelCodecs[CAdaptiveLevel::kMaxLevel + 1] = {
+    CompressType::None, CompressType::Huffman4X, CompressType::FSE, CompressType::LongRange, CompressType::BWT,
+};
+
+double smooth(double previous, double sample, bool measured) {
+    return measured ? previous + (sample - previous) * CAdaptiveLevel::kSmoothing : sample;
+}
+
+}  // namespace
+
+CAdaptiveLevel::CAdaptiveLevel(int maxLevel, int startLevel)
+    : m_maxLevel(std::clamp(maxLevel, 0, kMaxLevel)),
+      m_level(std::clamp(startLevel, 0, m_maxLevel)) {
+    // 不压缩的耗时只取决于写出速度
+    m_stats[0].measured = true;
+}
+
+CompressType CAdaptiveLevel::codecForLevel(int level) {
+    return kLevelCodecs[std::clamp(level, 0, kMaxLevel)];
+}
+
+int CAdaptiveLevel::maxLevelForConfig(int compressionLevel) {
+    // 1-2: Huffman4X  3-4: FSE  5-7: LongRange  8-9: BWT
+    static constexpr int kLevels[10] = {1, 1, 1, 2, 2, 3, 3, 3, 4, 4};
+    return kLevels[std::clamp(compressionLevel, 0, 9)];
+}
+
+double CAdaptiveLevel::estimateCost(int level) const {
+    if (level < 0 || level > m_maxLevel || !m_stats[level].measured) return -1;
+    return m_stats[level].nanosPerByte + m_stats[level].ratio * m_writeNanosPerByte;
+}
+
+int CAdaptiveLevel::nextLevel() {
+    ++m_blocks;
+    if (!m_writeMeasured || !m_stats[m_level].measured) {
+        return m_level;  // 还没有测量数据
+    }
+
+    // 已测量的级别中估计耗时最小的，只有明显更快时才离开当前级别
+    const double currentCost = estimateCost(m_level);
+    int best = m_level;
+    for (int level = 0; level <= m_maxLevel; ++level) {
+        const double cost = estimateCost(level);
+        if (cost >= 0 && cost < estimateCost(best)) best = level;
+    }
+    if (estimateCost(best) < currentCost * (1 - kSwitchMargin)) m_level = best;
+
+    // 估计最快的级别两侧还没有测量时立即试探（差距不足以切换时也继续向该方向探索），
+    // 否则定期轮流试探当前级别的上下两侧（级别 0 无需试探）
+    for (int neighbor : {best + 1, best - 1}) {
+        if (neighbor >= 1 && neighbor <= m_maxLevel && !m_stats[neighbor].measured) {
+            return neighbor;
+        }
+    }
+    if (m_blocks % kProbeInterval == 0) {
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            const int probe = m_probeUp ? m_level + 1 : m_level - 1;
+            m_probeUp = !m_probeUp;
+            if (probe >= 1 && probe <= m_maxLevel) return probe;
+        }
+    }
+    return m_level;
+}
+
+void CAdaptiveLevel::recordCompress(int level, uint64_t rawBytes, uint64_t storedBytes, uint64_t nanos) {
+    if (level < 0 || level > m_maxLevel || rawBytes == 0) return;
+    ++m_blockCounts[level];
+    if (level == 0) return;
+    LevelStats& stats = m_stats[level];
+    stats.nanosPerByte = smooth(stats.nanosPerByte, static_cast<double>(nanos) / rawBytes, stats.measured);
+    stats.ratio = smooth(stats.ratio, static_cast<double>(storedBytes) / rawBytes, stats.measured);
+    stats.measured = true;
+}
+
+void CAdaptiveLevel::recordWrite(uint64_t bytes, uint64_t nanos) {
+    if (bytes == 0) return;
+    m_writeNanosPerByte = smooth(m_writeNanosPerByte, static_cast<double>(nanos) / bytes, m_writeMeasured);
+    m_writeMeasured = true;
+}
@@ -1,4 +1,10 @@
 ﻿#include "CBackup.h"
+#include "CLogger.h"
+#include "CParityFile.h"
+#include "CStreamPipe.h"
+#include <chrono>
+#include <functional>
+#include <thread>
 
 /**
  * CBackup implementation
@@ -7,7 +13,8 @@
 // build 去搭建项目框架  Cmake  --> 项目一些开发环境
 
 // 构造函数
-CBackup::CBackup(){
+CBackup::CBackup() : metrics(std::make_shared<CMetrics>()) {
+    metrics->setEnabled(false);
 }
 
 // 析构函数
@@ -21,7 +28,7 @@ bool ReadFile(const std::string& filePath, std::vector<char>& buffer){
     std::ifstream inFile(filePath, std::ios::binary); 
     // 检查文件是否打开成功
     if(!inFile.is_open()){
-        std::cerr << "Failed to open file: " << filePath << std::endl;
+        LOG_ERROR("Failed to open file: " << filePath);
         return false;
     }
     // 获取文件大小
@@ -31,7 +38,7 @@ bool ReadFile(const std::string& filePath, std::vector<char>& buffer){
     // 读取文件内容
     buffer.resize(fileSize);
     if(!inFile.read(buffer.data(), fileSize)){  //  后续可以设置分块读取以防止文件过大导致内存不足
-        std::cerr << "Failed to read file: " << filePath << std::endl;
+        LOG_ERROR("Failed to read file: " << filePath);
         return false;
     }
     return true;
@@ -41,12 +48,12 @@ bool WriteFile(const std::string& filePath, std::vector<char>& buffer){
     // 以二进制进行写操作
     std::ofstream outFile(filePath, std::ofstream::binary);
     if(!outFile.is_open()){
-        std::cerr << "Failed to open file: " << filePath << std::endl;
+        LOG_ERROR("Failed to open file: " << filePath);
         return false;
     }
     outFile.write(buffer.data(), buffer.size());
     if(!outFile){
-        std::cerr << "Failed to write file: " << filePath << std::endl;
+        LOG_ERROR("Failed to write file: " << filePath);
         return false;
     }
     outFile.close();
@@ -55,30 +62,9 @@ bool WriteFile(const std::string& filePath, std::vector<char>& buffer){
 
 
 bool CopyFileBinary(const std::string& srcPath, const std::string& destPath){
-    // 以二进制进行文件读写
-    std::ifstream inFile(srcPath, std::ios::binary); 
-    // 检查文件是否打开成功
-    if(!inFile.is_open()){
-        std::cerr << "Failed to open file: " << srcPath << std::endl;
-        return false;
-    }
-    // 获取文件大小
-    inFile.seekg(0, std::ifstream::end);   // 移动到文件末尾
-    std::streampos fileSize = inFile.tellg();   // 获取文件大小（当前指针的位置）
-    inFile.seekg(0);               // 移动回文件开头
-    // 读取文件内容
-    std::vector<char> buffer(fileSize);
-    if(!inFile.read(buffer.data(), fileSize)){  //  后续可以设置分块读取以防止文件过大导致内存不足
-        std::cerr << "Failed to read file: " << srcPath << std::endl;
-        return false;
-    }
-    inFile.close();
-    // 写入文件内容
-    if(!WriteFile(destPath, buffer)){
-        std::cerr << "Failed to write file: " << destPath << std::endl;
-        return false;
-    }
-    return true;
+    // 交给拷贝引擎：优先引用拷贝/内核态拷贝，内存占用与文件大小无关
+    CCopyEngine engine;
+    return engine.copyFile(srcPath, destPath);
 }
 
 // 收集需要备份的文件列表
@@ -103,6 +89,13 @@ std::vector<std::string> collectFilesToBackup(const std::string& rootPath, const
                  it != fs::directory_iterator(); ++it) {
                 const auto& p = *it;
                 const std::string pathStr = p.path().string();
+
+                // 未开启跟随符号链接时，链接作为链接本身备份，不进入其指向的目录（避免重复与环）
+                std::error_code linkEc;
+                if (!config->isFollowSymlinks() && p.is_symlink(linkEc)) {
+                    filesList.push_back(pathStr);
+                    continue;
+                }
                 
                 // 递归调用，继续先根遍历
                 std::vector<std::string> subFiles = collectFilesToBackup(pathStr, config);
@@ -124,8 +117,235 @@ std::vector<std::string> collectFilesToBackup(const std::string& rootPath, const
     return filesList;
 }
 
+// 根据源根路径得到前缀基础名（文件名或目录名）
+static std::string sourceBaseName(const std::string& rootPath) {
+    fs::path p = fs::path(rootPath).lexically_normal();
+    std::string name = p.filename().string();
+    if (name.empty() || name == "." || name == "..") {
+        // 形如 "dir/" 的路径，filename 为空，取上一级
+        name = p.parent_path().filename().string();
+    }
+    return name.empty() ? "source" : name;
+}
+
+// 并发遍历多个源根
+std::vector<PackSource> collectSourcesToBackup(const std::vector<std::string>& rootPaths, const std::shared_ptr<CConfig>& config) {
+    std::vector<PackSource> sources(rootPaths.size());
+
+    // 分配前缀：默认使用源的名字，重名时追加序号
+    std::set<std::string> usedPrefixes;
+    for (size_t i = 0; i < rootPaths.size(); ++i) {
+        const std::string base = sourceBaseName(rootPaths[i]);
+        std::string prefix = base;
+        for (int n = 2; usedPrefixes.count(prefix); ++n) {
+            prefix = base + "_" + std::to_string(n);
+        }
+        usedPrefixes.insert(prefix);
+        sources[i].rootPath = rootPaths[i];
+        sources[i].prefix = prefix;
+    }
+
+    // 按配置的线程数并发遍历各个源
+    const size_t workerCount = std::min<size_t>(rootPaths.size(), config ? config->getThreadCount() : 1);
+    std::atomic<size_t> next{0};
+    CMetrics* metrics = CMetrics::current();
+    auto worker = [&]() {
+        // 工作线程需要重新绑定统计对象
+        CMetrics::Bind bindMetrics(metrics);
+        for (size_t i = next++; i < sources.size(); i = next++) {
+            CStageTimer walkTimer(Stage::Walk, metrics);
+            sources[i].files = collectFilesToBackup(sources[i].rootPath, config);
+            walkTimer.addFiles(sources[i].files.size());
+        }
+    };
+    std::vector<std::future<void>> tasks;
+    for (size_t t = 1; t < workerCount; ++t) {
+        tasks.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& task : tasks) {
+        task.get();
+    }
+    return sources;
+}
+
+
+// 找到目标根目录下最近一次的快照目录（快照名含时间戳，按名称排序即按时间排序）
+std::string findLatestSnapshot(const std::string& destinationRoot) {
+    std::string latest;
+    std::error_code ec;
+    for (fs::directory_iterator it(destinationRoot, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind(SNAPSHOT_DIR_PREFIX, 0) == 0 && it->is_directory(ec) && name > latest) {
+            latest = name;
+        }
+    }
+    return latest.empty() ? "" : (fs::path(destinationRoot) / latest).string();
+}
+
+// 生成新的快照目录名：snapshot_年月日_时分秒，同一秒内重复时追加序号
+static std::string makeSnapshotPath(const std::string& destinationRoot) {
+    std::time_t now = std::time(nullptr);
+    char timeBuffer[32];
+    std::strftime(timeBuffer, sizeof(timeBuffer), "%Y%m%d_%H%M%S", std::localtime(&now));
+    const std::string base = (fs::path(destinationRoot) / (std::string(SNAPSHOT_DIR_PREFIX) + timeBuffer)).string();
+    std::string path = base;
+    for (int n = 2; fs::exists(path); ++n) {
+        path = base + "_" + std::to_string(n);
+    }
+    return path;
+}
+
+// 计算文件内容的CRC32
+static bool computeFileCrc32(const std::string& path, uint32_t& crc) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::vector<char> buffer(1 << 16);
+    uint32_t value = CRC32::getInitialValue();
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        const std::streamsize n = in.gcount();
+        for (std::streamsize i = 0; i < n; ++i) {
+            value = CRC32::update(value, static_cast<uint8_t>(buffer[i]));
+        }
+    }
+    crc = CRC32::finalize(value);
+    return !in.bad();
+}
+
+// 读取快照清单；不存在或无法解析时返回空对象
+static nlohmann::json loadSnapshotManifest(const fs::path& snapshotPath) {
+    nlohmann::json manifest = nlohmann::json::object();
+    std::ifstream in(snapshotPath / SNAPSHOT_MANIFEST_NAME);
+    if (in) {
+        try {
+            in >> manifest;
+        } catch (const std::exception& e) {
+            LOG_WARN("Warning: Ignoring unreadable snapshot manifest in " << snapshotPath.string() << ": " << e.what());
+            manifest = nlohmann::json::object();
+        }
+    }
+    return manifest;
+}
+
+// 差量基准的签名缓存路径：目标根目录/.delta_signatures/快照名/条目名.bksig
+static std::string deltaSignatureCachePath(const std::string& destinationRoot, const std::string& baseRef) {
+    return (fs::path(destinationRoot) / DELTA_SIGNATURE_DIR_NAME / (baseRef + CDeltaEngine::kSignatureExtension)).string();
+}
+
+// 由基准版本与差量重建 target（差量文件为 target + .bkdelta），完成后删除差量文件并恢复修改时间
+static bool rebuildDeltaEntry(const fs::path& baseRoot, const fs::path& target, const nlohmann::json& item) {
+    const std::string deltaPath = target.string() + CDeltaEngine::kDeltaExtension;
+    const fs::path basePath = baseRoot / item["delta"].get<std::string>();
+    if (!CDeltaEngine::applyDelta(basePath.string(), deltaPath, target.string())) {
+        return false;
+    }
+    fs::remove(deltaPath);
+    if (item.contains("mtime")) {
+        fs::last_write_time(target, fs::file_time_type(fs::file_time_type::duration(item["mtime"].get<int64_t>())));
+    }
+    return true;
+}
+
+// 删除快照前调用：其他快照中以该快照内文件为基准的差量条目重建为完整文件
+bool detachSnapshotDeltas(const std::string& destinationRoot, const std::string& snapshotName) {
+    const std::string prefix = snapshotName + "/";
+    std::error_code ec;
+    for (fs::directory_iterator it(destinationRoot, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.rfind(SNAPSHOT_DIR_PREFIX, 0) != 0 || name == snapshotName || !it->is_directory()) {
+            continue;
+        }
+        nlohmann::json manifest = loadSnapshotManifest(it->path());
+        bool modified = false;
+        for (auto& [entryName, item] : manifest.items()) {
+            if (!item.contains("delta") || item["delta"].get<std::string>().rfind(prefix, 0) != 0) {
+                continue;
+            }
+            try {
+                if (!rebuildDeltaEntry(destinationRoot, it->path() / entryName, item)) {
+                    LOG_ERROR("Error: Failed to rebuild " << entryName << " in " << name << " from its delta");
+                    return false;
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Error rebuilding " << entryName << " in " << name << ": " << e.what());
+                return false;
+            }
+            item.erase("delta");
+            modified = true;
+        }
+        if (modified) {
+            std::ofstream manifestFile(it->path() / SNAPSHOT_MANIFEST_NAME);
+            manifestFile << manifest.dump(1);
+            if (!manifestFile) {
+                LOG_ERROR("Error: Failed to write snapshot manifest in " << it->path().string());
+                return false;
+            }
+            LOG_INFO("Rebuilt delta entries in " << name << " that depended on " << snapshotName);
+        }
+    }
+    fs::remove_all(fs::path(destinationRoot) / DELTA_SIGNATURE_DIR_NAME / snapshotName, ec);
+    return true;
+}
+
+// 把目录形式的备份复制回 destDir（跳过快照清单），差量条目由基准版本重建
+static bool restoreDirectoryBackup(const fs::path& backupPath, const std::string& destDir) {
+    try {
+        fs::create_directories(destDir);
+        for (const auto& item : fs::directory_iterator(backupPath)) {
+            if (item.path().filename() == SNAPSHOT_MANIFEST_NAME) {
+                continue;
+            }
+            const fs::path target = fs::path(destDir) / item.path().filename();
+            if (item.is_directory()) {
+                fs::copy(item.path(), target, fs::copy_options::recursive | fs::copy_options::overwrite_existing);
+            } else {
+                fs::copy_file(item.path(), target, fs::copy_options::overwrite_existing);
+            }
+        }
+        const nlohmann::json manifest = loadSnapshotManifest(backupPath);
+        for (const auto& [entryName, item] : manifest.items()) {
+            const fs::path target = fs::path(destDir) / entryName;
+            if (!item.contains("delta")) {
+                continue;
+            }
+            if (!fs::exists(target.string() + CDeltaEngine::kDeltaExtension)) {
+                LOG_ERROR("Error: Delta file of " << entryName << " is missing in " << backupPath.string());
+                return false;
+            }
+            if (!rebuildDeltaEntry(backupPath.parent_path(), target, item)) {
+                LOG_ERROR("Error: Failed to rebuild " << entryName << " from its delta");
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error restoring directory backup: " << e.what());
+        return false;
+    }
+    return true;
+}
+
+
+// 归档旁有校验文件时，还原前先修复损坏的分片；无法修复时仍继续还原，由解包跳过损坏的条目
+static void repairFromParity(const fs::path& backupPath) {
+    std::error_code ec;
+    const std::string path = backupPath.string();
+    if (!fs::is_regular_file(backupPath, ec) || !fs::exists(CParityFile::parityPath(path), ec)) {
+        return;
+    }
+    ParityReport report;
+    if (!CParityFile::repair(path, &report)) {
+        LOG_WARN("Warning: " << path << " could not be fully repaired, restoring what is intact.");
+    }
+}
 
 bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
+    if (metrics->isEnabled()) {
+        metrics->reset();
+    }
+    CMetrics::Bind bindMetrics(metrics.get());
     // 基础恢复：
     // - 若是打包：调用解包器（此处保留输出提示，具体实现按打包器完成）
     // - 若非打包：从备份目录将文件按原始相对路径复制回去
@@ -134,6 +354,7 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
     std::string backupName = entry.backupFileName; // 记录中的备份文件名或相对路径
 
     const fs::path backupPath = fs::path(backupRoot) / backupName;  
+    repairFromParity(backupPath);
     // 删除的话保留最初的备份文件，形成的中间文件都被删掉
     bool isDecrypted = false;
     bool isDecompressed = false;
@@ -141,24 +362,26 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
     // 先解密
     EncryptFactory encryptFactory;
     if(encryptFactory.isFileEncrypted(backupRoot + "/" + backupName)){
-        std::cout << "Decrypting file:" << backupName << std::endl;
+        LOG_INFO("Decrypting file:" << backupName);
 
         // 向用户请求密码
         std::string password;
+        // 先写出排队中的日志，避免与提示交错
+        CLogger::instance().flush();
         std::cout << "Enter password for decrypting file " << backupName << ": ";
         std::cin >> password;
 
         // 创建对应类型加密器
         std::string encryptType = encryptFactory.getEncryptType(backupRoot + "/" + backupName);
         if(encryptType.empty()){
-            std::cerr << "Error: Unknown encrypt type for file: " << backupName << std::endl;
+            LOG_ERROR("Error: Unknown encrypt type for file: " << backupName);
             return false;
         }
         std::unique_ptr<IEncrypt> decryptor = nullptr;
         try {
             decryptor = encryptFactory.createEncryptor(encryptType);
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create decryptor: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create decryptor: " << e.what());
             return false;
         }
         // 解密到备份目录
@@ -167,7 +390,7 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
         // 将后缀去除
         backupName = backupName.substr(0, backupName.find_last_of('.'));
         if (!decryptor->decryptFile(sourcePath, backupRoot + "/" + backupName, password)) {
-            std::cerr << "Error: Failed to decrypt file: " << backupName << std::endl;
+            LOG_ERROR("Error: Failed to decrypt file: " << backupName);
             return false;
         }
         isDecrypted = true;
@@ -176,18 +399,18 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
     // 再解压缩
     CompressFactory compressFactory;
     if(compressFactory.isCompressedFile(backupRoot + "/" + backupName)){
-        std::cout << "Decompressing file:" << backupName << std::endl;
+        LOG_INFO("Decompressing file:" << backupName);
         // 创建对应类压缩器
         std::string decompressType = compressFactory.getCompressType(backupRoot + "/" + backupName);
         if(decompressType.empty()){
-            std::cerr << "Error: Unknown compress type for file: " << backupName << std::endl;
+            LOG_ERROR("Error: Unknown compress type for file: " << backupName);
             return false;
         }
         std::unique_ptr<ICompress> decompressor = nullptr;
         try {
             decompressor = compressFactory.createCompress(decompressType);
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create decompressor: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create decompressor: " << e.what());
             return false;
         }
         // 解压缩到备份目录
@@ -196,13 +419,13 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
         // 将后缀去除
         backupName = backupName.substr(0, backupName.find_last_of('.'));
         if (!decompressor->decompressFile(sourcePath, backupRoot + "/" + backupName)) {
-            std::cerr << "Error: Failed to decompress file: " << backupName << std::endl;
+            LOG_ERROR("Error: Failed to decompress file: " << backupName);
             return false;
         }
         // 解压完成了，如果之前有解密过，那就删除解密后的文件
         if(isDecrypted){
             if(!fs::remove(sourcePath)){
-                std::cerr << "Error: Failed to remove compressed file: " << sourcePath << std::endl;
+                LOG_ERROR("Error: Failed to remove compressed file: " << sourcePath);
                 return false;
             }
         }
@@ -213,29 +436,29 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
     // 最后解包
     PackFactory packFactory;
     if (packFactory.isPackedFile(backupRoot + "/" + backupName)) {
-        std::cout << "Unpacking file: " << backupName << std::endl;
+        LOG_INFO("Unpacking file: " << backupName);
         // 创建对应类型打包器
         std::string packType = packFactory.getPackType(backupRoot + "/" + backupName);
         if(packType.empty()){
-            std::cerr << "Error: Unknown pack type for file: " << backupName << std::endl;
+            LOG_ERROR("Error: Unknown pack type for file: " << backupName);
             return false;
         }
         std::unique_ptr<IPack> packer = nullptr;
         try {
             packer = PackFactory::createPacker(packType);
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create packer: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create packer: " << e.what());
             return false;
         }
         // 解包到源文件目录
         if (!packer->unpack(backupRoot + "/" + backupName, destDir)) {
-            std::cerr << "Error: Failed to unpack file: " << backupName << std::endl;
+            LOG_ERROR("Error: Failed to unpack file: " << backupName);
             return false;
         }
         // 解包完成了，如果之前有解密过或者压缩过，那就删除解密后的文件或者压缩后的文件
         if(isDecompressed || isDecrypted){
             if(!fs::remove(backupRoot + "/" + backupName)){
-                std::cerr << "Error: Failed to remove packed file: " << backupRoot + "/" + backupName << std::endl;
+                LOG_ERROR("Error: Failed to remove packed file: " << backupRoot + "/" + backupName);
                 return false;
             }
         }
@@ -249,19 +472,23 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
     try {
         fs::create_directories(restorePath.parent_path());
     } catch (const std::exception& e) {
-        std::cerr << "Error creating directory for restore: " << e.what() << std::endl;
+        LOG_ERROR("Error creating directory for restore: " << e.what());
         return false;
     }
 
     // 直接复制文件
     try {
         if (!fs::exists(backupPath)) {
-            std::cerr << "Error: backup file not found: " << backupPath.string() << std::endl;
+            LOG_ERROR("Error: backup file not found: " << backupPath.string());
             return false;
         }
+        if (fs::is_directory(backupPath)) {
+            // 目录形式的备份（快照）：按原结构复制回 destDir
+            return restoreDirectoryBackup(backupPath, destDir);
+        }
         fs::copy_file(backupPath, restorePath, fs::copy_options::overwrite_existing);
     } catch (const std::exception& e) {
-        std::cerr << "Error restoring file: " << e.what() << std::endl;
+        LOG_ERROR("Error restoring file: " << e.what());
         return false;
     }
 
@@ -270,6 +497,10 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir) {
 
 // 带密码参数的重载版本（用于GUI）
 bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, const std::string& password) {
+    if (metrics->isEnabled()) {
+        metrics->reset();
+    }
+    CMetrics::Bind bindMetrics(metrics.get());
     // 基础恢复：
     // - 若是打包：调用解包器（此处保留输出提示，具体实现按打包器完成）
     // - 若非打包：从备份目录将文件按原始相对路径复制回去
@@ -278,6 +509,7 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
     std::string backupName = entry.backupFileName; // 记录中的备份文件名或相对路径
 
     const fs::path backupPath = fs::path(backupRoot) / backupName;  
+    repairFromParity(backupPath);
     // 删除的话保留最初的备份文件，形成的中间文件都被删掉
     bool isDecrypted = false;
     bool isDecompressed = false;
@@ -285,25 +517,25 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
     // 先解密
     EncryptFactory encryptFactory;
     if(encryptFactory.isFileEncrypted(backupRoot + "/" + backupName)){
-        std::cout << "Decrypting file:" << backupName << std::endl;
+        LOG_INFO("Decrypting file:" << backupName);
 
         // 使用提供的密码
         if(password.empty()){
-            std::cerr << "Error: Password is required for encrypted file" << std::endl;
+            LOG_ERROR("Error: Password is required for encrypted file");
             return false;
         }
 
         // 创建对应类型加密器
         std::string encryptType = encryptFactory.getEncryptType(backupRoot + "/" + backupName);
         if(encryptType.empty()){
-            std::cerr << "Error: Unknown encrypt type for file: " << backupName << std::endl;
+            LOG_ERROR("Error: Unknown encrypt type for file: " << backupName);
             return false;
         }
         std::unique_ptr<IEncrypt> decryptor = nullptr;
         try {
             decryptor = encryptFactory.createEncryptor(encryptType);
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create decryptor: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create decryptor: " << e.what());
             return false;
         }
         // 解密到备份目录
@@ -312,7 +544,7 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
         // 将后缀去除
         backupName = backupName.substr(0, backupName.find_last_of('.'));
         if (!decryptor->decryptFile(sourcePath, backupRoot + "/" + backupName, password)) {
-            std::cerr << "Error: Failed to decrypt file: " << backupName << std::endl;
+            LOG_ERROR("Error: Failed to decrypt file: " << backupName);
             return false;
         }
         isDecrypted = true;
@@ -321,18 +553,18 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
     // 再解压缩
     CompressFactory compressFactory;
     if(compressFactory.isCompressedFile(backupRoot + "/" + backupName)){
-        std::cout << "Decompressing file:" << backupName << std::endl;
+        LOG_INFO("Decompressing file:" << backupName);
         // 创建对应类型打包器
         std::string decompressType = compressFactory.getCompressType(backupRoot + "/" + backupName);
         if(decompressType.empty()){
-            std::cerr << "Error: Unknown compress type for file: " << backupName << std::endl;
+            LOG_ERROR("Error: Unknown compress type for file: " << backupName);
             return false;
         }
         std::unique_ptr<ICompress> decompressor = nullptr;
         try {
             decompressor = compressFactory.createCompress(decompressType);
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create decompressor: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create decompressor: " << e.what());
             return false;
         }
         // 解压缩到备份目录
@@ -341,13 +573,13 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
         // 将后缀去除
         backupName = backupName.substr(0, backupName.find_last_of('.'));
         if (!decompressor->decompressFile(sourcePath, backupRoot + "/" + backupName)) {
-            std::cerr << "Error: Failed to decompress file: " << backupName << std::endl;
+            LOG_ERROR("Error: Failed to decompress file: " << backupName);
             return false;
         }
         // 解压完成了，如果之前有解密过，那就删除解密后的文件
         if(isDecrypted){
             if(!fs::remove(sourcePath)){
-                std::cerr << "Error: Failed to remove compressed file: " << sourcePath << std::endl;
+                LOG_ERROR("Error: Failed to remove compressed file: " << sourcePath);
                 return false;
             }
         }
@@ -358,29 +590,29 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
     // 最后解包
     PackFactory packFactory;
     if (packFactory.isPackedFile(backupRoot + "/" + backupName)) {
-        std::cout << "Unpacking file: " << backupName << std::endl;
+        LOG_INFO("Unpacking file: " << backupName);
         // 创建对应类型打包器
         std::string packType = packFactory.getPackType(backupRoot + "/" + backupName);
         if(packType.empty()){
-            std::cerr << "Error: Unknown pack type for file: " << backupName << std::endl;
+            LOG_ERROR("Error: Unknown pack type for file: " << backupName);
             return false;
         }
         std::unique_ptr<IPack> packer = nullptr;
         try {
             packer = PackFactory::createPacker(packType);
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create packer: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create packer: " << e.what());
             return false;
         }
         // 解包到源文件目录
         if (!packer->unpack(backupRoot + "/" + backupName, destDir)) {
-            std::cerr << "Error: Failed to unpack file: " << backupName << std::endl;
+            LOG_ERROR("Error: Failed to unpack file: " << backupName);
             return false;
         }
         // 解包完成了，如果之前有解密过或者压缩过，那就删除解密后的文件或者压缩后的文件
         if(isDecompressed || isDecrypted){
             if(!fs::remove(backupRoot + "/" + backupName)){
-                std::cerr << "Error: Failed to remove packed file: " << backupRoot + "/" + backupName << std::endl;
+                LOG_ERROR("Error: Failed to remove packed file: " << backupRoot + "/" + backupName);
                 return false;
             }
         }
@@ -394,19 +626,23 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
     try {
         fs::create_directories(restorePath.parent_path());
     } catch (const std::exception& e) {
-        std::cerr << "Error creating directory for restore: " << e.what() << std::endl;
+        LOG_ERROR("Error creating directory for restore: " << e.what());
         return false;
     }
 
     // 直接复制文件
     try {
         if (!fs::exists(backupPath)) {
-            std::cerr << "Error: backup file not found: " << backupPath.string() << std::endl;
+            LOG_ERROR("Error: backup file not found: " << backupPath.string());
             return false;
         }
+        if (fs::is_directory(backupPath)) {
+            // 目录形式的备份（快照）：按原结构复制回 destDir
+            return restoreDirectoryBackup(backupPath, destDir);
+        }
         fs::copy_file(backupPath, restorePath, fs::copy_options::overwrite_existing);
     } catch (const std::exception& e) {
-        std::cerr << "Error restoring file: " << e.what() << std::endl;
+        LOG_ERROR("Error restoring file: " << e.what());
         return false;
     }
 
@@ -415,36 +651,64 @@ bool CBackup::doRecovery(const BackupEntry& entry, const std::string& destDir, c
 
 
 std::string CBackup::doBackup(const std::shared_ptr<CConfig>& config) {
+    if (config && config->isMetricsEnabled()) {
+        metrics->setEnabled(true);
+    }
+    if (metrics->isEnabled()) {
+        metrics->reset();
+    }
+
+    std::string destPath;
+    {
+        CMetrics::Bind bindMetrics(metrics.get());
+        destPath = runBackup(config);
+    }
+
+    // 任务结束，输出统计报告
+    if (metrics->isEnabled() && config && !config->getMetricsReportPath().empty()) {
+        std::ofstream report(config->getMetricsReportPath());
+        if (!report) {
+            LOG_ERROR("Error: Failed to write metrics report: " << config->getMetricsReportPath());
+        } else {
+            report << metrics->toJson() << std::endl;
+        }
+    }
+    return destPath;
+}
+
+std::string CBackup::runBackup(const std::shared_ptr<CConfig>& config) {
     // 1) 基础校验
     if (!config || !config->isValid()) {
-        std::cerr << "Error: Invalid backup configuration" << std::endl;
+        LOG_ERROR("Error: Invalid backup configuration");
         return "";
     }
 
-    // 2) 准备源集合（优先单源路径，如为空再尝试多源路径）
+    // 2) 准备源集合（单源路径与多源路径合并，去除重复）
     std::vector<std::string> sourceRoots;
     if (!config->getSourcePath().empty()) {
         sourceRoots.push_back(config->getSourcePath());
-    } else {
-        for (const auto& p : config->getSourcePaths()) {
+    }
+    for (const auto& p : config->getSourcePaths()) {
+        if (std::find(sourceRoots.begin(), sourceRoots.end(), p) == sourceRoots.end()) {
             sourceRoots.push_back(p);
         }
     }
     if (sourceRoots.empty()) {
-        std::cerr << "Error: No source specified" << std::endl;
+        LOG_ERROR("Error: No source specified");
         return "";
     }
 
     // 3) 收集需要备份的条目（含目录与文件；目录用于创建结构，文件用于拷贝）
-    std::vector<std::string> filesToBackup;
+    //    多个源并发遍历，每个源存放在各自的前缀下
     std::string destPath;
+    const std::vector<PackSource> sources = collectSourcesToBackup(sourceRoots, config);
+    size_t fileCount = 0;
+    for (const auto& source : sources) {
+        fileCount += source.files.size();
+    }
 
-    // 理论上只需要设计一个源就好，这个是之前的设计漏洞，后面改进一下
-    // TODO
-    filesToBackup = collectFilesToBackup(sourceRoots[0], config);
-
-    if (filesToBackup.empty()) {
-        std::cerr << "Error: No files to backup" << std::endl;
+    if (fileCount == 0) {
+        LOG_ERROR("Error: No files to backup");
         return "";
     }
 
@@ -453,130 +717,577 @@ std::string CBackup::doBackup(const std::shared_ptr<CConfig>& config) {
     try {
         fs::create_directories(destinationRoot);
     } catch (const std::exception& e) {
-        std::cerr << "Error: Failed to create destination root: " << e.what() << std::endl;
+        LOG_ERROR("Error: Failed to create destination root: " << e.what());
         return "";
     }
 
     // 5) 是否打包（基础版：若未启用打包，则直接镜像拷贝；启用打包则调用打包器）
     if (config->isPackingEnabled()) {
-        std::cout << "Packing files: " << filesToBackup.size() << std::endl;
+        LOG_INFO("Packing files: " << fileCount);
         std::unique_ptr<IPack> packer = nullptr;
         try {
             packer = PackFactory::createPacker(config->getPackType());
         } catch (const std::exception& e) {
-            std::cerr << "Error: Failed to create packer: " << e.what() << std::endl;
+            LOG_ERROR("Error: Failed to create packer: " << e.what());
             return "";
         }
+        packer->setRateLimiter(rateLimiter);
+        packer->setDeduplicationEnabled(config->isDeduplicationEnabled());
+        packer->setFollowSymlinks(config->isFollowSymlinks());
+        packer->setThreadCount(config->getThreadCount());
+        // 压缩在包内按条目进行：每个文件单独选择算法，已经压缩过的数据原样存放
+        if (config->isCompressionEnabled()) {
+            packer->setEntryCompression(config->getCompressionType());
+            packer->setDictionaryEnabled(config->isDictionaryEnabled());
+            packer->setEntryFilters(config->getFilterChain());
+            packer->setAdaptiveCompression(config->isAdaptiveCompressionEnabled(), config->getCompressionLevel());
+        }
 
         // 基础实现：将收集的文件直接打包到目标目录下（由具体打包器决定扩展名）
         // 调用打包器打包文件
-        const std::string packedFilePath = packer->pack(filesToBackup, destinationRoot);
-        std::string compressedFilePath;
+        const std::string packedFilePath = packer->pack(sources, destinationRoot);
         destPath = packedFilePath;
         if (packedFilePath.empty()) {
-            std::cerr << "Error: Failed to pack files" << std::endl;
+            LOG_ERROR("Error: Failed to pack files");
             return "";
         }
 
-        // 5.1)  打包完判断是否需要压缩
-        if(config->isCompressionEnabled()){
-            std::cout << "Compressing file: " << packedFilePath << std::endl;
-            std::unique_ptr<ICompress> compress = nullptr;
-            try{
-                compress = CompressFactory::createCompress(config->getCompressionType());
-            } catch (const std::exception& e) {
-                std::cerr << "Error: Failed to create compress: " << e.what() << std::endl;
-                return "";
-            }
-            // 这个路径需要斟酌一下，或许增加一个后缀，总之是要将之前的文件给覆盖了
-            compressedFilePath = compress->compressFile(packedFilePath);
-            destPath = compressedFilePath;
-            std::cout << "Compressed file path: " << compressedFilePath << std::endl;
-            if(compressedFilePath.empty()){
-                std::cerr << "Error: Failed to compress file" << std::endl;
-                return "";
-            }
-            // 要是压缩成功的话就把之前的文件删掉
-            if(fs::exists(compressedFilePath)){
-                try{
-                    fs::remove(packedFilePath);
-                } catch (const std::exception& e) {
-                    std::cerr << "Error: Failed to remove packed file: " << e.what() << std::endl;
-                    return "";
-                }
-            }
-        }
-
-        // 5.2) 是否需要加密（这个应该是和压缩平行的，但是执行上需要在压缩后面）
+        // 5.1) 是否需要加密（压缩已经在打包时按条目完成）
         if(config->isEncryptionEnabled()){
-            std::cout << "Encrypting file: " << (compressedFilePath.empty() ? packedFilePath : compressedFilePath) << std::endl;
+            LOG_INFO("Encrypting file: " << packedFilePath);
             std::unique_ptr<IEncrypt> encrypt = nullptr;
             try{
                 encrypt = EncryptFactory::createEncryptor(config->getEncryptType());
             } catch (const std::exception& e) {
-                std::cerr << "Error: Failed to create encrypt: " << e.what() << std::endl;
+                LOG_ERROR("Error: Failed to create encrypt: " << e.what());
                 return "";
             }
             // 加密文件
-            const std::string encryptedFilePath = encrypt->encryptFile((compressedFilePath.empty() ? packedFilePath : compressedFilePath)
+            const std::string encryptedFilePath = encrypt->encryptFile(packedFilePath
                                                                         , config->getEncryptionKey());
             destPath = encryptedFilePath;
-            std::cout << "Encrypted file path: " << encryptedFilePath << std::endl;
+            LOG_INFO("Encrypted file path: " << encryptedFilePath);
             if(encryptedFilePath.empty()){
-                std::cerr << "Error: Failed to encrypt file" << std::endl;
+                LOG_ERROR("Error: Failed to encrypt file");
                 return "";
             }
             // 要是加密成功的话就把之前的文件删掉
             if(fs::exists(encryptedFilePath)){
                 try{
-                    fs::remove((compressedFilePath.empty() ? packedFilePath : compressedFilePath));
+                    fs::remove(packedFilePath);
                 } catch (const std::exception& e) {
-                    std::cerr << "Error: Failed to remove compressed file: " << e.what() << std::endl;
+                    LOG_ERROR("Error: Failed to remove packed file: " << e.what());
                     return "";
                 }
             }
         }
 
+        // 5.2) 是否为最终的归档生成纠删码校验文件
+        if (config->isParityEnabled() &&
+            CParityFile::create(destPath, config->getParityDataShards(), config->getParityShards()).empty()) {
+            LOG_ERROR("Error: Failed to create parity file for " << destPath);
+            return "";
+        }
+
         return destPath;
     }
 
-    // 6) 非打包路径：直接拷贝。若是目录，保持相对路径结构拷贝到 destinationRoot
+    // 6) 非打包路径：快照模式下生成新的快照目录，未变化的文件硬链接到上一次快照
+    if (config->isSnapshotEnabled()) {
+        return runSnapshotBackup(sources, config, destinationRoot);
+    }
+
+    //    否则直接拷贝。每个源保持相对路径结构拷贝到 destinationRoot/前缀 下
     destPath = destinationRoot;
-    for(const auto& root : sourceRoots){
-        const fs::path rootPath = fs::path(root).parent_path();
-        if (fs::exists(root)) {
-            // 遍历所有收集的条目
-            for (const auto& entry : filesToBackup) {
-                // 只处理以当前root为前缀的条目
-                if (entry.rfind(rootPath.string(), 0) == 0) {
-                    const std::string relativePath = fs::relative(entry, rootPath).string();
-                    // 为空，说明相对路径就是当前目录，直接以entry作为相对路径
-                    const std::string destinationPath = (relativePath.empty() ? 
-                                                        (fs::path(destinationRoot) / entry).string() : 
-                                                        (fs::path(destinationRoot) / relativePath).string());
-                    
-                    std::cout << "Copying " << entry << " to " << destinationPath << std::endl;
-                    std::cout << "Root:" << rootPath << std::endl;
-                    std::cout << "Relative Path:" << relativePath << std::endl;
-
-                    try {
-                        if (fs::is_directory(entry)) {
-                            // 确保目录存在
-                            fs::create_directories(destinationPath);
-                        } else if (fs::is_regular_file(entry)) {
-                            // 确保目标文件的父目录存在
-                            fs::create_directories(fs::path(destinationPath).parent_path());
-                            // 复制文件
-                            CopyFileBinary(entry, destinationPath);
-                        }
-                    } catch (const std::exception& e) {
-                        std::cerr << "Error processing " << entry << ": " << e.what() << std::endl;
-                        return "";
+    CCopyEngine copyEngine;
+    copyEngine.setRateLimiter(rateLimiter);
+    for (const auto& source : sources) {
+        const fs::path rootPath = source.rootPath;
+        // 遍历该源收集的条目
+        for (const auto& entry : source.files) {
+            std::string relativePath = fs::relative(entry, rootPath).string();
+            if (relativePath == ".") {
+                relativePath.clear();
+            }
+            // 为空，说明就是源根本身，直接存放在前缀下
+            const std::string destinationPath = (relativePath.empty() ?
+                                                (fs::path(destinationRoot) / source.prefix).string() :
+                                                (fs::path(destinationRoot) / source.prefix / relativePath).string());
+
+            LOG_DEBUG("Copying " << entry << " to " << destinationPath);
+            LOG_DEBUG("Root:" << rootPath);
+            LOG_DEBUG("Relative Path:" << relativePath);
+
+            try {
+                if (fs::is_directory(entry)) {
+                    // 确保目录存在
+                    fs::create_directories(destinationPath);
+                } else if (fs::is_regular_file(entry)) {
+                    CFileLatencyTimer fileTimer;
+                    CStageTimer copyTimer(Stage::Write);
+                    // 确保目标文件的父目录存在
+                    fs::create_directories(fs::path(destinationPath).parent_path());
+                    // 复制文件（拷贝引擎按块申请I/O额度）
+                    const uint64_t fileSize = fs::file_size(entry);
+                    if (copyEngine.copyFile(entry, destinationPath)) {
+                        copyTimer.addBytes(fileSize);
+                        copyTimer.addFiles();
                     }
                 }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Error processing " << entry << ": " << e.what());
+                return "";
             }
         }
     }
 
     return destPath;
 }
+
+// 以上一次快照中的版本为基准为 sourceFile 写出差量（destinationPath + .bkdelta）
+// 上一版本本身是差量时沿用它的基准，差量不会串成链；差量不划算或失败时返回false，由调用方完整拷贝
+static bool writeSnapshotDelta(const std::string& sourceFile, uint64_t fileSize, const nlohmann::json& previousManifest,
+                               const std::string& previous, const std::string& entryName,
+                               const std::string& destinationRoot, const fs::path& destinationPath, unsigned threads,
+                               std::string& baseRef, DeltaStats& stats) {
+    std::error_code ec;
+    const auto found = previousManifest.find(entryName);
+    if (found != previousManifest.end() && found->contains("delta")) {
+        baseRef = (*found)["delta"].get<std::string>();
+    } else if (fs::is_regular_file(fs::path(previous) / entryName, ec)) {
+        baseRef = (fs::path(previous).filename() / entryName).generic_string();
+    } else {
+        return false;
+    }
+
+    DeltaSignature signature;
+    const std::string basePath = (fs::path(destinationRoot) / baseRef).string();
+    if (!CDeltaEngine::loadOrComputeSignature(basePath, deltaSignatureCachePath(destinationRoot, baseRef), signature,
+                                              threads)) {
+        return false;
+    }
+    const std::string deltaPath = destinationPath.string() + CDeltaEngine::kDeltaExtension;
+    CStageTimer writeTimer(Stage::Write);
+    if (!CDeltaEngine::createDelta(sourceFile, signature, baseRef, deltaPath, &stats)) {
+        fs::remove(deltaPath, ec);
+        return false;
+    }
+    // 差量超过原文件一半时不如完整保存，完整版本也成为之后的新基准
+    if (stats.deltaSize > fileSize / 2) {
+        LOG_DEBUG("Delta for " << sourceFile << " is " << stats.deltaSize << " bytes, storing full copy instead");
+        fs::remove(deltaPath, ec);
+        return false;
+    }
+    writeTimer.addBytes(fileSize);
+    writeTimer.addFiles();
+    LOG_DEBUG("Stored " << sourceFile << " as delta against " << baseRef << ": " << stats.copiedBytes
+              << " byte(s) reused, " << stats.insertedBytes << " byte(s) new");
+    return true;
+}
+
+std::string CBackup::runSnapshotBackup(const std::vector<PackSource>& sources, const std::shared_ptr<CConfig>& config,
+                                       const std::string& destinationRoot) {
+    const bool compareHash = config->isSnapshotCompareHash();
+    const bool deltaEnabled = config->isDeltaEnabled();
+    const std::string previous = findLatestSnapshot(destinationRoot);
+
+    // 按内容比较、以及判断上一版本是否为差量时需要上一次快照的清单
+    const nlohmann::json previousManifest =
+        previous.empty() ? nlohmann::json::object() : loadSnapshotManifest(previous);
+
+    const std::string snapshotRoot = makeSnapshotPath(destinationRoot);
+    try {
+        fs::create_directories(snapshotRoot);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error: Failed to create snapshot directory: " << e.what());
+        return "";
+    }
+
+    CCopyEngine copyEngine;
+    copyEngine.setRateLimiter(rateLimiter);
+    nlohmann::json manifest = nlohmann::json::object();
+    size_t linkedCount = 0;
+    size_t copiedCount = 0;
+    size_t deltaCount = 0;
+    uint64_t deltaSavedBytes = 0;
+
+    for (const auto& source : sources) {
+        const fs::path rootPath = source.rootPath;
+        for (const auto& entry : source.files) {
+            std::string relativePath = fs::relative(entry, rootPath).string();
+            if (relativePath == ".") {
+                relativePath.clear();
+            }
+            // 快照内的条目名与镜像模式相同：前缀/相对路径
+            const std::string entryName = relativePath.empty() ?
+                fs::path(source.prefix).generic_string() :
+                (fs::path(source.prefix) / relativePath).generic_string();
+            const fs::path destinationPath = fs::path(snapshotRoot) / entryName;
+
+            try {
+                if (fs::is_directory(entry)) {
+                    fs::create_directories(destinationPath);
+                    continue;
+                }
+                if (!fs::is_regular_file(entry)) {
+                    continue;
+                }
+                CFileLatencyTimer fileTimer;
+                fs::create_directories(destinationPath.parent_path());
+
+                const uint64_t fileSize = fs::file_size(entry);
+                const fs::file_time_type mtime = fs::last_write_time(entry);
+                nlohmann::json item = {{"size", fileSize}, {"mtime", static_cast<int64_t>(mtime.time_since_epoch().count())}};
+                uint32_t crc = 0;
+                if (compareHash) {
+                    if (!computeFileCrc32(entry, crc)) {
+                        LOG_ERROR("Error: Failed to read " << entry);
+                        return "";
+                    }
+                    item["crc32"] = crc;
+                }
+
+                // 与上一次快照中的同名文件比较：大小、修改时间一致（以及校验值一致）则视为未变化
+                // 上一版本以差量保存时按清单中记录的大小与修改时间比较，并链接差量文件
+                bool unchanged = false;
+                fs::path previousPath;
+                fs::path linkPath = destinationPath;
+                const auto found = previousManifest.find(entryName);
+                const bool previousIsDelta = found != previousManifest.end() && found->contains("delta");
+                if (!previous.empty()) {
+                    std::error_code ec;
+                    previousPath = fs::path(previous) / entryName;
+                    if (previousIsDelta) {
+                        previousPath += CDeltaEngine::kDeltaExtension;
+                        linkPath += CDeltaEngine::kDeltaExtension;
+                        unchanged = fs::is_regular_file(previousPath, ec) &&
+                                    (*found)["size"].get<uint64_t>() == fileSize && item["mtime"] == (*found)["mtime"];
+                    } else {
+                        unchanged = fs::is_regular_file(previousPath, ec) &&
+                                    fs::file_size(previousPath, ec) == fileSize && !ec &&
+                                    fs::last_write_time(previousPath, ec) == mtime && !ec;
+                    }
+                    if (unchanged && compareHash) {
+                        unchanged = found != previousManifest.end() && found->contains("crc32") &&
+                                    (*found)["crc32"].get<uint32_t>() == crc;
+                    }
+                }
+
+                if (unchanged) {
+                    std::error_code ec;
+                    fs::create_hard_link(previousPath, linkPath, ec);
+                    if (!ec) {
+                        LOG_DEBUG("Linking " << entry << " to " << previousPath.string());
+                        if (previousIsDelta) {
+                            item["delta"] = (*found)["delta"];
+                        }
+                        manifest[entryName] = item;
+                        ++linkedCount;
+                        continue;
+                    }
+                    // 硬链接失败（跨设备、链接数上限等）时退回拷贝
+                    LOG_DEBUG("Hard link failed for " << linkPath.string() << ": " << ec.message());
+                }
+
+                // 变化的大文件以上一版本为基准只保存差量
+                if (deltaEnabled && !previous.empty() && fileSize >= config->getDeltaMinSize()) {
+                    std::string baseRef;
+                    DeltaStats stats;
+                    if (writeSnapshotDelta(entry, fileSize, previousManifest, previous, entryName, destinationRoot,
+                                           destinationPath, config->getThreadCount(), baseRef, stats)) {
+                        fs::last_write_time(destinationPath.string() + CDeltaEngine::kDeltaExtension, mtime);
+                        item["delta"] = baseRef;
+                        manifest[entryName] = item;
+                        ++deltaCount;
+                        deltaSavedBytes += fileSize - stats.deltaSize;
+                        continue;
+                    }
+                }
+
+                LOG_DEBUG("Copying " << entry << " to " << destinationPath.string());
+                CStageTimer copyTimer(Stage::Write);
+                if (!copyEngine.copyFile(entry, destinationPath.string())) {
+                    LOG_ERROR("Error: Failed to copy " << entry << " into snapshot");
+                    return "";
+                }
+                copyTimer.addBytes(fileSize);
+                copyTimer.addFiles();
+                // 保留修改时间，下一次快照据此判断文件是否变化
+                fs::last_write_time(destinationPath, mtime);
+                manifest[entryName] = item;
+                ++copiedCount;
+            } catch (const std::exception& e) {
+                LOG_ERROR("Error processing " << entry << ": " << e.what());
+                return "";
+            }
+        }
+    }
+
+    std::ofstream manifestFile(fs::path(snapshotRoot) / SNAPSHOT_MANIFEST_NAME);
+    if (!manifestFile) {
+        LOG_ERROR("Error: Failed to write snapshot manifest in " << snapshotRoot);
+        return "";
+    }
+    manifestFile << manifest.dump(1);
+
+    LOG_INFO("Snapshot " << snapshotRoot << ": " << copiedCount << " file(s) copied, " << linkedCount
+             << " file(s) linked" << (previous.empty() ? "" : " to " + previous));
+    if (deltaCount > 0) {
+        LOG_INFO("Snapshot " << snapshotRoot << ": " << deltaCount << " file(s) stored as deltas, "
+                 << deltaSavedBytes << " byte(s) saved");
+    }
+    return snapshotRoot;
+}
+
+
+// 读完流中剩余的数据，返回读取的字节数
+static uint64_t drainStream(std::istream& in) {
+    std::vector<char> buffer(1024 * 1024);
+    uint64_t total = 0;
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        total += static_cast<uint64_t>(in.gcount());
+    }
+    return total;
+}
+
+// 确认文件可以完整读出，返回读取的字节数
+static bool readWholeFile(const fs::path& path, uint64_t& bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    bytes = drainStream(in);
+    return !in.bad();
+}
+
+// 校验目录形式的备份（快照）：按清单核对每个文件的大小与 CRC32，差量条目只确认差量文件可读；
+// 没有清单时只确认每个文件都可以完整读出
+static bool verifyDirectoryBackup(const fs::path& backupPath, uint64_t& bytes) {
+    size_t damaged = 0;
+    const nlohmann::json manifest = loadSnapshotManifest(backupPath);
+    try {
+        if (manifest.empty()) {
+            for (const auto& item : fs::recursive_directory_iterator(backupPath)) {
+                uint64_t n = 0;
+                if (item.is_regular_file() && !readWholeFile(item.path(), n)) {
+                    LOG_ERROR("Error: Failed to read " << item.path().string());
+                    ++damaged;
+                }
+                bytes += n;
+            }
+        }
+        for (const auto& [entryName, item] : manifest.items()) {
+            const fs::path target = backupPath / entryName;
+            if (item.contains("delta")) {
+                uint64_t n = 0;
+                if (!readWholeFile(target.string() + CDeltaEngine::kDeltaExtension, n)) {
+                    LOG_ERROR("Error: Failed to read the delta of " << entryName << " in " << backupPath.string());
+                    ++damaged;
+                }
+                bytes += n;
+                continue;
+            }
+            std::error_code ec;
+            const uint64_t size = fs::file_size(target, ec);
+            const bool hasCrc = item.contains("crc32");
+            uint32_t crc = 0;
+            const bool readable = !ec && (!hasCrc || computeFileCrc32(target.string(), crc));
+            if (!readable || size != item["size"].get<uint64_t>() || (hasCrc && item["crc32"].get<uint32_t>() != crc)) {
+                LOG_ERROR("Error: " << entryName << " in " << backupPath.string() << " is missing or damaged.");
+                ++damaged;
+            }
+            bytes += readable ? size : 0;
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error verifying directory backup " << backupPath.string() << ": " << e.what());
+        return false;
+    }
+    return damaged == 0;
+}
+
+bool CBackup::doVerify(const BackupEntry& entry, const std::string& password, VerifyResult* result) {
+    if (metrics->isEnabled()) {
+        metrics->reset();
+    }
+    CMetrics::Bind bindMetrics(metrics.get());
+    VerifyResult local;
+    VerifyResult& target = result ? *result : local;
+    return runVerify(entry, password, target);
+}
+
+std::vector<VerifyResult> CBackup::verifyBackups(const std::vector<BackupEntry>& entries, const std::string& password,
+                                                 unsigned threads) {
+    if (metrics->isEnabled()) {
+        metrics->reset();
+    }
+    std::vector<VerifyResult> results(entries.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const auto start = std::chrono::steady_clock::now();
+    // 每个工作线程依次领取下一个备份；每个备份内部的各阶段另有各自的线程
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        CMetrics::Bind bindMetrics(metrics.get());
+        for (size_t i = next++; i < entries.size(); i = next++) {
+            runVerify(entries[i], password, results[i]);
+        }
+    };
+    std::vector<std::future<void>> workers;
+    for (size_t t = 1; t < std::min<size_t>(threads, entries.size()); ++t) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& task : workers) {
+        task.get();
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t totalBytes = 0;
+    size_t failed = 0;
+    for (const auto& result : results) {
+        totalBytes += result.bytes;
+        failed += result.ok ? 0 : 1;
+    }
+    LOG_INFO("Verified " << entries.size() << " backup(s), " << failed << " failed: " << totalBytes << " bytes in "
+             << seconds << " s (" << (seconds > 0 ? totalBytes / seconds / (1024 * 1024) : 0) << " MB/s)");
+    return results;
+}
+
+bool CBackup::runVerify(const BackupEntry& entry, const std::string& password, VerifyResult& result) {
+    const auto start = std::chrono::steady_clock::now();
+    const fs::path backupPath = fs::path(entry.destDirectory) / entry.backupFileName;
+    const std::string path = backupPath.string();
+    result = VerifyResult();
+    result.backupName = entry.backupFileName;
+
+    std::error_code ec;
+    if (!fs::exists(backupPath, ec)) {
+        LOG_ERROR("Error: backup file not found: " << path);
+    } else if (fs::is_directory(backupPath, ec)) {
+        result.ok = verifyDirectoryBackup(backupPath, result.bytes);
+    } else {
+        std::ifstream file(backupPath, std::ios::binary);
+        if (!file) {
+            LOG_ERROR("Error: Failed to open file " << path << " for reading.");
+        }
+        result.bytes = fs::file_size(backupPath, ec);
+
+        // 各层在各自的线程中按流处理，经内存管道相连：文件 -> 解密 -> 解压 -> 解包校验
+        std::vector<std::unique_ptr<CStreamPipe>> pipes;
+        std::vector<std::future<bool>> stages;
+        std::istream* stream = &file;
+        CMetrics* stageMetrics = metrics.get();
+        auto addStage = [&](std::function<bool(std::istream&, std::ostream&)> produce) {
+            CStreamPipe* input = pipes.empty() ? nullptr : pipes.back().get();
+            pipes.push_back(std::make_unique<CStreamPipe>());
+            CStreamPipe* output = pipes.back().get();
+            std::istream* source = stream;
+            stages.push_back(std::async(std::launch::async, [=]() {
+                CMetrics::Bind bindMetrics(stageMetrics);
+                const bool ok = produce(*source, output->writer());
+                output->closeWrite();
+                // 提前结束时丢弃上一阶段剩余的输出，避免其一直等待
+                if (input) input->closeRead();
+                return ok;
+            }));
+            stream = &output->reader();
+        };
+        // 当前层开头的两个字节为格式标志与类型，据此决定下一层
+        auto peekHeader = [&](uint8_t header[2]) {
+            char bytes[2] = {0, 0};
+            size_t n = 0;
+            if (pipes.empty()) {
+                file.read(bytes, sizeof(bytes));
+                n = static_cast<size_t>(file.gcount());
+                file.clear();
+                file.seekg(0, std::ios::beg);
+            } else {
+                n = pipes.back()->peek(bytes, sizeof(bytes));
+            }
+            header[0] = static_cast<uint8_t>(bytes[0]);
+            header[1] = static_cast<uint8_t>(bytes[1]);
+            return n == sizeof(bytes);
+        };
+
+        // 记录中标明的层必须存在，最内层必须是可识别的包，否则无法确认内容完好
+        bool ok = static_cast<bool>(file);
+        uint8_t header[2] = {0, 0};
+        bool hasHeader = ok && peekHeader(header);
+        if (ok && hasHeader && header[0] == 0x31) {
+            const std::string encryptType = EncryptFactory::encryptTypeToString(static_cast<EncryptType>(header[1]));
+            std::shared_ptr<IEncrypt> decryptor = EncryptFactory::createEncryptor(encryptType);
+            if (!decryptor || password.empty()) {
+                LOG_ERROR("Error: Cannot decrypt " << path << (password.empty() ? ": password is required." : "."));
+                ok = false;
+            } else {
+                addStage([decryptor, password, path](std::istream& in, std::ostream& out) {
+                    return decryptor->decryptStream(in, out, password, path);
+                });
+                hasHeader = peekHeader(header);
+            }
+        } else if (ok && entry.isEncrypted) {
+            LOG_ERROR("Error: " << path << " is recorded as encrypted but has no encryption header.");
+            ok = false;
+        }
+        std::string compressType;
+        if (ok && hasHeader && header[0] == 0x21) {
+            try {
+                compressType = CompressFactory::compressTypeToString(static_cast<CompressType>(header[1]));
+            } catch (const std::exception&) {
+                LOG_ERROR("Error: Unknown compress type in " << path << ".");
+                ok = false;
+            }
+        }
+        if (ok && !compressType.empty()) {
+            std::shared_ptr<ICompress> decompressor = CompressFactory::createCompress(compressType);
+            addStage([decompressor, path](std::istream& in, std::ostream& out) {
+                return decompressor->decompressStream(in, out, path);
+            });
+            hasHeader = peekHeader(header);
+        }
+        const bool isPack = hasHeader &&
+                            (header[0] == PACK_FORMAT_V1 || header[0] == PACK_FORMAT_V2 || header[0] == PACK_FORMAT_V3) &&
+                            header[1] == static_cast<uint8_t>(PackType::Basic);
+        if (ok && isPack) {
+            std::unique_ptr<IPack> packer = PackFactory::createPacker("Basic");
+            ok = packer->verify(*stream, path);
+        } else if (ok) {
+            LOG_ERROR("Error: " << path << (entry.isPacked ? " is recorded as packed but" : "")
+                      << " does not contain a recognized pack.");
+            ok = false;
+        }
+        // 读完剩余数据，各层的 CRC 在数据全部经过后才能确认
+        if (ok) {
+            drainStream(*stream);
+        }
+        if (!pipes.empty()) {
+            pipes.back()->closeRead();
+        }
+        for (auto& stage : stages) {
+            ok = stage.get() && ok;
+        }
+        if (file.bad()) {
+            LOG_ERROR("Error: Failed to read file " << path << ".");
+            ok = false;
+        }
+        result.ok = ok;
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double megabytes = result.bytes / (1024.0 * 1024.0);
+    if (result.ok) {
+        LOG_INFO("Verified " << path << ": OK, " << megabytes << " MB in " << result.seconds << " s ("
+                 << (result.seconds > 0 ? megabytes / result.seconds : 0) << " MB/s)");
+    } else {
+        LOG_ERROR("Error: Verification of " << path << " failed.");
+        // 有校验文件时报告能否在还原时修复
+        ParityReport report;
+        if (fs::is_regular_file(backupPath, ec) && fs::exists(CParityFile::parityPath(path), ec) &&
+            !CParityFile::check(path, report) && report.damagedShards > 0 && report.unrecoverableStripes == 0) {
+            LOG_INFO(path << " has " << report.damagedShards << " damaged shard(s), repairable from its parity file.");
+        }
+    }
+    return result.ok;
+}
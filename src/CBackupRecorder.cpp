@@ -1,4 +1,7 @@
 ﻿#include "CBackupRecorder.h"
+#include "CLogger.h"
+#include "CBackup.h"
+#include "CParityFile.h"
 #include <fstream>
 #include <algorithm>
 #include <iostream>
@@ -65,7 +68,7 @@ bool CBackupRecorder::loadBackupRecordsFromFile(const std::string& filePath){
         // 读取文件
         std::ifstream file(filePath);
         if(!file.is_open()){
-            std::cerr << "Error: Failed to open file " << filePath << " for reading." << std::endl;
+            LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
             return false;
         }
         nlohmann::json j;
@@ -73,6 +76,7 @@ bool CBackupRecorder::loadBackupRecordsFromFile(const std::string& filePath){
 
         // 将原先的记录清空
         backupRecords.clear();
+        ++revision;
 
         // 将json数据格式转换
         if(j.is_array()){
@@ -82,7 +86,7 @@ bool CBackupRecorder::loadBackupRecordsFromFile(const std::string& filePath){
         file.close();
         return true;
     }catch(const std::exception& e){
-        std::cerr << "Error: Failed to load backup records from file " << filePath << ". Exception: " << e.what() << std::endl;
+        LOG_ERROR("Error: Failed to load backup records from file " << filePath << ". Exception: " << e.what());
         return false;
     }
 }
@@ -93,7 +97,7 @@ bool CBackupRecorder::saveBackupRecordsToFile(const std::string& filePath){
         // 写入文件
         std::ofstream file(filePath);
         if(!file.is_open()){
-            std::cerr << "Error: Failed to open file " << filePath << " for writing." << std::endl;
+            LOG_ERROR("Error: Failed to open file " << filePath << " for writing.");
             return false;
         }
         nlohmann::json j = backupRecords;
@@ -101,7 +105,7 @@ bool CBackupRecorder::saveBackupRecordsToFile(const std::string& filePath){
         file.close();
         return true;
     }catch(const std::exception& e){
-        std::cerr << "Error: Failed to save backup records to file " << filePath << ". Exception: " << e.what() << std::endl;
+        LOG_ERROR("Error: Failed to save backup records to file " << filePath << ". Exception: " << e.what());
         return false;
     }
 }
@@ -109,6 +113,7 @@ bool CBackupRecorder::saveBackupRecordsToFile(const std::string& filePath){
 // 直接将条目添加进来
 void CBackupRecorder::addBackupRecord(const BackupEntry& entry){
     backupRecords.push_back(entry);
+    ++revision;
 }
 
 const std::vector<BackupEntry>& CBackupRecorder::getBackupRecords() const{
@@ -117,25 +122,46 @@ const std::vector<BackupEntry>& CBackupRecorder::getBackupRecords() const{
 
 std::vector<BackupEntry> CBackupRecorder::findBackupRecordsByFileName(const std::string& queryFileName) const{
     std::vector<BackupEntry> result;
-    for(const auto& entry : backupRecords){
-        // 支持模糊搜索：检查文件名是否包含查询字符串
-        if(entry.fileName.find(queryFileName) != std::string::npos){
-            result.push_back(entry);
-        }
+    for(size_t index : findBackupRecordIndicesByFileName(queryFileName)){
+        result.push_back(backupRecords[index]);
     }
     return result;
 }
 
 std::vector<BackupEntry> CBackupRecorder::findBackupRecordsByBackupTime(const std::string& startime, const std::string& endTime) const{
     std::vector<BackupEntry> result;
-    for(const auto& entry : backupRecords){
+    for(size_t index : findBackupRecordIndicesByBackupTime(startime, endTime)){
+        result.push_back(backupRecords[index]);
+    }
+    return result;
+}
+
+std::vector<size_t> CBackupRecorder::findBackupRecordIndicesByFileName(const std::string& queryFileName) const{
+    std::vector<size_t> result;
+    for(size_t i = 0; i < backupRecords.size(); ++i){
+        // 支持模糊搜索：检查文件名是否包含查询字符串
+        if(backupRecords[i].fileName.find(queryFileName) != std::string::npos){
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+std::vector<size_t> CBackupRecorder::findBackupRecordIndicesByBackupTime(const std::string& startime, const std::string& endTime) const{
+    std::vector<size_t> result;
+    for(size_t i = 0; i < backupRecords.size(); ++i){
+        const BackupEntry& entry = backupRecords[i];
         if(entry.backupTime >= startime && entry.backupTime <= endTime){
-            result.push_back(entry);
+            result.push_back(i);
         }
     }
     return result;
 }
 
+uint64_t CBackupRecorder::getRevision() const{
+    return revision;
+}
+
 // 检查索引是否有效
 bool CBackupRecorder::isIndexValid(size_t index) const{
     return index < backupRecords.size();
@@ -150,7 +176,7 @@ size_t CBackupRecorder::getBackupRecordIndex(const BackupEntry& entry) const{
     return std::string::npos;
 }
 
-// 删除备份文件或目录的辅助函数
+// 删除备份文件或目录的辅助函数；备份仍需保留（如快照还被差量引用）或删除出错时返回 false
 static bool deleteBackupFile(const BackupEntry& entry) {
     try {
         // 直接读取记录的目标路径递归删除
@@ -158,81 +184,103 @@ static bool deleteBackupFile(const BackupEntry& entry) {
         fs::path backupFilePath = backupDirPath / entry.backupFileName;
         
         bool deleted = false;
-        
+
+        // 快照备份：目标根目录下还有其他快照，只删除本次的快照目录
+        if (entry.backupFileName.rfind("snapshot_", 0) == 0 && fs::is_directory(backupFilePath)) {
+            // 其他快照可能以本快照中的文件为差量基准，先把它们重建为完整文件
+            if (!detachSnapshotDeltas(entry.destDirectory, entry.backupFileName)) {
+                LOG_ERROR("Error: Snapshot " << backupFilePath.string() << " is still referenced by deltas, not deleted");
+                return false;
+            }
+            fs::remove_all(backupFilePath);
+            LOG_INFO("Deleted snapshot directory: " << backupFilePath.string());
+            return true;
+        }
+
         // 首先尝试删除整个 destDirectory 目录（对于目录备份，这是整个备份的根目录）
         if (fs::exists(backupDirPath) && fs::is_directory(backupDirPath)) {
             // 递归删除整个目录
             fs::remove_all(backupDirPath);
-            std::cout << "Deleted backup directory (recursive): " << backupDirPath.string() << std::endl;
+            LOG_INFO("Deleted backup directory (recursive): " << backupDirPath.string());
             deleted = true;
         }
         // 如果 destDirectory 不存在或不是目录，尝试删除 backupFilePath（打包的文件）
         else if (fs::exists(backupFilePath)) {
             if (fs::is_directory(backupFilePath)) {
                 fs::remove_all(backupFilePath);
-                std::cout << "Deleted backup directory: " << backupFilePath.string() << std::endl;
+                LOG_INFO("Deleted backup directory: " << backupFilePath.string());
                 deleted = true;
             } else if (fs::is_regular_file(backupFilePath)) {
                 fs::remove(backupFilePath);
-                std::cout << "Deleted backup file: " << backupFilePath.string() << std::endl;
+                fs::remove(CParityFile::parityPath(backupFilePath.string()));
+                LOG_INFO("Deleted backup file: " << backupFilePath.string());
                 deleted = true;
             } else {
                 fs::remove(backupFilePath);
-                std::cout << "Deleted backup item: " << backupFilePath.string() << std::endl;
+                LOG_INFO("Deleted backup item: " << backupFilePath.string());
                 deleted = true;
             }
         }
         
+        // 备份文件已经不存在时没有可删除的内容，记录照常删除
         if (!deleted) {
-            std::cerr << "Warning: Backup file/directory not found: " << backupDirPath.string() 
-                      << " or " << backupFilePath.string() << std::endl;
-            return false;
+            LOG_WARN("Warning: Backup file/directory not found: " << backupDirPath.string()
+                     << " or " << backupFilePath.string());
         }
         
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "Error deleting backup file: " << e.what() << std::endl;
+        LOG_ERROR("Error deleting backup file: " << e.what());
         return false;
     }
 }
 
 bool CBackupRecorder::deleteBackupRecord(size_t index){
     if(!isIndexValid(index)){
-        std::cerr << "Error: Invalid index " << index << " for deleting backup record." << std::endl;
+        LOG_ERROR("Error: Invalid index " << index << " for deleting backup record.");
         return false;
     }
     
     // 在删除记录前，先删除对应的备份文件
     const BackupEntry& entry = backupRecords[index];
-    deleteBackupFile(entry);
+    if (!deleteBackupFile(entry)) {
+        // 备份仍在磁盘上，保留记录以便重试或还原
+        return false;
+    }
     
     // 删除记录
     backupRecords.erase(backupRecords.begin() + index);
+    ++revision;
     return true;
 }
 
 bool CBackupRecorder::deleteBackupRecord(const BackupEntry& entry){
     size_t index = getBackupRecordIndex(entry);
     if(index == std::string::npos){
-        std::cerr << "Error: Backup record not found for deletion." << std::endl;
+        LOG_ERROR("Error: Backup record not found for deletion.");
         return false;
     }
     
     // 在删除记录前，先删除对应的备份文件（使用实际记录）
     const BackupEntry& actualEntry = backupRecords[index];
-    deleteBackupFile(actualEntry);
+    if (!deleteBackupFile(actualEntry)) {
+        // 备份仍在磁盘上，保留记录以便重试或还原
+        return false;
+    }
     
     // 删除记录
     backupRecords.erase(backupRecords.begin() + index);
+    ++revision;
     return true;
 }
 
 bool CBackupRecorder::modifyBackupRecord(size_t index, const BackupEntry& newEntry){
     if(isIndexValid(index)){
         backupRecords[index] = newEntry;
+        ++revision;
         return true;
     }
-    std::cerr << "Error: Invalid index " << index << " for modifying backup record." << std::endl;
+    LOG_ERROR("Error: Invalid index " << index << " for modifying backup record.");
     return false;
 }
 
@@ -241,7 +289,7 @@ bool CBackupRecorder::modifyBackupRecord(const BackupEntry& oldEntry, const Back
     if(index != std::string::npos){
         return modifyBackupRecord(index, newEntry);
     }
-    std::cerr << "Error: Backup record not found for modification." << std::endl;
+    LOG_ERROR("Error: Backup record not found for modification.");
     return false;
 }
 
@@ -255,6 +303,12 @@ void CBackupRecorder::addBackupRecord(const std::shared_ptr<CConfig>& config, co
     std::string sourcePath = config->getSourcePath();
     // 文件名就是绝对路径的文件名
     std::string fileName = fs::path(sourcePath).filename().string();
+    // 多源备份：记录所有源，文件名用逗号连接，完整路径用分号连接
+    for(const auto& path : config->getSourcePaths()){
+        if(path == config->getSourcePath()) continue;
+        fileName += (fileName.empty() ? "" : ", ") + fs::path(path).filename().string();
+        sourcePath += (sourcePath.empty() ? "" : ";") + path;
+    }
     // 完整的目标路径
     std::string destDir = config->getDestinationPath();
     // 最后备份的文件名通过destPath得到
@@ -272,6 +326,7 @@ void CBackupRecorder::addBackupRecord(const std::shared_ptr<CConfig>& config, co
     entry = BackupEntry(fileName, sourcePath, destDir, backupFileName, backupTime, isEncrypted, isPacked, isCompressed);
     // 增加备份记录
     backupRecords.push_back(entry);
+    ++revision;
 }
 
 
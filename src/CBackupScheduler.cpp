@@ -0,0 +1,165 @@
+#include "CBackupScheduler.h"
+#include "CLogger.h"
+#include "CBackup.h"
+#include <algorithm>
+#include <iostream>
+
+CBackupScheduler::CBackupScheduler(unsigned maxThreads, uint64_t maxIoBytesPerSec, uint64_t maxMemoryBytes)
+    : m_maxThreads(maxThreads == 0 ? 1 : maxThreads),
+      m_maxMemoryBytes(maxMemoryBytes),
+      m_globalLimiter(std::make_shared<CRateLimiter>(maxIoBytesPerSec)) {
+}
+
+CBackupScheduler::~CBackupScheduler() {
+    // 等待仍在执行的任务结束
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t CBackupScheduler::submit(const BackupJob& job) {
+    if (!job.config) {
+        throw std::invalid_argument("Backup job config cannot be null");
+    }
+    PendingJob pending{0, job};
+    // 深拷贝配置，避免调用方后续修改影响任务
+    pending.job.config = job.config->clone();
+    // 单个任务的线程数不能超过全局额度，否则永远无法启动
+    pending.job.threads = std::max(1u, std::min(job.threads, m_maxThreads));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    pending.id = m_results.size();
+    JobResult result;
+    result.jobId = pending.id;
+    m_results.push_back(result);
+    m_pending.push_back(std::move(pending));
+    m_cv.notify_all();
+    return m_results.back().jobId;
+}
+
+void CBackupScheduler::setRecorder(CBackupRecorder* recorder) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_recorder = recorder;
+}
+
+bool CBackupScheduler::runsBefore(const PendingJob& a, const PendingJob& b) {
+    if (a.job.deadline != b.job.deadline) return a.job.deadline < b.job.deadline;
+    if (a.job.priority != b.job.priority) return a.job.priority > b.job.priority;
+    return a.id < b.id;
+}
+
+bool CBackupScheduler::hasCapacity(const BackupJob& job) const {
+    if (m_usedThreads + job.threads > m_maxThreads) {
+        return false;
+    }
+    // 内存额度：单个任务超过全局额度时，只允许在没有其他任务运行时执行
+    if (m_maxMemoryBytes > 0 && job.memoryBytes > 0 && m_running > 0 &&
+        m_usedMemory + job.memoryBytes > m_maxMemoryBytes) {
+        return false;
+    }
+    return true;
+}
+
+void CBackupScheduler::runAll() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (m_pending.empty() && m_running == 0) {
+            break;
+        }
+        if (m_pending.empty()) {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        // 取出队首任务（截止时间最早者），额度不足时等待其他任务释放
+        auto head = std::min_element(m_pending.begin(), m_pending.end(), runsBefore);
+        if (!hasCapacity(head->job)) {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        PendingJob pending = std::move(*head);
+        m_pending.erase(head);
+        m_usedThreads += pending.job.threads;
+        m_usedMemory += pending.job.memoryBytes;
+        ++m_running;
+        m_results[pending.id].status = JobStatus::Running;
+        m_results[pending.id].startTime = std::chrono::system_clock::now();
+        m_workers.emplace_back(&CBackupScheduler::runJob, this, std::move(pending));
+    }
+
+    // 回收工作线程
+    std::vector<std::thread> workers;
+    workers.swap(m_workers);
+    lock.unlock();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void CBackupScheduler::runJob(PendingJob pending) {
+    BackupJob& job = pending.job;
+    std::string destPath;
+    std::string errorMessage;
+    std::string metricsReport;
+
+    try {
+        job.config->setThreadCount(job.threads);
+        CBackup backup;
+        // 任务限速器以全局限速器为父节点，同时受两者约束
+        backup.setRateLimiter(std::make_shared<CRateLimiter>(job.ioBytesPerSec, m_globalLimiter));
+        destPath = backup.doBackup(job.config);
+        if (job.config->isMetricsEnabled()) {
+            metricsReport = backup.getMetrics()->toJson();
+        }
+        if (destPath.empty()) {
+            errorMessage = "Backup failed";
+        }
+    } catch (const std::exception& e) {
+        errorMessage = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    JobResult& result = m_results[pending.id];
+    result.finishTime = std::chrono::system_clock::now();
+    result.missedDeadline = result.finishTime > job.deadline;
+    result.metricsReport = metricsReport;
+    if (errorMessage.empty()) {
+        result.status = JobStatus::Succeeded;
+        result.destPath = destPath;
+        if (m_recorder) {
+            m_recorder->addBackupRecord(job.config, destPath);
+        }
+    } else {
+        result.status = JobStatus::Failed;
+        result.errorMessage = errorMessage;
+        LOG_ERROR("Error: Backup job " << pending.id << " failed: " << errorMessage);
+    }
+
+    m_usedThreads -= job.threads;
+    m_usedMemory -= job.memoryBytes;
+    --m_running;
+    m_cv.notify_all();
+}
+
+JobStatus CBackupScheduler::getJobStatus(size_t jobId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (jobId >= m_results.size()) {
+        throw std::out_of_range("Unknown backup job id: " + std::to_string(jobId));
+    }
+    return m_results[jobId].status;
+}
+
+std::vector<JobResult> CBackupScheduler::getResults() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_results;
+}
+
+size_t CBackupScheduler::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
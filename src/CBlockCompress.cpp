@@ -0,0 +1,296 @@
+#include "CBlockCompress.h"
+#include "CLogger.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace {
+
+void storeU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+uint32_t loadU32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// 对 [0, count) 逐个调用 task；多于一个时除第一个外都放到其他线程上执行
+template <typename Task>
+void runBatch(size_t count, Task&& task) {
+    std::vector<std::future<void>> workers;
+    for (size_t i = 1; i < count; ++i) {
+        workers.push_back(std::async(std::launch::async, [&task, i] { task(i); }));
+    }
+    if (count > 0) {
+        task(0);
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+}
+
+}  // namespace
+
+void CBlockCompress::setThreadCount(unsigned threads) {
+    m_threads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+BlockHead CBlockCompress::makeHead() const {
+    BlockHead header{};
+    header.isCompress = 0x21;
+    header.compressType = getCompressType();
+    header.blockSize = static_cast<uint32_t>(m_blockSize);
+    return header;
+}
+
+// 文件头中的分块大小限制了每块解出的长度，不能大于本算法写出的分块大小
+bool CBlockCompress::checkHead(const BlockHead& header) const {
+    return header.isCompress == 0x21 && header.compressType == getCompressType() && header.blockSize != 0 &&
+           header.blockSize <= m_blockSize;
+}
+
+bool CBlockCompress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    CStageTimer timer(Stage::Compress);
+    timer.addBytes(sourceData.size());
+
+    BlockHead header = makeHead();
+    header.originalSize = sourceData.size();
+    header.crc32 = CRC32::calculate(std::vector<uint8_t>(sourceData.begin(), sourceData.end()));
+
+    // 每块前加上块长度，便于按块读取
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(sourceData.data());
+    const size_t blockCount = (sourceData.size() + m_blockSize - 1) / m_blockSize;
+    std::vector<std::vector<uint8_t>> encoded(blockCount);
+    for (size_t first = 0; first < blockCount; first += m_threads) {
+        runBatch(std::min<size_t>(m_threads, blockCount - first), [&](size_t i) {
+            const size_t offset = (first + i) * m_blockSize;
+            std::vector<uint8_t>& out = encoded[first + i];
+            out.resize(4);
+            encodeBlock(src + offset, std::min(m_blockSize, sourceData.size() - offset), out);
+            storeU32(out.data(), static_cast<uint32_t>(out.size() - 4));
+        });
+    }
+
+    destData.resize(sizeof(BlockHead));
+    std::memcpy(destData.data(), &header, sizeof(BlockHead));
+    for (const auto& block : encoded) {
+        destData.insert(destData.end(), block.begin(), block.end());
+    }
+    return true;
+}
+
+bool CBlockCompress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    CStageTimer timer(Stage::Decompress);
+    BlockHead header;
+    if (sourceData.size() < sizeof(BlockHead)) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated.");
+        return false;
+    }
+    std::memcpy(&header, sourceData.data(), sizeof(BlockHead));
+    if (!checkHead(header)) {
+        LOG_ERROR("Error: Data is not " << getCompressTypeName() << " compressed.");
+        return false;
+    }
+    timer.addBytes(header.originalSize);
+
+    // 先根据块长度找出每块的位置，再并行解码
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(sourceData.data());
+    std::vector<std::pair<size_t, uint32_t>> blocks;
+    size_t pos = sizeof(BlockHead);
+    while (pos < sourceData.size()) {
+        if (sourceData.size() - pos < 4) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated.");
+            return false;
+        }
+        const uint32_t blockLen = loadU32(src + pos);
+        pos += 4;
+        if (sourceData.size() - pos < blockLen) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated.");
+            return false;
+        }
+        blocks.push_back({pos, blockLen});
+        pos += blockLen;
+    }
+
+    std::vector<std::vector<uint8_t>> decoded(blocks.size());
+    std::vector<char> ok(blocks.size(), 0);
+    for (size_t first = 0; first < blocks.size(); first += m_threads) {
+        runBatch(std::min<size_t>(m_threads, blocks.size() - first), [&](size_t i) {
+            const auto& block = blocks[first + i];
+            size_t consumed = 0;
+            ok[first + i] = decodeBlock(src + block.first, block.second, header.blockSize, decoded[first + i], consumed) &&
+                            consumed == block.second;
+        });
+    }
+    std::vector<uint8_t> out;
+    out.reserve(static_cast<size_t>(std::min<uint64_t>(header.originalSize, uint64_t(sourceData.size()) * 64)));
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (!ok[i]) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " data is corrupted.");
+            return false;
+        }
+        out.insert(out.end(), decoded[i].begin(), decoded[i].end());
+    }
+    if (out.size() != header.originalSize || CRC32::calculate(out) != header.crc32) {
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
+        return false;
+    }
+    destData.assign(out.begin(), out.end());
+    return true;
+}
+
+std::string CBlockCompress::compressFile(const std::string& sourcePath) {
+    CStageTimer timer(Stage::Compress);
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return "";
+    }
+    const std::string destPath = sourcePath + getFileExtension();
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
+        return "";
+    }
+
+    BlockHead header = makeHead();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(BlockHead));
+
+    // 每次读入一批块并行编码，源文件只读一遍
+    std::vector<std::vector<uint8_t>> blocks(m_threads);
+    std::vector<std::vector<uint8_t>> encoded(m_threads);
+    std::vector<size_t> lengths(m_threads);
+    uint32_t crcValue = CRC32::getInitialValue();
+    while (in) {
+        size_t batch = 0;
+        while (batch < m_threads && in) {
+            blocks[batch].resize(m_blockSize);
+            in.read(reinterpret_cast<char*>(blocks[batch].data()), m_blockSize);
+            lengths[batch] = static_cast<size_t>(in.gcount());
+            if (lengths[batch] == 0) break;
+            for (size_t i = 0; i < lengths[batch]; ++i) {
+                crcValue = CRC32::update(crcValue, blocks[batch][i]);
+            }
+            header.originalSize += lengths[batch];
+            ++batch;
+        }
+        runBatch(batch, [&](size_t i) {
+            encoded[i].assign(4, 0);
+            encodeBlock(blocks[i].data(), lengths[i], encoded[i]);
+            storeU32(encoded[i].data(), static_cast<uint32_t>(encoded[i].size() - 4));
+        });
+        for (size_t i = 0; i < batch; ++i) {
+            out.write(reinterpret_cast<const char*>(encoded[i].data()), encoded[i].size());
+        }
+    }
+    if (in.bad()) {
+        LOG_ERROR("Error: Failed to read file " << sourcePath << ".");
+        return "";
+    }
+    timer.addBytes(header.originalSize);
+    timer.addFiles();
+
+    header.crc32 = CRC32::finalize(crcValue);
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(BlockHead));
+    out.close();
+    if (!out) {
+        LOG_ERROR("Error: Failed to write file " << destPath << ".");
+        return "";
+    }
+    return destPath;
+}
+
+bool CBlockCompress::decompressFile(const std::string& sourcePath, const std::string& destPath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return false;
+    }
+    BlockHead header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(BlockHead));
+    if (!in || !checkHead(header)) {
+        LOG_ERROR("Error: File " << sourcePath << " is not a " << getCompressTypeName() << " compressed file.");
+        return false;
+    }
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
+        return false;
+    }
+    in.seekg(0, std::ios::beg);
+    const bool ok = decompressStream(in, out, sourcePath);
+    out.close();
+    return ok && static_cast<bool>(out);
+}
+
+bool CBlockCompress::decompressStream(std::istream& in, std::ostream& out, const std::string& sourcePath) {
+    CStageTimer timer(Stage::Decompress);
+    BlockHead header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(BlockHead));
+    if (!in || !checkHead(header)) {
+        LOG_ERROR("Error: File " << sourcePath << " is not a " << getCompressTypeName() << " compressed file.");
+        return false;
+    }
+    timer.addBytes(header.originalSize);
+    timer.addFiles();
+
+    std::vector<std::vector<uint8_t>> encoded(m_threads);
+    std::vector<std::vector<uint8_t>> decoded(m_threads);
+    std::vector<char> ok(m_threads);
+    uint64_t restored = 0;
+    uint64_t pending = header.originalSize;
+    uint32_t crcValue = CRC32::getInitialValue();
+    while (restored < header.originalSize) {
+        // 读入一批块；每块最多 blockSize 字节原始数据，据此确定本批块数
+        size_t batch = 0;
+        while (batch < m_threads && pending > 0) {
+            uint32_t blockLen = 0;
+            in.read(reinterpret_cast<char*>(&blockLen), sizeof(blockLen));
+            // 编码后的块最多比原始数据多出块头
+            if (!in || blockLen > 2 * uint64_t(header.blockSize) + 1024) {
+                LOG_ERROR("Error: " << getCompressTypeName() << " file " << sourcePath << " is truncated or corrupted.");
+                return false;
+            }
+            encoded[batch].resize(blockLen);
+            in.read(reinterpret_cast<char*>(encoded[batch].data()), blockLen);
+            if (static_cast<uint32_t>(in.gcount()) != blockLen) {
+                LOG_ERROR("Error: " << getCompressTypeName() << " file " << sourcePath << " is truncated or corrupted.");
+                return false;
+            }
+            pending -= std::min<uint64_t>(pending, header.blockSize);
+            ++batch;
+        }
+        runBatch(batch, [&](size_t i) {
+            decoded[i].clear();
+            size_t consumed = 0;
+            ok[i] = decodeBlock(encoded[i].data(), encoded[i].size(), header.blockSize, decoded[i], consumed) &&
+                    consumed == encoded[i].size();
+        });
+        for (size_t i = 0; i < batch; ++i) {
+            if (!ok[i]) {
+                LOG_ERROR("Error: " << getCompressTypeName() << " file " << sourcePath << " is truncated or corrupted.");
+                return false;
+            }
+            for (uint8_t b : decoded[i]) {
+                crcValue = CRC32::update(crcValue, b);
+            }
+            out.write(reinterpret_cast<const char*>(decoded[i].data()), decoded[i].size());
+            restored += decoded[i].size();
+        }
+        if (batch == 0 || !out) break;
+    }
+    if (!out) {
+        LOG_ERROR("Error: Failed to write decompressed data of " << sourcePath << ".");
+        return false;
+    }
+    if (restored != header.originalSize || CRC32::finalize(crcValue) != header.crc32) {
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
+        return false;
+    }
+    return static_cast<bool>(out);
+}
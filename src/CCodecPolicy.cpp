@@ -0,0 +1,132 @@
+#include "CCodecPolicy.h"
+#include "CHistogram.h"
+#include "CLogger.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <set>
+
+CCodecPolicy::CCodecPolicy(CompressType preferred, double entropyThreshold)
+    : m_preferred(preferred), m_entropyThreshold(entropyThreshold) {
+}
+
+double CCodecPolicy::entropy(const char* data, size_t len) {
+    if (len == 0) {
+        return 0.0;
+    }
+    CHistogram::Counts counts{};
+    CHistogram::count(data, len, counts);
+    double bits = 0.0;
+    for (uint64_t count : counts) {
+        if (count > 0) {
+            const double p = static_cast<double>(count) / len;
+            bits -= p * std::log2(p);
+        }
+    }
+    return bits;
+}
+
+bool CCodecPolicy::isCompressedExtension(const std::string& path) {
+    static const std::set<std::string> extensions = {
+        // 图片
+        ".jpg", ".jpeg", ".png", ".gif", ".webp", ".heic", ".avif", ".jxl",
+        // 音视频
+        ".mp3", ".aac", ".m4a", ".ogg", ".opus", ".flac", ".mp4", ".m4v", ".mkv", ".webm", ".mov", ".avi",
+        // 压缩包与基于 zip 的格式
+        ".zip", ".jar", ".war", ".apk", ".docx", ".xlsx", ".pptx", ".odt", ".epub", ".whl", ".nupkg",
+        ".gz", ".tgz", ".bz2", ".xz", ".txz", ".zst", ".lz4", ".7z", ".rar", ".cab",
+        // 字体与其他
+        ".woff", ".woff2", ".pdf",
+    };
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extensions.count(ext) > 0;
+}
+
+bool CCodecPolicy::hasCompressedMagic(const char* data, size_t len) {
+    struct Magic {
+        size_t offset;
+        const char* bytes;
+        size_t len;
+    };
+    static const Magic magics[] = {
+        {0, "\xFF\xD8\xFF", 3},                  // JPEG
+        {0, "\x89PNG\r\n\x1A\n", 8},             // PNG
+        {0, "GIF8", 4},                          // GIF
+        {0, "PK\x03\x04", 4},                    // ZIP/JAR/Office
+        {0, "\x1F\x8B", 2},                      // gzip
+        {0, "BZh", 3},                           // bzip2
+        {0, "\xFD" "7zXZ\x00", 6},               // xz
+        {0, "\x28\xB5\x2F\xFD", 4},              // zstd
+        {0, "\x04\x22\x4D\x18", 4},              // lz4
+        {0, "7z\xBC\xAF\x27\x1C", 6},            // 7z
+        {0, "Rar!\x1A\x07", 6},                  // rar
+        {0, "\x1A\x45\xDF\xA3", 4},              // Matroska/WebM
+        {4, "ftyp", 4},                          // MP4/MOV/HEIC
+        {0, "OggS", 4},                          // Ogg
+        {0, "fLaC", 4},                          // FLAC
+        {0, "ID3", 3},                           // MP3（ID3标签）
+        {0, "wOF2", 4},                          // WOFF2
+    };
+    for (const auto& magic : magics) {
+        if (len >= magic.offset + magic.len && std::memcmp(data + magic.offset, magic.bytes, magic.len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CCodecPolicy::readSample(const std::string& path, uint64_t size, std::vector<char>& sample) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    sample.clear();
+    if (size <= 3 * kSampleWindow) {
+        sample.resize(static_cast<size_t>(size));
+        in.read(sample.data(), sample.size());
+        sample.resize(static_cast<size_t>(in.gcount()));
+        return true;
+    }
+    // 头、中、尾三个窗口：头部包含魔数，中间与尾部反映数据主体
+    const uint64_t offsets[] = {0, size / 2 - kSampleWindow / 2, size - kSampleWindow};
+    for (uint64_t offset : offsets) {
+        const size_t start = sample.size();
+        sample.resize(start + kSampleWindow);
+        in.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        in.read(sample.data() + start, kSampleWindow);
+        sample.resize(start + static_cast<size_t>(in.gcount()));
+        in.clear();
+    }
+    return true;
+}
+
+CompressType CCodecPolicy::chooseForData(const char* data, size_t len) const {
+    if (len < kMinCompressSize || hasCompressedMagic(data, len)) {
+        return CompressType::None;
+    }
+    return entropy(data, len) >= m_entropyThreshold ? CompressType::None : m_preferred;
+}
+
+CompressType CCodecPolicy::preselect(const std::string& path, uint64_t size) const {
+    if (m_preferred == CompressType::None || size < kMinCompressSize || isCompressedExtension(path)) {
+        return CompressType::None;
+    }
+    return m_preferred;
+}
+
+CompressType CCodecPolicy::choose(const std::string& path, uint64_t size) const {
+    if (preselect(path, size) == CompressType::None) {
+        return CompressType::None;
+    }
+    std::vector<char> sample;
+    if (!readSample(path, size, sample)) {
+        LOG_WARN("Warning: Failed to sample " << path << ", storing it uncompressed.");
+        return CompressType::None;
+    }
+    return chooseForData(sample.data(), sample.size());
+}
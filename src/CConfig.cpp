@@ -1,4 +1,5 @@
 #include "CConfig.h"
+#include "CLogger.h"
 
 // ===== 构造函数与析构函数实现 =====
 CConfig::CConfig() {
@@ -31,7 +32,7 @@ const std::string& CConfig::getSourcePath() const {
 
 void CConfig::addSourcePath(const std::string& path) {
     if (path.empty()) {
-        std::cerr << "Warning: Source path cannot be empty, skip adding" << std::endl;
+        LOG_WARN("Warning: Source path cannot be empty, skip adding");
         return;
     }
     m_sourcePaths.push_back(path); // 追加到多源路径列表
@@ -76,7 +77,7 @@ CConfig& CConfig::addIncludePattern(const std::string& pattern) {
     try {
         m_includePatterns.emplace_back(pattern); // 追加到统一命名的列表
     } catch (const std::regex_error& e) {
-        std::cerr << "Warning: Invalid include regex pattern: " << e.what() << std::endl;
+        LOG_WARN("Warning: Invalid include regex pattern: " << e.what());
     }
     return *this;
 }
@@ -89,7 +90,7 @@ CConfig& CConfig::addExcludePattern(const std::string& pattern) {
     try {
         m_excludePatterns.emplace_back(pattern); // 追加到统一命名的列表
     } catch (const std::regex_error& e) {
-        std::cerr << "Warning: Invalid exclude regex pattern: " << e.what() << std::endl;
+        LOG_WARN("Warning: Invalid exclude regex pattern: " << e.what());
     }
     return *this;
 }
@@ -117,6 +118,15 @@ const std::string& CConfig::getPackType() const {
     return m_packType; // 返回统一命名的成员变量
 }
 
+CConfig& CConfig::setDeduplicationEnabled(bool value) {
+    m_enableDeduplication = value;
+    return *this;
+}
+
+bool CConfig::isDeduplicationEnabled() const {
+    return m_enableDeduplication;
+}
+
 CConfig& CConfig::setCompressionEnabled(bool value) {
     m_enableCompression = value; // 赋值给统一命名的成员变量
     return *this;
@@ -147,6 +157,33 @@ int CConfig::getCompressionLevel() const {
     return m_compressionLevel; // 返回统一命名的成员变量
 }
 
+CConfig& CConfig::setAdaptiveCompressionEnabled(bool value) {
+    m_enableAdaptiveCompression = value;
+    return *this;
+}
+
+bool CConfig::isAdaptiveCompressionEnabled() const {
+    return m_enableAdaptiveCompression;
+}
+
+CConfig& CConfig::setDictionaryEnabled(bool value) {
+    m_enableDictionary = value;
+    return *this;
+}
+
+bool CConfig::isDictionaryEnabled() const {
+    return m_enableDictionary;
+}
+
+CConfig& CConfig::setFilterChain(const std::string& value) {
+    m_filterChain = value;
+    return *this;
+}
+
+std::string CConfig::getFilterChain() const {
+    return m_filterChain;
+}
+
 CConfig& CConfig::setEncryptionEnabled(bool value) {
     m_enableEncryption = value; // 赋值给统一命名的成员变量
     return *this;
@@ -174,11 +211,103 @@ const std::string& CConfig::getEncryptType() const {
     return m_encryptType; // 返回统一命名的成员变量
 }
 
+CConfig& CConfig::setSnapshotEnabled(bool enable) {
+    m_enableSnapshot = enable;
+    return *this;
+}
+
+bool CConfig::isSnapshotEnabled() const {
+    return m_enableSnapshot;
+}
+
+CConfig& CConfig::setSnapshotCompareHash(bool enable) {
+    m_snapshotCompareHash = enable;
+    return *this;
+}
+
+bool CConfig::isSnapshotCompareHash() const {
+    return m_snapshotCompareHash;
+}
+
+CConfig& CConfig::setDeltaEnabled(bool enable) {
+    m_enableDelta = enable;
+    return *this;
+}
+
+bool CConfig::isDeltaEnabled() const {
+    return m_enableDelta;
+}
+
+CConfig& CConfig::setDeltaMinSize(uint64_t bytes) {
+    m_deltaMinSize = bytes;
+    return *this;
+}
+
+uint64_t CConfig::getDeltaMinSize() const {
+    return m_deltaMinSize;
+}
+
+CConfig& CConfig::setParityEnabled(bool enable) {
+    m_enableParity = enable;
+    return *this;
+}
+
+bool CConfig::isParityEnabled() const {
+    return m_enableParity;
+}
+
+CConfig& CConfig::setParityShards(unsigned dataShards, unsigned parityShards) {
+    if (dataShards == 0 || parityShards == 0 || dataShards + parityShards > 255) {
+        throw std::invalid_argument("Parity shard counts must be at least 1 and total at most 255");
+    }
+    m_parityDataShards = dataShards;
+    m_parityShards = parityShards;
+    return *this;
+}
+
+unsigned CConfig::getParityDataShards() const {
+    return m_parityDataShards;
+}
+
+unsigned CConfig::getParityShards() const {
+    return m_parityShards;
+}
+
+// ===== 性能配置接口实现 =====
+CConfig& CConfig::setThreadCount(unsigned count) {
+    if (count == 0) {
+        throw std::invalid_argument("Thread count must be at least 1");
+    }
+    m_threadCount = count;
+    return *this;
+}
+
+unsigned CConfig::getThreadCount() const {
+    return m_threadCount;
+}
+
+CConfig& CConfig::setMetricsEnabled(bool enable) {
+    m_enableMetrics = enable;
+    return *this;
+}
+
+bool CConfig::isMetricsEnabled() const {
+    return m_enableMetrics;
+}
+
+CConfig& CConfig::setMetricsReportPath(const std::string& path) {
+    m_metricsReportPath = path;
+    return *this;
+}
+
+const std::string& CConfig::getMetricsReportPath() const {
+    return m_metricsReportPath;
+}
 
 // ===== 高级配置接口实现 =====
 CConfig& CConfig::setCustomOption(const std::string& key, const std::string& value) {
     if (key.empty()) {
-        std::cerr << "Warning: Custom option key cannot be empty, skip setting" << std::endl;
+        LOG_WARN("Warning: Custom option key cannot be empty, skip setting");
         return *this;
     }
     m_customOptions[key] = value; // 赋值给统一命名的 map
@@ -219,24 +348,24 @@ bool CConfig::isValid() const {
     // 1. 检查必要路径（单个源路径或多源路径至少有一个非空）
     bool hasValidSource = !m_sourcePath.empty() || !m_sourcePaths.empty();
     if (!hasValidSource) {
-        std::cerr << "Error: No valid source path (single or multiple paths)" << std::endl;
+        LOG_ERROR("Error: No valid source path (single or multiple paths)");
         return false;
     }
     if (m_destinationPath.empty()) {
-        std::cerr << "Error: Destination path cannot be empty" << std::endl;
+        LOG_ERROR("Error: Destination path cannot be empty");
         return false;
     }
     
     // 2. 检查单个源路径是否存在（若有）
     if (!m_sourcePath.empty() && !std::filesystem::exists(m_sourcePath)) {
-        std::cerr << "Error: Single source path does not exist: " << m_sourcePath << std::endl;
+        LOG_ERROR("Error: Single source path does not exist: " << m_sourcePath);
         return false;
     }
     
     // 3. 检查多源路径是否存在（若有）
     for (const auto& path : m_sourcePaths) {
         if (!std::filesystem::exists(path)) {
-            std::cerr << "Error: Multiple source path does not exist: " << path << std::endl;
+            LOG_ERROR("Error: Multiple source path does not exist: " << path);
             return false;
         }
     }
@@ -245,24 +374,24 @@ bool CConfig::isValid() const {
     if (!std::filesystem::exists(m_destinationPath)) {
         try {
             if (!std::filesystem::create_directories(m_destinationPath)) {
-                std::cerr << "Error: Failed to create destination directory: " << m_destinationPath << std::endl;
+                LOG_ERROR("Error: Failed to create destination directory: " << m_destinationPath);
                 return false;
             }
         } catch (const std::exception& e) {
-            std::cerr << "Error: Create destination directory failed: " << e.what() << std::endl;
+            LOG_ERROR("Error: Create destination directory failed: " << e.what());
             return false;
         }
     }
     
     // 5. 检查压缩级别有效性（仅当启用压缩时）
     if (m_enableCompression && (m_compressionLevel < 1 || m_compressionLevel > 9)) {
-        std::cerr << "Error: Compression level must be between 1 and 9 (current: " << m_compressionLevel << ")" << std::endl;
+        LOG_ERROR("Error: Compression level must be between 1 and 9 (current: " << m_compressionLevel << ")");
         return false;
     }
     
     // 6. 检查加密配置（仅当启用加密时，密钥非空）
     if (m_enableEncryption && m_encryptionKey.empty()) {
-        std::cerr << "Error: Encryption enabled but encryption key is empty" << std::endl;
+        LOG_ERROR("Error: Encryption enabled but encryption key is empty");
         return false;
     }
     
@@ -285,11 +414,27 @@ void CConfig::reset() {
     // 重置备份行为配置
     m_enablePacking = false;
     m_packType = "tar";
+    m_enableDeduplication = true;
     m_enableCompression = false;
     m_compressionType = "gzip";
     m_compressionLevel = 1;
+    m_enableDictionary = false;
+    m_enableAdaptiveCompression = false;
+    m_filterChain.clear();
     m_enableEncryption = false;
     m_encryptionKey.clear();
+    m_enableSnapshot = false;
+    m_snapshotCompareHash = false;
+    m_enableDelta = false;
+    m_deltaMinSize = 16ull << 20;
+    m_enableParity = false;
+    m_parityDataShards = 16;
+    m_parityShards = 2;
+
+    // 重置性能配置
+    m_threadCount = 1;
+    m_enableMetrics = false;
+    m_metricsReportPath.clear();
     
     // 重置高级配置
     m_customOptions.clear();
@@ -323,10 +468,19 @@ std::string CConfig::toString() const {
     // 备份行为配置
     oss << "3. Backup Behavior Config:" << std::endl;
     oss << "   - Packing: " << (m_enablePacking ? "Enabled (" + m_packType + ")" : "Disabled") << std::endl;
+    oss << "   - Deduplication: " << (m_enableDeduplication ? "Enabled" : "Disabled") << std::endl;
     oss << "   - Compression: " << (m_enableCompression ? 
-        "Enabled (" + m_compressionType + ", Level " + std::to_string(m_compressionLevel) + ")" : 
+        "Enabled (" + m_compressionType + ", Level " + std::to_string(m_compressionLevel) +
+        (m_enableAdaptiveCompression ? " Adaptive" : "") +
+        (m_enableDictionary ? ", Dictionary" : "") +
+        (m_filterChain.empty() ? "" : ", Filters " + m_filterChain) + ")" : 
         "Disabled") << std::endl;
     oss << "   - Encryption: " << (m_enableEncryption ? "Enabled" : "Disabled") << std::endl;
+    oss << "   - Snapshot: " << (m_enableSnapshot ? (m_snapshotCompareHash ? "Enabled (size/mtime/crc32)" : "Enabled (size/mtime)") : "Disabled") << std::endl;
+    oss << "   - Delta: " << (m_enableDelta ? "Enabled (>= " + std::to_string(m_deltaMinSize) + " bytes)" : "Disabled") << std::endl;
+    oss << "   - Parity: " << (m_enableParity ? "Enabled (" + std::to_string(m_parityDataShards) + "+" + std::to_string(m_parityShards) + " shards)" : "Disabled") << std::endl;
+    oss << "   - Worker Threads: " << m_threadCount << std::endl;
+    oss << "   - Metrics: " << (m_enableMetrics ? "Enabled" : "Disabled") << std::endl;
     
     // 高级配置
     oss << "4. Advanced Config:" << std::endl;
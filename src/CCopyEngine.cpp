@@ -0,0 +1,228 @@
+#include "CCopyEngine.h"
+#include "CLogger.h"
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <filesystem>
+#endif
+
+CCopyEngine::CCopyEngine(size_t chunkSize)
+    : m_chunkSize(chunkSize == 0 ? kDefaultChunkSize : chunkSize) {
+}
+
+const char* CCopyEngine::methodName(CopyMethod method) {
+    switch (method) {
+        case CopyMethod::Reflink: return "reflink";
+        case CopyMethod::KernelCopy: return "kernel-copy";
+        case CopyMethod::Sendfile: return "sendfile";
+        case CopyMethod::Buffered: return "buffered";
+        default: return "none";
+    }
+}
+
+// 用户态缓冲区分块拷贝（所有平台通用的最后手段）
+bool CCopyEngine::copyBuffered(const std::string& srcPath, const std::string& destPath) {
+    std::ifstream in(srcPath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Failed to open file: " << srcPath);
+        return false;
+    }
+    std::ofstream out(destPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        LOG_ERROR("Failed to open file: " << destPath);
+        return false;
+    }
+    std::vector<char> buffer(std::min<size_t>(m_chunkSize, 1024 * 1024));
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        const std::streamsize n = in.gcount();
+        if (n <= 0) break;
+        if (m_rateLimiter) {
+            m_rateLimiter->acquire(static_cast<uint64_t>(n));
+        }
+        out.write(buffer.data(), n);
+        if (!out) {
+            LOG_ERROR("Failed to write file: " << destPath);
+            return false;
+        }
+    }
+    if (in.bad()) {
+        LOG_ERROR("Failed to read file: " << srcPath);
+        return false;
+    }
+    m_lastMethod = CopyMethod::Buffered;
+    return true;
+}
+
+#if defined(__linux__)
+
+namespace {
+// 自动关闭的文件描述符
+struct FdGuard {
+    int fd;
+    explicit FdGuard(int f) : fd(f) {}
+    ~FdGuard() { if (fd >= 0) ::close(fd); }
+    FdGuard(const FdGuard&) = delete;
+    FdGuard& operator=(const FdGuard&) = delete;
+};
+
+// 这些错误表示当前方式在这对文件上不可用，应退回下一种方式
+bool isUnsupported(int err) {
+    return err == EXDEV || err == ENOSYS || err == EOPNOTSUPP || err == ENOTTY ||
+           err == EINVAL || err == EBADF || err == EPERM || err == ETXTBSY;
+}
+}
+
+bool CCopyEngine::copyFile(const std::string& srcPath, const std::string& destPath) {
+    m_lastMethod = CopyMethod::None;
+
+    FdGuard in(::open(srcPath.c_str(), O_RDONLY | O_CLOEXEC));
+    if (in.fd < 0) {
+        LOG_ERROR("Failed to open file: " << srcPath << " (" << std::strerror(errno) << ")");
+        return false;
+    }
+    struct stat st;
+    if (::fstat(in.fd, &st) != 0) {
+        LOG_ERROR("Failed to stat file: " << srcPath << " (" << std::strerror(errno) << ")");
+        return false;
+    }
+    FdGuard out(::open(destPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777));
+    if (out.fd < 0) {
+        LOG_ERROR("Failed to open file: " << destPath << " (" << std::strerror(errno) << ")");
+        return false;
+    }
+
+    // 1) 引用拷贝：成功时目标与源共享数据块，不产生数据I/O
+    if (m_reflinkEnabled && st.st_size > 0 && ::ioctl(out.fd, FICLONE, in.fd) == 0) {
+        m_lastMethod = CopyMethod::Reflink;
+        return true;
+    }
+
+    const uint64_t total = static_cast<uint64_t>(st.st_size);
+    uint64_t copied = 0;
+    CopyMethod method = CopyMethod::Buffered;
+
+    // 2) 内核态拷贝，每次最多一个块，便于限速；不支持时依次退回 sendfile、缓冲区
+    if (m_kernelCopyEnabled) {
+        method = CopyMethod::KernelCopy;
+        while (copied < total) {
+            const size_t len = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, total - copied));
+            loff_t inOff = static_cast<loff_t>(copied);
+            loff_t outOff = static_cast<loff_t>(copied);
+            ssize_t n = -1;
+            if (method == CopyMethod::KernelCopy) {
+                n = ::copy_file_range(in.fd, &inOff, out.fd, &outOff, len, 0);
+                if (n < 0 && isUnsupported(errno)) {
+                    method = CopyMethod::Sendfile;
+                    continue;
+                }
+            } else {
+                off_t offset = static_cast<off_t>(copied);
+                if (::lseek(out.fd, offset, SEEK_SET) < 0) {
+                    n = -1;
+                } else {
+                    n = ::sendfile(out.fd, in.fd, &offset, len);
+                }
+                if (n < 0 && isUnsupported(errno)) {
+                    method = CopyMethod::Buffered;
+                    break;
+                }
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                LOG_ERROR("Failed to copy " << srcPath << " to " << destPath << " (" << std::strerror(errno) << ")");
+                return false;
+            }
+            if (n == 0) {
+                // procfs/sysfs、部分 FUSE 文件系统与旧内核在数据未拷完时也返回 0，交给缓冲区拷贝继续
+                method = CopyMethod::Buffered;
+                break;
+            }
+            copied += static_cast<uint64_t>(n);
+            // 限速器允许欠账，拷贝完一块后再申请额度
+            if (m_rateLimiter) {
+                m_rateLimiter->acquire(static_cast<uint64_t>(n));
+            }
+        }
+    }
+
+    // 3) 用户态缓冲区，从内核拷贝停下的位置继续
+    if (copied < total && method == CopyMethod::Buffered) {
+        std::vector<char> buffer(std::min<size_t>(m_chunkSize, 1024 * 1024));
+        while (copied < total) {
+            const size_t len = static_cast<size_t>(std::min<uint64_t>(buffer.size(), total - copied));
+            if (m_rateLimiter) {
+                m_rateLimiter->acquire(len);
+            }
+            const ssize_t n = ::pread(in.fd, buffer.data(), len, static_cast<off_t>(copied));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                LOG_ERROR("Failed to read file: " << srcPath << " (" << std::strerror(errno) << ")");
+                return false;
+            }
+            if (n == 0) break;
+            ssize_t written = 0;
+            while (written < n) {
+                const ssize_t w = ::pwrite(out.fd, buffer.data() + written, static_cast<size_t>(n - written),
+                                           static_cast<off_t>(copied + written));
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    LOG_ERROR("Failed to write file: " << destPath << " (" << std::strerror(errno) << ")");
+                    return false;
+                }
+                written += w;
+            }
+            copied += static_cast<uint64_t>(n);
+        }
+    }
+
+    // 源文件在拷贝过程中变短时目标不完整
+    if (copied != total) {
+        LOG_ERROR("Failed to copy " << srcPath << " to " << destPath << ": copied " << copied << " of " << total
+                  << " bytes");
+        return false;
+    }
+    m_lastMethod = method;
+    return true;
+}
+
+#elif defined(_WIN32)
+
+bool CCopyEngine::copyFile(const std::string& srcPath, const std::string& destPath) {
+    m_lastMethod = CopyMethod::None;
+    // CopyFileEx 在内核中完成拷贝，ReFS 上会自动使用块克隆；
+    // 设置了限速器时退回缓冲区拷贝，以便按块申请额度
+    if (m_kernelCopyEnabled && !m_rateLimiter) {
+        const std::wstring src = std::filesystem::path(srcPath).wstring();
+        const std::wstring dest = std::filesystem::path(destPath).wstring();
+        if (::CopyFileExW(src.c_str(), dest.c_str(), nullptr, nullptr, nullptr, 0)) {
+            m_lastMethod = CopyMethod::KernelCopy;
+            return true;
+        }
+    }
+    return copyBuffered(srcPath, destPath);
+}
+
+#else
+
+bool CCopyEngine::copyFile(const std::string& srcPath, const std::string& destPath) {
+    m_lastMethod = CopyMethod::None;
+    return copyBuffered(srcPath, destPath);
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "CCpuFeatures.h"
+
+#if defined(CPU_HAS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+bool detectAvx2() {
+#if !defined(CPU_HAS_X86)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;  // 操作系统需保存 YMM 寄存器
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+}  // namespace
+
+bool CCpuFeatures::hasAvx2() {
+    static const bool supported = detectAvx2();
+    return supported;
+}
@@ -0,0 +1,497 @@
+#include "CDeltaEngine.h"
+#include "CHash.h"
+#include "CRC32.h"
+#include "CLogger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kDeltaMagic[4] = {'B', 'K', 'D', 'L'};
+constexpr char kSignatureMagic[4] = {'B', 'K', 'S', 'G'};
+constexpr uint8_t kFormatVersion = 1;
+
+constexpr uint8_t kOpEnd = 0x00;
+constexpr uint8_t kOpCopy = 0x01;
+constexpr uint8_t kOpInsert = 0x02;
+
+constexpr uint32_t kMinBlockSize = 2 * 1024;
+constexpr uint32_t kMaxBlockSize = 256 * 1024;
+constexpr size_t kMaxLiteral = 1024 * 1024;  // 单条 INSERT 的上限，也限制了滚动窗口前积压的数据量
+constexpr size_t kReadChunk = 4 * 1024 * 1024;
+constexpr uint32_t kNoBlock = UINT32_MAX;
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        crc = CRC32::update(crc, data[i]);
+    }
+    return crc;
+}
+
+int64_t fileMtime(const std::string& path) {
+    std::error_code ec;
+    const auto mtime = fs::last_write_time(path, ec);
+    return ec ? 0 : static_cast<int64_t>(mtime.time_since_epoch().count());
+}
+
+// 按偏移顺序写出指令，相邻的 COPY 合并为一条
+class DeltaWriter {
+public:
+    explicit DeltaWriter(std::ostream& out, DeltaStats& stats) : m_out(out), m_stats(stats) {}
+
+    void copy(uint64_t offset, uint64_t len) {
+        if (m_copyLen > 0 && m_copyOffset + m_copyLen == offset) {
+            m_copyLen += len;
+            return;
+        }
+        flushCopy();
+        m_copyOffset = offset;
+        m_copyLen = len;
+    }
+
+    void insert(const uint8_t* data, size_t len) {
+        if (len == 0) return;
+        flushCopy();
+        writeValue(m_out, kOpInsert);
+        writeValue(m_out, static_cast<uint32_t>(len));
+        m_out.write(reinterpret_cast<const char*>(data), len);
+        m_stats.insertedBytes += len;
+    }
+
+    // 下一个 COPY 若紧接上一个，期望匹配的基准偏移
+    uint64_t expectedOffset() const { return m_copyLen > 0 ? m_copyOffset + m_copyLen : UINT64_MAX; }
+
+    void finish() {
+        flushCopy();
+        writeValue(m_out, kOpEnd);
+    }
+
+private:
+    void flushCopy() {
+        if (m_copyLen == 0) return;
+        writeValue(m_out, kOpCopy);
+        writeValue(m_out, m_copyOffset);
+        writeValue(m_out, m_copyLen);
+        m_stats.copiedBytes += m_copyLen;
+        m_copyLen = 0;
+    }
+
+    std::ostream& m_out;
+    DeltaStats& m_stats;
+    uint64_t m_copyOffset = 0;
+    uint64_t m_copyLen = 0;
+};
+
+}  // namespace
+
+uint32_t CDeltaEngine::chooseBlockSize(uint64_t fileSize) {
+    const uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(fileSize)));
+    const uint64_t aligned = (root + 1023) / 1024 * 1024;
+    return static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(aligned, kMinBlockSize), kMaxBlockSize));
+}
+
+uint32_t CDeltaEngine::weakChecksum(const uint8_t* data, size_t len) {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    for (size_t i = 0; i < len; ++i) {
+        a += data[i];
+        b += static_cast<uint32_t>(len - i) * data[i];
+    }
+    return (a & 0xFFFF) | ((b & 0xFFFF) << 16);
+}
+
+bool CDeltaEngine::computeSignature(const std::string& basePath, uint32_t blockSize, DeltaSignature& signature,
+                                    unsigned threads) {
+    std::error_code ec;
+    const uint64_t size = fs::file_size(basePath, ec);
+    if (ec || blockSize == 0) {
+        LOG_ERROR("Error: Failed to read " << basePath << " for delta signature.");
+        return false;
+    }
+    signature.blockSize = blockSize;
+    signature.baseSize = size;
+    signature.baseMtime = fileMtime(basePath);
+    const size_t blockCount = static_cast<size_t>((size + blockSize - 1) / blockSize);
+    signature.blocks.assign(blockCount, DeltaBlockSignature{0, 0});
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // 每个线程负责一段连续的块，各自打开文件读取
+    const size_t workers = std::max<size_t>(1, std::min<size_t>(threads, blockCount));
+    const size_t perWorker = (blockCount + workers - 1) / workers;
+    auto task = [&](size_t first, size_t last) {
+        std::ifstream in(basePath, std::ios::binary);
+        if (!in) return false;
+        in.seekg(static_cast<std::streamoff>(uint64_t(first) * blockSize));
+        std::vector<uint8_t> buffer(blockSize);
+        for (size_t i = first; i < last; ++i) {
+            const size_t len = static_cast<size_t>(std::min<uint64_t>(blockSize, size - uint64_t(i) * blockSize));
+            if (!in.read(reinterpret_cast<char*>(buffer.data()), len)) return false;
+            signature.blocks[i].weak = weakChecksum(buffer.data(), len);
+            signature.blocks[i].strong = CXXHash64::hash(buffer.data(), len);
+        }
+        return true;
+    };
+    std::vector<std::future<bool>> futures;
+    for (size_t w = 1; w < workers; ++w) {
+        const size_t first = std::min(blockCount, w * perWorker);
+        const size_t last = std::min(blockCount, first + perWorker);
+        futures.push_back(std::async(std::launch::async, task, first, last));
+    }
+    bool ok = task(0, std::min(blockCount, perWorker));
+    for (auto& future : futures) {
+        ok = future.get() && ok;
+    }
+    if (!ok) {
+        LOG_ERROR("Error: Failed to read " << basePath << " for delta signature.");
+    }
+    return ok;
+}
+
+bool CDeltaEngine::saveSignature(const std::string& path, const DeltaSignature& signature) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << path << " for writing.");
+        return false;
+    }
+    out.write(kSignatureMagic, sizeof(kSignatureMagic));
+    writeValue(out, kFormatVersion);
+    writeValue(out, signature.blockSize);
+    writeValue(out, signature.baseSize);
+    writeValue(out, signature.baseMtime);
+    writeValue(out, static_cast<uint64_t>(signature.blocks.size()));
+    for (const auto& block : signature.blocks) {
+        writeValue(out, block.weak);
+        writeValue(out, block.strong);
+    }
+    out.close();
+    if (!out) {
+        LOG_ERROR("Error: Failed to write file " << path << ".");
+        return false;
+    }
+    return true;
+}
+
+bool CDeltaEngine::loadSignature(const std::string& path, DeltaSignature& signature) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    char magic[4];
+    uint8_t version = 0;
+    uint64_t count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kSignatureMagic, sizeof(magic)) != 0 || !readValue(in, version) ||
+        version != kFormatVersion || !readValue(in, signature.blockSize) || !readValue(in, signature.baseSize) ||
+        !readValue(in, signature.baseMtime) || !readValue(in, count) || signature.blockSize == 0 ||
+        count != (signature.baseSize + signature.blockSize - 1) / signature.blockSize) {
+        return false;
+    }
+    signature.blocks.resize(static_cast<size_t>(count));
+    for (auto& block : signature.blocks) {
+        if (!readValue(in, block.weak) || !readValue(in, block.strong)) return false;
+    }
+    return true;
+}
+
+bool CDeltaEngine::loadOrComputeSignature(const std::string& basePath, const std::string& cachePath,
+                                          DeltaSignature& signature, unsigned threads) {
+    std::error_code ec;
+    const uint64_t size = fs::file_size(basePath, ec);
+    if (ec) {
+        LOG_ERROR("Error: Failed to read " << basePath << " for delta signature.");
+        return false;
+    }
+    if (!cachePath.empty() && loadSignature(cachePath, signature) && signature.baseSize == size &&
+        signature.baseMtime == fileMtime(basePath)) {
+        LOG_DEBUG("Using cached delta signature " << cachePath);
+        return true;
+    }
+    if (!computeSignature(basePath, chooseBlockSize(size), signature, threads)) {
+        return false;
+    }
+    if (!cachePath.empty()) {
+        // 缓存写入失败不影响本次差量
+        fs::create_directories(fs::path(cachePath).parent_path(), ec);
+        saveSignature(cachePath, signature);
+    }
+    return true;
+}
+
+bool CDeltaEngine::createDelta(const std::string& targetPath, const DeltaSignature& signature,
+                               const std::string& baseRef, const std::string& deltaPath, DeltaStats* stats) {
+    const size_t L = signature.blockSize;
+    if (L == 0 || baseRef.size() > UINT16_MAX) {
+        LOG_ERROR("Error: Invalid delta signature for " << targetPath << ".");
+        return false;
+    }
+    std::ifstream in(targetPath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Error: Failed to open file " << targetPath << " for reading.");
+        return false;
+    }
+    std::ofstream out(deltaPath, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << deltaPath << " for writing.");
+        return false;
+    }
+
+    // 只有整块参与滚动查找；最后不足一块的尾部单独比较
+    const size_t blockCount = signature.blocks.size();
+    const size_t fullCount = static_cast<size_t>(signature.baseSize / L);
+    const size_t tailLen = static_cast<size_t>(signature.baseSize % L);
+    std::unordered_map<uint32_t, uint32_t> heads;
+    heads.reserve(fullCount);
+    std::vector<uint32_t> chain(fullCount, kNoBlock);
+    for (size_t i = fullCount; i-- > 0;) {
+        auto inserted = heads.emplace(signature.blocks[i].weak, static_cast<uint32_t>(i));
+        if (!inserted.second) {
+            chain[i] = inserted.first->second;
+            inserted.first->second = static_cast<uint32_t>(i);
+        }
+    }
+
+    // 文件头，目标大小与CRC32在最后回填
+    out.write(kDeltaMagic, sizeof(kDeltaMagic));
+    writeValue(out, kFormatVersion);
+    writeValue(out, static_cast<uint16_t>(baseRef.size()));
+    out.write(baseRef.data(), baseRef.size());
+    writeValue(out, signature.baseSize);
+    const std::streampos sizePos = out.tellp();
+    writeValue(out, uint64_t(0));
+    writeValue(out, uint32_t(0));
+
+    DeltaStats localStats;
+    DeltaWriter writer(out, localStats);
+    std::vector<uint8_t> buf(kMaxLiteral + 2 * L + kReadChunk);
+    size_t litStart = 0;  // 尚未写出的新数据起点
+    size_t pos = 0;       // 当前窗口起点
+    size_t end = 0;
+    bool eof = false;
+    uint64_t targetSize = 0;
+    uint32_t crc = CRC32::getInitialValue();
+
+    // 丢弃已写出的部分并继续读入
+    auto fill = [&]() {
+        if (litStart > 0) {
+            std::memmove(buf.data(), buf.data() + litStart, end - litStart);
+            pos -= litStart;
+            end -= litStart;
+            litStart = 0;
+        }
+        in.read(reinterpret_cast<char*>(buf.data() + end), static_cast<std::streamsize>(buf.size() - end));
+        const size_t n = static_cast<size_t>(in.gcount());
+        crc = updateCrc(crc, buf.data() + end, n);
+        end += n;
+        targetSize += n;
+        eof = !in;
+    };
+
+    auto findBlock = [&](uint32_t weak, const uint8_t* window) -> size_t {
+        uint64_t strong = 0;
+        bool hashed = false;
+        auto matches = [&](size_t i) {
+            if (signature.blocks[i].weak != weak) return false;
+            if (!hashed) {
+                strong = CXXHash64::hash(window, L);
+                hashed = true;
+            }
+            return signature.blocks[i].strong == strong;
+        };
+        // 优先尝试紧接上一个匹配的块，使连续区域合并为一条 COPY
+        const uint64_t expected = writer.expectedOffset();
+        if (expected != UINT64_MAX && expected % L == 0 && expected / L < fullCount && matches(size_t(expected / L))) {
+            return size_t(expected / L);
+        }
+        const auto found = heads.find(weak);
+        for (uint32_t i = found == heads.end() ? kNoBlock : found->second; i != kNoBlock; i = chain[i]) {
+            if (matches(i)) return i;
+        }
+        return SIZE_MAX;
+    };
+
+    uint32_t a = 0;
+    uint32_t b = 0;
+    bool rolling = false;
+    while (true) {
+        if (end - pos < L + 1 && !eof) {
+            fill();
+            continue;
+        }
+        if (end - pos < L || fullCount == 0) break;
+        if (!rolling) {
+            const uint32_t weak = weakChecksum(buf.data() + pos, L);
+            a = weak & 0xFFFF;
+            b = weak >> 16;
+            rolling = true;
+        }
+        const size_t block = findBlock(a | (b << 16), buf.data() + pos);
+        if (block != SIZE_MAX) {
+            writer.insert(buf.data() + litStart, pos - litStart);
+            writer.copy(uint64_t(block) * L, L);
+            pos += L;
+            litStart = pos;
+            rolling = false;
+            continue;
+        }
+        if (end - pos == L) break;  // 已到文件末尾
+        if (pos - litStart >= kMaxLiteral) {
+            writer.insert(buf.data() + litStart, pos - litStart);
+            litStart = pos;
+        }
+        // 窗口右移一个字节
+        const uint32_t outByte = buf[pos];
+        const uint32_t inByte = buf[pos + L];
+        a = (a - outByte + inByte) & 0xFFFF;
+        b = (b - static_cast<uint32_t>(L) * outByte + a) & 0xFFFF;
+        ++pos;
+    }
+    // 没有整块可匹配时直接读完剩余数据，只保留最后一块用于尾块比较
+    while (!eof) {
+        if (end - litStart > kMaxLiteral + L) {
+            writer.insert(buf.data() + litStart, end - L - litStart);
+            litStart = end - L;
+            pos = std::max(pos, litStart);
+        }
+        fill();
+    }
+    // 结尾恰好是基准文件的尾块时也可复用
+    const DeltaBlockSignature* tail = tailLen > 0 && blockCount > 0 ? &signature.blocks.back() : nullptr;
+    if (tail && end - litStart >= tailLen && tail->weak == weakChecksum(buf.data() + end - tailLen, tailLen) &&
+        tail->strong == CXXHash64::hash(buf.data() + end - tailLen, tailLen)) {
+        writer.insert(buf.data() + litStart, end - tailLen - litStart);
+        writer.copy(signature.baseSize - tailLen, tailLen);
+    } else {
+        writer.insert(buf.data() + litStart, end - litStart);
+    }
+    writer.finish();
+    if (in.bad()) {
+        LOG_ERROR("Error: Failed to read file " << targetPath << ".");
+        return false;
+    }
+
+    localStats.deltaSize = static_cast<uint64_t>(out.tellp());
+    out.seekp(sizePos);
+    writeValue(out, targetSize);
+    writeValue(out, CRC32::finalize(crc));
+    out.close();
+    if (!out) {
+        LOG_ERROR("Error: Failed to write file " << deltaPath << ".");
+        return false;
+    }
+    if (stats) {
+        *stats = localStats;
+    }
+    return true;
+}
+
+namespace {
+
+bool readHeader(std::istream& in, DeltaHeader& header) {
+    char magic[4];
+    uint8_t version = 0;
+    uint16_t refLen = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kDeltaMagic, sizeof(magic)) != 0 || !readValue(in, version) ||
+        version != kFormatVersion || !readValue(in, refLen)) {
+        return false;
+    }
+    header.baseRef.resize(refLen);
+    in.read(&header.baseRef[0], refLen);
+    return readValue(in, header.baseSize) && readValue(in, header.targetSize) && readValue(in, header.targetCrc32);
+}
+
+}  // namespace
+
+bool CDeltaEngine::readDeltaHeader(const std::string& deltaPath, DeltaHeader& header) {
+    std::ifstream in(deltaPath, std::ios::binary);
+    return in && readHeader(in, header);
+}
+
+bool CDeltaEngine::applyDelta(const std::string& basePath, const std::string& deltaPath, const std::string& outPath) {
+    std::ifstream delta(deltaPath, std::ios::binary);
+    DeltaHeader header;
+    if (!delta || !readHeader(delta, header)) {
+        LOG_ERROR("Error: File " << deltaPath << " is not a delta file.");
+        return false;
+    }
+    std::error_code ec;
+    std::ifstream base(basePath, std::ios::binary);
+    if (!base || fs::file_size(basePath, ec) != header.baseSize || ec) {
+        LOG_ERROR("Error: Delta base " << basePath << " is missing or has changed.");
+        return false;
+    }
+    std::ofstream out(outPath, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << outPath << " for writing.");
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(kReadChunk);
+    uint64_t written = 0;
+    uint32_t crc = CRC32::getInitialValue();
+    // 从 in 读取 len 字节追加到输出
+    auto transfer = [&](std::istream& in, uint64_t len) {
+        while (len > 0) {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(len, buffer.size()));
+            if (!in.read(reinterpret_cast<char*>(buffer.data()), n)) return false;
+            crc = updateCrc(crc, buffer.data(), n);
+            out.write(reinterpret_cast<const char*>(buffer.data()), n);
+            written += n;
+            len -= n;
+        }
+        return true;
+    };
+
+    bool ok = true;
+    while (ok) {
+        uint8_t op = 0;
+        if (!readValue(delta, op)) {
+            ok = false;
+        } else if (op == kOpEnd) {
+            break;
+        } else if (op == kOpCopy) {
+            uint64_t offset = 0;
+            uint64_t len = 0;
+            ok = readValue(delta, offset) && readValue(delta, len) && offset <= header.baseSize &&
+                 len <= header.baseSize - offset && written + len <= header.targetSize;
+            if (ok) {
+                base.seekg(static_cast<std::streamoff>(offset));
+                ok = transfer(base, len);
+            }
+        } else if (op == kOpInsert) {
+            uint32_t len = 0;
+            ok = readValue(delta, len) && written + len <= header.targetSize && transfer(delta, len);
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        LOG_ERROR("Error: Delta file " << deltaPath << " is truncated or corrupted.");
+        return false;
+    }
+    if (written != header.targetSize || CRC32::finalize(crc) != header.targetCrc32) {
+        LOG_ERROR("Error: CRC32 checksum mismatch. Reconstructed file " << outPath << " may be corrupted.");
+        return false;
+    }
+    out.close();
+    return static_cast<bool>(out);
+}
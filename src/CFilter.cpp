@@ -0,0 +1,503 @@
+#include "CFilter.h"
+#include "CCodecPolicy.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define FILTER_HAS_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+constexpr size_t kMinZeroRun = 4;                  // 达到这么多个 0 之后才写游程长度
+constexpr uint64_t kMaxZeroRun = uint64_t(1) << 32;  // 解码时拒绝更长的游程（数据损坏）
+constexpr size_t kDetectSample = 64 * 1024;         // 选择过滤器时抽样的字节数
+constexpr double kMinEntropyGain = 0.5;             // 差分后字节熵至少下降这么多（位/字节）才使用
+
+uint32_t loadU32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void storeU32(uint8_t* p, uint32_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+#ifdef FILTER_HAS_SSE2
+unsigned lowestBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// 从 i 开始找第一个（不）等于 0 的字节，没有时返回 len
+template <bool kZero>
+size_t findZero(const uint8_t* p, size_t i, size_t len) {
+#ifdef FILTER_HAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16) {
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), zero)));
+        if (!kZero) mask ^= 0xFFFF;
+        if (mask) return i + lowestBit(mask);
+    }
+#endif
+    while (i < len && (p[i] == 0) != kZero) ++i;
+    return i;
+}
+
+// 从 i 开始找第一个 E8/E9 字节，没有时返回 len
+size_t findBranch(const uint8_t* p, size_t i, size_t len) {
+#ifdef FILTER_HAS_SSE2
+    const __m128i maskFE = _mm_set1_epi8(static_cast<char>(0xFE));
+    const __m128i opcode = _mm_set1_epi8(static_cast<char>(0xE8));
+    for (; i + 16 <= len; i += 16) {
+        const __m128i x = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), maskFE);
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, opcode)));
+        if (mask) return i + lowestBit(mask);
+    }
+#endif
+    while (i < len && (p[i] & 0xFE) != 0xE8) ++i;
+    return i;
+}
+
+// 差分：out[i] = in[i] - in[i - stride]，流开头之前的字节视为 0
+class DeltaEncoder : public IFilterStream {
+public:
+    explicit DeltaEncoder(unsigned stride) : m_history(stride, 0) {}
+
+    void update(const uint8_t* data, size_t len, std::vector<uint8_t>& out) override {
+        const size_t stride = m_history.size();
+        const size_t start = out.size();
+        out.resize(start + len);
+        uint8_t* dst = out.data() + start;
+        const size_t head = std::min(len, stride);
+        for (size_t i = 0; i < head; ++i) {
+            dst[i] = static_cast<uint8_t>(data[i] - m_history[i]);
+        }
+        size_t i = head;
+#ifdef FILTER_HAS_SSE2
+        for (; i + 16 <= len; i += 16) {
+            const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i - stride));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_sub_epi8(cur, prev));
+        }
+#endif
+        for (; i < len; ++i) {
+            dst[i] = static_cast<uint8_t>(data[i] - data[i - stride]);
+        }
+        remember(data, len);
+    }
+
+    bool finish(std::vector<uint8_t>&) override { return true; }
+
+protected:
+    // 保留最后 stride 个原始字节，供下一段开头使用
+    void remember(const uint8_t* data, size_t len) {
+        const size_t stride = m_history.size();
+        if (len >= stride) {
+            std::memcpy(m_history.data(), data + len - stride, stride);
+        } else {
+            m_history.erase(m_history.begin(), m_history.begin() + len);
+            m_history.insert(m_history.end(), data, data + len);
+        }
+    }
+
+    std::vector<uint8_t> m_history;
+};
+
+#ifdef FILTER_HAS_SSE2
+// 步长为 S（1/2/4/8）时的 16 字节前缀和：先在寄存器内按步长累加，再加上前一段末尾 S 个字节
+template <int S>
+__m128i prefixSum(__m128i x, const uint8_t* prev) {
+    x = _mm_add_epi8(x, _mm_slli_si128(x, S));
+    if (S < 8) x = _mm_add_epi8(x, _mm_slli_si128(x, (2 * S) & 15));
+    if (S < 4) x = _mm_add_epi8(x, _mm_slli_si128(x, (4 * S) & 15));
+    if (S < 2) x = _mm_add_epi8(x, _mm_slli_si128(x, (8 * S) & 15));
+    __m128i carry;
+    switch (S) {
+        case 1: carry = _mm_set1_epi8(static_cast<char>(prev[0])); break;
+        case 2: { uint16_t v; std::memcpy(&v, prev, 2); carry = _mm_set1_epi16(static_cast<short>(v)); break; }
+        case 4: carry = _mm_set1_epi32(static_cast<int>(loadU32(prev))); break;
+        default: { uint64_t v; std::memcpy(&v, prev, 8); carry = _mm_set1_epi64x(static_cast<long long>(v)); break; }
+    }
+    return _mm_add_epi8(x, carry);
+}
+
+template <int S>
+size_t prefixSumLoop(const uint8_t* data, uint8_t* dst, size_t i, size_t len) {
+    for (; i + 16 <= len; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), prefixSum<S>(x, dst + i - S));
+    }
+    return i;
+}
+#endif
+
+// 差分还原：out[i] = in[i] + out[i - stride]
+class DeltaDecoder : public DeltaEncoder {
+public:
+    explicit DeltaDecoder(unsigned stride) : DeltaEncoder(stride) {}
+
+    void update(const uint8_t* data, size_t len, std::vector<uint8_t>& out) override {
+        const size_t stride = m_history.size();
+        const size_t start = out.size();
+        out.resize(start + len);
+        uint8_t* dst = out.data() + start;
+        const size_t head = std::min(len, stride);
+        for (size_t i = 0; i < head; ++i) {
+            dst[i] = static_cast<uint8_t>(data[i] + m_history[i]);
+        }
+        size_t i = head;
+#ifdef FILTER_HAS_SSE2
+        switch (stride) {
+            case 1: i = prefixSumLoop<1>(data, dst, i, len); break;
+            case 2: i = prefixSumLoop<2>(data, dst, i, len); break;
+            case 4: i = prefixSumLoop<4>(data, dst, i, len); break;
+            case 8: i = prefixSumLoop<8>(data, dst, i, len); break;
+            default:
+                // 步长不小于 16 时，16 个字节引用的都是已经还原的数据
+                for (; stride >= 16 && i + 16 <= len; i += 16) {
+                    const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    const __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i - stride));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi8(cur, prev));
+                }
+                break;
+        }
+#endif
+        for (; i < len; ++i) {
+            dst[i] = static_cast<uint8_t>(data[i] + dst[i - stride]);
+        }
+        remember(dst, len);
+    }
+};
+
+class ZeroRleEncoder : public IFilterStream {
+public:
+    void update(const uint8_t* data, size_t len, std::vector<uint8_t>& out) override {
+        size_t i = 0;
+        while (i < len) {
+            if (m_zeros == 0) {
+                const size_t j = findZero<true>(data, i, len);
+                out.insert(out.end(), data + i, data + j);
+                i = j;
+                if (i == len) break;
+            }
+            const size_t j = findZero<false>(data, i, len);
+            m_zeros += j - i;
+            i = j;
+            if (i < len) flushRun(out);
+        }
+    }
+
+    bool finish(std::vector<uint8_t>& out) override {
+        flushRun(out);
+        return true;
+    }
+
+private:
+    void flushRun(std::vector<uint8_t>& out) {
+        // 超过解码上限的游程拆成几段
+        while (m_zeros > kMaxZeroRun + kMinZeroRun) {
+            const uint64_t rest = m_zeros - kMaxZeroRun - kMinZeroRun;
+            m_zeros = kMaxZeroRun + kMinZeroRun;
+            flushRun(out);
+            m_zeros = rest;
+        }
+        if (m_zeros < kMinZeroRun) {
+            out.insert(out.end(), static_cast<size_t>(m_zeros), 0);
+        } else {
+            out.insert(out.end(), kMinZeroRun, 0);
+            for (uint64_t v = m_zeros - kMinZeroRun;; v >>= 7) {
+                if (v < 0x80) {
+                    out.push_back(static_cast<uint8_t>(v));
+                    break;
+                }
+                out.push_back(static_cast<uint8_t>(v | 0x80));
+            }
+        }
+        m_zeros = 0;
+    }
+
+    uint64_t m_zeros = 0;  // 当前游程中尚未输出的 0 的个数
+};
+
+class ZeroRleDecoder : public IFilterStream {
+public:
+    void update(const uint8_t* data, size_t len, std::vector<uint8_t>& out) override {
+        size_t i = 0;
+        while (i < len && !m_failed) {
+            if (m_inCount) {
+                const uint8_t b = data[i++];
+                m_count |= uint64_t(b & 0x7F) << m_shift;
+                m_shift += 7;
+                if (m_count > kMaxZeroRun || m_shift > 35) {
+                    m_failed = true;
+                } else if (!(b & 0x80)) {
+                    out.insert(out.end(), static_cast<size_t>(m_count), 0);
+                    m_inCount = false;
+                }
+                continue;
+            }
+            if (data[i] != 0) {
+                const size_t j = findZero<true>(data, i, len);
+                out.insert(out.end(), data + i, data + j);
+                i = j;
+                m_zeros = 0;
+                continue;
+            }
+            out.push_back(0);
+            ++i;
+            if (++m_zeros == kMinZeroRun) {
+                m_zeros = 0;
+                m_inCount = true;
+                m_count = 0;
+                m_shift = 0;
+            }
+        }
+    }
+
+    bool finish(std::vector<uint8_t>&) override { return !m_failed && !m_inCount; }
+
+private:
+    size_t m_zeros = 0;      // 已经连续输出的 0
+    bool m_inCount = false;  // 正在读取游程长度
+    uint64_t m_count = 0;
+    unsigned m_shift = 0;
+    bool m_failed = false;
+};
+
+// E8/E9 之后的 32 位相对地址与绝对地址互换；只转换高字节为 00/FF（±16MB 以内）的地址，
+// 结果按 25 位符号扩展，高字节仍为 00/FF，解码时据此做出与编码时相同的判断
+class X86Filter : public IFilterStream {
+public:
+    explicit X86Filter(bool encoding) : m_encoding(encoding) {}
+
+    void update(const uint8_t* data, size_t len, std::vector<uint8_t>& out) override {
+        m_buffer.insert(m_buffer.end(), data, data + len);
+        uint8_t* p = m_buffer.data();
+        const size_t size = m_buffer.size();
+        size_t i = 0;
+        while (i + 5 <= size) {
+            i = findBranch(p, i, size - 4);
+            if (i + 5 > size) break;
+            // 不论是否转换都跳过整条指令，保证编码、解码判断的是同样未被改写的操作码
+            const uint32_t v = loadU32(p + i + 1);
+            const uint32_t top = v >> 24;
+            if (top == 0 || top == 0xFF) {
+                const uint32_t ip = static_cast<uint32_t>(m_position + i + 5);
+                uint32_t converted = (m_encoding ? v + ip : v - ip) & 0x01FFFFFF;
+                if (converted & 0x01000000) converted |= 0xFE000000;
+                storeU32(p + i + 1, converted);
+            }
+            i += 5;
+        }
+        // 不足 5 个字节、还不能判断的尾部留到下一段
+        out.insert(out.end(), p, p + i);
+        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + i);
+        m_position += i;
+    }
+
+    bool finish(std::vector<uint8_t>& out) override {
+        out.insert(out.end(), m_buffer.begin(), m_buffer.end());
+        m_position += m_buffer.size();
+        m_buffer.clear();
+        return true;
+    }
+
+private:
+    bool m_encoding;
+    std::vector<uint8_t> m_buffer;  // 尚未输出的字节
+    uint64_t m_position = 0;        // m_buffer[0] 在流中的位置
+};
+
+bool validSpec(const FilterSpec& spec) {
+    switch (spec.type) {
+        case FilterType::Delta: return spec.param >= 1;
+        case FilterType::ZeroRle:
+        case FilterType::X86: return spec.param == 0;
+        default: return false;
+    }
+}
+
+// 让数据依次通过各级过滤器，分段传递
+bool runChain(std::vector<std::unique_ptr<IFilterStream>>& stages, const uint8_t* src, size_t len,
+              std::vector<uint8_t>& out) {
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> next;
+    auto feed = [&](size_t stage, const uint8_t* data, size_t n) {
+        for (; stage < stages.size(); ++stage) {
+            next.clear();
+            stages[stage]->update(data, n, next);
+            current.swap(next);
+            data = current.data();
+            n = current.size();
+        }
+        out.insert(out.end(), data, data + n);
+    };
+    for (size_t offset = 0; offset < len; offset += CFilterChain::kChunkSize) {
+        feed(0, src + offset, std::min(CFilterChain::kChunkSize, len - offset));
+    }
+    bool ok = true;
+    std::vector<uint8_t> tail;
+    for (size_t stage = 0; stage < stages.size(); ++stage) {
+        tail.clear();
+        ok = stages[stage]->finish(tail) && ok;
+        feed(stage + 1, tail.data(), tail.size());
+    }
+    return ok;
+}
+
+}  // namespace
+
+std::unique_ptr<IFilterStream> CFilterChain::createEncoder(const FilterSpec& spec) {
+    if (!validSpec(spec)) return nullptr;
+    switch (spec.type) {
+        case FilterType::Delta: return std::make_unique<DeltaEncoder>(spec.param);
+        case FilterType::ZeroRle: return std::make_unique<ZeroRleEncoder>();
+        default: return std::make_unique<X86Filter>(true);
+    }
+}
+
+std::unique_ptr<IFilterStream> CFilterChain::createDecoder(const FilterSpec& spec) {
+    if (!validSpec(spec)) return nullptr;
+    switch (spec.type) {
+        case FilterType::Delta: return std::make_unique<DeltaDecoder>(spec.param);
+        case FilterType::ZeroRle: return std::make_unique<ZeroRleDecoder>();
+        default: return std::make_unique<X86Filter>(false);
+    }
+}
+
+void CFilterChain::encode(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const {
+    std::vector<std::unique_ptr<IFilterStream>> stages;
+    for (const FilterSpec& spec : m_filters) {
+        stages.push_back(createEncoder(spec));
+    }
+    runChain(stages, src, len, out);
+}
+
+bool CFilterChain::decode(const uint8_t* src, size_t len, std::vector<uint8_t>& out) const {
+    std::vector<std::unique_ptr<IFilterStream>> stages;
+    for (auto it = m_filters.rbegin(); it != m_filters.rend(); ++it) {
+        stages.push_back(createDecoder(*it));
+    }
+    return runChain(stages, src, len, out);
+}
+
+void CFilterChain::writeHeader(std::vector<char>& out) const {
+    out.push_back(static_cast<char>(m_filters.size()));
+    for (const FilterSpec& spec : m_filters) {
+        out.push_back(static_cast<char>(spec.type));
+        out.push_back(static_cast<char>(spec.param));
+    }
+}
+
+bool CFilterChain::readHeader(const uint8_t* src, size_t len, CFilterChain& chain, size_t& consumed) {
+    if (len < 1 || src[0] > kMaxFilters || len < 1 + 2 * size_t(src[0])) return false;
+    std::vector<FilterSpec> filters;
+    for (size_t k = 0; k < src[0]; ++k) {
+        const FilterSpec spec{static_cast<FilterType>(src[1 + 2 * k]), src[2 + 2 * k]};
+        if (!validSpec(spec)) return false;
+        filters.push_back(spec);
+    }
+    chain = CFilterChain(std::move(filters));
+    consumed = 1 + 2 * chain.m_filters.size();
+    return true;
+}
+
+bool CFilterChain::parse(const std::string& text, CFilterChain& chain) {
+    std::vector<FilterSpec> filters;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        const size_t colon = item.find(':');
+        const std::string name = item.substr(0, colon);
+        const std::string arg = colon == std::string::npos ? "" : item.substr(colon + 1);
+        FilterSpec spec{FilterType::ZeroRle, 0};
+        if (name == "delta") {
+            int stride = 1;
+            try {
+                if (!arg.empty()) stride = std::stoi(arg);
+            } catch (const std::exception&) {
+                return false;
+            }
+            if (stride < 1 || stride > 255) return false;
+            spec = {FilterType::Delta, static_cast<uint8_t>(stride)};
+        } else if (name == "zrle" && arg.empty()) {
+            spec = {FilterType::ZeroRle, 0};
+        } else if (name == "x86" && arg.empty()) {
+            spec = {FilterType::X86, 0};
+        } else {
+            return false;
+        }
+        filters.push_back(spec);
+    }
+    if (filters.size() > kMaxFilters) return false;
+    chain = CFilterChain(std::move(filters));
+    return true;
+}
+
+std::string CFilterChain::toString() const {
+    std::string text;
+    for (const FilterSpec& spec : m_filters) {
+        if (!text.empty()) text += ",";
+        switch (spec.type) {
+            case FilterType::Delta: text += "delta:" + std::to_string(spec.param); break;
+            case FilterType::ZeroRle: text += "zrle"; break;
+            case FilterType::X86: text += "x86"; break;
+        }
+    }
+    return text;
+}
+
+CFilterChain CFilterChain::detect(const uint8_t* data, size_t len) {
+    std::vector<FilterSpec> filters;
+    const size_t n = std::min(len, kDetectSample);
+    // PE（MZ）与 ELF 可执行文件
+    if (n >= 4 && ((data[0] == 'M' && data[1] == 'Z') || std::memcmp(data, "\x7f" "ELF", 4) == 0)) {
+        filters.push_back({FilterType::X86, 0});
+    }
+
+    // 比较各步长差分后的字节熵
+    std::vector<uint8_t> sample(data, data + n);
+    if (filters.empty() && n >= 1024) {
+        double best = CCodecPolicy::entropy(reinterpret_cast<const char*>(data), n) - kMinEntropyGain;
+        unsigned bestStride = 0;
+        std::vector<uint8_t> delta;
+        for (unsigned stride : {1u, 2u, 3u, 4u, 8u}) {
+            delta.clear();
+            DeltaEncoder(stride).update(data, n, delta);
+            const double e = CCodecPolicy::entropy(reinterpret_cast<const char*>(delta.data()), n);
+            if (e < best) {
+                best = e;
+                bestStride = stride;
+                sample.swap(delta);
+            }
+        }
+        if (bestStride) filters.push_back({FilterType::Delta, static_cast<uint8_t>(bestStride)});
+    }
+
+    // 至少八分之一的字节处在 16 个以上的 0 组成的游程中
+    size_t zeroRunBytes = 0;
+    for (size_t i = findZero<true>(sample.data(), 0, sample.size()); i < sample.size();) {
+        const size_t j = findZero<false>(sample.data(), i, sample.size());
+        if (j - i >= 16) zeroRunBytes += j - i;
+        i = findZero<true>(sample.data(), j, sample.size());
+    }
+    if (n > 0 && zeroRunBytes * 8 >= n) {
+        filters.push_back({FilterType::ZeroRle, 0});
+    }
+    return CFilterChain(std::move(filters));
+}
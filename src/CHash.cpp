@@ -0,0 +1,514 @@
+#include "CHash.h"
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HASH_HAS_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 按小端读取，与平台字节序无关
+inline uint64_t readLE64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+inline uint32_t readLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round64(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+}
+
+CXXHash64::CXXHash64(uint64_t seed) {
+    reset(seed);
+}
+
+void CXXHash64::reset(uint64_t seed) {
+    m_seed = seed;
+    m_acc[0] = seed + PRIME64_1 + PRIME64_2;
+    m_acc[1] = seed + PRIME64_2;
+    m_acc[2] = seed;
+    m_acc[3] = seed - PRIME64_1;
+    m_bufferSize = 0;
+    m_totalLen = 0;
+}
+
+void CXXHash64::update(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_totalLen += len;
+
+    // 先补满缓冲区中剩余的条带
+    if (m_bufferSize > 0) {
+        const size_t fill = std::min<size_t>(len, 32 - m_bufferSize);
+        std::memcpy(m_buffer + m_bufferSize, p, fill);
+        m_bufferSize += fill;
+        p += fill;
+        len -= fill;
+        if (m_bufferSize < 32) {
+            return;
+        }
+        for (int i = 0; i < 4; ++i) {
+            m_acc[i] = round64(m_acc[i], readLE64(m_buffer + i * 8));
+        }
+        m_bufferSize = 0;
+    }
+
+    // 每32字节一个条带，四路累加
+    while (len >= 32) {
+        for (int i = 0; i < 4; ++i) {
+            m_acc[i] = round64(m_acc[i], readLE64(p + i * 8));
+        }
+        p += 32;
+        len -= 32;
+    }
+
+    if (len > 0) {
+        std::memcpy(m_buffer, p, len);
+        m_bufferSize = len;
+    }
+}
+
+uint64_t CXXHash64::digest() const {
+    uint64_t h;
+    if (m_totalLen >= 32) {
+        h = rotl64(m_acc[0], 1) + rotl64(m_acc[1], 7) + rotl64(m_acc[2], 12) + rotl64(m_acc[3], 18);
+        for (int i = 0; i < 4; ++i) {
+            h = mergeRound(h, m_acc[i]);
+        }
+    } else {
+        h = m_seed + PRIME64_5;
+    }
+    h += m_totalLen;
+
+    // 处理缓冲区中不足一个条带的尾部
+    const uint8_t* p = m_buffer;
+    size_t len = m_bufferSize;
+    while (len >= 8) {
+        h ^= round64(0, readLE64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h ^= static_cast<uint64_t>(readLE32(p)) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        ++p;
+        --len;
+    }
+    return avalanche(h);
+}
+
+uint64_t CXXHash64::hash(const void* data, size_t len, uint64_t seed) {
+    CXXHash64 state(seed);
+    state.update(data, len);
+    return state.digest();
+}
+
+bool CXXHash64::hashFile(const std::string& path, uint64_t& result, uint64_t seed) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    CXXHash64 state(seed);
+    std::vector<char> buffer(1024 * 1024);
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        const std::streamsize n = in.gcount();
+        if (n > 0) {
+            state.update(buffer.data(), static_cast<size_t>(n));
+        }
+    }
+    if (in.bad()) {
+        return false;
+    }
+    result = state.digest();
+    return true;
+}
+
+namespace {
+constexpr uint32_t PRIME32_1 = 0x9E3779B1U;
+constexpr uint32_t PRIME32_2 = 0x85EBCA77U;
+constexpr uint32_t PRIME32_3 = 0xC2B2AE3DU;
+constexpr uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t kStripeLen = 64;
+constexpr size_t kSecretSize = 192;
+constexpr size_t kStripesPerBlock = (kSecretSize - kStripeLen) / 8;  // 每个条带的密钥向后移 8 字节
+constexpr size_t kMidSizeMax = 240;
+constexpr size_t kLastStripeOffset = kSecretSize - kStripeLen - 7;
+constexpr size_t kMergeOffset = 11;
+
+// XXH3 的默认密钥
+alignas(16) constexpr uint8_t kSecret[kSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+constexpr uint64_t kInitAcc[8] = {
+    PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1,
+};
+
+// 64x64 -> 128 位乘法
+inline Hash128 mult64to128(uint64_t a, uint64_t b) {
+    Hash128 r;
+#if defined(_MSC_VER) && defined(_M_X64)
+    r.low = _umul128(a, b, &r.high);
+#elif defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 u128;  // 避免 -Wpedantic 警告
+    const u128 product = static_cast<u128>(a) * b;
+    r.low = static_cast<uint64_t>(product);
+    r.high = static_cast<uint64_t>(product >> 64);
+#else
+    const uint64_t loLo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    const uint64_t hiLo = (a >> 32) * (b & 0xFFFFFFFF);
+    const uint64_t loHi = (a & 0xFFFFFFFF) * (b >> 32);
+    const uint64_t hiHi = (a >> 32) * (b >> 32);
+    const uint64_t cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+    r.high = (hiLo >> 32) + (cross >> 32) + hiHi;
+    r.low = (cross << 32) | (loLo & 0xFFFFFFFF);
+#endif
+    return r;
+}
+
+inline uint64_t mulFold64(uint64_t a, uint64_t b) {
+    const Hash128 product = mult64to128(a, b);
+    return product.low ^ product.high;
+}
+
+inline uint32_t rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t swap32(uint32_t x) {
+    return ((x << 24) & 0xFF000000) | ((x << 8) & 0x00FF0000) | ((x >> 8) & 0x0000FF00) | ((x >> 24) & 0x000000FF);
+}
+
+inline uint64_t swap64(uint64_t x) {
+    return (static_cast<uint64_t>(swap32(static_cast<uint32_t>(x))) << 32) | swap32(static_cast<uint32_t>(x >> 32));
+}
+
+// 输入已经部分混合时使用的快速雪崩
+inline uint64_t avalanche3(uint64_t h) {
+    h ^= h >> 37;
+    h *= PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t mix16B(const uint8_t* input, const uint8_t* secret) {
+    return mulFold64(readLE64(input) ^ readLE64(secret), readLE64(input + 8) ^ readLE64(secret + 8));
+}
+
+inline void mix32B(Hash128& acc, const uint8_t* input1, const uint8_t* input2, const uint8_t* secret) {
+    acc.low += mix16B(input1, secret);
+    acc.low ^= readLE64(input2) + readLE64(input2 + 8);
+    acc.high += mix16B(input2, secret + 16);
+    acc.high ^= readLE64(input1) + readLE64(input1 + 8);
+}
+
+// 17~240 字节的收尾
+inline Hash128 finishMid(const Hash128& acc, size_t len) {
+    Hash128 h;
+    h.low = avalanche3(acc.low + acc.high);
+    h.high = 0 - avalanche3(acc.low * PRIME64_1 + acc.high * PRIME64_4 + len * PRIME64_2);
+    return h;
+}
+
+// 不超过 240 字节的输入
+Hash128 hashShort(const uint8_t* p, size_t len) {
+    Hash128 h;
+    if (len == 0) {
+        h.low = avalanche(readLE64(kSecret + 64) ^ readLE64(kSecret + 72));
+        h.high = avalanche(readLE64(kSecret + 80) ^ readLE64(kSecret + 88));
+        return h;
+    }
+    if (len <= 3) {
+        const uint32_t combinedLow = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[len >> 1]) << 24) |
+                                     p[len - 1] | (static_cast<uint32_t>(len) << 8);
+        const uint32_t combinedHigh = rotl32(swap32(combinedLow), 13);
+        h.low = avalanche(combinedLow ^ static_cast<uint64_t>(readLE32(kSecret) ^ readLE32(kSecret + 4)));
+        h.high = avalanche(combinedHigh ^ static_cast<uint64_t>(readLE32(kSecret + 8) ^ readLE32(kSecret + 12)));
+        return h;
+    }
+    if (len <= 8) {
+        const uint64_t input = readLE32(p) + (static_cast<uint64_t>(readLE32(p + len - 4)) << 32);
+        const uint64_t keyed = input ^ (readLE64(kSecret + 16) ^ readLE64(kSecret + 24));
+        h = mult64to128(keyed, PRIME64_1 + (len << 2));
+        h.high += h.low << 1;
+        h.low ^= h.high >> 3;
+        h.low ^= h.low >> 35;
+        h.low *= PRIME_MX2;
+        h.low ^= h.low >> 28;
+        h.high = avalanche3(h.high);
+        return h;
+    }
+    if (len <= 16) {
+        const uint64_t bitflipLow = readLE64(kSecret + 32) ^ readLE64(kSecret + 40);
+        const uint64_t bitflipHigh = readLE64(kSecret + 48) ^ readLE64(kSecret + 56);
+        const uint64_t inputLow = readLE64(p);
+        uint64_t inputHigh = readLE64(p + len - 8);
+        Hash128 m = mult64to128(inputLow ^ inputHigh ^ bitflipLow, PRIME64_1);
+        m.low += static_cast<uint64_t>(len - 1) << 54;
+        inputHigh ^= bitflipHigh;
+        m.high += inputHigh + static_cast<uint64_t>(static_cast<uint32_t>(inputHigh)) * (PRIME32_2 - 1);
+        m.low ^= swap64(m.high);
+        h = mult64to128(m.low, PRIME64_2);
+        h.high += m.high * PRIME64_2;
+        h.low = avalanche3(h.low);
+        h.high = avalanche3(h.high);
+        return h;
+    }
+    Hash128 acc{len * PRIME64_1, 0};
+    if (len <= 128) {
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) mix32B(acc, p + 48, p + len - 64, kSecret + 96);
+                mix32B(acc, p + 32, p + len - 48, kSecret + 64);
+            }
+            mix32B(acc, p + 16, p + len - 32, kSecret + 32);
+        }
+        mix32B(acc, p, p + len - 16, kSecret);
+        return finishMid(acc, len);
+    }
+    for (size_t i = 32; i < 160; i += 32) {
+        mix32B(acc, p + i - 32, p + i - 16, kSecret + i - 32);
+    }
+    acc.low = avalanche3(acc.low);
+    acc.high = avalanche3(acc.high);
+    for (size_t i = 160; i <= len; i += 32) {
+        mix32B(acc, p + i - 32, p + i - 16, kSecret + 3 + i - 160);
+    }
+    mix32B(acc, p + len - 16, p + len - 32, kSecret + 136 - 17 - 16);
+    return finishMid(acc, len);
+}
+
+// 累加一个 64 字节条带：每路 acc += 相邻路的输入 + (输入^密钥) 低 32 位 × 高 32 位
+inline void accumulateStripe(uint64_t* acc, const uint8_t* input, const uint8_t* secret) {
+#ifdef HASH_HAS_SSE2
+    __m128i* const xacc = reinterpret_cast<__m128i*>(acc);
+    for (size_t i = 0; i < 4; ++i) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        const __m128i dataKey = _mm_xor_si128(data, key);
+        const __m128i product = _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+        const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm_add_epi64(product, _mm_add_epi64(xacc[i], swapped));
+    }
+#else
+    for (size_t i = 0; i < 8; ++i) {
+        const uint64_t data = readLE64(input + i * 8);
+        const uint64_t dataKey = data ^ readLE64(secret + i * 8);
+        acc[i ^ 1] += data;
+        acc[i] += (dataKey & 0xFFFFFFFF) * (dataKey >> 32);
+    }
+#endif
+}
+
+// 每处理完一块（16 个条带）打乱一次累加器
+inline void scramble(uint64_t* acc, const uint8_t* secret) {
+#ifdef HASH_HAS_SSE2
+    __m128i* const xacc = reinterpret_cast<__m128i*>(acc);
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+    for (size_t i = 0; i < 4; ++i) {
+        const __m128i value = _mm_xor_si128(xacc[i], _mm_srli_epi64(xacc[i], 47));
+        const __m128i dataKey = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+        const __m128i productLow = _mm_mul_epu32(dataKey, prime);
+        const __m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        xacc[i] = _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32));
+    }
+#else
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t value = acc[i] ^ (acc[i] >> 47);
+        value ^= readLE64(secret + i * 8);
+        acc[i] = value * PRIME32_1;
+    }
+#endif
+}
+
+// 依次处理若干条带，stripesInBlock 记录当前块内的位置（跨多次调用）
+void accumulateStripes(uint64_t* acc, const uint8_t* input, size_t count, size_t& stripesInBlock) {
+    for (size_t n = 0; n < count; ++n) {
+        accumulateStripe(acc, input + n * kStripeLen, kSecret + stripesInBlock * 8);
+        if (++stripesInBlock == kStripesPerBlock) {
+            scramble(acc, kSecret + kSecretSize - kStripeLen);
+            stripesInBlock = 0;
+        }
+    }
+}
+
+inline uint64_t mergeAccs(const uint64_t* acc, const uint8_t* secret, uint64_t start) {
+    uint64_t result = start;
+    for (size_t i = 0; i < 4; ++i) {
+        result += mulFold64(acc[2 * i] ^ readLE64(secret + 16 * i), acc[2 * i + 1] ^ readLE64(secret + 16 * i + 8));
+    }
+    return avalanche3(result);
+}
+
+// 长输入的收尾：加入最后一个条带（与已处理的数据可能重叠），合并累加器
+Hash128 finishLong(uint64_t* acc, const uint8_t* lastStripe, uint64_t len) {
+    accumulateStripe(acc, lastStripe, kSecret + kLastStripeOffset);
+    Hash128 h;
+    h.low = mergeAccs(acc, kSecret + kMergeOffset, len * PRIME64_1);
+    h.high = mergeAccs(acc, kSecret + kSecretSize - 64 - kMergeOffset, ~(len * PRIME64_2));
+    return h;
+}
+}
+
+std::string Hash128::toHex() const {
+    static const char* const kDigits = "0123456789abcdef";
+    std::string hex(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        hex[15 - i] = kDigits[(high >> (4 * i)) & 0xF];
+        hex[31 - i] = kDigits[(low >> (4 * i)) & 0xF];
+    }
+    return hex;
+}
+
+CXXHash128::CXXHash128() {
+    reset();
+}
+
+void CXXHash128::reset() {
+    std::memcpy(m_acc, kInitAcc, sizeof(m_acc));
+    m_bufferSize = 0;
+    m_stripesInBlock = 0;
+    m_totalLen = 0;
+}
+
+void CXXHash128::update(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    m_totalLen += len;
+    if (m_bufferSize + len <= sizeof(m_buffer)) {
+        if (len > 0) std::memcpy(m_buffer + m_bufferSize, p, len);
+        m_bufferSize += len;
+        return;
+    }
+
+    // 条带只有在其后还有数据时才能处理（最后一个条带在 digest 中单独处理），因此总保留至少一个字节
+    if (m_bufferSize > 0) {
+        const size_t fill = sizeof(m_buffer) - m_bufferSize;
+        std::memcpy(m_buffer + m_bufferSize, p, fill);
+        p += fill;
+        len -= fill;
+        accumulateStripes(m_acc, m_buffer, sizeof(m_buffer) / kStripeLen, m_stripesInBlock);
+        std::memcpy(m_lastStripe, m_buffer + sizeof(m_buffer) - kStripeLen, kStripeLen);
+        m_bufferSize = 0;
+    }
+    if (len > sizeof(m_buffer)) {
+        const size_t bulk = (len - 1) / sizeof(m_buffer) * sizeof(m_buffer);
+        accumulateStripes(m_acc, p, bulk / kStripeLen, m_stripesInBlock);
+        std::memcpy(m_lastStripe, p + bulk - kStripeLen, kStripeLen);
+        p += bulk;
+        len -= bulk;
+    }
+    std::memcpy(m_buffer, p, len);
+    m_bufferSize = len;
+}
+
+Hash128 CXXHash128::digest() const {
+    if (m_totalLen <= kMidSizeMax) {
+        return hashShort(m_buffer, static_cast<size_t>(m_totalLen));
+    }
+    alignas(16) uint64_t acc[8];
+    std::memcpy(acc, m_acc, sizeof(acc));
+    size_t stripesInBlock = m_stripesInBlock;
+    accumulateStripes(acc, m_buffer, (m_bufferSize - 1) / kStripeLen, stripesInBlock);
+    // 缓冲区不足一个条带时，用之前处理过的数据补齐
+    uint8_t lastStripe[kStripeLen];
+    const uint8_t* last = m_buffer + m_bufferSize - kStripeLen;
+    if (m_bufferSize < kStripeLen) {
+        const size_t head = kStripeLen - m_bufferSize;
+        std::memcpy(lastStripe, m_lastStripe + m_bufferSize, head);
+        std::memcpy(lastStripe + head, m_buffer, m_bufferSize);
+        last = lastStripe;
+    }
+    return finishLong(acc, last, m_totalLen);
+}
+
+Hash128 CXXHash128::hash(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    if (len <= kMidSizeMax) {
+        return hashShort(p, len);
+    }
+    alignas(16) uint64_t acc[8];
+    std::memcpy(acc, kInitAcc, sizeof(acc));
+    size_t stripesInBlock = 0;
+    accumulateStripes(acc, p, (len - 1) / kStripeLen, stripesInBlock);
+    return finishLong(acc, p + len - kStripeLen, len);
+}
+
+bool CXXHash128::hashFile(const std::string& path, Hash128& result) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    CXXHash128 state;
+    std::vector<char> buffer(1024 * 1024);
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        const std::streamsize n = in.gcount();
+        if (n > 0) {
+            state.update(buffer.data(), static_cast<size_t>(n));
+        }
+    }
+    if (in.bad()) {
+        return false;
+    }
+    result = state.digest();
+    return true;
+}
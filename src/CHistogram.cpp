@@ -0,0 +1,113 @@
+#include "CHistogram.h"
+#include "CCpuFeatures.h"
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kSubTables = 4;
+// 子表为 32 位计数，每次最多统计这么多字节后合并一次，避免溢出
+constexpr size_t kMaxChunk = size_t(1) << 30;
+
+using SubTables = uint32_t[kSubTables][256];
+
+void mergeInto(const SubTables& tables, CHistogram::Counts& counts) {
+    for (size_t s = 0; s < 256; ++s) {
+        counts[s] += uint64_t(tables[0][s]) + tables[1][s] + tables[2][s] + tables[3][s];
+    }
+}
+
+// 每次读取 8 字节，相邻字节落在不同的子表
+void countScalarChunk(const uint8_t* data, size_t len, SubTables& t) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, data + i, 8);
+        ++t[0][v & 0xFF];
+        ++t[1][(v >> 8) & 0xFF];
+        ++t[2][(v >> 16) & 0xFF];
+        ++t[3][(v >> 24) & 0xFF];
+        ++t[0][(v >> 32) & 0xFF];
+        ++t[1][(v >> 40) & 0xFF];
+        ++t[2][(v >> 48) & 0xFF];
+        ++t[3][v >> 56];
+    }
+    for (; i < len; ++i) {
+        ++t[i & 3][data[i]];
+    }
+}
+
+#ifdef CPU_HAS_X86
+
+// 长串快速路径：向量比较只用于判断整段是否为同一字节，其余情况与标量实现相同
+CPU_TARGET_AVX2 void countRunsAvx2Chunk(const uint8_t* data, size_t len, SubTables& t) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i first = _mm256_set1_epi8(static_cast<char>(data[i]));
+        // 整段相同（零页、填充、重复字符）时一次计入
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, first)) == -1) {
+            t[0][data[i]] += 32;
+            continue;
+        }
+        for (int lane = 0; lane < 4; ++lane) {
+            uint64_t w;
+            std::memcpy(&w, data + i + 8 * lane, 8);
+            ++t[0][w & 0xFF];
+            ++t[1][(w >> 8) & 0xFF];
+            ++t[2][(w >> 16) & 0xFF];
+            ++t[3][(w >> 24) & 0xFF];
+            ++t[0][(w >> 32) & 0xFF];
+            ++t[1][(w >> 40) & 0xFF];
+            ++t[2][(w >> 48) & 0xFF];
+            ++t[3][w >> 56];
+        }
+    }
+    countScalarChunk(data + i, len - i, t);
+}
+
+#endif
+
+using ChunkKernel = void (*)(const uint8_t*, size_t, SubTables&);
+
+ChunkKernel chunkKernel(HistogramKernel kernel) {
+#ifdef CPU_HAS_X86
+    if (kernel == HistogramKernel::Avx2Runs) return countRunsAvx2Chunk;
+#endif
+    (void)kernel;
+    return countScalarChunk;
+}
+
+void run(ChunkKernel kernel, const uint8_t* data, size_t len, CHistogram::Counts& counts) {
+    while (len > 0) {
+        const size_t n = std::min(len, kMaxChunk);
+        SubTables tables = {};
+        kernel(data, n, tables);
+        mergeInto(tables, counts);
+        data += n;
+        len -= n;
+    }
+}
+
+}  // namespace
+
+HistogramKernel CHistogram::activeKernel() {
+    static const HistogramKernel kernel = CCpuFeatures::hasAvx2() ? HistogramKernel::Avx2Runs : HistogramKernel::Scalar;
+    return kernel;
+}
+
+const char* CHistogram::kernelName(HistogramKernel kernel) {
+    return kernel == HistogramKernel::Avx2Runs ? "avx2-runs" : "scalar";
+}
+
+void CHistogram::count(const uint8_t* data, size_t len, Counts& counts) {
+    run(chunkKernel(activeKernel()), data, len, counts);
+}
+
+bool CHistogram::countWith(HistogramKernel kernel, const uint8_t* data, size_t len, Counts& counts) {
+    if (kernel == HistogramKernel::Avx2Runs && activeKernel() != HistogramKernel::Avx2Runs) {
+        return false;
+    }
+    run(chunkKernel(kernel), data, len, counts);
+    return true;
+}
@@ -0,0 +1,128 @@
+#include "CLogger.h"
+#include <iostream>
+
+CLogger& CLogger::instance() {
+    static CLogger logger;
+    return logger;
+}
+
+CLogger::CLogger(size_t capacity) : m_ring(capacity == 0 ? 1 : capacity) {
+    m_worker = std::thread(&CLogger::run, this);
+}
+
+CLogger::~CLogger() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_spaceCv.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void CLogger::log(LogLevel level, std::string message) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // Warning/Error 不丢弃：等待后台线程取走当前消息腾出空间
+        if (level >= LogLevel::Warning) {
+            m_spaceCv.wait(lock, [&] { return m_size < m_ring.size() || m_stop; });
+        }
+        if (m_size == m_ring.size()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Entry& entry = m_ring[(m_head + m_size) % m_ring.size()];
+        entry.level = level;
+        entry.message = std::move(message);
+        ++m_size;
+        ++m_enqueued;
+    }
+    m_cv.notify_one();
+}
+
+void CLogger::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const uint64_t target = m_enqueued;
+    m_cv.notify_one();
+    m_flushedCv.wait(lock, [&] { return m_written >= target || m_stop; });
+}
+
+void CLogger::setSink(Sink sink) {
+    flush();
+    std::lock_guard<std::mutex> lock(m_sinkMutex);
+    m_sink = std::move(sink);
+}
+
+const char* CLogger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "Debug";
+        case LogLevel::Info: return "Info";
+        case LogLevel::Warning: return "Warning";
+        case LogLevel::Error: return "Error";
+        default: return "Off";
+    }
+}
+
+void CLogger::run() {
+    std::vector<Entry> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [&] { return m_size > 0 || m_stop; });
+        if (m_size == 0 && m_stop) {
+            break;
+        }
+
+        // 取出当前所有消息后释放锁，写出期间调用方可以继续放入
+        batch.clear();
+        while (m_size > 0) {
+            batch.push_back(std::move(m_ring[m_head]));
+            m_head = (m_head + 1) % m_ring.size();
+            --m_size;
+        }
+        const uint64_t dropped = m_dropped.load(std::memory_order_relaxed) - m_reportedDropped;
+        m_reportedDropped += dropped;
+        lock.unlock();
+        m_spaceCv.notify_all();
+
+        write(batch, dropped);
+
+        lock.lock();
+        m_written += batch.size();
+        m_flushedCv.notify_all();
+    }
+    m_flushedCv.notify_all();
+}
+
+void CLogger::write(std::vector<Entry>& batch, uint64_t dropped) {
+    std::lock_guard<std::mutex> lock(m_sinkMutex);
+    if (m_sink) {
+        for (const auto& entry : batch) {
+            m_sink(entry.level, entry.message);
+        }
+        if (dropped > 0) {
+            m_sink(LogLevel::Warning, "Warning: " + std::to_string(dropped) + " log message(s) dropped");
+        }
+        return;
+    }
+
+    bool wroteOut = false;
+    bool wroteErr = false;
+    for (const auto& entry : batch) {
+        if (entry.level >= LogLevel::Warning) {
+            std::cerr << entry.message << '\n';
+            wroteErr = true;
+        } else {
+            std::cout << entry.message << '\n';
+            wroteOut = true;
+        }
+    }
+    if (dropped > 0) {
+        std::cerr << "Warning: " << dropped << " log message(s) dropped\n";
+        wroteErr = true;
+    }
+    // 每批只刷新一次
+    if (wroteOut) std::cout.flush();
+    if (wroteErr) std::cerr.flush();
+}
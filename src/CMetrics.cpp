@@ -0,0 +1,126 @@
+#include "CMetrics.h"
+#include <nlohmann/json.hpp>
+
+// 当前线程绑定的统计对象
+static thread_local CMetrics* t_currentMetrics = nullptr;
+
+void CMetrics::addTime(Stage stage, uint64_t nanos) {
+    auto& counters = m_stages[static_cast<size_t>(stage)];
+    counters.nanos.fetch_add(nanos, std::memory_order_relaxed);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CMetrics::addBytes(Stage stage, uint64_t bytes) {
+    m_stages[static_cast<size_t>(stage)].bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void CMetrics::addFiles(Stage stage, uint64_t files) {
+    m_stages[static_cast<size_t>(stage)].files.fetch_add(files, std::memory_order_relaxed);
+}
+
+void CMetrics::recordFileLatency(uint64_t nanos) {
+    // 按微秒取对数分桶
+    uint64_t micros = nanos / 1000;
+    size_t bucket = 0;
+    while (micros > 1 && bucket + 1 < kHistogramBuckets) {
+        micros >>= 1;
+        ++bucket;
+    }
+    m_latency[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void CMetrics::reset() {
+    for (auto& counters : m_stages) {
+        counters.nanos.store(0, std::memory_order_relaxed);
+        counters.bytes.store(0, std::memory_order_relaxed);
+        counters.files.store(0, std::memory_order_relaxed);
+        counters.calls.store(0, std::memory_order_relaxed);
+    }
+    for (auto& bucket : m_latency) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_startTime = std::chrono::steady_clock::now();
+}
+
+CMetrics::StageSnapshot CMetrics::getStage(Stage stage) const {
+    const auto& counters = m_stages[static_cast<size_t>(stage)];
+    StageSnapshot snapshot;
+    snapshot.nanos = counters.nanos.load(std::memory_order_relaxed);
+    snapshot.bytes = counters.bytes.load(std::memory_order_relaxed);
+    snapshot.files = counters.files.load(std::memory_order_relaxed);
+    snapshot.calls = counters.calls.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+std::array<uint64_t, CMetrics::kHistogramBuckets> CMetrics::getLatencyHistogram() const {
+    std::array<uint64_t, kHistogramBuckets> histogram{};
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+        histogram[i] = m_latency[i].load(std::memory_order_relaxed);
+    }
+    return histogram;
+}
+
+double CMetrics::getElapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+std::string CMetrics::toJson() const {
+    nlohmann::json j;
+    j["elapsed_seconds"] = getElapsedSeconds();
+
+    nlohmann::json stages = nlohmann::json::object();
+    for (size_t i = 0; i < kStageCount; ++i) {
+        const Stage stage = static_cast<Stage>(i);
+        const StageSnapshot s = getStage(stage);
+        if (s.calls == 0 && s.bytes == 0 && s.files == 0) continue;
+        const double seconds = s.nanos / 1e9;
+        stages[stageName(stage)] = {
+            {"seconds", seconds},
+            {"bytes", s.bytes},
+            {"files", s.files},
+            {"calls", s.calls},
+            {"mb_per_s", seconds > 0 ? s.bytes / (1024.0 * 1024.0) / seconds : 0.0},
+        };
+    }
+    j["stages"] = stages;
+
+    // 直方图只输出非空桶，键为桶下界（微秒）
+    nlohmann::json histogram = nlohmann::json::array();
+    const auto buckets = getLatencyHistogram();
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+        if (buckets[i] == 0) continue;
+        histogram.push_back({{"min_us", i == 0 ? 0ull : (1ull << i)}, {"max_us", 1ull << (i + 1)}, {"count", buckets[i]}});
+    }
+    j["file_latency_histogram"] = histogram;
+    return j.dump(2);
+}
+
+const char* CMetrics::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Walk: return "walk";
+        case Stage::Read: return "read";
+        case Stage::Pack: return "pack";
+        case Stage::Compress: return "compress";
+        case Stage::Encrypt: return "encrypt";
+        case Stage::Write: return "write";
+        case Stage::Unpack: return "unpack";
+        case Stage::Decompress: return "decompress";
+        case Stage::Decrypt: return "decrypt";
+        case Stage::Verify: return "verify";
+        case Stage::Parity: return "parity";
+        default: return "unknown";
+    }
+}
+
+CMetrics* CMetrics::current() {
+    CMetrics* metrics = t_currentMetrics;
+    return (metrics && metrics->isEnabled()) ? metrics : nullptr;
+}
+
+CMetrics::Bind::Bind(CMetrics* metrics) : m_previous(t_currentMetrics) {
+    t_currentMetrics = metrics;
+}
+
+CMetrics::Bind::~Bind() {
+    t_currentMetrics = m_previous;
+}
@@ -0,0 +1,345 @@
+#include "CParityFile.h"
+#include "CHash.h"
+#include "CLogger.h"
+#include "CMetrics.h"
+#include "CReedSolomon.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kParityMagic[4] = {'B', 'K', 'P', 'R'};
+constexpr uint8_t kFormatVersion = 1;
+constexpr uint64_t kHeaderSize = 4 + 1 + 1 + 1 + 4 + 8;
+constexpr uint64_t kHashSize = 16;
+constexpr uint32_t kMinShardSize = 64;
+constexpr uint32_t kMaxShardSize = 64 * 1024;
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+struct ParityLayout {
+    unsigned dataShards = 0;
+    unsigned parityShards = 0;
+    uint32_t shardSize = 0;
+    uint64_t archiveSize = 0;
+
+    unsigned totalShards() const { return dataShards + parityShards; }
+    uint64_t stripeBytes() const { return uint64_t(shardSize) * dataShards; }
+    uint64_t stripes() const { return (archiveSize + stripeBytes() - 1) / stripeBytes(); }
+    uint64_t tableBytes() const { return stripes() * totalShards() * kHashSize; }
+    uint64_t parityOffset() const { return kHeaderSize + tableBytes() + kHashSize; }
+};
+
+void writeHeader(std::ostream& out, const ParityLayout& layout) {
+    out.write(kParityMagic, sizeof(kParityMagic));
+    writeValue(out, kFormatVersion);
+    writeValue(out, static_cast<uint8_t>(layout.dataShards));
+    writeValue(out, static_cast<uint8_t>(layout.parityShards));
+    writeValue(out, layout.shardSize);
+    writeValue(out, layout.archiveSize);
+}
+
+bool readHeader(std::istream& in, ParityLayout& layout) {
+    char magic[4];
+    uint8_t version = 0;
+    uint8_t dataShards = 0;
+    uint8_t parityShards = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kParityMagic, sizeof(magic)) != 0 || !readValue(in, version) ||
+        version != kFormatVersion || !readValue(in, dataShards) || !readValue(in, parityShards) ||
+        !readValue(in, layout.shardSize) || !readValue(in, layout.archiveSize)) {
+        return false;
+    }
+    layout.dataShards = dataShards;
+    layout.parityShards = parityShards;
+    return dataShards > 0 && parityShards > 0 && layout.totalShards() <= CReedSolomon::kMaxShards &&
+           layout.shardSize >= kMinShardSize && layout.shardSize <= kMaxShardSize;
+}
+
+// 头与哈希表一起计算哈希，用于确认校验文件本身可用
+Hash128 hashHeaderAndTable(const ParityLayout& layout, const std::vector<uint8_t>& table) {
+    std::ostringstream header;
+    writeHeader(header, layout);
+    const std::string headerBytes = header.str();
+    CXXHash128 hasher;
+    hasher.update(headerBytes.data(), headerBytes.size());
+    hasher.update(table.data(), table.size());
+    return hasher.digest();
+}
+
+void storeHash(std::vector<uint8_t>& table, uint64_t index, const Hash128& hash) {
+    std::memcpy(&table[index * kHashSize], &hash.low, 8);
+    std::memcpy(&table[index * kHashSize + 8], &hash.high, 8);
+}
+
+Hash128 loadHash(const std::vector<uint8_t>& table, uint64_t index) {
+    Hash128 hash;
+    std::memcpy(&hash.low, &table[index * kHashSize], 8);
+    std::memcpy(&hash.high, &table[index * kHashSize + 8], 8);
+    return hash;
+}
+
+// 从 offset 读取最多 len 字节到 dest，不足部分补 0；返回实际读到的字节数
+size_t readPadded(std::istream& in, uint64_t offset, uint8_t* dest, size_t len) {
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    in.read(reinterpret_cast<char*>(dest), static_cast<std::streamsize>(len));
+    const size_t n = in ? len : static_cast<size_t>(std::max<std::streamsize>(in.gcount(), 0));
+    std::memset(dest + n, 0, len - n);
+    in.clear();
+    return n;
+}
+
+}  // namespace
+
+uint32_t CParityFile::chooseShardSize(uint64_t archiveSize, unsigned dataShards) {
+    const uint64_t perShard = (archiveSize + std::max(1u, dataShards) - 1) / std::max(1u, dataShards);
+    const uint64_t aligned = (perShard + kMinShardSize - 1) / kMinShardSize * kMinShardSize;
+    return static_cast<uint32_t>(std::clamp<uint64_t>(aligned, kMinShardSize, kMaxShardSize));
+}
+
+std::string CParityFile::create(const std::string& archivePath, unsigned dataShards, unsigned parityShards) {
+    CStageTimer timer(Stage::Parity);
+    std::unique_ptr<CReedSolomon> coder;
+    try {
+        coder = std::make_unique<CReedSolomon>(dataShards, parityShards);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error: " << e.what());
+        return "";
+    }
+    std::error_code ec;
+    const uint64_t archiveSize = fs::file_size(archivePath, ec);
+    std::ifstream in(archivePath, std::ios::binary);
+    if (ec || !in) {
+        LOG_ERROR("Error: Failed to open file " << archivePath << " for reading.");
+        return "";
+    }
+    const std::string path = parityPath(archivePath);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << path << " for writing.");
+        return "";
+    }
+    auto fail = [&](const std::string& message) {
+        LOG_ERROR("Error: " << message);
+        out.close();
+        fs::remove(path, ec);
+        return std::string();
+    };
+
+    ParityLayout layout;
+    layout.dataShards = dataShards;
+    layout.parityShards = parityShards;
+    layout.shardSize = chooseShardSize(archiveSize, dataShards);
+    layout.archiveSize = archiveSize;
+
+    // 哈希表先占位，校验分片写完后回填
+    std::vector<uint8_t> table(static_cast<size_t>(layout.tableBytes()), 0);
+    writeHeader(out, layout);
+    out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size()));
+    const uint8_t placeholder[kHashSize] = {};
+    out.write(reinterpret_cast<const char*>(placeholder), sizeof(placeholder));
+
+    const size_t shardSize = layout.shardSize;
+    std::vector<uint8_t> buffer(shardSize * layout.totalShards());
+    std::vector<uint8_t*> shards(layout.totalShards());
+    for (unsigned i = 0; i < layout.totalShards(); ++i) {
+        shards[i] = buffer.data() + i * shardSize;
+    }
+    for (uint64_t stripe = 0; stripe < layout.stripes(); ++stripe) {
+        const uint64_t offset = stripe * layout.stripeBytes();
+        const size_t expected = static_cast<size_t>(std::min(layout.stripeBytes(), archiveSize - offset));
+        if (readPadded(in, offset, buffer.data(), static_cast<size_t>(layout.stripeBytes())) != expected) {
+            return fail("Failed to read file " + archivePath + ".");
+        }
+        coder->encode(shards.data(), shards.data() + dataShards, shardSize);
+        for (unsigned i = 0; i < layout.totalShards(); ++i) {
+            storeHash(table, stripe * layout.totalShards() + i, CXXHash128::hash(shards[i], shardSize));
+        }
+        out.write(reinterpret_cast<const char*>(shards[dataShards]),
+                  static_cast<std::streamsize>(shardSize * parityShards));
+        if (!out) {
+            return fail("Failed to write file " + path + ".");
+        }
+    }
+
+    out.seekp(static_cast<std::streamoff>(kHeaderSize), std::ios::beg);
+    out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size()));
+    const Hash128 tableHash = hashHeaderAndTable(layout, table);
+    writeValue(out, tableHash.low);
+    writeValue(out, tableHash.high);
+    out.close();
+    if (!out) {
+        return fail("Failed to write file " + path + ".");
+    }
+    timer.addBytes(archiveSize);
+    timer.addFiles();
+    LOG_INFO("Parity file " << path << ": " << layout.stripes() << " stripe(s) of " << dataShards << "+"
+             << parityShards << " shards x " << shardSize << " bytes");
+    return path;
+}
+
+bool CParityFile::check(const std::string& archivePath, ParityReport& report) {
+    return scan(archivePath, report, false);
+}
+
+bool CParityFile::repair(const std::string& archivePath, ParityReport* report) {
+    ParityReport local;
+    return scan(archivePath, report ? *report : local, true);
+}
+
+bool CParityFile::scan(const std::string& archivePath, ParityReport& report, bool writeBack) {
+    CStageTimer timer(Stage::Parity);
+    report = ParityReport();
+    const std::string path = parityPath(archivePath);
+    const std::ios::openmode mode = writeBack ? (std::ios::in | std::ios::out | std::ios::binary)
+                                              : (std::ios::in | std::ios::binary);
+    std::fstream par(path, mode);
+    if (!par) {
+        LOG_ERROR("Error: Failed to open parity file " << path << ".");
+        return false;
+    }
+
+    // 头与哈希表本身完好才能使用
+    std::error_code ec;
+    const uint64_t paritySize = fs::file_size(path, ec);
+    ParityLayout layout;
+    std::vector<uint8_t> table;
+    Hash128 storedHash;
+    bool usable = !ec && readHeader(par, layout) && layout.parityOffset() <= paritySize;
+    if (usable) {
+        table.resize(static_cast<size_t>(layout.tableBytes()));
+        par.read(reinterpret_cast<char*>(table.data()), static_cast<std::streamsize>(table.size()));
+        usable = readValue(par, storedHash.low) && readValue(par, storedHash.high) &&
+                 hashHeaderAndTable(layout, table) == storedHash;
+    }
+    if (!usable) {
+        LOG_ERROR("Error: Parity file " << path << " is damaged or has an unknown format.");
+        return false;
+    }
+
+    // 大小与记录不符：只检查时视为损坏，修复时按记录的大小截断或补齐（补齐部分随后按分片重建）
+    const uint64_t archiveSize = fs::file_size(archivePath, ec);
+    if (ec) {
+        LOG_ERROR("Error: Failed to read file " << archivePath << ".");
+        return false;
+    }
+    bool sizeOk = archiveSize == layout.archiveSize;
+    if (!sizeOk) {
+        LOG_WARN("Warning: " << archivePath << " is " << archiveSize << " bytes, parity file records "
+                 << layout.archiveSize << " bytes.");
+        if (writeBack) {
+            fs::resize_file(archivePath, layout.archiveSize, ec);
+            if (ec) {
+                LOG_ERROR("Error: Failed to resize " << archivePath << ": " << ec.message());
+                return false;
+            }
+            sizeOk = true;
+        }
+    }
+    std::fstream archive(archivePath, mode);
+    if (!archive) {
+        LOG_ERROR("Error: Failed to open file " << archivePath << ".");
+        return false;
+    }
+
+    const CReedSolomon coder(layout.dataShards, layout.parityShards);
+    const unsigned k = layout.dataShards;
+    const unsigned m = layout.parityShards;
+    const size_t shardSize = layout.shardSize;
+    std::vector<uint8_t> buffer(shardSize * layout.totalShards());
+    std::vector<uint8_t*> shards(layout.totalShards());
+    for (unsigned i = 0; i < layout.totalShards(); ++i) {
+        shards[i] = buffer.data() + i * shardSize;
+    }
+    std::vector<bool> present(layout.totalShards());
+    report.stripes = layout.stripes();
+    for (uint64_t stripe = 0; stripe < layout.stripes(); ++stripe) {
+        const uint64_t offset = stripe * layout.stripeBytes();
+        const size_t dataBytes = static_cast<size_t>(std::min(layout.stripeBytes(), layout.archiveSize - offset));
+        readPadded(archive, offset, buffer.data(), dataBytes);
+        std::memset(buffer.data() + dataBytes, 0, static_cast<size_t>(layout.stripeBytes()) - dataBytes);
+        readPadded(par, layout.parityOffset() + stripe * m * shardSize, shards[k], shardSize * m);
+        timer.addBytes(dataBytes);
+
+        unsigned damaged = 0;
+        for (unsigned i = 0; i < layout.totalShards(); ++i) {
+            present[i] = CXXHash128::hash(shards[i], shardSize) == loadHash(table, stripe * layout.totalShards() + i);
+            damaged += present[i] ? 0 : 1;
+        }
+        if (damaged == 0) {
+            continue;
+        }
+        report.damagedShards += damaged;
+        if (damaged > m) {
+            LOG_ERROR("Error: Stripe " << stripe << " of " << archivePath << " has " << damaged
+                      << " damaged shard(s), more than the " << m << " parity shard(s) can repair.");
+            ++report.unrecoverableStripes;
+            continue;
+        }
+        if (!writeBack) {
+            continue;
+        }
+        // 重建后再次核对哈希，全部相符才写回
+        bool rebuilt = coder.reconstruct(shards.data(), present, shardSize);
+        for (unsigned i = 0; rebuilt && i < layout.totalShards(); ++i) {
+            rebuilt = present[i] ||
+                      CXXHash128::hash(shards[i], shardSize) == loadHash(table, stripe * layout.totalShards() + i);
+        }
+        if (!rebuilt) {
+            LOG_ERROR("Error: Failed to rebuild stripe " << stripe << " of " << archivePath << ".");
+            ++report.unrecoverableStripes;
+            continue;
+        }
+        for (unsigned i = 0; i < layout.totalShards(); ++i) {
+            if (present[i]) continue;
+            if (i < k) {
+                const uint64_t shardOffset = offset + uint64_t(i) * shardSize;
+                if (shardOffset < layout.archiveSize) {  // 补齐的部分不写回
+                    archive.seekp(static_cast<std::streamoff>(shardOffset), std::ios::beg);
+                    archive.write(reinterpret_cast<const char*>(shards[i]),
+                                  static_cast<std::streamsize>(std::min<uint64_t>(shardSize, layout.archiveSize - shardOffset)));
+                }
+            } else {
+                par.seekp(static_cast<std::streamoff>(layout.parityOffset() + (stripe * m + (i - k)) * shardSize),
+                          std::ios::beg);
+                par.write(reinterpret_cast<const char*>(shards[i]), static_cast<std::streamsize>(shardSize));
+            }
+            ++report.repairedShards;
+        }
+    }
+    archive.flush();
+    par.flush();
+    if (!archive || !par) {
+        LOG_ERROR("Error: Failed to write repaired shards of " << archivePath << ".");
+        return false;
+    }
+
+    if (report.damagedShards > 0) {
+        if (writeBack) {
+            LOG_INFO("Repaired " << report.repairedShards << " of " << report.damagedShards << " damaged shard(s) in "
+                     << archivePath << ".");
+        } else {
+            LOG_WARN("Warning: " << report.damagedShards << " damaged shard(s) in " << archivePath << ", "
+                     << report.unrecoverableStripes << " stripe(s) beyond repair.");
+        }
+    }
+    return sizeOk && report.unrecoverableStripes == 0 && (writeBack || report.damagedShards == 0);
+}
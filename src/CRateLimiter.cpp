@@ -0,0 +1,53 @@
+#include "CRateLimiter.h"
+#include <algorithm>
+#include <thread>
+
+CRateLimiter::CRateLimiter(uint64_t bytesPerSec, std::shared_ptr<CRateLimiter> parent)
+    : m_bytesPerSec(bytesPerSec), m_parent(std::move(parent)),
+      m_tokens(static_cast<double>(bytesPerSec)), m_lastRefill(Clock::now()) {
+}
+
+void CRateLimiter::acquire(uint64_t bytes) {
+    if (bytes == 0) return;
+
+    if (m_bytesPerSec > 0) {
+        // 桶容量为一秒的额度，单次申请超过容量时按容量分段申请
+        const double capacity = static_cast<double>(m_bytesPerSec);
+        uint64_t remaining = bytes;
+        while (remaining > 0) {
+            const uint64_t chunk = std::min<uint64_t>(remaining, m_bytesPerSec);
+            std::chrono::duration<double> wait(0);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                // 补充令牌
+                const auto now = Clock::now();
+                const double elapsed = std::chrono::duration<double>(now - m_lastRefill).count();
+                m_tokens = std::min(capacity, m_tokens + elapsed * capacity);
+                m_lastRefill = now;
+                // 先扣减（允许为负），负值部分即需要等待的时间
+                m_tokens -= static_cast<double>(chunk);
+                if (m_tokens < 0) {
+                    wait = std::chrono::duration<double>(-m_tokens / capacity);
+                }
+                m_totalBytes += chunk;
+            }
+            if (wait.count() > 0) {
+                std::this_thread::sleep_for(wait);
+            }
+            remaining -= chunk;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_totalBytes += bytes;
+    }
+
+    // 同时满足全局限速
+    if (m_parent) {
+        m_parent->acquire(bytes);
+    }
+}
+
+uint64_t CRateLimiter::getTotalBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totalBytes;
+}
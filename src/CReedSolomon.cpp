@@ -0,0 +1,228 @@
+#include "CReedSolomon.h"
+#include "CCpuFeatures.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr unsigned kPolynomial = 0x11D;
+// 编码时按块处理，使校验分片的当前块留在 L1 缓存中
+constexpr size_t kEncodeBlock = 16 * 1024;
+
+struct GaloisTables {
+    uint8_t exp[512];
+    uint8_t log[256];
+    uint8_t mul[256][256];
+
+    GaloisTables() {
+        unsigned x = 1;
+        for (unsigned i = 0; i < 255; ++i) {
+            exp[i] = static_cast<uint8_t>(x);
+            exp[i + 255] = static_cast<uint8_t>(x);
+            log[x] = static_cast<uint8_t>(i);
+            x <<= 1;
+            if (x & 0x100) x ^= kPolynomial;
+        }
+        exp[510] = exp[0];
+        exp[511] = exp[1];
+        log[0] = 0;
+        for (unsigned a = 0; a < 256; ++a) {
+            for (unsigned b = 0; b < 256; ++b) {
+                mul[a][b] = (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+            }
+        }
+    }
+};
+
+const GaloisTables& tables() {
+    static const GaloisTables t;
+    return t;
+}
+
+void mulAddScalar(uint8_t c, const uint8_t* src, uint8_t* dst, size_t len) {
+    const uint8_t* row = tables().mul[c];
+    for (size_t i = 0; i < len; ++i) {
+        dst[i] ^= row[src[i]];
+    }
+}
+
+#ifdef CPU_HAS_X86
+
+// c * x = c * (x & 0x0F) ^ c * (x & 0xF0)，两部分各查一张 16 项表
+CPU_TARGET_AVX2 void mulAddAvx2(uint8_t c, const uint8_t* src, uint8_t* dst, size_t len) {
+    const uint8_t* row = tables().mul[c];
+    alignas(16) uint8_t low[16];
+    alignas(16) uint8_t high[16];
+    for (int i = 0; i < 16; ++i) {
+        low[i] = row[i];
+        high[i] = row[i << 4];
+    }
+    const __m256i lowTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(low)));
+    const __m256i highTable = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(high)));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i lo = _mm256_and_si256(s, mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi64(s, 4), mask);
+        const __m256i product =
+            _mm256_xor_si256(_mm256_shuffle_epi8(lowTable, lo), _mm256_shuffle_epi8(highTable, hi));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d, product));
+    }
+    mulAddScalar(c, src + i, dst + i, len - i);
+}
+
+#endif
+
+using MulAddKernel = void (*)(uint8_t, const uint8_t*, uint8_t*, size_t);
+
+MulAddKernel mulAddKernel(GaloisKernel kernel) {
+#ifdef CPU_HAS_X86
+    if (kernel == GaloisKernel::Avx2) return mulAddAvx2;
+#endif
+    (void)kernel;
+    return mulAddScalar;
+}
+
+}  // namespace
+
+CReedSolomon::CReedSolomon(unsigned dataShards, unsigned parityShards)
+    : m_dataShards(dataShards), m_parityShards(parityShards) {
+    if (dataShards == 0 || parityShards == 0 || dataShards + parityShards > kMaxShards) {
+        throw std::invalid_argument("Invalid Reed-Solomon shard counts: " + std::to_string(dataShards) + " data, " +
+                                    std::to_string(parityShards) + " parity");
+    }
+    m_parityMatrix.resize(static_cast<size_t>(parityShards) * dataShards);
+    for (unsigned r = 0; r < parityShards; ++r) {
+        for (unsigned c = 0; c < dataShards; ++c) {
+            m_parityMatrix[r * dataShards + c] = inverse(static_cast<uint8_t>((dataShards + r) ^ c));
+        }
+    }
+}
+
+std::vector<uint8_t> CReedSolomon::matrixRow(unsigned row) const {
+    std::vector<uint8_t> result(m_dataShards, 0);
+    if (row < m_dataShards) {
+        result[row] = 1;
+    } else {
+        const uint8_t* coefficients = &m_parityMatrix[(row - m_dataShards) * m_dataShards];
+        std::copy(coefficients, coefficients + m_dataShards, result.begin());
+    }
+    return result;
+}
+
+void CReedSolomon::encode(const uint8_t* const* data, uint8_t* const* parity, size_t len) const {
+    for (size_t offset = 0; offset < len; offset += kEncodeBlock) {
+        const size_t n = std::min(kEncodeBlock, len - offset);
+        for (unsigned r = 0; r < m_parityShards; ++r) {
+            uint8_t* out = parity[r] + offset;
+            std::memset(out, 0, n);
+            for (unsigned c = 0; c < m_dataShards; ++c) {
+                mulAdd(m_parityMatrix[r * m_dataShards + c], data[c] + offset, out, n);
+            }
+        }
+    }
+}
+
+bool CReedSolomon::reconstruct(uint8_t* const* shards, const std::vector<bool>& present, size_t len) const {
+    const unsigned k = m_dataShards;
+    const unsigned total = m_dataShards + m_parityShards;
+    if (present.size() != total) {
+        return false;
+    }
+    // 取前 k 个完好的分片
+    std::vector<unsigned> rows;
+    for (unsigned i = 0; i < total && rows.size() < k; ++i) {
+        if (present[i]) rows.push_back(i);
+    }
+    if (rows.size() < k) {
+        return false;
+    }
+
+    if (std::find(present.begin(), present.begin() + k, false) != present.begin() + k) {
+        // 所取各行组成的矩阵求逆（Gauss-Jordan），缺失的数据分片 = 逆矩阵对应行 x 所取分片
+        std::vector<uint8_t> a(static_cast<size_t>(k) * k);
+        std::vector<uint8_t> inv(static_cast<size_t>(k) * k, 0);
+        for (unsigned t = 0; t < k; ++t) {
+            const std::vector<uint8_t> row = matrixRow(rows[t]);
+            std::copy(row.begin(), row.end(), a.begin() + t * k);
+            inv[t * k + t] = 1;
+        }
+        for (unsigned col = 0; col < k; ++col) {
+            unsigned pivot = col;
+            while (pivot < k && a[pivot * k + col] == 0) ++pivot;
+            if (pivot == k) {
+                return false;
+            }
+            if (pivot != col) {
+                std::swap_ranges(a.begin() + pivot * k, a.begin() + (pivot + 1) * k, a.begin() + col * k);
+                std::swap_ranges(inv.begin() + pivot * k, inv.begin() + (pivot + 1) * k, inv.begin() + col * k);
+            }
+            const uint8_t scale = inverse(a[col * k + col]);
+            for (unsigned j = 0; j < k; ++j) {
+                a[col * k + j] = mul(a[col * k + j], scale);
+                inv[col * k + j] = mul(inv[col * k + j], scale);
+            }
+            for (unsigned r = 0; r < k; ++r) {
+                const uint8_t factor = a[r * k + col];
+                if (r == col || factor == 0) continue;
+                for (unsigned j = 0; j < k; ++j) {
+                    a[r * k + j] ^= mul(factor, a[col * k + j]);
+                    inv[r * k + j] ^= mul(factor, inv[col * k + j]);
+                }
+            }
+        }
+        for (unsigned j = 0; j < k; ++j) {
+            if (present[j]) continue;
+            std::memset(shards[j], 0, len);
+            for (unsigned t = 0; t < k; ++t) {
+                mulAdd(inv[j * k + t], shards[rows[t]], shards[j], len);
+            }
+        }
+    }
+
+    // 数据分片已完整，重新计算缺失的校验分片
+    for (unsigned r = 0; r < m_parityShards; ++r) {
+        if (present[k + r]) continue;
+        std::memset(shards[k + r], 0, len);
+        for (unsigned c = 0; c < k; ++c) {
+            mulAdd(m_parityMatrix[r * k + c], shards[c], shards[k + r], len);
+        }
+    }
+    return true;
+}
+
+uint8_t CReedSolomon::mul(uint8_t a, uint8_t b) {
+    return tables().mul[a][b];
+}
+
+uint8_t CReedSolomon::inverse(uint8_t a) {
+    const GaloisTables& t = tables();
+    return t.exp[255 - t.log[a]];
+}
+
+void CReedSolomon::mulAdd(uint8_t c, const uint8_t* src, uint8_t* dst, size_t len) {
+    if (c == 0) return;
+    static const MulAddKernel kernel = mulAddKernel(activeKernel());
+    kernel(c, src, dst, len);
+}
+
+bool CReedSolomon::mulAddWith(GaloisKernel kernel, uint8_t c, const uint8_t* src, uint8_t* dst, size_t len) {
+    if (kernel == GaloisKernel::Avx2 && activeKernel() != GaloisKernel::Avx2) {
+        return false;
+    }
+    mulAddKernel(kernel)(c, src, dst, len);
+    return true;
+}
+
+GaloisKernel CReedSolomon::activeKernel() {
+    static const GaloisKernel kernel = CCpuFeatures::hasAvx2() ? GaloisKernel::Avx2 : GaloisKernel::Scalar;
+    return kernel;
+}
+
+const char* CReedSolomon::kernelName(GaloisKernel kernel) {
+    return kernel == GaloisKernel::Avx2 ? "avx2" : "scalar";
+}
@@ -0,0 +1,139 @@
+#include "CSparseFile.h"
+#include "CLogger.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#endif
+
+bool CSparseFile::isDense(const std::vector<FileExtent>& extents, uint64_t size) {
+    if (size == 0) {
+        return extents.empty();
+    }
+    return extents.size() == 1 && extents[0].offset == 0 && extents[0].length == size;
+}
+
+uint64_t CSparseFile::dataLength(const std::vector<FileExtent>& extents) {
+    uint64_t total = 0;
+    for (const auto& extent : extents) {
+        total += extent.length;
+    }
+    return total;
+}
+
+std::vector<FileExtent> CSparseFile::scanZeroBlocks(const std::string& path, uint64_t size) {
+    std::vector<FileExtent> extents;
+    if (size == 0) {
+        return extents;
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Failed to open file: " << path);
+        return {{0, size}};
+    }
+    // 每次读入多个块，逐块判断是否全零，相邻的数据块合并为一个区间
+    std::vector<char> buffer(256 * kBlockSize);
+    uint64_t position = 0;
+    while (position < size) {
+        const size_t toRead = static_cast<size_t>(std::min<uint64_t>(buffer.size(), size - position));
+        in.read(buffer.data(), toRead);
+        const size_t bytesRead = static_cast<size_t>(in.gcount());
+        if (bytesRead == 0) {
+            break;
+        }
+        for (size_t blockStart = 0; blockStart < bytesRead; blockStart += kBlockSize) {
+            const size_t blockLen = std::min<size_t>(kBlockSize, bytesRead - blockStart);
+            const char* block = buffer.data() + blockStart;
+            const bool zero = std::all_of(block, block + blockLen, [](char c) { return c == 0; });
+            if (zero) {
+                continue;
+            }
+            const uint64_t offset = position + blockStart;
+            if (!extents.empty() && extents.back().offset + extents.back().length == offset) {
+                extents.back().length += blockLen;
+            } else {
+                extents.push_back({offset, blockLen});
+            }
+        }
+        position += bytesRead;
+    }
+    if (position < size) {
+        // 读取过程中文件变短，按原长度整体存储，由调用方读取时报错
+        LOG_WARN("Warning: " << path << " shrank while scanning for holes.");
+        return {{0, size}};
+    }
+    return extents;
+}
+
+#if defined(__linux__)
+
+std::vector<FileExtent> CSparseFile::mapDataExtents(const std::string& path, uint64_t size) {
+    std::vector<FileExtent> extents;
+    if (size == 0) {
+        return extents;
+    }
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {{0, size}};
+    }
+    struct stat st;
+    const bool haveStat = ::fstat(fd, &st) == 0;
+
+    bool supported = true;
+    off_t position = 0;
+    while (static_cast<uint64_t>(position) < size) {
+        const off_t dataStart = ::lseek(fd, position, SEEK_DATA);
+        if (dataStart < 0) {
+            // ENXIO：之后没有数据，其余部分都是空洞
+            supported = (errno == ENXIO);
+            break;
+        }
+        off_t holeStart = ::lseek(fd, dataStart, SEEK_HOLE);
+        if (holeStart < 0) {
+            supported = false;
+            break;
+        }
+        holeStart = std::min<off_t>(holeStart, static_cast<off_t>(size));
+        if (holeStart > dataStart) {
+            extents.push_back({static_cast<uint64_t>(dataStart), static_cast<uint64_t>(holeStart - dataStart)});
+        }
+        position = holeStart;
+    }
+    ::close(fd);
+
+    if (!supported) {
+        extents = {{0, size}};
+    }
+    // 文件系统把整个文件报告为数据，但分配的磁盘块比文件长度少：说明不支持空洞查询，改为扫描全零块
+    if (isDense(extents, size) && haveStat && static_cast<uint64_t>(st.st_blocks) * 512 < size) {
+        return scanZeroBlocks(path, size);
+    }
+    return extents;
+}
+
+#else
+
+std::vector<FileExtent> CSparseFile::mapDataExtents(const std::string& path, uint64_t size) {
+    (void)path;
+    if (size == 0) {
+        return {};
+    }
+    return {{0, size}};
+}
+
+#endif
+
+bool CSparseFile::setLength(const std::string& path, uint64_t size) {
+    std::error_code ec;
+    std::filesystem::resize_file(path, size, ec);
+    if (ec) {
+        LOG_ERROR("Failed to resize file: " << path << " (" << ec.message() << ")");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+#include "CStreamPipe.h"
+
+#include <algorithm>
+#include <cstring>
+
+CStreamPipe::CStreamPipe(size_t chunkSize, size_t maxChunks)
+    : m_maxChunks(std::max<size_t>(1, maxChunks)),
+      m_writeBuffer(*this, std::max<size_t>(1, chunkSize)),
+      m_readBuffer(*this),
+      m_writer(&m_writeBuffer),
+      m_reader(&m_readBuffer) {}
+
+void CStreamPipe::closeWrite() {
+    m_writer.flush();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_writeClosed = true;
+    m_changed.notify_all();
+}
+
+void CStreamPipe::closeRead() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_readClosed = true;
+    m_chunks.clear();
+    m_changed.notify_all();
+}
+
+size_t CStreamPipe::peek(char* dest, size_t len) {
+    return m_readBuffer.peek(dest, len);
+}
+
+bool CStreamPipe::push(std::vector<char>& chunk) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this] { return m_readClosed || m_chunks.size() < m_maxChunks; });
+    if (m_readClosed) {
+        return false;
+    }
+    m_chunks.push_back(std::move(chunk));
+    m_changed.notify_all();
+    return true;
+}
+
+bool CStreamPipe::pop(std::vector<char>& chunk) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this] { return m_readClosed || m_writeClosed || !m_chunks.empty(); });
+    if (m_chunks.empty()) {
+        return false;
+    }
+    chunk = std::move(m_chunks.front());
+    m_chunks.pop_front();
+    m_changed.notify_all();
+    return true;
+}
+
+CStreamPipe::WriteBuffer::WriteBuffer(CStreamPipe& pipe, size_t chunkSize) : m_pipe(pipe), m_chunk(chunkSize) {
+    setp(m_chunk.data(), m_chunk.data() + m_chunk.size());
+}
+
+bool CStreamPipe::WriteBuffer::flushChunk() {
+    const size_t used = static_cast<size_t>(pptr() - pbase());
+    if (used == 0) {
+        return true;
+    }
+    const size_t chunkSize = m_chunk.size();
+    m_chunk.resize(used);
+    const bool ok = m_pipe.push(m_chunk);
+    m_chunk.assign(chunkSize, 0);
+    setp(m_chunk.data(), m_chunk.data() + m_chunk.size());
+    return ok;
+}
+
+CStreamPipe::WriteBuffer::int_type CStreamPipe::WriteBuffer::overflow(int_type ch) {
+    if (!flushChunk()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int CStreamPipe::WriteBuffer::sync() {
+    return flushChunk() ? 0 : -1;
+}
+
+size_t CStreamPipe::ReadBuffer::peek(char* dest, size_t len) {
+    if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+        return 0;
+    }
+    // 只复制当前块中的数据
+    const size_t n = std::min(len, static_cast<size_t>(egptr() - gptr()));
+    std::memcpy(dest, gptr(), n);
+    return n;
+}
+
+CStreamPipe::ReadBuffer::int_type CStreamPipe::ReadBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    if (!m_pipe.pop(m_chunk)) {
+        return traits_type::eof();
+    }
+    setg(m_chunk.data(), m_chunk.data(), m_chunk.data() + m_chunk.size());
+    return traits_type::to_int_type(*gptr());
+}
@@ -1,4 +1,5 @@
 #include "CompressFactory.h"
+#include "CLogger.h"
 #include <stdexcept>
 
 // 字符串压缩类型转换为枚举类型
@@ -6,6 +7,21 @@ CompressType CompressFactory::stringToCompressType(const std::string& compressTy
     if(compressType == "Huffman"){
         return CompressType::Huffman;
     }
+    if(compressType == "FSE"){
+        return CompressType::FSE;
+    }
+    if(compressType == "Huffman4X"){
+        return CompressType::Huffman4X;
+    }
+    if(compressType == "BWT"){
+        return CompressType::BWT;
+    }
+    if(compressType == "LongRange"){
+        return CompressType::LongRange;
+    }
+    if(compressType == "Dictionary"){
+        return CompressType::Dictionary;
+    }
     // 后续继续补充
     throw std::runtime_error("Unknown compress type: " + compressType);
 }
@@ -15,6 +31,21 @@ std::string CompressFactory::compressTypeToString(CompressType compressType) {
     if(compressType == CompressType::Huffman){
         return "Huffman";
     }
+    if(compressType == CompressType::FSE){
+        return "FSE";
+    }
+    if(compressType == CompressType::Huffman4X){
+        return "Huffman4X";
+    }
+    if(compressType == CompressType::BWT){
+        return "BWT";
+    }
+    if(compressType == CompressType::LongRange){
+        return "LongRange";
+    }
+    if(compressType == CompressType::Dictionary){
+        return "Dictionary";
+    }
     // 后续继续补充
     throw std::runtime_error("Unknown compress type");
 }
@@ -28,6 +59,16 @@ std::unique_ptr<ICompress> CompressFactory::createCompress(const std::string& co
     switch(type){
         case CompressType::Huffman:
             return std::make_unique<HuffmanCompress>();
+        case CompressType::FSE:
+            return std::make_unique<FSECompress>();
+        case CompressType::Huffman4X:
+            return std::make_unique<Huffman4XCompress>();
+        case CompressType::BWT:
+            return std::make_unique<BWTCompress>();
+        case CompressType::LongRange:
+            return std::make_unique<LongRangeCompress>();
+        case CompressType::Dictionary:
+            return std::make_unique<DictCompress>();
         default:
             throw std::runtime_error("Unknown compress type: " + compressType);
     }
@@ -37,7 +78,7 @@ std::unique_ptr<ICompress> CompressFactory::createCompress(const std::string& co
 
 std::vector<std::string> CompressFactory::getSupportedCompressTypes() {
     // 后续继续补充
-    return {"Huffman"};
+    return {"Huffman", "Huffman4X", "FSE", "BWT", "LongRange", "Dictionary"};
 }
 
 
@@ -50,7 +91,7 @@ std::string CompressFactory::getCompressType(const std::string& filePath) {
     // 根据文件的第二个字节判断压缩类型，第一个字节适用于判断当前文件是否为压缩文件的标志位
     std::ifstream in(filePath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << filePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
         return "";
     }
     // 跳过第一个字节
@@ -63,12 +104,12 @@ std::string CompressFactory::getCompressType(const std::string& filePath) {
 bool CompressFactory::isCompressedFile(const std::string& filePath) {
     // 应该是第一个位既是标志位，第二个字节也是符合条件的压缩类型
     if(!std::filesystem::exists(filePath)){
-        std::cerr << "Error: File " << filePath << " does not exist.\n";
+        LOG_ERROR("Error: File " << filePath << " does not exist.");
         return false;
     }
     std::ifstream in(filePath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << filePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
         return false;
     }
     uint8_t firstByte;
@@ -0,0 +1,578 @@
+#include "DictCompress.h"
+#include "Huffman4XCompress.h"
+#include "CBitStream.h"
+#include "CHash.h"
+#include "CMetrics.h"
+#include "CLogger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr uint8_t kDictVersion = 1;
+constexpr size_t kDmer = 8;          // 训练时统计的片段长度
+constexpr size_t kSegment = 256;     // 字典内容按段选取
+constexpr unsigned kFreqLog = 20;    // 片段频率表的位数
+constexpr size_t kStatsBudget = 1024 * 1024;  // 统计码表时最多解析的样本字节数
+constexpr size_t kGoodMatch = 64;    // 找到这么长的匹配后不再比较其余候选
+constexpr unsigned kAlphabet[CDictionary::TableCount] = {
+    CDictionary::kLiteralCodes, CDictionary::kLengthCodes, CDictionary::kLengthCodes, CDictionary::kOffsetCodes};
+
+enum class DictMode : uint8_t {
+    Raw = 0,
+    Coded = 1,
+};
+
+struct Sequence {
+    uint32_t literalLength;
+    uint32_t matchLength;
+    uint32_t offset;  // 大于已输出长度时指向字典内容
+};
+
+uint32_t loadU32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void storeU32(std::vector<char>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+}
+
+void writeVarint(std::vector<char>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t b = *p++;
+        v |= uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// 两段数据相同前缀的长度（不超过 limit），每次比较 8 字节
+size_t commonLength(const uint8_t* a, const uint8_t* b, size_t limit) {
+    size_t n = 0;
+    while (n + 8 <= limit) {
+        uint64_t x, y;
+        std::memcpy(&x, a + n, 8);
+        std::memcpy(&y, b + n, 8);
+        if (const uint64_t diff = x ^ y) {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, diff);
+            return n + index / 8;
+#else
+            return n + static_cast<size_t>(__builtin_ctzll(diff)) / 8;
+#endif
+        }
+        n += 8;
+    }
+    while (n < limit && a[n] == b[n]) ++n;
+    return n;
+}
+
+unsigned highBit(uint32_t v) {
+    unsigned n = 0;
+    while (v >>= 1) ++n;
+    return n;
+}
+
+// 长度码：0~15 直接表示，更大的值按最高位分段，余下的位作为附加位
+unsigned lengthCode(uint32_t v, unsigned& extraBits) {
+    if (v < 16) {
+        extraBits = 0;
+        return v;
+    }
+    extraBits = highBit(v);
+    return 12 + extraBits;
+}
+
+// 距离码：按最高位分段（距离至少为1）
+unsigned offsetCode(uint32_t v, unsigned& extraBits) {
+    extraBits = highBit(v);
+    return extraBits;
+}
+
+uint32_t hashProduct(const uint8_t* p) {
+    return loadU32(p) * 2654435761u;
+}
+
+// 为 [0, len) 中可读 4 字节的位置建立哈希链
+void buildHashChain(const uint8_t* data, size_t len, unsigned hashLog, std::vector<uint32_t>& head,
+                    std::vector<uint32_t>& chain) {
+    head.assign(size_t(1) << hashLog, 0);
+    chain.assign(len, 0);
+    for (size_t p = 0; p + DictCompress::kMinMatch <= len; ++p) {
+        const uint32_t h = hashProduct(data + p) >> (32 - hashLog);
+        chain[p] = head[h];
+        head[h] = static_cast<uint32_t>(p + 1);
+    }
+}
+
+// 贪心 LZ 解析：每个位置在文件内已处理的部分与字典内容中各查找最长匹配。
+// 文件内的哈希链随解析建立；字典的哈希链预先建好、只读
+void parseSequences(const CDictionary& dict, const uint8_t* src, size_t len, std::vector<Sequence>& sequences) {
+    sequences.clear();
+    if (len < DictCompress::kMinMatch) return;
+    const uint8_t* dictData = dict.getContent().data();
+    const size_t dictLen = dict.getContent().size();
+    const uint32_t* dictHead = dict.getHashHead().data();
+    const uint32_t* dictChain = dict.getHashChain().data();
+
+    const unsigned hashLog = std::min(16u, std::max(10u, highBit(static_cast<uint32_t>(len)) + 1));
+    std::vector<uint32_t> head(size_t(1) << hashLog, 0);
+    std::vector<uint32_t> chain(len, 0);
+    const size_t limit = len - DictCompress::kMinMatch + 1;
+    auto insert = [&](size_t p) {
+        const uint32_t h = hashProduct(src + p) >> (32 - hashLog);
+        chain[p] = head[h];
+        head[h] = static_cast<uint32_t>(p + 1);
+    };
+
+    size_t pos = 0;
+    size_t anchor = 0;
+    while (pos < limit) {
+        const uint32_t v = loadU32(src + pos);
+        const uint32_t product = v * 2654435761u;
+        const size_t maxLen = len - pos;
+        size_t bestLen = 0;
+        size_t bestOffset = 0;
+        unsigned depth = 0;
+        for (uint32_t cand = head[product >> (32 - hashLog)]; cand && depth < DictCompress::kSearchDepth;
+             cand = chain[cand - 1], ++depth) {
+            const size_t c = cand - 1;
+            if (loadU32(src + c) != v) continue;
+            const size_t n = DictCompress::kMinMatch + commonLength(src + c + DictCompress::kMinMatch,
+                                                                    src + pos + DictCompress::kMinMatch,
+                                                                    maxLen - DictCompress::kMinMatch);
+            if (n > bestLen) {
+                bestLen = n;
+                bestOffset = pos - c;
+                if (n >= kGoodMatch) break;
+            }
+        }
+        depth = 0;
+        for (uint32_t cand = (dictLen && bestLen < kGoodMatch) ? dictHead[product >> (32 - CDictionary::kHashLog)] : 0;
+             cand && depth < DictCompress::kSearchDepth; cand = dictChain[cand - 1], ++depth) {
+            const size_t c = cand - 1;
+            if (loadU32(dictData + c) != v) continue;
+            // 匹配可以越过字典末尾，继续与文件开头比较
+            const size_t inDict = std::min(maxLen, dictLen - c);
+            size_t n = DictCompress::kMinMatch + commonLength(dictData + c + DictCompress::kMinMatch,
+                                                              src + pos + DictCompress::kMinMatch,
+                                                              inDict - DictCompress::kMinMatch);
+            if (c + n == dictLen) {
+                n += commonLength(src, src + pos + n, maxLen - n);
+            }
+            if (n > bestLen) {
+                bestLen = n;
+                bestOffset = pos + dictLen - c;
+                if (n >= kGoodMatch) break;
+            }
+        }
+        if (bestLen < DictCompress::kMinMatch) {
+            insert(pos++);
+            continue;
+        }
+        sequences.push_back({static_cast<uint32_t>(pos - anchor), static_cast<uint32_t>(bestLen),
+                             static_cast<uint32_t>(bestOffset)});
+        const size_t end = pos + bestLen;
+        for (; pos < end; ++pos) {
+            if (pos < limit) insert(pos);
+        }
+        anchor = pos;
+    }
+}
+
+// 统计每个样本中出现的 8 字节片段（同一样本只计一次），返回每个位置的片段哈希
+void countDmers(const std::vector<std::vector<char>>& samples, std::vector<uint8_t>& all,
+                std::vector<uint32_t>& hashes, std::vector<uint32_t>& freq) {
+    constexpr uint32_t kInvalid = UINT32_MAX;
+    freq.assign(size_t(1) << kFreqLog, 0);
+    std::vector<uint32_t> lastSample(freq.size(), kInvalid);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const std::vector<char>& sample = samples[i];
+        const size_t base = all.size();
+        all.insert(all.end(), sample.begin(), sample.end());
+        hashes.resize(all.size(), kInvalid);
+        for (size_t p = 0; p + kDmer <= sample.size(); ++p) {
+            uint64_t v;
+            std::memcpy(&v, all.data() + base + p, sizeof(v));
+            const uint32_t h = static_cast<uint32_t>((v * 0x9E3779B97F4A7C15ull) >> (64 - kFreqLog));
+            hashes[base + p] = h;
+            if (lastSample[h] != i) {
+                lastSample[h] = static_cast<uint32_t>(i);
+                ++freq[h];
+            }
+        }
+    }
+    // 只出现在一个样本中的片段对其他文件没有帮助
+    for (uint32_t& f : freq) {
+        if (f < 2) f = 0;
+    }
+}
+
+// 简化的 COVER：把全部样本均分为若干区间，每个区间选出片段频率之和最高的一段，
+// 选中后把段内片段的频率清零，避免后面的区间重复选取相同内容
+std::vector<uint8_t> selectContent(const std::vector<std::vector<char>>& samples, size_t maxSize) {
+    std::vector<uint8_t> all;
+    std::vector<uint32_t> hashes;
+    std::vector<uint32_t> freq;
+    countDmers(samples, all, hashes, freq);
+    if (all.size() < kSegment || maxSize < kSegment) return {};
+
+    const size_t epochs = std::max<size_t>(1, std::min(maxSize / kSegment, all.size() / kSegment));
+    const size_t epochSize = all.size() / epochs;
+    auto score = [&](size_t p) { return hashes[p] == UINT32_MAX ? 0 : uint64_t(freq[hashes[p]]); };
+
+    std::vector<std::pair<uint64_t, size_t>> chosen;  // (得分, 起始位置)
+    for (size_t e = 0; e < epochs; ++e) {
+        const size_t begin = e * epochSize;
+        const size_t end = (e + 1 == epochs) ? all.size() : std::min(all.size(), begin + std::max(epochSize, kSegment));
+        if (end - begin < kSegment) break;
+        const size_t window = kSegment - kDmer + 1;
+        uint64_t sum = 0;
+        for (size_t p = begin; p < begin + window; ++p) sum += score(p);
+        uint64_t bestScore = sum;
+        size_t bestStart = begin;
+        for (size_t s = begin + 1; s + kSegment <= end; ++s) {
+            sum += score(s + window - 1);
+            sum -= score(s - 1);
+            if (sum > bestScore) {
+                bestScore = sum;
+                bestStart = s;
+            }
+        }
+        if (bestScore == 0) continue;
+        chosen.push_back({bestScore, bestStart});
+        for (size_t p = bestStart; p < bestStart + window; ++p) {
+            if (hashes[p] != UINT32_MAX) freq[hashes[p]] = 0;
+        }
+    }
+    // 得分高的段放在末尾，匹配距离更短
+    std::stable_sort(chosen.begin(), chosen.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<uint8_t> content;
+    for (const auto& c : chosen) {
+        content.insert(content.end(), all.begin() + c.second, all.begin() + c.second + kSegment);
+    }
+    return content;
+}
+
+}  // namespace
+
+std::shared_ptr<const CDictionary> CDictionary::train(const std::vector<std::vector<char>>& samples, size_t maxSize) {
+    if (samples.empty()) return nullptr;
+    std::shared_ptr<CDictionary> dict(new CDictionary());
+    dict->m_content = selectContent(samples, maxSize);
+    buildHashChain(dict->m_content.data(), dict->m_content.size(), kHashLog, dict->m_hashHead, dict->m_hashChain);
+
+    // 用字典内容解析样本（总量超过 kStatsBudget 时按间隔抽取），统计各类符号；
+    // 每个符号至少计1次，保证都有码字
+    std::array<std::array<uint32_t, 256>, TableCount> counts{};
+    for (unsigned t = 0; t < TableCount; ++t) {
+        std::fill(counts[t].begin(), counts[t].begin() + kAlphabet[t], 1u);
+    }
+    size_t sampleBytes = 0;
+    for (const auto& sample : samples) sampleBytes += sample.size();
+    const size_t stride = sampleBytes / kStatsBudget + 1;
+    std::vector<Sequence> sequences;
+    for (size_t k = 0; k < samples.size(); k += stride) {
+        const std::vector<char>& sample = samples[k];
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(sample.data());
+        parseSequences(*dict, src, sample.size(), sequences);
+        size_t pos = 0;
+        unsigned extra = 0;
+        for (const Sequence& seq : sequences) {
+            ++counts[LiteralLength][lengthCode(seq.literalLength, extra)];
+            for (uint32_t i = 0; i < seq.literalLength; ++i) ++counts[Literal][src[pos + i]];
+            ++counts[MatchLength][lengthCode(seq.matchLength - DictCompress::kMinMatch, extra)];
+            ++counts[Offset][offsetCode(seq.offset, extra)];
+            pos += seq.literalLength + seq.matchLength;
+        }
+        for (; pos < sample.size(); ++pos) ++counts[Literal][src[pos]];
+    }
+    for (unsigned t = 0; t < TableCount; ++t) {
+        Huffman4XCodec::buildCodeLengths(counts[t], kAlphabet[t] - 1, kMaxCodeLen, dict->m_tables[t].lengths);
+    }
+    if (!dict->finalize()) return nullptr;
+    return dict;
+}
+
+bool CDictionary::finalize() {
+    for (unsigned t = 0; t < TableCount; ++t) {
+        SymbolTable& table = m_tables[t];
+        // 字母表内每个符号都必须有码字，解码表才完整
+        for (unsigned s = 0; s < 256; ++s) {
+            if ((s < kAlphabet[t]) != (table.lengths[s] != 0)) return false;
+        }
+        if (!Huffman4XCodec::assignCanonicalCodes(table.lengths, kAlphabet[t] - 1, table.tableLog, table.codes)) {
+            return false;
+        }
+        table.decode.assign(size_t(1) << table.tableLog, 0);
+        for (unsigned s = 0; s < kAlphabet[t]; ++s) {
+            const unsigned shift = table.tableLog - table.lengths[s];
+            const size_t first = size_t(table.codes[s]) << shift;
+            std::fill(table.decode.begin() + first, table.decode.begin() + first + (size_t(1) << shift),
+                      static_cast<uint16_t>((s << 4) | table.lengths[s]));
+        }
+    }
+    if (m_hashHead.empty()) {
+        buildHashChain(m_content.data(), m_content.size(), kHashLog, m_hashHead, m_hashChain);
+    }
+    std::vector<char> serialized;
+    serialize(serialized);
+    m_id = static_cast<uint32_t>(CXXHash64::hash(serialized));
+    return true;
+}
+
+void CDictionary::serialize(std::vector<char>& out) const {
+    out.insert(out.end(), {'B', 'K', 'D', 'C', static_cast<char>(kDictVersion)});
+    storeU32(out, static_cast<uint32_t>(m_content.size()));
+    out.insert(out.end(), m_content.begin(), m_content.end());
+    for (unsigned t = 0; t < TableCount; ++t) {
+        for (unsigned s = 0; s < kAlphabet[t]; s += 2) {
+            out.push_back(static_cast<char>(m_tables[t].lengths[s] | (m_tables[t].lengths[s + 1] << 4)));
+        }
+    }
+}
+
+std::shared_ptr<const CDictionary> CDictionary::deserialize(const char* data, size_t len) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    if (len < 9 || std::memcmp(p, "BKDC", 4) != 0 || p[4] != kDictVersion) return nullptr;
+    const uint32_t contentLen = loadU32(p + 5);
+    size_t tableBytes = 0;
+    for (unsigned t = 0; t < TableCount; ++t) tableBytes += kAlphabet[t] / 2;
+    if (contentLen > len - 9 || len - 9 - contentLen != tableBytes) return nullptr;
+    std::shared_ptr<CDictionary> dict(new CDictionary());
+    dict->m_content.assign(p + 9, p + 9 + contentLen);
+    const uint8_t* lengths = p + 9 + contentLen;
+    for (unsigned t = 0; t < TableCount; ++t) {
+        for (unsigned s = 0; s < kAlphabet[t]; s += 2, ++lengths) {
+            dict->m_tables[t].lengths[s] = *lengths & 0x0F;
+            dict->m_tables[t].lengths[s + 1] = *lengths >> 4;
+        }
+    }
+    if (!dict->finalize()) return nullptr;
+    return dict;
+}
+
+bool DictCompress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    if (!m_dictionary) return false;
+    CStageTimer timer(Stage::Compress);
+    timer.addBytes(sourceData.size());
+    const CDictionary& dict = *m_dictionary;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(sourceData.data());
+    const size_t len = sourceData.size();
+
+    destData.clear();
+    destData.push_back(static_cast<char>(DictMode::Coded));
+    storeU32(destData, dict.getId());
+    writeVarint(destData, len);
+    const size_t headerLen = destData.size();
+
+    std::vector<Sequence> sequences;
+    parseSequences(dict, src, len, sequences);
+    writeVarint(destData, sequences.size());
+
+    // 按解码顺序收集（值, 位数），再逆序写入比特流
+    struct Item {
+        uint32_t value;
+        uint32_t bits;
+    };
+    std::vector<Item> items;
+    items.reserve(len / 2 + 3 * sequences.size() + 16);
+    auto putSymbol = [&](CDictionary::Table t, unsigned symbol) {
+        const CDictionary::SymbolTable& table = dict.getTable(t);
+        items.push_back({table.codes[symbol], table.lengths[symbol]});
+    };
+    auto putLength = [&](CDictionary::Table t, uint32_t v) {
+        unsigned extra = 0;
+        putSymbol(t, lengthCode(v, extra));
+        if (extra) items.push_back({v - (1u << extra), extra});
+    };
+    size_t pos = 0;
+    for (const Sequence& seq : sequences) {
+        putLength(CDictionary::LiteralLength, seq.literalLength);
+        for (uint32_t i = 0; i < seq.literalLength; ++i) putSymbol(CDictionary::Literal, src[pos + i]);
+        putLength(CDictionary::MatchLength, seq.matchLength - kMinMatch);
+        unsigned extra = 0;
+        putSymbol(CDictionary::Offset, offsetCode(seq.offset, extra));
+        if (extra) items.push_back({seq.offset - (1u << extra), extra});
+        pos += seq.literalLength + seq.matchLength;
+    }
+    for (; pos < len; ++pos) putSymbol(CDictionary::Literal, src[pos]);
+
+    std::vector<uint8_t> stream;
+    CBitWriter writer(stream);
+    for (size_t i = items.size(); i-- > 0;) {
+        writer.write(items[i].value, items[i].bits);
+    }
+    writer.close();
+
+    if (destData.size() + stream.size() >= headerLen + len) {
+        // 编码后没有变小，原样存放
+        destData.resize(headerLen);
+        destData[0] = static_cast<char>(DictMode::Raw);
+        destData.insert(destData.end(), sourceData.begin(), sourceData.end());
+    } else {
+        destData.insert(destData.end(), stream.begin(), stream.end());
+    }
+    return true;
+}
+
+bool DictCompress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    CStageTimer timer(Stage::Decompress);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(sourceData.data());
+    const uint8_t* end = p + sourceData.size();
+    if (sourceData.size() < 6) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated.");
+        return false;
+    }
+    const DictMode mode = static_cast<DictMode>(*p++);
+    const uint32_t dictId = loadU32(p);
+    p += 4;
+    if (!m_dictionary || m_dictionary->getId() != dictId) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data requires dictionary " << std::hex << dictId
+                  << std::dec << ", which is not loaded.");
+        return false;
+    }
+    uint64_t rawLen = 0;
+    if (!readVarint(p, end, rawLen) || rawLen > UINT32_MAX) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated or corrupted.");
+        return false;
+    }
+    if (mode == DictMode::Raw) {
+        if (size_t(end - p) != rawLen) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated or corrupted.");
+            return false;
+        }
+        destData.assign(p, end);
+        timer.addBytes(destData.size());
+        return true;
+    }
+
+    const CDictionary& dict = *m_dictionary;
+    const uint8_t* dictData = dict.getContent().data();
+    const size_t dictLen = dict.getContent().size();
+    uint64_t sequenceCount = 0;
+    CBitReader reader;
+    if (mode != DictMode::Coded || !readVarint(p, end, sequenceCount) || !reader.init(p, end - p)) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated or corrupted.");
+        return false;
+    }
+    auto readSymbol = [&](CDictionary::Table t) {
+        const CDictionary::SymbolTable& table = dict.getTable(t);
+        const uint16_t e = table.decode[reader.peek(table.tableLog)];
+        reader.skip(e & 0x0F);
+        return static_cast<unsigned>(e >> 4);
+    };
+    auto readLength = [&](CDictionary::Table t) {
+        const unsigned code = readSymbol(t);
+        if (code < 16) return uint64_t(code);
+        const unsigned extra = code - 12;
+        return (uint64_t(1) << extra) + reader.read(extra);
+    };
+
+    destData.resize(static_cast<size_t>(rawLen));
+    uint8_t* out = reinterpret_cast<uint8_t*>(destData.data());
+    size_t o = 0;
+    bool ok = true;
+    for (uint64_t s = 0; s < sequenceCount && ok; ++s) {
+        const uint64_t literalLength = readLength(CDictionary::LiteralLength);
+        if (literalLength > rawLen - o) {
+            ok = false;
+            break;
+        }
+        for (uint64_t i = 0; i < literalLength; ++i) out[o++] = static_cast<uint8_t>(readSymbol(CDictionary::Literal));
+        const uint64_t matchLength = readLength(CDictionary::MatchLength) + kMinMatch;
+        const unsigned extra = readSymbol(CDictionary::Offset);
+        const uint64_t offset = (uint64_t(1) << extra) + reader.read(extra);
+        if (matchLength > rawLen - o || offset > o + dictLen) {
+            ok = false;
+            break;
+        }
+        size_t remaining = static_cast<size_t>(matchLength);
+        if (offset > o) {
+            // 先复制字典中的部分，剩下的从输出开头继续
+            const size_t from = dictLen - static_cast<size_t>(offset - o);
+            const size_t n = std::min(remaining, dictLen - from);
+            std::memcpy(out + o, dictData + from, n);
+            o += n;
+            remaining -= n;
+        }
+        for (size_t i = o - static_cast<size_t>(std::min<uint64_t>(offset, o)); remaining > 0; --remaining) {
+            out[o++] = out[i++];
+        }
+    }
+    while (ok && o < rawLen) {
+        out[o++] = static_cast<uint8_t>(readSymbol(CDictionary::Literal));
+    }
+    if (!ok || !reader.finished()) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated or corrupted.");
+        return false;
+    }
+    timer.addBytes(destData.size());
+    return true;
+}
+
+std::string DictCompress::compressFile(const std::string& sourcePath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return "";
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<char> encoded;
+    if (!compressData(data, encoded)) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " compression requires a trained dictionary.");
+        return "";
+    }
+    const std::string destPath = sourcePath + ".dict";
+    std::ofstream out(destPath, std::ios::binary);
+    out.write(encoded.data(), encoded.size());
+    out.close();
+    if (!out) {
+        LOG_ERROR("Error: Failed to write file " << destPath << ".");
+        return "";
+    }
+    return destPath;
+}
+
+bool DictCompress::decompressFile(const std::string& sourcePath, const std::string& destPath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return false;
+    }
+    std::ofstream out(destPath, std::ios::binary);
+    if (!decompressStream(in, out, sourcePath)) return false;
+    out.close();
+    if (!out) {
+        LOG_ERROR("Error: Failed to write file " << destPath << ".");
+        return false;
+    }
+    return true;
+}
+
+bool DictCompress::decompressStream(std::istream& in, std::ostream& out, const std::string& /*sourceName*/) {
+    // 整个文件是一个字典压缩帧，只能整体解码
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<char> decoded;
+    if (!decompressData(data, decoded)) return false;
+    out.write(decoded.data(), decoded.size());
+    return static_cast<bool>(out);
+}
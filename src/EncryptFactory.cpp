@@ -1,4 +1,5 @@
 #include "EncryptFactory.h"
+#include "CLogger.h"
 
 
 // 将类型从string类型转换为EncryptType枚举类型
@@ -32,7 +33,7 @@ std::unique_ptr<IEncrypt> EncryptFactory::createEncryptor(const std::string& enc
         case EncryptType::SimXOR:
             return std::make_unique<SimpleXOREncrypt>();
         default:
-            std::cerr << "Error: Unknown encrypt type." << std::endl;
+            LOG_ERROR("Error: Unknown encrypt type.");
             return nullptr;
     }
 }
@@ -56,7 +57,7 @@ std::string EncryptFactory::getEncryptType(const std::string& filePath){
     // 根据文件的第二个字节判断压缩类型，第一个字节适用于判断当前文件是否为压缩文件的标志位
     std::ifstream in(filePath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << filePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
         return "";
     }
     // 跳过第一个字节
@@ -71,12 +72,12 @@ std::string EncryptFactory::getEncryptType(const std::string& filePath){
 bool EncryptFactory::isFileEncrypted(const std::string& filePath){
     // 应该是第一个位既是标志位，第二个字节也是符合条件的压缩类型
     if(!std::filesystem::exists(filePath)){
-        std::cerr << "Error: File " << filePath << " does not exist.\n";
+        LOG_ERROR("Error: File " << filePath << " does not exist.");
         return false;
     }
     std::ifstream in(filePath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << filePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
         return false;
     }
     uint8_t firstByte;
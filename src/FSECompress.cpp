@@ -0,0 +1,331 @@
+#include "FSECompress.h"
+#include "CBitStream.h"
+#include "CHistogram.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+// 最高位1的位置（v > 0）
+inline unsigned highBit(uint32_t v) {
+    unsigned r = 0;
+    while (v >>= 1) {
+        ++r;
+    }
+    return r;
+}
+
+// 符号在状态表中的散布顺序，编码与解码必须一致
+void spreadSymbols(const std::array<uint32_t, 256>& norm, unsigned maxSymbol, unsigned tableLog,
+                   std::vector<uint8_t>& tableSymbol) {
+    const uint32_t tableSize = 1u << tableLog;
+    const uint32_t mask = tableSize - 1;
+    const uint32_t step = (tableSize >> 1) + (tableSize >> 3) + 3;
+    tableSymbol.assign(tableSize, 0);
+    uint32_t position = 0;
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        for (uint32_t i = 0; i < norm[s]; ++i) {
+            tableSymbol[position] = static_cast<uint8_t>(s);
+            position = (position + step) & mask;
+        }
+    }
+}
+
+// 把频率归一化到 2^tableLog，出现过的符号至少为1
+void normalizeCounts(const std::array<uint32_t, 256>& counts, size_t total, unsigned maxSymbol, unsigned tableLog,
+                     std::array<uint32_t, 256>& norm) {
+    const uint32_t tableSize = 1u << tableLog;
+    std::array<double, 256> remainder{};
+    int64_t sum = 0;
+    norm.fill(0);
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        if (counts[s] == 0) continue;
+        const double ideal = static_cast<double>(counts[s]) * tableSize / total;
+        norm[s] = std::max<uint32_t>(1, static_cast<uint32_t>(ideal));
+        remainder[s] = ideal - norm[s];
+        sum += norm[s];
+    }
+    int64_t diff = static_cast<int64_t>(tableSize) - sum;
+    // 多出的名额给舍去部分最大的符号
+    while (diff > 0) {
+        unsigned best = 0;
+        for (unsigned s = 1; s <= maxSymbol; ++s) {
+            if (counts[s] > 0 && (counts[best] == 0 || remainder[s] > remainder[best])) best = s;
+        }
+        ++norm[best];
+        remainder[best] -= 1.0;
+        --diff;
+    }
+    // 不足时从占比最大的符号扣除（因强制为1的稀有符号引起，数量很少）
+    while (diff < 0) {
+        unsigned best = 0;
+        for (unsigned s = 1; s <= maxSymbol; ++s) {
+            if (norm[s] > norm[best]) best = s;
+        }
+        const uint32_t take = static_cast<uint32_t>(std::min<int64_t>(-diff, norm[best] - 1));
+        norm[best] -= take;
+        diff += take;
+    }
+}
+
+void writeVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool readVarint(const uint8_t* src, size_t len, size_t& pos, uint32_t& v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 32 && pos < len; shift += 7) {
+        const uint8_t b = src[pos++];
+        v |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+void appendU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+uint32_t loadU32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+struct SymbolTransform {
+    int32_t deltaFindState;
+    uint32_t deltaNbBits;
+};
+
+struct DecodeEntry {
+    uint16_t newState;
+    uint8_t symbol;
+    uint8_t nbBits;
+};
+
+}  // namespace
+
+void FseCodec::compressBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) {
+    const size_t blockStart = out.size();
+    auto writeRaw = [&]() {
+        out.resize(blockStart);
+        out.push_back(static_cast<uint8_t>(BlockMode::Raw));
+        appendU32(out, static_cast<uint32_t>(len));
+        out.insert(out.end(), src, src + len);
+    };
+
+    CHistogram::Counts histogram{};
+    CHistogram::count(src, len, histogram);
+    std::array<uint32_t, 256> counts;
+    for (unsigned s = 0; s < 256; ++s) {
+        counts[s] = static_cast<uint32_t>(histogram[s]);
+    }
+    unsigned maxSymbol = 0;
+    unsigned distinct = 0;
+    for (unsigned s = 0; s < 256; ++s) {
+        if (counts[s] > 0) {
+            maxSymbol = s;
+            ++distinct;
+        }
+    }
+    if (len < 16 || distinct == 0) {
+        writeRaw();
+        return;
+    }
+    if (distinct == 1) {
+        out.push_back(static_cast<uint8_t>(BlockMode::Rle));
+        appendU32(out, static_cast<uint32_t>(len));
+        out.push_back(src[0]);
+        return;
+    }
+
+    // 小块使用更小的表，表的大小至少能容纳所有出现的符号
+    unsigned tableLog = kMaxTableLog;
+    const unsigned minLog = std::max(kMinTableLog, highBit(distinct - 1) + 2);
+    while (tableLog > minLog && (size_t(1) << (tableLog - 1)) >= len) {
+        --tableLog;
+    }
+    const uint32_t tableSize = 1u << tableLog;
+
+    std::array<uint32_t, 256> norm;
+    normalizeCounts(counts, len, maxSymbol, tableLog, norm);
+    std::vector<uint8_t> tableSymbol;
+    spreadSymbols(norm, maxSymbol, tableLog, tableSymbol);
+
+    // 编码表：每个符号的状态按散布顺序排列，以及由当前状态求输出位数、下一状态的偏移
+    std::array<uint32_t, 257> cumul{};
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        cumul[s + 1] = cumul[s] + norm[s];
+    }
+    std::vector<uint16_t> stateTable(tableSize);
+    {
+        std::array<uint32_t, 257> next = cumul;
+        for (uint32_t u = 0; u < tableSize; ++u) {
+            stateTable[next[tableSymbol[u]]++] = static_cast<uint16_t>(tableSize + u);
+        }
+    }
+    std::array<SymbolTransform, 256> transform{};
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        const uint32_t n = norm[s];
+        if (n == 0) continue;
+        if (n == 1) {
+            transform[s].deltaNbBits = (tableLog << 16) - tableSize;
+            transform[s].deltaFindState = static_cast<int32_t>(cumul[s]) - 1;
+        } else {
+            const unsigned maxBitsOut = tableLog - highBit(n - 1);
+            const uint32_t minStatePlus = n << maxBitsOut;
+            transform[s].deltaNbBits = (maxBitsOut << 16) - minStatePlus;
+            transform[s].deltaFindState = static_cast<int32_t>(cumul[s]) - static_cast<int32_t>(n);
+        }
+    }
+
+    // 块头
+    out.push_back(static_cast<uint8_t>(BlockMode::Fse));
+    appendU32(out, static_cast<uint32_t>(len));
+    out.push_back(static_cast<uint8_t>(tableLog));
+    out.push_back(static_cast<uint8_t>(maxSymbol));
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        writeVarint(out, norm[s]);
+    }
+    const size_t streamLenPos = out.size();
+    appendU32(out, 0);
+    const size_t streamStart = out.size();
+
+    // 逆序编码，符号 i 使用第 i % kStates 个状态；解码时正序得到原始顺序
+    std::vector<uint8_t> stream;
+    stream.reserve(len);
+    CBitWriter writer(stream);
+    uint32_t states[kStates];
+    for (uint32_t& st : states) {
+        st = tableSize;
+    }
+    for (size_t i = len; i-- > 0;) {
+        uint32_t& st = states[i % kStates];
+        const SymbolTransform& t = transform[src[i]];
+        const uint32_t nbBits = (st + t.deltaNbBits) >> 16;
+        writer.write(st, nbBits);
+        st = stateTable[(st >> nbBits) + t.deltaFindState];
+    }
+    // 最后写入的最先被读到：状态按 kStates-1..0 的顺序写出，解码按 0..kStates-1 读取
+    for (unsigned k = kStates; k-- > 0;) {
+        writer.write(states[k] - tableSize, tableLog);
+    }
+    writer.close();
+
+    if (streamStart + stream.size() >= blockStart + 5 + len) {
+        writeRaw();
+        return;
+    }
+    const uint32_t streamLen = static_cast<uint32_t>(stream.size());
+    for (int i = 0; i < 4; ++i) {
+        out[streamLenPos + i] = static_cast<uint8_t>(streamLen >> (8 * i));
+    }
+    out.insert(out.end(), stream.begin(), stream.end());
+}
+
+bool FseCodec::decompressBlock(const uint8_t* src, size_t srcLen, size_t maxLen, std::vector<uint8_t>& out,
+                               size_t& consumed) {
+    if (srcLen < 5) {
+        return false;
+    }
+    const BlockMode mode = static_cast<BlockMode>(src[0]);
+    const uint32_t len = loadU32(src + 1);
+    if (len > maxLen) {
+        return false;
+    }
+    size_t pos = 5;
+    const size_t outStart = out.size();
+
+    switch (mode) {
+        case BlockMode::Raw:
+            if (srcLen - pos < len) return false;
+            out.insert(out.end(), src + pos, src + pos + len);
+            consumed = pos + len;
+            return true;
+        case BlockMode::Rle:
+            if (srcLen - pos < 1) return false;
+            out.insert(out.end(), len, src[pos]);
+            consumed = pos + 1;
+            return true;
+        case BlockMode::Fse:
+            break;
+        default:
+            return false;
+    }
+
+    if (srcLen - pos < 2) return false;
+    const unsigned tableLog = src[pos++];
+    const unsigned maxSymbol = src[pos++];
+    if (tableLog < kMinTableLog || tableLog > kMaxTableLog) return false;
+    const uint32_t tableSize = 1u << tableLog;
+    std::array<uint32_t, 256> norm{};
+    uint64_t sum = 0;
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        if (!readVarint(src, srcLen, pos, norm[s])) return false;
+        sum += norm[s];
+    }
+    if (sum != tableSize || srcLen - pos < 4) return false;
+    const uint32_t streamLen = loadU32(src + pos);
+    pos += 4;
+    if (srcLen - pos < streamLen) return false;
+
+    // 解码表：状态 -> (符号, 读取位数, 下一状态基数)
+    std::vector<uint8_t> tableSymbol;
+    spreadSymbols(norm, maxSymbol, tableLog, tableSymbol);
+    std::vector<DecodeEntry> table(tableSize);
+    {
+        std::array<uint32_t, 256> symbolNext = norm;
+        for (uint32_t u = 0; u < tableSize; ++u) {
+            const uint8_t s = tableSymbol[u];
+            const uint32_t nextState = symbolNext[s]++;
+            const unsigned nbBits = tableLog - highBit(nextState);
+            table[u].symbol = s;
+            table[u].nbBits = static_cast<uint8_t>(nbBits);
+            table[u].newState = static_cast<uint16_t>((nextState << nbBits) - tableSize);
+        }
+    }
+
+    CBitReader reader;
+    if (!reader.init(src + pos, streamLen)) return false;
+    uint32_t states[kStates];
+    for (unsigned k = 0; k < kStates; ++k) {
+        states[k] = reader.read(tableLog);
+    }
+
+    out.resize(outStart + len);
+    uint8_t* dst = out.data() + outStart;
+    const DecodeEntry* t = table.data();
+    size_t i = 0;
+    // 4 个状态互相独立，展开后 CPU 可以同时推进 4 条依赖链
+    for (; i + kStates <= len; i += kStates) {
+        const DecodeEntry e0 = t[states[0]];
+        const DecodeEntry e1 = t[states[1]];
+        const DecodeEntry e2 = t[states[2]];
+        const DecodeEntry e3 = t[states[3]];
+        dst[i] = e0.symbol;
+        dst[i + 1] = e1.symbol;
+        dst[i + 2] = e2.symbol;
+        dst[i + 3] = e3.symbol;
+        states[0] = e0.newState + reader.read(e0.nbBits);
+        states[1] = e1.newState + reader.read(e1.nbBits);
+        states[2] = e2.newState + reader.read(e2.nbBits);
+        states[3] = e3.newState + reader.read(e3.nbBits);
+    }
+    for (; i < len; ++i) {
+        uint32_t& st = states[i % kStates];
+        const DecodeEntry e = t[st];
+        dst[i] = e.symbol;
+        st = e.newState + reader.read(e.nbBits);
+    }
+    if (!reader.finished()) {
+        out.resize(outStart);
+        return false;
+    }
+    consumed = pos + streamLen;
+    return true;
+}
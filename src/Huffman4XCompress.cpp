@@ -0,0 +1,277 @@
+#include "Huffman4XCompress.h"
+#include "CBitStream.h"
+#include "CHistogram.h"
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <functional>
+
+namespace {
+
+void appendU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+}
+
+uint32_t loadU32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+struct DecodeEntry {
+    uint8_t symbol;
+    uint8_t length;
+};
+
+// 解码一个符号：窥视 tableLog 位查表，再跳过实际码长
+inline uint8_t decodeSymbol(CBitReader& reader, const DecodeEntry* table, unsigned tableLog) {
+    const DecodeEntry e = table[reader.peek(tableLog)];
+    reader.skip(e.length);
+    return e.symbol;
+}
+
+}  // namespace
+
+// 由频率构造 Huffman 树并得到各符号的码长，超过 maxLen 时把频率减半后重建
+void Huffman4XCodec::buildCodeLengths(std::array<uint32_t, 256> counts, unsigned maxSymbol, unsigned maxLen,
+                                      std::array<uint8_t, 256>& lengths) {
+    using Item = std::pair<uint64_t, int>;  // (频率, 节点编号)
+    for (;;) {
+        lengths.fill(0);
+        std::vector<int> parent;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+        for (unsigned s = 0; s <= maxSymbol; ++s) {
+            if (counts[s] > 0) {
+                pq.push({counts[s], static_cast<int>(parent.size())});
+                parent.push_back(-1);
+            }
+        }
+        while (pq.size() > 1) {
+            const Item a = pq.top(); pq.pop();
+            const Item b = pq.top(); pq.pop();
+            const int node = static_cast<int>(parent.size());
+            parent.push_back(-1);
+            parent[a.second] = node;
+            parent[b.second] = node;
+            pq.push({a.first + b.first, node});
+        }
+        // 内部节点编号大于子节点，倒序即可自顶向下求深度
+        std::vector<uint8_t> depth(parent.size(), 0);
+        for (size_t i = parent.size() - 1; i-- > 0;) {
+            depth[i] = static_cast<uint8_t>(depth[parent[i]] + 1);
+        }
+        unsigned longest = 0;
+        size_t leaf = 0;
+        for (unsigned s = 0; s <= maxSymbol; ++s) {
+            if (counts[s] > 0) {
+                lengths[s] = depth[leaf++];
+                longest = std::max<unsigned>(longest, lengths[s]);
+            }
+        }
+        if (longest <= maxLen) {
+            return;
+        }
+        for (unsigned s = 0; s <= maxSymbol; ++s) {
+            if (counts[s] > 0) counts[s] = (counts[s] >> 1) | 1;
+        }
+    }
+}
+
+bool Huffman4XCodec::assignCanonicalCodes(const std::array<uint8_t, 256>& lengths, unsigned maxSymbol,
+                                          unsigned& tableLog, std::array<uint16_t, 256>& codes) {
+    std::array<uint32_t, kMaxCodeLen + 1> lengthCount{};
+    tableLog = 0;
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        if (lengths[s] > kMaxCodeLen) return false;
+        if (lengths[s] > 0) {
+            ++lengthCount[lengths[s]];
+            tableLog = std::max<unsigned>(tableLog, lengths[s]);
+        }
+    }
+    if (tableLog == 0) return false;
+    uint64_t kraft = 0;
+    for (unsigned l = 1; l <= tableLog; ++l) {
+        kraft += uint64_t(lengthCount[l]) << (tableLog - l);
+    }
+    if (kraft != (uint64_t(1) << tableLog)) return false;
+
+    std::array<uint32_t, kMaxCodeLen + 2> nextCode{};
+    uint32_t code = 0;
+    for (unsigned l = 1; l <= tableLog; ++l) {
+        code = (code + lengthCount[l - 1]) << 1;
+        nextCode[l] = code;
+    }
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        if (lengths[s] > 0) codes[s] = static_cast<uint16_t>(nextCode[lengths[s]]++);
+    }
+    return true;
+}
+
+void Huffman4XCodec::compressBlock(const uint8_t* src, size_t len, std::vector<uint8_t>& out) {
+    const size_t blockStart = out.size();
+    auto writeRaw = [&]() {
+        out.resize(blockStart);
+        out.push_back(static_cast<uint8_t>(BlockMode::Raw));
+        appendU32(out, static_cast<uint32_t>(len));
+        out.insert(out.end(), src, src + len);
+    };
+
+    CHistogram::Counts histogram{};
+    CHistogram::count(src, len, histogram);
+    std::array<uint32_t, 256> counts;
+    for (unsigned s = 0; s < 256; ++s) {
+        counts[s] = static_cast<uint32_t>(histogram[s]);
+    }
+    unsigned maxSymbol = 0;
+    unsigned distinct = 0;
+    for (unsigned s = 0; s < 256; ++s) {
+        if (counts[s] > 0) {
+            maxSymbol = s;
+            ++distinct;
+        }
+    }
+    if (len < 32 || distinct == 0) {
+        writeRaw();
+        return;
+    }
+    if (distinct == 1) {
+        out.push_back(static_cast<uint8_t>(BlockMode::Rle));
+        appendU32(out, static_cast<uint32_t>(len));
+        out.push_back(src[0]);
+        return;
+    }
+
+    std::array<uint8_t, 256> lengths;
+    buildCodeLengths(counts, maxSymbol, kMaxCodeLen, lengths);
+    std::array<uint16_t, 256> codes{};
+    unsigned tableLog = 0;
+    assignCanonicalCodes(lengths, maxSymbol, tableLog, codes);
+
+    // 块头：码长每个符号占4位
+    out.push_back(static_cast<uint8_t>(BlockMode::Huffman));
+    appendU32(out, static_cast<uint32_t>(len));
+    out.push_back(static_cast<uint8_t>(maxSymbol));
+    for (unsigned s = 0; s <= maxSymbol; s += 2) {
+        const uint8_t hi = s + 1 <= maxSymbol ? lengths[s + 1] : 0;
+        out.push_back(static_cast<uint8_t>(lengths[s] | (hi << 4)));
+    }
+    const size_t jumpPos = out.size();
+    out.resize(jumpPos + 4 * kStreams);
+
+    // 每条流逆序编码自己的一段，解码时即按原始顺序输出
+    const size_t segment = (len + kStreams - 1) / kStreams;
+    for (unsigned k = 0; k < kStreams; ++k) {
+        const size_t begin = std::min(len, k * segment);
+        const size_t end = std::min(len, begin + segment);
+        const size_t streamStart = out.size();
+        CBitWriter writer(out);
+        for (size_t i = end; i-- > begin;) {
+            writer.write(codes[src[i]], lengths[src[i]]);
+        }
+        writer.close();
+        const uint32_t streamLen = static_cast<uint32_t>(out.size() - streamStart);
+        for (int b = 0; b < 4; ++b) {
+            out[jumpPos + 4 * k + b] = static_cast<uint8_t>(streamLen >> (8 * b));
+        }
+        if (out.size() - blockStart >= 5 + len) {
+            writeRaw();
+            return;
+        }
+    }
+}
+
+bool Huffman4XCodec::decompressBlock(const uint8_t* src, size_t srcLen, size_t maxLen, std::vector<uint8_t>& out,
+                               size_t& consumed) {
+    if (srcLen < 5) {
+        return false;
+    }
+    const BlockMode mode = static_cast<BlockMode>(src[0]);
+    const uint32_t len = loadU32(src + 1);
+    if (len > maxLen) {
+        return false;
+    }
+    size_t pos = 5;
+
+    switch (mode) {
+        case BlockMode::Raw:
+            if (srcLen - pos < len) return false;
+            out.insert(out.end(), src + pos, src + pos + len);
+            consumed = pos + len;
+            return true;
+        case BlockMode::Rle:
+            if (srcLen - pos < 1) return false;
+            out.insert(out.end(), len, src[pos]);
+            consumed = pos + 1;
+            return true;
+        case BlockMode::Huffman:
+            break;
+        default:
+            return false;
+    }
+
+    if (srcLen - pos < 1) return false;
+    const unsigned maxSymbol = src[pos++];
+    const size_t lengthBytes = maxSymbol / 2 + 1;
+    if (srcLen - pos < lengthBytes + 4 * kStreams) return false;
+    std::array<uint8_t, 256> lengths{};
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        const uint8_t packed = src[pos + s / 2];
+        lengths[s] = (s & 1) ? (packed >> 4) : (packed & 0x0F);
+    }
+    pos += lengthBytes;
+    std::array<uint16_t, 256> codes{};
+    unsigned tableLog = 0;
+    if (!assignCanonicalCodes(lengths, maxSymbol, tableLog, codes)) return false;
+
+    // 查表：以码字为前缀的所有 tableLog 位索引都指向该符号
+    std::vector<DecodeEntry> table(size_t(1) << tableLog);
+    for (unsigned s = 0; s <= maxSymbol; ++s) {
+        if (lengths[s] == 0) continue;
+        const unsigned shift = tableLog - lengths[s];
+        const size_t first = size_t(codes[s]) << shift;
+        std::fill(table.begin() + first, table.begin() + first + (size_t(1) << shift),
+                  DecodeEntry{static_cast<uint8_t>(s), lengths[s]});
+    }
+
+    // 跳转表
+    CBitReader readers[kStreams];
+    const size_t jumpPos = pos;
+    pos += 4 * kStreams;
+    for (unsigned k = 0; k < kStreams; ++k) {
+        const uint32_t streamLen = loadU32(src + jumpPos + 4 * k);
+        if (srcLen - pos < streamLen || !readers[k].init(src + pos, streamLen)) return false;
+        pos += streamLen;
+    }
+
+    const size_t outStart = out.size();
+    out.resize(outStart + len);
+    uint8_t* dst = out.data() + outStart;
+    const DecodeEntry* t = table.data();
+    const size_t segment = (size_t(len) + kStreams - 1) / kStreams;
+    size_t begin[kStreams];
+    size_t count[kStreams];
+    for (unsigned k = 0; k < kStreams; ++k) {
+        begin[k] = std::min<size_t>(len, k * segment);
+        count[k] = std::min<size_t>(len, begin[k] + segment) - begin[k];
+    }
+    static_assert(kStreams == 4, "decode loop is unrolled for 4 streams");
+    // 最后一段最短，先 4 路同时解码到它的长度，再补齐前面几段的尾部
+    size_t i = 0;
+    for (; i < count[kStreams - 1]; ++i) {
+        dst[begin[0] + i] = decodeSymbol(readers[0], t, tableLog);
+        dst[begin[1] + i] = decodeSymbol(readers[1], t, tableLog);
+        dst[begin[2] + i] = decodeSymbol(readers[2], t, tableLog);
+        dst[begin[3] + i] = decodeSymbol(readers[3], t, tableLog);
+    }
+    for (unsigned k = 0; k < kStreams; ++k) {
+        for (size_t j = i; j < count[k]; ++j) {
+            dst[begin[k] + j] = decodeSymbol(readers[k], t, tableLog);
+        }
+        if (!readers[k].finished()) {
+            out.resize(outStart);
+            return false;
+        }
+    }
+    consumed = pos;
+    return true;
+}
@@ -1,5 +1,9 @@
 #include "HuffmanCompress.h"
+#include "CLogger.h"
+#include "CHistogram.h"
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
@@ -9,7 +13,7 @@ bool HuffmanCompress::readFreqTable(const std::string& sourcePath, std::array<ui
     // 读取文件
     std::ifstream in(sourcePath, std::ios::binary);
     if(!in || !in.is_open()){
-        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
         return false;
     }
 
@@ -22,9 +26,7 @@ bool HuffmanCompress::readFreqTable(const std::string& sourcePath, std::array<ui
         if(n <= 0)  break;
         originalSize += static_cast<uint64_t>(n);
         // 统计词频
-        for(std::streamsize i = 0;i < n; ++ i){
-            ++freqTable[buffer[i]];
-        }
+        CHistogram::count(buffer.data(), static_cast<size_t>(n), freqTable);
     }
     return true;
 }
@@ -91,22 +93,148 @@ std::array<std::vector<bool>, 256> HuffmanCompress::generateHuffmanCodes(HNode*
 }
 
 
+uint8_t HuffmanCompress::encodeBits(const uint8_t* data, size_t len, const std::array<std::vector<bool>, 256>& codes,
+                                    std::vector<uint8_t>& out){
+    uint8_t currentByte = 0;
+    int bitPosition = 0;
+    for(size_t i = 0; i < len; i++){
+        for(bool bit : codes[data[i]]){
+            currentByte |= (bit << (7 - bitPosition));
+            if(++bitPosition == 8){
+                out.push_back(currentByte);
+                currentByte = 0;
+                bitPosition = 0;
+            }
+        }
+    }
+    if(bitPosition > 0){
+        out.push_back(currentByte);
+        return static_cast<uint8_t>(8 - bitPosition);
+    }
+    return 0;
+}
+
 std::string HuffmanCompress::compressFile(const std::string& sourcePath){
+    // 在原先文件基础上增加后缀即可
+    std::string destPath = sourcePath + ".huff";
+    if(!m_singlePass){
+        return compressFileTwoPass(sourcePath, destPath);
+    }
+    std::ifstream in(sourcePath, std::ios::binary);
+    if(!in || !in.is_open()){
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return "";
+    }
+    std::ofstream out(destPath, std::ios::binary);
+    if(!out || !out.is_open()){
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
+        return "";
+    }
+    if(!compressStream(in, out)){
+        LOG_ERROR("Error: Failed to compress file " << sourcePath << ".");
+        return "";
+    }
+    return destPath;
+}
+
+bool HuffmanCompress::compressStream(std::istream& in, std::ostream& out){
+    CStageTimer timer(Stage::Compress);
+    // 输出不可回退（如管道）时 tellp 返回 -1，此时不回填文件头，以尾部的大小与CRC为准
+    const std::streampos headPos = out.tellp();
+
+    Head header;
+    header.isCompress = 0x21;
+    header.compressType = CompressType::Huffman;
+    header.validBits = 0;
+    header.reservedBits = HUFF_FLAG_BLOCKED;
+    header.headerSize = sizeof(Head);
+    header.freqTableSize = 0;
+    header.originalSize = 0;
+    header.crc32 = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
+
+    // 每块：原始长度（4字节） 词频表大小（4字节） 词频表 编码长度（4字节） 无效位数（1字节） 编码数据
+    std::vector<uint8_t> block(HUFF_TABLE_BLOCK_SIZE);
+    std::vector<uint8_t> encoded;
+    uint32_t crcValue = CRC32::getInitialValue();
+    while(in){
+        in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size()));
+        std::streamsize n = in.gcount();
+        if(n <= 0)  break;
+
+        std::array<uint64_t, 256> freq;
+        freq.fill(0);
+        CHistogram::count(block.data(), static_cast<size_t>(n), freq);
+        for(std::streamsize i = 0; i < n; i++){
+            crcValue = CRC32::update(crcValue, block[i]);
+        }
+        HNode* root = buildHuffmanTree(freq);
+        auto codes = generateHuffmanCodes(root);
+        deleteHuffmanTree(root);
+        encoded.clear();
+        const uint8_t invalidBits = encodeBits(block.data(), static_cast<size_t>(n), codes, encoded);
+
+        const uint32_t rawLen = static_cast<uint32_t>(n);
+        uint32_t freqTableSize = 0;
+        for(int i = 0; i < 256; i++){
+            if(freq[i] > 0) freqTableSize += 1 + 8;
+        }
+        out.write(reinterpret_cast<const char*>(&rawLen), 4);
+        out.write(reinterpret_cast<const char*>(&freqTableSize), 4);
+        for(int i = 0; i < 256; i++){
+            if(freq[i] > 0){
+                out.write(reinterpret_cast<const char*>(&i), 1);
+                out.write(reinterpret_cast<const char*>(&freq[i]), 8);
+            }
+        }
+        const uint32_t encodedLen = static_cast<uint32_t>(encoded.size());
+        out.write(reinterpret_cast<const char*>(&encodedLen), 4);
+        out.write(reinterpret_cast<const char*>(&invalidBits), 1);
+        out.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+        header.originalSize += rawLen;
+    }
+    if(in.bad()){
+        LOG_ERROR("Error: Failed to read input stream.");
+        return false;
+    }
+    header.crc32 = CRC32::finalize(crcValue);
+    timer.addBytes(header.originalSize);
+    timer.addFiles();
+
+    // 结束块与尾部
+    const uint32_t endMark = 0;
+    out.write(reinterpret_cast<const char*>(&endMark), 4);
+    out.write(reinterpret_cast<const char*>(&header.originalSize), 8);
+    out.write(reinterpret_cast<const char*>(&header.crc32), 4);
+
+    if(headPos != std::streampos(-1)){
+        out.seekp(headPos);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Head));
+        out.seekp(0, std::ios::end);
+    }
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+std::string HuffmanCompress::compressFileTwoPass(const std::string& sourcePath, const std::string& destPath){
     // 检查目标文件路径是否可以访问
     // 直接检查是不是存在不太对，因为还没创建一定不存在
     // TODO: 检查目标文件路径是否可以访问
+    CStageTimer timer(Stage::Compress);
 
     // 读取内容统计每个字节的出现频率
     std::array<uint64_t, 256> freq;
     uint64_t originalSize = 0;
     if(!readFreqTable(sourcePath, freq, originalSize)){
-        std::cerr << "Error: Failed to read frequency table from file " << sourcePath << ".\n";
+        LOG_ERROR("Error: Failed to read frequency table from file " << sourcePath << ".");
         return "";
     }
+    timer.addBytes(originalSize);
+    timer.addFiles();
     // 构造哈夫曼树
     HNode* root = buildHuffmanTree(freq);
     if(!root){
-        std::cerr << "Error: Failed to build Huffman tree.\n";
+        LOG_ERROR("Error: Failed to build Huffman tree.");
         return "";
     }
 
@@ -115,16 +243,14 @@ std::string HuffmanCompress::compressFile(const std::string& sourcePath){
     // 释放资源
     deleteHuffmanTree(root);
     if(codes.empty()){
-        std::cerr << "Error: Failed to generate Huffman codes.\n";
+        LOG_ERROR("Error: Failed to generate Huffman codes.");
         return "";
     }
     
     // 随后创建文件头，存储CRC offset 压缩算法类型
-    // 在原先文件基础上增加后缀即可
-    std::string destPath = sourcePath + ".huff";
     std::ofstream out(destPath, std::ios::binary);
     if(!out|| !out.is_open()){
-        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
         return "";
     }
 
@@ -164,7 +290,7 @@ std::string HuffmanCompress::compressFile(const std::string& sourcePath){
     // 打开文件
     std::ifstream in(sourcePath, std::ios::binary);
     if(!in || !in.is_open()){
-        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
         return "";
     }
 
@@ -245,32 +371,44 @@ std::string HuffmanCompress::compressFile(const std::string& sourcePath){
 
 bool HuffmanCompress::decompressFile(const std::string& sourcePath, const std::string& destPath){
     // 打开压缩文件
-     std::ifstream in(sourcePath, std::ios::binary);
+    std::ifstream in(sourcePath, std::ios::binary);
     if(!in || !in.is_open()){
-        std::cerr << "Error: Failed to open file " << sourcePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
         return false;
     }
 
     // 打开目标文件写入
     std::ofstream out(destPath, std::ios::binary);
     if(!out || !out.is_open()){
-        std::cerr << "Error: Failed to open file " << destPath << " for writing.\n";
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
         in.close();
         return false;
     }
+    const bool ok = decompressStream(in, out, sourcePath);
+    out.close();
+    return ok && static_cast<bool>(out);
+}
 
+bool HuffmanCompress::decompressStream(std::istream& in, std::ostream& out, const std::string& sourcePath){
+    CStageTimer timer(Stage::Decompress);
     // 读取头信息
     Head header;
     in.read(reinterpret_cast<char*>(&header), sizeof(Head));
 
     // 验证是否位压缩文件或压缩类型
     if(header.isCompress != 0x21 || header.compressType != CompressType::Huffman){
-        std::cerr << "Error: File " << sourcePath << " is not a Huffman compressed file.\n";
-        in.close();
-        out.close();
+        LOG_ERROR("Error: File " << sourcePath << " is not a Huffman compressed file.");
         return false;
     }
 
+    timer.addBytes(header.originalSize);
+    timer.addFiles();
+
+    // 分块格式：每块自带词频表
+    if(header.reservedBits & HUFF_FLAG_BLOCKED){
+        return decompressBlocks(in, out, sourcePath);
+    }
+
     // 读取词频表
     std::array<uint64_t, 256> freqTable = {0};
     for(uint32_t i = 0 ;i < header.freqTableSize;){
@@ -285,9 +423,7 @@ bool HuffmanCompress::decompressFile(const std::string& sourcePath, const std::s
     // 重建 Huffman 树
     HNode* root = buildHuffmanTree(freqTable);
     if(!root){
-        std::cerr << "Error: Failed to build Huffman tree.\n";
-        in.close();
-        out.close();
+        LOG_ERROR("Error: Failed to build Huffman tree.");
         return false;
     }
 
@@ -351,19 +487,198 @@ bool HuffmanCompress::decompressFile(const std::string& sourcePath, const std::s
 
     // 校验校验码
     if(calculatedCRC != header.crc32){
-        std::cerr << "Error: CRC32 checksum mismatch. Decompressed data may be corrupted.\n";
-        out.close();
-        in.close();
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
         return false;
     }
 
     // 将解压后的数据写入目标文件
     out.write(reinterpret_cast<const char*>(decompressedData.data()), decompressedData.size());
+    return static_cast<bool>(out);
+}
+
+bool HuffmanCompress::decompressBlocks(std::istream& in, std::ostream& out, const std::string& sourcePath){
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> decoded;
+    uint64_t decompressedCount = 0;
+    uint32_t crcValue = CRC32::getInitialValue();
+    for(;;){
+        uint32_t rawLen = 0;
+        in.read(reinterpret_cast<char*>(&rawLen), 4);
+        if(!in){
+            LOG_ERROR("Error: Huffman file " << sourcePath << " is truncated.");
+            return false;
+        }
+        if(rawLen == 0)  break;   // 结束块
+
+        uint32_t freqTableSize = 0;
+        in.read(reinterpret_cast<char*>(&freqTableSize), 4);
+        if(!in || rawLen > HUFF_TABLE_BLOCK_SIZE || freqTableSize == 0 || freqTableSize % 9 != 0 ||
+           freqTableSize > 256 * 9){
+            LOG_ERROR("Error: Huffman file " << sourcePath << " is corrupted.");
+            return false;
+        }
+        std::array<uint64_t, 256> freqTable = {0};
+        for(uint32_t i = 0; i < freqTableSize; i += 1 + 8){
+            uint8_t byte = 0;
+            in.read(reinterpret_cast<char*>(&byte), 1);
+            in.read(reinterpret_cast<char*>(&freqTable[byte]), 8);
+        }
+        uint32_t encodedLen = 0;
+        uint8_t invalidBits = 0;
+        in.read(reinterpret_cast<char*>(&encodedLen), 4);
+        in.read(reinterpret_cast<char*>(&invalidBits), 1);
+        // 块内不超过 2^20 个符号，码长不会超过 32 位
+        if(!in || encodedLen == 0 || encodedLen > uint64_t(rawLen) * 4 || invalidBits > 7){
+            LOG_ERROR("Error: Huffman file " << sourcePath << " is corrupted.");
+            return false;
+        }
+        encoded.resize(encodedLen);
+        in.read(reinterpret_cast<char*>(encoded.data()), encodedLen);
+        if(static_cast<uint32_t>(in.gcount()) != encodedLen){
+            LOG_ERROR("Error: Huffman file " << sourcePath << " is truncated.");
+            return false;
+        }
 
+        HNode* root = buildHuffmanTree(freqTable);
+        HNode* currentNode = root;
+        decoded.clear();
+        for(uint32_t pos = 0; pos < encodedLen && decoded.size() < rawLen && currentNode; pos++){
+            const uint8_t byte = encoded[pos];
+            const int bitsToProcess = (pos + 1 == encodedLen) ? 8 - invalidBits : 8;
+            for(int j = 0; j < bitsToProcess && decoded.size() < rawLen; j++){
+                currentNode = ((byte >> (7 - j)) & 1) ? currentNode->right : currentNode->left;
+                if(!currentNode)  break;
+                if(currentNode->isLeaf()){
+                    decoded.push_back(currentNode->byte);
+                    currentNode = root;
+                }
+            }
+        }
+        deleteHuffmanTree(root);
+        if(decoded.size() != rawLen){
+            LOG_ERROR("Error: Huffman file " << sourcePath << " is corrupted.");
+            return false;
+        }
+        for(uint8_t byte : decoded){
+            crcValue = CRC32::update(crcValue, byte);
+        }
+        out.write(reinterpret_cast<const char*>(decoded.data()), decoded.size());
+        decompressedCount += rawLen;
+    }
 
-    out.close();
-    in.close();
+    // 尾部：原始大小与CRC32
+    uint64_t originalSize = 0;
+    uint32_t crc32 = 0;
+    in.read(reinterpret_cast<char*>(&originalSize), 8);
+    in.read(reinterpret_cast<char*>(&crc32), 4);
+    if(!in || originalSize != decompressedCount || CRC32::finalize(crcValue) != crc32){
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
+        return false;
+    }
+    return static_cast<bool>(out);
+}
+
+bool HuffmanCompress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData){
+    CStageTimer timer(Stage::Compress);
+    timer.addBytes(sourceData.size());
+
+    std::array<uint64_t, 256> freq;
+    freq.fill(0);
+    CHistogram::count(sourceData.data(), sourceData.size(), freq);
+    uint32_t crcValue = CRC32::getInitialValue();
+    for(char c : sourceData){
+        crcValue = CRC32::update(crcValue, static_cast<uint8_t>(c));
+    }
+    HNode* root = buildHuffmanTree(freq);
+    auto codes = generateHuffmanCodes(root);
+    deleteHuffmanTree(root);
+
+    Head header;
+    header.isCompress = 0x21;
+    header.compressType = CompressType::Huffman;
+    header.validBits = 0;
+    header.reservedBits = 0;
+    header.headerSize = sizeof(Head);
+    header.freqTableSize = 0;
+    header.originalSize = sourceData.size();
+    header.crc32 = CRC32::finalize(crcValue);
+
+    // 文件头之后是词频表（1字节字节值 + 8字节频率）
+    destData.assign(sizeof(Head), 0);
+    for(int i = 0; i < 256; i++){
+        if(freq[i] > 0){
+            destData.push_back(static_cast<char>(i));
+            const char* f = reinterpret_cast<const char*>(&freq[i]);
+            destData.insert(destData.end(), f, f + 8);
+            header.freqTableSize += 1 + 8;
+        }
+    }
+
+    // 编码数据，高位在前
+    std::vector<uint8_t> encoded;
+    header.validBits = encodeBits(reinterpret_cast<const uint8_t*>(sourceData.data()), sourceData.size(), codes, encoded);
+    destData.insert(destData.end(), encoded.begin(), encoded.end());
+    std::memcpy(destData.data(), &header, sizeof(Head));
     return true;
 }
 
+bool HuffmanCompress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData){
+    CStageTimer timer(Stage::Decompress);
+    Head header;
+    if(sourceData.size() < sizeof(Head)){
+        LOG_ERROR("Error: Huffman data is truncated.");
+        return false;
+    }
+    std::memcpy(&header, sourceData.data(), sizeof(Head));
+    if(header.isCompress != 0x21 || header.compressType != CompressType::Huffman ||
+       header.freqTableSize % 9 != 0 || sizeof(Head) + header.freqTableSize > sourceData.size()){
+        LOG_ERROR("Error: Data is not Huffman compressed.");
+        return false;
+    }
+    timer.addBytes(header.originalSize);
+
+    std::array<uint64_t, 256> freqTable = {0};
+    size_t pos = sizeof(Head);
+    for(uint32_t i = 0; i < header.freqTableSize; i += 1 + 8){
+        const uint8_t byte = static_cast<uint8_t>(sourceData[pos]);
+        std::memcpy(&freqTable[byte], sourceData.data() + pos + 1, 8);
+        pos += 1 + 8;
+    }
 
+    HNode* root = buildHuffmanTree(freqTable);
+    destData.clear();
+    destData.reserve(static_cast<size_t>(std::min<uint64_t>(header.originalSize, sourceData.size() * 8)));
+    HNode* currentNode = root;
+    for(; pos < sourceData.size() && destData.size() < header.originalSize; ++pos){
+        const uint8_t byte = static_cast<uint8_t>(sourceData[pos]);
+        const int bitsToProcess = (pos + 1 == sourceData.size()) ? 8 - header.validBits : 8;
+        for(int j = 0; j < bitsToProcess && destData.size() < header.originalSize; j++){
+            currentNode = ((byte >> (7 - j)) & 1) ? currentNode->right : currentNode->left;
+            if(!currentNode){
+                break;
+            }
+            if(currentNode->isLeaf()){
+                destData.push_back(static_cast<char>(currentNode->byte));
+                currentNode = root;
+            }
+        }
+        if(!currentNode){
+            break;
+        }
+    }
+    deleteHuffmanTree(root);
+
+    if(destData.size() != header.originalSize){
+        LOG_ERROR("Error: Huffman data is truncated or corrupted.");
+        return false;
+    }
+    uint32_t calculatedCRC = CRC32::getInitialValue();
+    for(char c : destData){
+        calculatedCRC = CRC32::update(calculatedCRC, static_cast<uint8_t>(c));
+    }
+    if(CRC32::finalize(calculatedCRC) != header.crc32){
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
+        return false;
+    }
+    return true;
+}
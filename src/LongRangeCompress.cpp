@@ -0,0 +1,551 @@
+#include "LongRangeCompress.h"
+#include "CLogger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+constexpr size_t kCompareChunk = 4096;
+constexpr size_t kMinBudget = 64 * 1024;
+constexpr size_t kMinHuffmanLiterals = 64;  // 更少的字面量不值得带上词频表
+
+enum class LiteralMode : uint8_t {
+    Raw = 0,
+    Huffman = 1,
+};
+
+// gear 滚动哈希的字节表（splitmix64 生成）
+struct GearTable {
+    uint64_t values[256];
+    constexpr GearTable() : values() {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (auto& v : values) {
+            state += 0x9E3779B97F4A7C15ull;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            v = z ^ (z >> 31);
+        }
+    }
+};
+constexpr GearTable kGear;
+
+// gear 哈希：每次左移一位再加上新字节的表值，64 字节之前的字节自然移出，
+// 滚动一次只有移位和加法两步依赖
+uint64_t hashWindow(const uint8_t* p) {
+    uint64_t h = 0;
+    for (size_t i = 0; i < LongRangeMatcher::kWindow; ++i) {
+        h = (h << 1) + kGear.values[p[i]];
+    }
+    return h;
+}
+
+// 高位受整个窗口影响，用来决定是否采样
+bool sampled(uint64_t h) {
+    return (h >> (64 - LongRangeMatcher::kSampleLog)) == 0;
+}
+
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+void storeU32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void storeU32At(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint32_t loadU32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+void writeVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t b = *p++;
+        v |= uint64_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+LongRangeMatcher::LongRangeMatcher(size_t memoryBudget) {
+    const size_t entries = std::max(memoryBudget, kMinBudget) / sizeof(uint64_t);
+    unsigned bucketLog = 1;
+    while ((size_t(1) << (bucketLog + 1)) * kBucketSize <= entries) ++bucketLog;
+    m_table.assign((size_t(1) << bucketLog) * kBucketSize, 0);
+    m_shift = 64 - bucketLog;
+    m_scratch.resize(kCompareChunk);
+}
+
+void LongRangeMatcher::findMatches(const uint8_t* data, size_t len, uint64_t start, const HistoryReader& history,
+                                   std::vector<LongRangeSequence>& sequences) {
+    // 读取 [offset, offset + n)：当前段之前的部分来自 history，其余来自 data
+    auto readAt = [&](uint64_t offset, uint8_t* dest, size_t n) {
+        if (offset >= start) {
+            std::memcpy(dest, data + (offset - start), n);
+            return true;
+        }
+        const size_t before = static_cast<size_t>(std::min<uint64_t>(n, start - offset));
+        if (!history(offset, dest, before)) return false;
+        std::memcpy(dest + before, data, n - before);
+        return true;
+    };
+    // 从 pos 与 candidate 开始向后比较，返回相同的字节数
+    auto forwardLength = [&](size_t pos, uint64_t candidate) {
+        size_t matched = 0;
+        while (pos + matched < len) {
+            const size_t n = std::min(kCompareChunk, len - pos - matched);
+            if (!readAt(candidate + matched, m_scratch.data(), n)) break;
+            const uint8_t* cur = data + pos + matched;
+            size_t i = 0;
+            while (i < n && cur[i] == m_scratch[i]) ++i;
+            matched += i;
+            if (i < n) break;
+        }
+        return matched;
+    };
+    // 向前扩展，不越过尚未输出的字面量起点
+    auto backwardLength = [&](size_t pos, uint64_t candidate, size_t litStart) {
+        const size_t limit = static_cast<size_t>(std::min<uint64_t>({pos - litStart, candidate, kMaxBackward}));
+        if (limit == 0 || !readAt(candidate - limit, m_scratch.data(), limit)) return size_t(0);
+        size_t back = 0;
+        while (back < limit && data[pos - back - 1] == m_scratch[limit - back - 1]) ++back;
+        return back;
+    };
+
+    size_t litStart = 0;
+    size_t pos = 0;
+    uint64_t h = 0;
+    bool hashed = false;
+    while (pos + kWindow <= len) {
+        if (!hashed) {
+            h = hashWindow(data + pos);
+            hashed = true;
+        }
+        if (sampled(h)) {
+            const uint64_t mixed = mix(h);
+            uint64_t* bucket = &m_table[(mixed >> m_shift) * kBucketSize];
+            const uint64_t check = mixed & 0xFFFF;
+            const uint64_t position = start + pos;
+            size_t bestLen = 0;
+            size_t bestBack = 0;
+            uint64_t bestCandidate = 0;
+            for (size_t i = 0; i < kBucketSize && bucket[i] != 0; ++i) {
+                const uint64_t candidate = (bucket[i] >> 16) - 1;
+                if ((bucket[i] & 0xFFFF) != check || candidate >= position) continue;
+                const size_t forward = forwardLength(pos, candidate);
+                if (forward < kMinMatch) continue;
+                const size_t back = backwardLength(pos, candidate, litStart);
+                if (forward + back > bestLen + bestBack) {
+                    bestLen = forward;
+                    bestBack = back;
+                    bestCandidate = candidate;
+                }
+            }
+            // 新位置放在桶首，最旧的一项被挤出
+            std::memmove(bucket + 1, bucket, (kBucketSize - 1) * sizeof(uint64_t));
+            bucket[0] = ((position + 1) << 16) | check;
+
+            if (bestLen > 0) {
+                const size_t matchStart = pos - bestBack;
+                sequences.push_back({static_cast<uint32_t>(matchStart - litStart), static_cast<uint32_t>(bestBack + bestLen),
+                                     position - bestCandidate});
+                pos += bestLen;
+                litStart = pos;
+                hashed = false;
+                continue;
+            }
+        }
+        if (pos + kWindow == len) break;
+        // 窗口右移一个字节
+        h = (h << 1) + kGear.values[data[pos + kWindow]];
+        ++pos;
+    }
+    sequences.push_back({static_cast<uint32_t>(len - litStart), 0, 0});
+}
+
+void LongRangeCompress::encodeSegment(const uint8_t* data, size_t len, uint64_t start, LongRangeMatcher& matcher,
+                                      const LongRangeMatcher::HistoryReader& history, std::vector<uint8_t>& out) {
+    std::vector<LongRangeSequence> sequences;
+    matcher.findMatches(data, len, start, history, sequences);
+
+    std::vector<uint8_t> sequenceBytes;
+    std::vector<char> literals;
+    size_t pos = 0;
+    for (const auto& seq : sequences) {
+        writeVarint(sequenceBytes, seq.literalLength);
+        writeVarint(sequenceBytes, seq.matchLength);
+        if (seq.matchLength > 0) {
+            writeVarint(sequenceBytes, seq.distance);
+        }
+        literals.insert(literals.end(), data + pos, data + pos + seq.literalLength);
+        pos += seq.literalLength + seq.matchLength;
+    }
+
+    // 字面量交给哈夫曼编码，没有变小时原样存放；内部计时已包含在外层
+    std::vector<char> encoded;
+    LiteralMode mode = LiteralMode::Raw;
+    if (literals.size() >= kMinHuffmanLiterals) {
+        CMetrics::Bind unbound(nullptr);
+        if (m_literalCoder.compressData(literals, encoded) && encoded.size() < literals.size()) {
+            mode = LiteralMode::Huffman;
+        }
+    }
+    const std::vector<char>& payload = mode == LiteralMode::Huffman ? encoded : literals;
+
+    const size_t begin = out.size();
+    storeU32(out, 0);
+    storeU32(out, static_cast<uint32_t>(len));
+    storeU32(out, static_cast<uint32_t>(sequenceBytes.size()));
+    out.insert(out.end(), sequenceBytes.begin(), sequenceBytes.end());
+    out.push_back(static_cast<uint8_t>(mode));
+    storeU32(out, static_cast<uint32_t>(payload.size()));
+    out.insert(out.end(), payload.begin(), payload.end());
+    storeU32At(out.data() + begin, static_cast<uint32_t>(out.size() - begin - 4));
+}
+
+bool LongRangeCompress::decodeSegment(const uint8_t* src, size_t srcLen, uint64_t start,
+                                      const LongRangeMatcher::HistoryReader& history, std::vector<uint8_t>& out) {
+    if (srcLen < 8) return false;
+    const uint32_t rawLen = loadU32(src);
+    const uint32_t sequenceLen = loadU32(src + 4);
+    if (rawLen > kSegmentSize || srcLen - 8 < sequenceLen || srcLen - 8 - sequenceLen < 5) return false;
+    const uint8_t* seq = src + 8;
+    const uint8_t* seqEnd = seq + sequenceLen;
+    const LiteralMode mode = static_cast<LiteralMode>(seqEnd[0]);
+    const uint32_t payloadLen = loadU32(seqEnd + 1);
+    const uint8_t* payload = seqEnd + 5;
+    if (static_cast<size_t>(src + srcLen - payload) != payloadLen) return false;
+
+    std::vector<char> literals;
+    if (mode == LiteralMode::Huffman) {
+        CMetrics::Bind unbound(nullptr);
+        if (!m_literalCoder.decompressData(std::vector<char>(payload, payload + payloadLen), literals)) return false;
+    } else if (mode == LiteralMode::Raw) {
+        literals.assign(payload, payload + payloadLen);
+    } else {
+        return false;
+    }
+
+    out.resize(rawLen);
+    size_t o = 0;
+    size_t lit = 0;
+    while (seq < seqEnd) {
+        uint64_t literalLength = 0;
+        uint64_t matchLength = 0;
+        uint64_t distance = 0;
+        if (!readVarint(seq, seqEnd, literalLength) || !readVarint(seq, seqEnd, matchLength) ||
+            (matchLength > 0 && !readVarint(seq, seqEnd, distance))) {
+            return false;
+        }
+        if (literalLength > literals.size() - lit || literalLength > rawLen - o) return false;
+        std::memcpy(out.data() + o, literals.data() + lit, static_cast<size_t>(literalLength));
+        o += static_cast<size_t>(literalLength);
+        lit += static_cast<size_t>(literalLength);
+        if (matchLength == 0) continue;
+        if (matchLength > rawLen - o || distance == 0 || distance > start + o) return false;
+
+        // 匹配来源先取之前段的历史，再取本段已解码的部分（可与当前位置重叠，逐字节复制）
+        uint64_t from = start + o - distance;
+        size_t remaining = static_cast<size_t>(matchLength);
+        if (from < start) {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(remaining, start - from));
+            if (!history(from, out.data() + o, n)) return false;
+            o += n;
+            from += n;
+            remaining -= n;
+        }
+        for (size_t i = static_cast<size_t>(from - start); remaining > 0; --remaining) {
+            out[o++] = out[i++];
+        }
+    }
+    return o == rawLen && lit == literals.size();
+}
+
+bool LongRangeCompress::compressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    CStageTimer timer(Stage::Compress);
+    timer.addBytes(sourceData.size());
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(sourceData.data());
+
+    BlockHead header{};
+    header.isCompress = 0x21;
+    header.compressType = getCompressType();
+    header.blockSize = static_cast<uint32_t>(kSegmentSize);
+    header.originalSize = sourceData.size();
+    header.crc32 = CRC32::calculate(std::vector<uint8_t>(src, src + sourceData.size()));
+
+    LongRangeMatcher matcher(std::min(m_memoryBudget, std::max<size_t>(sourceData.size(), 1) * 2));
+    auto history = [&](uint64_t offset, uint8_t* dest, size_t len) {
+        std::memcpy(dest, src + offset, len);
+        return true;
+    };
+    std::vector<uint8_t> out(sizeof(BlockHead));
+    std::memcpy(out.data(), &header, sizeof(BlockHead));
+    for (size_t offset = 0; offset < sourceData.size(); offset += kSegmentSize) {
+        encodeSegment(src + offset, std::min(kSegmentSize, sourceData.size() - offset), offset, matcher, history, out);
+    }
+    destData.assign(out.begin(), out.end());
+    return true;
+}
+
+bool LongRangeCompress::decompressData(const std::vector<char>& sourceData, std::vector<char>& destData) {
+    CStageTimer timer(Stage::Decompress);
+    BlockHead header;
+    if (sourceData.size() < sizeof(BlockHead)) {
+        LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated.");
+        return false;
+    }
+    std::memcpy(&header, sourceData.data(), sizeof(BlockHead));
+    if (header.isCompress != 0x21 || header.compressType != getCompressType()) {
+        LOG_ERROR("Error: Data is not " << getCompressTypeName() << " compressed.");
+        return false;
+    }
+    timer.addBytes(header.originalSize);
+
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(sourceData.data());
+    std::vector<uint8_t> restored;
+    restored.reserve(static_cast<size_t>(std::min<uint64_t>(header.originalSize, uint64_t(sourceData.size()) * 64)));
+    auto history = [&](uint64_t offset, uint8_t* dest, size_t len) {
+        std::memcpy(dest, restored.data() + offset, len);
+        return true;
+    };
+    std::vector<uint8_t> segment;
+    size_t pos = sizeof(BlockHead);
+    while (pos < sourceData.size()) {
+        if (sourceData.size() - pos < 4 || sourceData.size() - pos - 4 < loadU32(src + pos) ||
+            !decodeSegment(src + pos + 4, loadU32(src + pos), restored.size(), history, segment)) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " data is truncated or corrupted.");
+            return false;
+        }
+        pos += 4 + loadU32(src + pos);
+        restored.insert(restored.end(), segment.begin(), segment.end());
+    }
+    if (restored.size() != header.originalSize || CRC32::calculate(restored) != header.crc32) {
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
+        return false;
+    }
+    destData.assign(restored.begin(), restored.end());
+    return true;
+}
+
+std::string LongRangeCompress::compressFile(const std::string& sourcePath) {
+    CStageTimer timer(Stage::Compress);
+    std::ifstream in(sourcePath, std::ios::binary);
+    // 匹配确认时从第二个句柄读回更早的数据
+    std::ifstream historyIn(sourcePath, std::ios::binary);
+    if (!in || !historyIn) {
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return "";
+    }
+    const std::string destPath = sourcePath + ".lrm";
+    std::ofstream out(destPath, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
+        return "";
+    }
+
+    BlockHead header{};
+    header.isCompress = 0x21;
+    header.compressType = getCompressType();
+    header.blockSize = static_cast<uint32_t>(kSegmentSize);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(BlockHead));
+
+    LongRangeMatcher matcher(m_memoryBudget);
+    auto history = [&](uint64_t offset, uint8_t* dest, size_t len) {
+        historyIn.clear();
+        historyIn.seekg(static_cast<std::streamoff>(offset));
+        return static_cast<bool>(historyIn.read(reinterpret_cast<char*>(dest), len));
+    };
+    std::vector<uint8_t> segment(kSegmentSize);
+    std::vector<uint8_t> encoded;
+    uint32_t crcValue = CRC32::getInitialValue();
+    while (in) {
+        in.read(reinterpret_cast<char*>(segment.data()), kSegmentSize);
+        const size_t n = static_cast<size_t>(in.gcount());
+        if (n == 0) break;
+        for (size_t i = 0; i < n; ++i) {
+            crcValue = CRC32::update(crcValue, segment[i]);
+        }
+        encoded.clear();
+        encodeSegment(segment.data(), n, header.originalSize, matcher, history, encoded);
+        out.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+        header.originalSize += n;
+    }
+    if (in.bad()) {
+        LOG_ERROR("Error: Failed to read file " << sourcePath << ".");
+        return "";
+    }
+    timer.addBytes(header.originalSize);
+    timer.addFiles();
+
+    header.crc32 = CRC32::finalize(crcValue);
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(BlockHead));
+    out.close();
+    if (!out) {
+        LOG_ERROR("Error: Failed to write file " << destPath << ".");
+        return "";
+    }
+    return destPath;
+}
+
+bool LongRangeCompress::decompressFile(const std::string& sourcePath, const std::string& destPath) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return false;
+    }
+    return decompressTo(in, sourcePath, destPath);
+}
+
+bool LongRangeCompress::decompressStream(std::istream& in, std::ostream& out, const std::string& sourcePath) {
+    // 匹配会引用任意早的输出，解压结果须可随机读回：先解压到临时文件，再顺序写出
+    const std::filesystem::path tempPath = std::filesystem::temp_directory_path() /
+        ("lrm_stream_" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "_" +
+         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp");
+    bool ok = decompressTo(in, sourcePath, tempPath.string());
+    if (ok) {
+        std::ifstream restored(tempPath, std::ios::binary);
+        std::vector<char> buffer(1024 * 1024);
+        while (out && restored.read(buffer.data(), buffer.size()).gcount() > 0) {
+            out.write(buffer.data(), restored.gcount());
+        }
+        ok = static_cast<bool>(out);
+    }
+    std::error_code ec;
+    std::filesystem::remove(tempPath, ec);
+    return ok;
+}
+
+bool LongRangeCompress::decompressTo(std::istream& in, const std::string& sourcePath, const std::string& destPath) {
+    CStageTimer timer(Stage::Decompress);
+    BlockHead header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(BlockHead));
+    if (!in || header.isCompress != 0x21 || header.compressType != getCompressType()) {
+        LOG_ERROR("Error: File " << sourcePath << " is not a " << getCompressTypeName() << " compressed file.");
+        return false;
+    }
+    std::ofstream out(destPath, std::ios::binary);
+    // 匹配引用之前段的数据时从已写出的输出中读回
+    std::ifstream historyIn(destPath, std::ios::binary);
+    if (!out || !historyIn) {
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
+        return false;
+    }
+    timer.addBytes(header.originalSize);
+    timer.addFiles();
+
+    auto history = [&](uint64_t offset, uint8_t* dest, size_t len) {
+        historyIn.clear();
+        historyIn.seekg(static_cast<std::streamoff>(offset));
+        return static_cast<bool>(historyIn.read(reinterpret_cast<char*>(dest), len));
+    };
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> segment;
+    uint64_t restored = 0;
+    uint32_t crcValue = CRC32::getInitialValue();
+    while (restored < header.originalSize) {
+        uint32_t segmentLen = 0;
+        in.read(reinterpret_cast<char*>(&segmentLen), sizeof(segmentLen));
+        // 字面量不可压缩时段数据略大于原始数据
+        if (!in || segmentLen > 2 * kSegmentSize + 1024) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " file " << sourcePath << " is truncated or corrupted.");
+            return false;
+        }
+        encoded.resize(segmentLen);
+        in.read(reinterpret_cast<char*>(encoded.data()), segmentLen);
+        if (static_cast<uint32_t>(in.gcount()) != segmentLen ||
+            !decodeSegment(encoded.data(), segmentLen, restored, history, segment) || segment.empty()) {
+            LOG_ERROR("Error: " << getCompressTypeName() << " file " << sourcePath << " is truncated or corrupted.");
+            return false;
+        }
+        for (uint8_t b : segment) {
+            crcValue = CRC32::update(crcValue, b);
+        }
+        out.write(reinterpret_cast<const char*>(segment.data()), segment.size());
+        out.flush();
+        restored += segment.size();
+    }
+    if (restored != header.originalSize || CRC32::finalize(crcValue) != header.crc32) {
+        LOG_ERROR("Error: CRC32 checksum mismatch. Decompressed data may be corrupted.");
+        return false;
+    }
+    return static_cast<bool>(out);
+}
+
+LongRangeStream::LongRangeStream(uint64_t start, size_t window, uint64_t sizeHint)
+    : m_window(std::max<size_t>(window, 1)), m_start(start), m_position(start), m_sizeHint(sizeHint) {}
+
+bool LongRangeStream::readHistory(uint64_t offset, uint8_t* dest, size_t len) const {
+    // 只能读取窗口内已追加的数据
+    if (offset < m_position - m_ring.size() || offset > m_position || m_position - offset < len) return false;
+    const size_t index = static_cast<size_t>((offset - m_start) % m_window);
+    const size_t first = std::min(len, m_ring.size() - index);
+    std::memcpy(dest, m_ring.data() + index, first);
+    std::memcpy(dest + first, m_ring.data(), len - first);
+    return true;
+}
+
+void LongRangeStream::append(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        size_t n = 0;
+        if (m_ring.size() < m_window) {
+            n = std::min(len, m_window - m_ring.size());
+            m_ring.insert(m_ring.end(), data, data + n);
+        } else {
+            const size_t index = static_cast<size_t>((m_position - m_start) % m_window);
+            n = std::min(len, m_window - index);
+            std::memcpy(m_ring.data() + index, data, n);
+        }
+        m_position += n;
+        data += n;
+        len -= n;
+    }
+}
+
+void LongRangeStream::encodeBlock(const uint8_t* data, size_t len, std::vector<char>& out) {
+    CStageTimer timer(Stage::Compress);
+    timer.addBytes(len);
+    if (!m_matcher) {
+        const size_t budget = m_codec.getMemoryBudget();
+        m_matcher = std::make_unique<LongRangeMatcher>(
+            m_sizeHint > 0 ? static_cast<size_t>(std::min<uint64_t>(budget, m_sizeHint * 2)) : budget);
+    }
+    auto history = [this](uint64_t offset, uint8_t* dest, size_t n) { return readHistory(offset, dest, n); };
+    m_segment.clear();
+    m_codec.encodeSegment(data, len, m_position, *m_matcher, history, m_segment);
+    // 去掉段长度，块头中已有存放长度
+    out.assign(m_segment.begin() + 4, m_segment.end());
+    append(data, len);
+}
+
+bool LongRangeStream::decodeBlock(const char* src, size_t srcLen, std::vector<char>& out) {
+    CStageTimer timer(Stage::Decompress);
+    auto history = [this](uint64_t offset, uint8_t* dest, size_t n) { return readHistory(offset, dest, n); };
+    if (!m_codec.decodeSegment(reinterpret_cast<const uint8_t*>(src), srcLen, m_position, history, m_segment)) {
+        return false;
+    }
+    timer.addBytes(m_segment.size());
+    out.assign(m_segment.begin(), m_segment.end());
+    append(m_segment.data(), m_segment.size());
+    return true;
+}
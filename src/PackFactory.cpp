@@ -1,4 +1,5 @@
 #include "PackFactory.h"
+#include "CLogger.h"
 
 
 std::unique_ptr<IPack> PackFactory::createPacker(const std::string& packType){
@@ -24,7 +25,7 @@ std::string PackFactory::getPackType(const std::string& filePath) {
     // 根据文件的第二个字节判断打包类型，第一个字节适用于判断当前文件是否为打包文件的标志位
     std::ifstream in(filePath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << filePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
         return "";
     }
     // 跳过第一个字节
@@ -39,16 +40,16 @@ std::string PackFactory::getPackType(const std::string& filePath) {
 
 bool PackFactory::isPackedFile(const std::string& filePath) {
     if(!std::filesystem::exists(filePath)){
-        std::cerr << "Error: File " << filePath << " does not exist.\n";
+        LOG_ERROR("Error: File " << filePath << " does not exist.");
         return false;
     }
     std::ifstream in(filePath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << filePath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << filePath << " for reading.");
         return false;
     }
     uint8_t firstByte;
     in.read(reinterpret_cast<char*>(&firstByte), sizeof(firstByte));
-    return firstByte == 0x01 && getPackType(filePath) != "";
+    return (firstByte == PACK_FORMAT_V1 || firstByte == PACK_FORMAT_V2 || firstByte == PACK_FORMAT_V3) && getPackType(filePath) != "";
 }
 
@@ -1,9 +1,11 @@
 #include "SimpleXOREncrypt.h"
+#include "CLogger.h"
 
 std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const std::string& key){
+    CStageTimer timer(Stage::Encrypt);
     // 首先检查文件是否存在
     if(!std::filesystem::exists(sourcePath)){
-        std::cerr << "Error: File " << sourcePath << " does not exist." << std::endl;
+        LOG_ERROR("Error: File " << sourcePath << " does not exist.");
         return "";
     }
 
@@ -13,14 +15,14 @@ std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const s
     // 打开文件
     std::ifstream inFile(sourcePath, std::ios::binary);
     if(!inFile.is_open()){
-        std::cerr << "Error: Failed to open file " << sourcePath << " for reading." << std::endl;
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
         return "";
     }
 
     // 打开加密文件
     std::ofstream outFile(destPath, std::ios::binary);
     if(!outFile.is_open()){
-        std::cerr << "Error: Failed to open file " << destPath << " for writing." << std::endl;
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
         return "";
     }
 
@@ -40,6 +42,7 @@ std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const s
     uint32_t crc32 = CRC32::getInitialValue();
 
     while((bytesRead = inFile.read(buffer.data(), BUFFER_SIZE).gcount())){
+        timer.addBytes(bytesRead);
         for(size_t i = 0; i < bytesRead; ++i){
             // 计算crc
             crc32 = CRC32::update(crc32, static_cast<uint8_t>(buffer[i]));
@@ -62,6 +65,7 @@ std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const s
     inFile.close();
     outFile.close();
 
+    timer.addFiles();
     return destPath;
 }
 
@@ -70,14 +74,38 @@ std::string SimpleXOREncrypt::encryptFile(const std::string& sourcePath, const s
 bool SimpleXOREncrypt::decryptFile(const std::string& sourcePath, const std::string& destPath, const std::string& key){
     // 首先检查文件是否存在
     if(!std::filesystem::exists(sourcePath)){
-        std::cerr << "Error: File " << sourcePath << " does not exist." << std::endl;
+        LOG_ERROR("Error: File " << sourcePath << " does not exist.");
         return false;
     }
 
     // 打开文件
     std::ifstream inFile(sourcePath, std::ios::binary);
     if(!inFile.is_open()){
-        std::cerr << "Error: Failed to open file " << sourcePath << " for reading." << std::endl;
+        LOG_ERROR("Error: Failed to open file " << sourcePath << " for reading.");
+        return false;
+    }
+
+    // 打开解密文件
+    std::ofstream outFile(destPath, std::ios::binary);
+    if(!outFile.is_open()){
+        LOG_ERROR("Error: Failed to open file " << destPath << " for writing.");
+        return false;
+    }
+
+    const bool ok = decryptStream(inFile, outFile, key, sourcePath);
+
+    // 关闭文件
+    inFile.close();
+    outFile.close();
+    return ok && static_cast<bool>(outFile);
+}
+
+
+// 按流解密
+bool SimpleXOREncrypt::decryptStream(std::istream& inFile, std::ostream& outFile, const std::string& key, const std::string& sourcePath){
+    CStageTimer timer(Stage::Decrypt);
+    if(key.empty()){
+        LOG_ERROR("Error: Key is required to decrypt " << sourcePath << ".");
         return false;
     }
 
@@ -85,20 +113,13 @@ bool SimpleXOREncrypt::decryptFile(const std::string& sourcePath, const std::str
     EncHead head;
     inFile.read(reinterpret_cast<char*>(&head), sizeof(EncHead));
     if(!inFile.good()){
-        std::cerr << "Error: Failed to read header from file " << sourcePath << "." << std::endl;
+        LOG_ERROR("Error: Failed to read header from file " << sourcePath << ".");
         return false;
     }
 
     // 检查是否为加密文件
     if(head.isEncrypt != 0x31 || head.encryptType != EncryptType::SimXOR){
-        std::cerr << "Error: File " << sourcePath << " is not an encrypted file." << std::endl;
-        return false;
-    }
-
-    // 打开解密文件
-    std::ofstream outFile(destPath, std::ios::binary);
-    if(!outFile.is_open()){
-        std::cerr << "Error: Failed to open file " << destPath << " for writing." << std::endl;
+        LOG_ERROR("Error: File " << sourcePath << " is not an encrypted file.");
         return false;
     }
 
@@ -109,7 +130,8 @@ bool SimpleXOREncrypt::decryptFile(const std::string& sourcePath, const std::str
     size_t bytesRead;
     uint32_t crc32 = CRC32::getInitialValue(); 
 
-    while((bytesRead = inFile.read(buffer.data(), BUFFER_SIZE).gcount()) > 0) {
+    while(outFile && (bytesRead = inFile.read(buffer.data(), BUFFER_SIZE).gcount()) > 0) {
+        timer.addBytes(bytesRead);
         // 对数据进行CRC计算
         for(size_t i = 0; i < bytesRead; ++i) {  
             // 先解密，再计算crc32
@@ -123,17 +145,18 @@ bool SimpleXOREncrypt::decryptFile(const std::string& sourcePath, const std::str
         // 写入解密后的数据
         outFile.write(buffer.data(), bytesRead);
     }
+    if(!outFile){
+        LOG_ERROR("Error: Failed to write decrypted data of " << sourcePath << ".");
+        return false;
+    }
 
     // 完成CRC计算，获取最终结果
     crc32 = CRC32::finalize(crc32);
     if(crc32 != head.crc32) {
-        std::cerr << "Error: CRC32 checksum mismatch. File may be corrupted." << std::endl;
+        LOG_ERROR("Error: CRC32 checksum mismatch. File may be corrupted.");
         return false;
     }
 
-    // 关闭文件
-    inFile.close();
-    outFile.close();
-
+    timer.addFiles();
     return true;
-}
\ No newline at end of file
+}
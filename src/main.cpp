@@ -6,6 +6,7 @@
 #include <memory>
 #include <algorithm>
 #include <cstring>
+#include <cstdint>
 
 // Windows API for file dialogs
 #ifdef _WIN32
@@ -123,16 +124,37 @@ struct BackupState {
     bool enableEncrypt = false;
     int encryptTypeIndex = 0;
     char encryptKey[256] = "";
+    bool enableParity = false;
+    int parityDataShards = 16;
+    int parityShards = 2;
     char includeRegex[256] = "";
     std::string statusMessage = "";
     bool statusIsError = false;
 };
 
+// 记录列表的缓存视图
+// 过滤结果只保存记录下标，标签在行可见时才生成并缓存，
+// 只有查询条件或记录集合的版本变化时才重新计算，避免每帧拷贝记录、拼接字符串
+struct RecordListView {
+    // 当前生效的查询（点击 Search 时更新）
+    bool isQueryMode = false;
+    int queryType = 0; // 0: 按名称, 1: 按时间
+    std::string queryName;
+    std::string queryStartTime;
+    std::string queryEndTime;
+
+    bool dirty = true;                          // 查询条件已变化，需要重新过滤
+    uint64_t revision = UINT64_MAX;             // 缓存对应的记录版本
+    std::vector<size_t> indices;                // 要显示的记录在记录器中的下标
+    std::vector<std::string> labels;            // 按记录下标缓存的标签，空串表示尚未生成
+};
+
 struct RecoverState {
-    int selectedRecordIndex = -1;
+    int selectedRecordIndex = -1; // 选中记录在记录器中的下标
     char restoreToPath[512] = "";
     char passwordInput[256] = "";
     bool showPasswordDialog = false;
+    int passwordAction = 0; // 密码确认后执行的操作：0 还原，1 校验选中记录，2 校验全部记录
     std::string statusMessage = "";
     bool statusIsError = false;
     // 查询相关字段
@@ -140,13 +162,12 @@ struct RecoverState {
     char queryNameInput[256] = "";
     char queryStartTime[64] = "";
     char queryEndTime[64] = "";
-    std::vector<BackupEntry> queryResults;
-    bool isQueryMode = false; // 是否处于查询模式
+    RecordListView view;
     std::string queryStatusMessage = "";
 };
 
 struct RecordsState {
-    int selectedRecordIndex = -1;
+    int selectedRecordIndex = -1; // 选中记录在记录器中的下标
     char repoPath[512] = "";
     bool repoPathChanged = false;
     // 查询相关字段
@@ -154,11 +175,145 @@ struct RecordsState {
     char queryNameInput[256] = "";
     char queryStartTime[64] = "";
     char queryEndTime[64] = "";
-    std::vector<BackupEntry> queryResults;
-    bool isQueryMode = false; // 是否处于查询模式
+    RecordListView view;
     std::string queryStatusMessage = "";
 };
 
+// 在记录集合或查询条件变化时重新计算过滤结果，返回记录集合是否发生了变化
+static bool refreshRecordView(RecordListView& view, const CBackupRecorder& recorder) {
+    const bool catalogChanged = view.revision != recorder.getRevision();
+    if (!catalogChanged && !view.dirty) {
+        return false;
+    }
+    const auto& records = recorder.getBackupRecords();
+    if (catalogChanged) {
+        // 记录下标可能已经变化，标签缓存整体失效
+        view.labels.assign(records.size(), std::string());
+    }
+    if (!view.isQueryMode) {
+        view.indices.resize(records.size());
+        for (size_t i = 0; i < records.size(); ++i) {
+            view.indices[i] = i;
+        }
+    } else if (view.queryType == 0) {
+        view.indices = recorder.findBackupRecordIndicesByFileName(view.queryName);
+    } else {
+        view.indices = recorder.findBackupRecordIndicesByBackupTime(view.queryStartTime, view.queryEndTime);
+    }
+    view.revision = recorder.getRevision();
+    view.dirty = false;
+    return catalogChanged;
+}
+
+// 虚拟化渲染记录列表：只为可见行生成标签、提交控件
+template <typename MakeLabel>
+static void renderRecordList(const char* id, float height, RecordListView& view, const CBackupRecorder& recorder,
+                             int& selectedIndex, MakeLabel makeLabel) {
+    if (!ImGui::BeginListBox(id, ImVec2(-1, height))) {
+        return;
+    }
+    const auto& records = recorder.getBackupRecords();
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(view.indices.size()));
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+            const size_t index = view.indices[row];
+            std::string& label = view.labels[index];
+            if (label.empty()) {
+                label = makeLabel(records[index], index);
+            }
+            // 以记录下标作为ID，避免同名同时间的记录冲突
+            ImGui::PushID(static_cast<int>(index));
+            if (ImGui::Selectable(label.c_str(), selectedIndex == static_cast<int>(index))) {
+                selectedIndex = static_cast<int>(index);
+            }
+            ImGui::PopID();
+        }
+    }
+    ImGui::EndListBox();
+}
+
+// 渲染查询区域（还原界面与记录界面共用）
+template <typename State>
+static void renderRecordSearch(State& state, CBackupRecorder& recorder) {
+    ImGui::Text("Search Records:");
+    const char* queryTypes[] = { "By Name", "By Time Range" };
+    ImGui::Combo("Query Type", &state.queryType, queryTypes, IM_ARRAYSIZE(queryTypes));
+
+    bool searched = false;
+    if (state.queryType == 0) {
+        // 按名称查询
+        ImGui::Text("File Name:");
+        ImGui::InputText("##queryName", state.queryNameInput, sizeof(state.queryNameInput));
+        ImGui::SameLine();
+        if (ImGui::Button("Search")) {
+            if (strlen(state.queryNameInput) > 0) {
+                state.view.queryName = state.queryNameInput;
+                searched = true;
+            } else {
+                state.queryStatusMessage = "Error: Please enter a file name to search";
+            }
+        }
+    } else {
+        // 按时间范围查询
+        ImGui::Text("Start Time (YYYY-MM-DD HH:MM):");
+        ImGui::InputText("##startTime", state.queryStartTime, sizeof(state.queryStartTime));
+        ImGui::Text("End Time (YYYY-MM-DD HH:MM):");
+        ImGui::InputText("##endTime", state.queryEndTime, sizeof(state.queryEndTime));
+        ImGui::SameLine();
+        if (ImGui::Button("Search")) {
+            if (strlen(state.queryStartTime) > 0 && strlen(state.queryEndTime) > 0) {
+                state.view.queryStartTime = state.queryStartTime;
+                state.view.queryEndTime = state.queryEndTime;
+                searched = true;
+            } else {
+                state.queryStatusMessage = "Error: Please enter both start time and end time";
+            }
+        }
+    }
+
+    if (searched) {
+        state.view.isQueryMode = true;
+        state.view.queryType = state.queryType;
+        state.view.dirty = true;
+        refreshRecordView(state.view, recorder);
+        state.selectedRecordIndex = -1;
+        if (state.view.indices.empty()) {
+            state.queryStatusMessage = state.queryType == 0 ?
+                "No records found matching: " + std::string(state.queryNameInput) :
+                "No records found in time range: " + std::string(state.queryStartTime) + " to " + std::string(state.queryEndTime);
+        } else {
+            state.queryStatusMessage = "Found " + std::to_string(state.view.indices.size()) + " record(s)";
+        }
+    }
+
+    // 显示查询状态消息
+    if (!state.queryStatusMessage.empty()) {
+        ImGui::Spacing();
+        if (state.queryStatusMessage.find("Error") != std::string::npos) {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
+        } else {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
+        }
+        ImGui::TextWrapped("%s", state.queryStatusMessage.c_str());
+        ImGui::PopStyleColor();
+    }
+
+    // 清除查询按钮
+    if (state.view.isQueryMode) {
+        ImGui::SameLine();
+        if (ImGui::Button("Clear Search")) {
+            state.view.isQueryMode = false;
+            state.view.dirty = true;
+            state.selectedRecordIndex = -1;
+            state.queryStatusMessage = "";
+            memset(state.queryNameInput, 0, sizeof(state.queryNameInput));
+            memset(state.queryStartTime, 0, sizeof(state.queryStartTime));
+            memset(state.queryEndTime, 0, sizeof(state.queryEndTime));
+        }
+    }
+}
+
 // 执行备份操作
 static void executeBackup(BackupState& state, CBackupRecorder& recorder) {
     if (strlen(state.sourcePath) == 0 || strlen(state.destPath) == 0) {
@@ -224,6 +379,17 @@ static void executeBackup(BackupState& state, CBackupRecorder& recorder) {
                                 .setEncryptionEnabled(true)
                       .setEncryptionKey(state.encryptKey);
             }
+
+            // 设置纠删码校验文件
+            if (state.enableParity) {
+                if (state.parityDataShards < 1 || state.parityShards < 1 ||
+                    state.parityDataShards + state.parityShards > 255) {
+                    state.statusMessage = "Error: Parity shard counts must be at least 1 and total at most 255.";
+                    state.statusIsError = true;
+                    return;
+                }
+                config->setParityShards(state.parityDataShards, state.parityShards).setParityEnabled(true);
+            }
         }
 
         // 设置文件过滤
@@ -260,27 +426,13 @@ static void executeRecover(RecoverState& state, CBackupRecorder& recorder) {
         return;
     }
 
-    BackupEntry entry;
-    if (state.isQueryMode) {
-        // 查询模式下，从查询结果中获取记录
-        if (state.selectedRecordIndex >= static_cast<int>(state.queryResults.size())) {
-            state.statusMessage = "Error: Invalid record index!";
-            state.statusIsError = true;
-            return;
-        }
-        entry = state.queryResults[state.selectedRecordIndex];
-        // 需要找到原始记录在完整列表中的索引，用于后续操作
-        // 这里直接使用 entry 对象，因为 doRecovery 只需要 BackupEntry
-    } else {
-        // 正常模式下，从完整记录列表中获取
-        auto records = recorder.getBackupRecords();
-        if (state.selectedRecordIndex >= static_cast<int>(records.size())) {
-            state.statusMessage = "Error: Invalid record index!";
-            state.statusIsError = true;
-            return;
-        }
-        entry = records[state.selectedRecordIndex];
+    // 选中下标指向记录器中的记录
+    if (!recorder.isIndexValid(static_cast<size_t>(state.selectedRecordIndex))) {
+        state.statusMessage = "Error: Invalid record index!";
+        state.statusIsError = true;
+        return;
     }
+    const BackupEntry entry = recorder.getBackupRecords()[state.selectedRecordIndex];
 
     if (strlen(state.restoreToPath) == 0) {
         state.statusMessage = "Error: Restore destination path is required!";
@@ -316,6 +468,52 @@ static void executeRecover(RecoverState& state, CBackupRecorder& recorder) {
     }
 }
 
+// 校验选中的备份或全部备份（不解出文件）
+static void executeVerify(RecoverState& state, CBackupRecorder& recorder, bool all) {
+    std::vector<BackupEntry> entries;
+    if (all) {
+        entries = recorder.getBackupRecords();
+    } else if (state.selectedRecordIndex >= 0 &&
+               recorder.isIndexValid(static_cast<size_t>(state.selectedRecordIndex))) {
+        entries.push_back(recorder.getBackupRecords()[state.selectedRecordIndex]);
+    }
+    if (entries.empty()) {
+        state.statusMessage = all ? "Error: No backup records to verify!" : "Error: Please select a backup record!";
+        state.statusIsError = true;
+        return;
+    }
+
+    try {
+        CBackup backup;
+        const std::vector<VerifyResult> results = backup.verifyBackups(entries, state.passwordInput);
+        uint64_t totalBytes = 0;
+        double seconds = 0;
+        std::string failedNames;
+        for (const auto& result : results) {
+            totalBytes += result.bytes;
+            seconds = std::max(seconds, result.seconds);
+            if (!result.ok) {
+                failedNames += (failedNames.empty() ? "" : ", ") + result.backupName;
+            }
+        }
+        if (!failedNames.empty()) {
+            state.statusMessage = "Verification failed: " + failedNames;
+            state.statusIsError = true;
+            return;
+        }
+        char summary[128];
+        snprintf(summary, sizeof(summary), "%zu backup(s) OK, %.1f MB in %.2f s", results.size(),
+                 totalBytes / (1024.0 * 1024.0), seconds);
+        state.statusMessage = std::string("Verification finished: ") + summary;
+        state.statusIsError = false;
+        state.showPasswordDialog = false;
+        memset(state.passwordInput, 0, sizeof(state.passwordInput));
+    } catch (const std::exception& e) {
+        state.statusMessage = "Error: " + std::string(e.what());
+        state.statusIsError = true;
+    }
+}
+
 // 渲染备份界面
 static void renderBackupTab(BackupState& state, CBackupRecorder& recorder) {
     ImGui::Text("Backup Configuration");
@@ -403,6 +601,18 @@ static void renderBackupTab(BackupState& state, CBackupRecorder& recorder) {
             ImGui::InputText("Encryption Key", state.encryptKey, sizeof(state.encryptKey), ImGuiInputTextFlags_Password);
             ImGui::Unindent();
         }
+
+        // 纠删码校验文件（仅在打包时可用）
+        ImGui::Checkbox("Enable Parity File", &state.enableParity);
+        if (state.enableParity) {
+            ImGui::Indent();
+            ImGui::InputInt("Data Shards", &state.parityDataShards);
+            ImGui::InputInt("Parity Shards", &state.parityShards);
+            ImGui::TextDisabled("Repairs up to %d damaged shard(s) per %d, %.1f%% extra space",
+                                state.parityShards, state.parityDataShards + state.parityShards,
+                                state.parityDataShards > 0 ? 100.0 * state.parityShards / state.parityDataShards : 0.0);
+            ImGui::Unindent();
+        }
         ImGui::Unindent();
     }
 
@@ -438,7 +648,7 @@ static void renderRecoverTab(RecoverState& state, CBackupRecorder& recorder) {
     ImGui::Text("Recovery Configuration");
     ImGui::Separator();
 
-    auto allRecords = recorder.getBackupRecords();
+    const auto& allRecords = recorder.getBackupRecords();
     
     if (allRecords.empty()) {
         ImGui::TextWrapped("No backup records found. Please create a backup first.");
@@ -446,118 +656,37 @@ static void renderRecoverTab(RecoverState& state, CBackupRecorder& recorder) {
     }
 
     // 查询区域
-    ImGui::Text("Search Records:");
-    const char* queryTypes[] = { "By Name", "By Time Range" };
-    ImGui::Combo("Query Type", &state.queryType, queryTypes, IM_ARRAYSIZE(queryTypes));
-
-    if (state.queryType == 0) {
-        // 按名称查询
-        ImGui::Text("File Name:");
-        ImGui::InputText("##queryName", state.queryNameInput, sizeof(state.queryNameInput));
-        ImGui::SameLine();
-        if (ImGui::Button("Search")) {
-            if (strlen(state.queryNameInput) > 0) {
-                state.queryResults = recorder.findBackupRecordsByFileName(state.queryNameInput);
-                state.isQueryMode = true;
-                state.selectedRecordIndex = -1;
-                if (state.queryResults.empty()) {
-                    state.queryStatusMessage = "No records found matching: " + std::string(state.queryNameInput);
-                } else {
-                    state.queryStatusMessage = "Found " + std::to_string(state.queryResults.size()) + " record(s)";
-                }
-            } else {
-                state.queryStatusMessage = "Error: Please enter a file name to search";
-            }
-        }
-    } else {
-        // 按时间范围查询
-        ImGui::Text("Start Time (YYYY-MM-DD HH:MM):");
-        ImGui::InputText("##startTime", state.queryStartTime, sizeof(state.queryStartTime));
-        ImGui::Text("End Time (YYYY-MM-DD HH:MM):");
-        ImGui::InputText("##endTime", state.queryEndTime, sizeof(state.queryEndTime));
-        ImGui::SameLine();
-        if (ImGui::Button("Search")) {
-            if (strlen(state.queryStartTime) > 0 && strlen(state.queryEndTime) > 0) {
-                state.queryResults = recorder.findBackupRecordsByBackupTime(
-                    state.queryStartTime, state.queryEndTime);
-                state.isQueryMode = true;
-                state.selectedRecordIndex = -1;
-                if (state.queryResults.empty()) {
-                    state.queryStatusMessage = "No records found in time range: " + 
-                        std::string(state.queryStartTime) + " to " + std::string(state.queryEndTime);
-                } else {
-                    state.queryStatusMessage = "Found " + std::to_string(state.queryResults.size()) + " record(s)";
-                }
-            } else {
-                state.queryStatusMessage = "Error: Please enter both start time and end time";
-            }
-        }
-    }
-
-    // 显示查询状态消息
-    if (!state.queryStatusMessage.empty()) {
-        ImGui::Spacing();
-        if (state.queryStatusMessage.find("Error") != std::string::npos) {
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
-        } else {
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
-        }
-        ImGui::TextWrapped("%s", state.queryStatusMessage.c_str());
-        ImGui::PopStyleColor();
-    }
-
-    // 清除查询按钮
-    if (state.isQueryMode) {
-        ImGui::SameLine();
-        if (ImGui::Button("Clear Search")) {
-            state.isQueryMode = false;
-            state.queryResults.clear();
-            state.selectedRecordIndex = -1;
-            state.queryStatusMessage = "";
-            memset(state.queryNameInput, 0, sizeof(state.queryNameInput));
-            memset(state.queryStartTime, 0, sizeof(state.queryStartTime));
-            memset(state.queryEndTime, 0, sizeof(state.queryEndTime));
-        }
-    }
+    renderRecordSearch(state, recorder);
 
     ImGui::Spacing();
     ImGui::Separator();
 
-    // 获取要显示的记录列表
-    std::vector<BackupEntry> displayRecords;
-    if (state.isQueryMode) {
-        displayRecords = state.queryResults;
-    } else {
-        displayRecords = allRecords;
+    // 记录集合变化后下标可能失效，清除选中状态
+    if (refreshRecordView(state.view, recorder)) {
+        state.selectedRecordIndex = -1;
     }
 
-    if (displayRecords.empty()) {
+    if (state.view.indices.empty()) {
         ImGui::TextWrapped("No backup records found.");
         return;
     }
 
     // 备份记录列表
-    std::string listTitle = state.isQueryMode ? 
-        "Search Results - Select Backup Record (" + std::to_string(displayRecords.size()) + " found):" :
-        "Select Backup Record (" + std::to_string(displayRecords.size()) + " total):";
+    std::string listTitle = state.view.isQueryMode ? 
+        "Search Results - Select Backup Record (" + std::to_string(state.view.indices.size()) + " found):" :
+        "Select Backup Record (" + std::to_string(state.view.indices.size()) + " total):";
     ImGui::Text("%s", listTitle.c_str());
-    if (ImGui::BeginListBox("##records", ImVec2(-1, 200))) {
-        for (size_t i = 0; i < displayRecords.size(); i++) {
-            const auto& record = displayRecords[i];
-            std::string label = record.fileName + " @ " + record.backupTime;
-            if (record.isPacked) label += " [Pack]";
-            if (record.isCompressed) label += " [Compress]";
-            if (record.isEncrypted) label += " [Encrypt]";
-            
-            if (ImGui::Selectable(label.c_str(), state.selectedRecordIndex == static_cast<int>(i))) {
-                state.selectedRecordIndex = static_cast<int>(i);
-            }
-        }
-        ImGui::EndListBox();
-    }
-
-    if (state.selectedRecordIndex >= 0 && state.selectedRecordIndex < static_cast<int>(displayRecords.size())) {
-        const auto& selected = displayRecords[state.selectedRecordIndex];
+    renderRecordList("##records", 200, state.view, recorder, state.selectedRecordIndex,
+                     [](const BackupEntry& record, size_t) {
+        std::string label = record.fileName + " @ " + record.backupTime;
+        if (record.isPacked) label += " [Pack]";
+        if (record.isCompressed) label += " [Compress]";
+        if (record.isEncrypted) label += " [Encrypt]";
+        return label;
+    });
+
+    if (state.selectedRecordIndex >= 0 && recorder.isIndexValid(static_cast<size_t>(state.selectedRecordIndex))) {
+        const auto& selected = allRecords[state.selectedRecordIndex];
         
         ImGui::Spacing();
         ImGui::Separator();
@@ -577,12 +706,30 @@ static void renderRecoverTab(RecoverState& state, CBackupRecorder& recorder) {
 
         ImGui::Spacing();
         if (ImGui::Button("Start Recovery", ImVec2(-1, 0))) {
+            state.passwordAction = 0;
             if (selected.isEncrypted) {
                 state.showPasswordDialog = true;
             } else {
                 executeRecover(state, recorder);
             }
         }
+        if (ImGui::Button("Verify Selected Backup", ImVec2(-1, 0))) {
+            state.passwordAction = 1;
+            if (selected.isEncrypted) {
+                state.showPasswordDialog = true;
+            } else {
+                executeVerify(state, recorder, false);
+            }
+        }
+    }
+
+    if (ImGui::Button("Verify All Backups", ImVec2(-1, 0))) {
+        state.passwordAction = 2;
+        if (std::any_of(allRecords.begin(), allRecords.end(), [](const BackupEntry& r) { return r.isEncrypted; })) {
+            state.showPasswordDialog = true;
+        } else {
+            executeVerify(state, recorder, true);
+        }
     }
 
     // 密码输入对话框
@@ -606,7 +753,11 @@ static void renderRecoverTab(RecoverState& state, CBackupRecorder& recorder) {
         ImGui::Spacing();
         if (ImGui::Button("OK", ImVec2(120, 0))) {
             if (strlen(state.passwordInput) > 0) {
-                executeRecover(state, recorder);
+                if (state.passwordAction == 0) {
+                    executeRecover(state, recorder);
+                } else {
+                    executeVerify(state, recorder, state.passwordAction == 2);
+                }
                 if (!state.statusIsError) {
                     // 成功后才关闭对话框
                     state.showPasswordDialog = false;
@@ -678,8 +829,8 @@ static void renderRecordsTab(RecordsState& state, CBackupRecorder& recorder) {
     // 刷新按钮
     if (ImGui::Button("Refresh Records")) {
         recorder.loadBackupRecordsFromFile(recorder.getRecorderFilePath());
-        state.isQueryMode = false; // 刷新时退出查询模式
-        state.queryResults.clear();
+        state.view.isQueryMode = false; // 刷新时退出查询模式
+        state.view.dirty = true;
         state.selectedRecordIndex = -1;
     }
 
@@ -687,117 +838,35 @@ static void renderRecordsTab(RecordsState& state, CBackupRecorder& recorder) {
     ImGui::Separator();
 
     // 查询区域
-    ImGui::Text("Search Records:");
-    const char* queryTypes[] = { "By Name", "By Time Range" };
-    ImGui::Combo("Query Type", &state.queryType, queryTypes, IM_ARRAYSIZE(queryTypes));
-
-    if (state.queryType == 0) {
-        // 按名称查询
-        ImGui::Text("File Name:");
-        ImGui::InputText("##queryName", state.queryNameInput, sizeof(state.queryNameInput));
-        ImGui::SameLine();
-        if (ImGui::Button("Search")) {
-            if (strlen(state.queryNameInput) > 0) {
-                state.queryResults = recorder.findBackupRecordsByFileName(state.queryNameInput);
-                state.isQueryMode = true;
-                state.selectedRecordIndex = -1;
-                if (state.queryResults.empty()) {
-                    state.queryStatusMessage = "No records found matching: " + std::string(state.queryNameInput);
-                } else {
-                    state.queryStatusMessage = "Found " + std::to_string(state.queryResults.size()) + " record(s)";
-                }
-            } else {
-                state.queryStatusMessage = "Error: Please enter a file name to search";
-            }
-        }
-    } else {
-        // 按时间范围查询
-        ImGui::Text("Start Time (YYYY-MM-DD HH:MM):");
-        ImGui::InputText("##startTime", state.queryStartTime, sizeof(state.queryStartTime));
-        ImGui::Text("End Time (YYYY-MM-DD HH:MM):");
-        ImGui::InputText("##endTime", state.queryEndTime, sizeof(state.queryEndTime));
-        ImGui::SameLine();
-        if (ImGui::Button("Search")) {
-            if (strlen(state.queryStartTime) > 0 && strlen(state.queryEndTime) > 0) {
-                state.queryResults = recorder.findBackupRecordsByBackupTime(
-                    state.queryStartTime, state.queryEndTime);
-                state.isQueryMode = true;
-                state.selectedRecordIndex = -1;
-                if (state.queryResults.empty()) {
-                    state.queryStatusMessage = "No records found in time range: " + 
-                        std::string(state.queryStartTime) + " to " + std::string(state.queryEndTime);
-                } else {
-                    state.queryStatusMessage = "Found " + std::to_string(state.queryResults.size()) + " record(s)";
-                }
-            } else {
-                state.queryStatusMessage = "Error: Please enter both start time and end time";
-            }
-        }
-    }
-
-    // 显示查询状态消息
-    if (!state.queryStatusMessage.empty()) {
-        ImGui::Spacing();
-        if (state.queryStatusMessage.find("Error") != std::string::npos) {
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.0f, 0.0f, 1.0f));
-        } else {
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.0f, 1.0f, 0.0f, 1.0f));
-        }
-        ImGui::TextWrapped("%s", state.queryStatusMessage.c_str());
-        ImGui::PopStyleColor();
-    }
-
-    // 清除查询按钮
-    if (state.isQueryMode) {
-        ImGui::SameLine();
-        if (ImGui::Button("Clear Search")) {
-            state.isQueryMode = false;
-            state.queryResults.clear();
-            state.selectedRecordIndex = -1;
-            state.queryStatusMessage = "";
-            memset(state.queryNameInput, 0, sizeof(state.queryNameInput));
-            memset(state.queryStartTime, 0, sizeof(state.queryStartTime));
-            memset(state.queryEndTime, 0, sizeof(state.queryEndTime));
-        }
-    }
+    renderRecordSearch(state, recorder);
 
     ImGui::Spacing();
     ImGui::Separator();
 
-    // 获取要显示的记录列表
-    std::vector<BackupEntry> displayRecords;
-    if (state.isQueryMode) {
-        displayRecords = state.queryResults;
-    } else {
-        displayRecords = recorder.getBackupRecords();
+    // 记录集合变化后下标可能失效，清除选中状态
+    if (refreshRecordView(state.view, recorder)) {
+        state.selectedRecordIndex = -1;
     }
 
-    if (displayRecords.empty()) {
+    if (state.view.indices.empty()) {
         ImGui::TextWrapped("No backup records found.");
         return;
     }
 
     // 记录列表
-    std::string listTitle = state.isQueryMode ? 
-        "Search Results (" + std::to_string(displayRecords.size()) + " found):" :
-        "Backup Records List (" + std::to_string(displayRecords.size()) + " total):";
+    std::string listTitle = state.view.isQueryMode ? 
+        "Search Results (" + std::to_string(state.view.indices.size()) + " found):" :
+        "Backup Records List (" + std::to_string(state.view.indices.size()) + " total):";
     ImGui::Text("%s", listTitle.c_str());
     
-    if (ImGui::BeginListBox("##recordsList", ImVec2(-1, 300))) {
-        for (size_t i = 0; i < displayRecords.size(); i++) {
-            const auto& record = displayRecords[i];
-            std::string label = "[" + std::to_string(i) + "] " + record.fileName + " @ " + record.backupTime;
-            
-            if (ImGui::Selectable(label.c_str(), state.selectedRecordIndex == static_cast<int>(i))) {
-                state.selectedRecordIndex = static_cast<int>(i);
-            }
-        }
-        ImGui::EndListBox();
-    }
+    renderRecordList("##recordsList", 300, state.view, recorder, state.selectedRecordIndex,
+                     [](const BackupEntry& record, size_t index) {
+        return "[" + std::to_string(index) + "] " + record.fileName + " @ " + record.backupTime;
+    });
 
     // 显示选中记录的详情
-    if (state.selectedRecordIndex >= 0 && state.selectedRecordIndex < static_cast<int>(displayRecords.size())) {
-        const auto& record = displayRecords[state.selectedRecordIndex];
+    if (state.selectedRecordIndex >= 0 && recorder.isIndexValid(static_cast<size_t>(state.selectedRecordIndex))) {
+        const auto& record = recorder.getBackupRecords()[state.selectedRecordIndex];
         
         ImGui::Spacing();
         ImGui::Separator();
@@ -819,30 +888,12 @@ static void renderRecordsTab(RecordsState& state, CBackupRecorder& recorder) {
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.9f, 0.3f, 0.3f, 1.0f));
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.7f, 0.1f, 0.1f, 1.0f));
         if (ImGui::Button("Delete Record", ImVec2(-1, 0))) {
-            // 找到原始记录在完整列表中的索引
-            auto allRecords = recorder.getBackupRecords();
-            size_t originalIndex = recorder.getBackupRecordIndex(record);
-            
-            if (originalIndex != std::string::npos) {
-                // 删除记录
-                if (recorder.deleteBackupRecord(originalIndex)) {
-                    // 保存到文件
-                    recorder.saveBackupRecordsToFile(recorder.getRecorderFilePath());
-                    
-                    // 如果在查询模式下，需要更新查询结果
-                    if (state.isQueryMode) {
-                        // 从查询结果中移除已删除的记录
-                        state.queryResults.erase(state.queryResults.begin() + state.selectedRecordIndex);
-                        // 如果查询结果为空，退出查询模式
-                        if (state.queryResults.empty()) {
-                            state.isQueryMode = false;
-                            state.queryStatusMessage = "";
-                        }
-                    }
-                    
-                    // 清除选中状态
-                    state.selectedRecordIndex = -1;
-                }
+            // 选中下标即记录在完整列表中的下标
+            if (recorder.deleteBackupRecord(static_cast<size_t>(state.selectedRecordIndex))) {
+                // 保存到文件
+                recorder.saveBackupRecordsToFile(recorder.getRecorderFilePath());
+                // 记录版本已变化，下一帧会按当前查询重新过滤
+                state.selectedRecordIndex = -1;
             }
         }
         ImGui::PopStyleColor(3);
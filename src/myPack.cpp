@@ -1,70 +1,969 @@
 ﻿# include "myPack.h"
+#include "CLogger.h"
+#include "CHash.h"
+#include "CCopyEngine.h"
+#include "CCodecPolicy.h"
+#include "CompressFactory.h"
+#include "CFilter.h"
+#include "CAdaptiveLevel.h"
+#include "LongRangeCompress.h"
+#include "CBlockCompress.h"
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
 
-// 定义辅助函数，用于确认文件类型
-FileType getFileType(const std::string& path){
-    if(std::filesystem::is_directory(path)){
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// 定义辅助函数，用于确认文件类型；默认不跟随符号链接
+FileType getFileType(const std::string& path, bool followSymlinks = false){
+    const std::filesystem::file_status status = followSymlinks ?
+        std::filesystem::status(path) : std::filesystem::symlink_status(path);
+    if(std::filesystem::is_symlink(status)){
+        return FileType::SymbolicLink;
+    }
+    if(std::filesystem::is_directory(status)){
         return FileType::Directory;
     }
-    else if(std::filesystem::is_regular_file(path)){
+    else if(std::filesystem::is_regular_file(status)){
         return FileType::Regular;
     }
     else{
         // 报错，说明该类型不支持，但是处理就按照普通文件处理
-        std::cerr << "Warning: File type of " << path << " is not supported, but processed as Regular file.\n";
+        LOG_WARN("Warning: File type of " << path << " is not supported, but processed as Regular file.");
         return FileType::Regular;
     }
 }
 
 
-std::string myPack::pack(const std::vector<std::string>& files, const std::string& destPath) {
+// 文件的唯一标识（设备号, inode），只对链接数大于1的文件返回true
+using FileIdentity = std::pair<uint64_t, uint64_t>;
+static bool getHardLinkIdentity(const std::string& path, FileIdentity& identity){
+#if defined(_WIN32)
+    HANDLE handle = ::CreateFileW(std::filesystem::path(path).wstring().c_str(), 0,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if(handle == INVALID_HANDLE_VALUE){
+        return false;
+    }
+    BY_HANDLE_FILE_INFORMATION info;
+    const bool ok = ::GetFileInformationByHandle(handle, &info) != 0;
+    ::CloseHandle(handle);
+    if(!ok || info.nNumberOfLinks < 2){
+        return false;
+    }
+    identity = {info.dwVolumeSerialNumber,
+                (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow};
+    return true;
+#else
+    struct stat st;
+    if(::stat(path.c_str(), &st) != 0 || st.st_nlink < 2){
+        return false;
+    }
+    identity = {static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino)};
+    return true;
+#endif
+}
+
+
+namespace {
+// 按需创建的压缩器，同一算法只创建一次
+class CodecCache {
+public:
+    // 包内共享的字典，创建 Dictionary 压缩器时注入
+    void setDictionary(std::shared_ptr<const CDictionary> dictionary){ m_dictionary = std::move(dictionary); }
+
+    ICompress* get(CompressType type){
+        auto it = m_codecs.find(type);
+        if(it != m_codecs.end()){
+            return it->second.get();
+        }
+        std::unique_ptr<ICompress> codec;
+        try{
+            codec = CompressFactory::createCompress(CompressFactory::compressTypeToString(type));
+        }catch(const std::exception& e){
+            LOG_ERROR("Error: Unsupported codec " << static_cast<int>(type) << ": " << e.what());
+        }
+        if(codec && type == CompressType::Dictionary){
+            static_cast<DictCompress*>(codec.get())->setDictionary(m_dictionary);
+        }
+        return (m_codecs[type] = std::move(codec)).get();
+    }
+private:
+    std::map<CompressType, std::unique_ptr<ICompress>> m_codecs;
+    std::shared_ptr<const CDictionary> m_dictionary;
+};
+
+// 读取文件开头最多 limit 字节作为字典训练样本
+bool readDictionarySample(const std::string& path, uint64_t limit, std::vector<char>& sample){
+    std::ifstream in(path, std::ios::binary);
+    sample.resize(static_cast<size_t>(limit));
+    in.read(sample.data(), sample.size());
+    sample.resize(static_cast<size_t>(in.gcount()));
+    return !sample.empty();
+}
+
+// 测量目标设备的写出速度。ofstream 的写入通常只拷贝到页缓存，单次写入的耗时与设备快慢无关；
+// 这里每写出 kWindow 字节就把缓冲刷新到页缓存，交给后台线程同步到设备（fdatasync / FlushFileBuffers），
+// 按同步的字节数与耗时上报给自适应级别。编码与写出不等待同步，压缩与设备 I/O 重叠进行；
+// 后台线程仍在同步时新写出的字节并入下一次同步。测量结果在写出线程上取回再上报，CAdaptiveLevel 只在写出线程上使用
+class DeviceWriteMeter {
+public:
+    static constexpr uint64_t kWindow = 4 * 1024 * 1024;
+
+    DeviceWriteMeter(std::ofstream& out, const std::string& path, CAdaptiveLevel& adaptive, CMetrics* metrics)
+        : m_out(out), m_adaptive(adaptive), m_metrics(metrics) {
+#if defined(_WIN32)
+        m_handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        const bool opened = m_handle != INVALID_HANDLE_VALUE;
+#else
+        m_fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        const bool opened = m_fd >= 0;
+#endif
+        if(!opened){
+            LOG_WARN("Warning: Cannot sync " << path << ", adaptive compression measures cached write speed only.");
+            return;
+        }
+        m_syncThread = std::thread([this]{ syncLoop(); });
+    }
+
+    ~DeviceWriteMeter(){
+        if(m_syncThread.joinable()){
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wakeup.notify_one();
+            m_syncThread.join();
+        }
+#if defined(_WIN32)
+        if(m_handle != INVALID_HANDLE_VALUE) CloseHandle(m_handle);
+#else
+        if(m_fd >= 0) ::close(m_fd);
+#endif
+    }
+
+    DeviceWriteMeter(const DeviceWriteMeter&) = delete;
+    DeviceWriteMeter& operator=(const DeviceWriteMeter&) = delete;
+
+    // 记录一次写出的 bytes 字节，攒满一个窗口后交给后台线程同步；同时上报已经完成的同步
+    void record(uint64_t bytes, std::chrono::steady_clock::time_point start){
+        m_bytes += bytes;
+        if(!m_syncThread.joinable()){
+            // 无法同步时只能按写入页缓存的耗时估计
+            m_nanos += elapsedNanos(start);
+            if(m_bytes >= kWindow){
+                m_adaptive.recordWrite(m_bytes, m_nanos);
+                m_bytes = 0;
+                m_nanos = 0;
+            }
+            return;
+        }
+        if(m_bytes < kWindow){
+            return;
+        }
+        {
+            CStageTimer writeTimer(Stage::Write, m_metrics);
+            m_out.flush();
+        }
+        uint64_t syncedBytes = 0;
+        uint64_t syncedNanos = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingBytes += m_bytes;
+            std::swap(syncedBytes, m_syncedBytes);
+            std::swap(syncedNanos, m_syncedNanos);
+        }
+        m_wakeup.notify_one();
+        m_bytes = 0;
+        if(syncedBytes > 0){
+            m_adaptive.recordWrite(syncedBytes, syncedNanos);
+        }
+    }
+
+private:
+    static uint64_t elapsedNanos(std::chrono::steady_clock::time_point start){
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // 后台线程：每次同步此前已刷新到页缓存的全部字节，并累计同步的字节数与耗时
+    void syncLoop(){
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for(;;){
+            m_wakeup.wait(lock, [this]{ return m_stop || m_pendingBytes > 0; });
+            if(m_stop){
+                return;
+            }
+            const uint64_t bytes = m_pendingBytes;
+            m_pendingBytes = 0;
+            lock.unlock();
+            const auto syncStart = std::chrono::steady_clock::now();
+            syncToDevice();
+            const uint64_t nanos = elapsedNanos(syncStart);
+            lock.lock();
+            m_syncedBytes += bytes;
+            m_syncedNanos += nanos;
+        }
+    }
+
+    // 同步整个文件的脏页；数据落盘与文件由哪个句柄写入无关
+    void syncToDevice(){
+#if defined(_WIN32)
+        FlushFileBuffers(m_handle);
+#elif defined(__linux__)
+        ::fdatasync(m_fd);
+#else
+        ::fsync(m_fd);
+#endif
+    }
+
+    std::ofstream& m_out;
+    CAdaptiveLevel& m_adaptive;
+    CMetrics* m_metrics;
+#if defined(_WIN32)
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+#else
+    int m_fd = -1;
+#endif
+    uint64_t m_bytes = 0;           // 本窗口已写出、尚未交给后台线程的字节
+    uint64_t m_nanos = 0;           // 无法同步时本窗口写入页缓存的耗时
+
+    std::thread m_syncThread;
+    std::mutex m_mutex;             // 保护以下各成员
+    std::condition_variable m_wakeup;
+    bool m_stop = false;
+    uint64_t m_pendingBytes = 0;    // 等待同步的字节
+    uint64_t m_syncedBytes = 0;     // 已同步、尚未上报的字节与耗时
+    uint64_t m_syncedNanos = 0;
+};
+
+// 写出条目内容：不压缩时直接写出；压缩时攒满一块再编码，没有变小的块原样存放。
+// 设置了过滤器链时先过滤再压缩；detect 为 true 时按条目的第一块选择过滤器，后续各块沿用。
+// LongRange 块不过滤，经条目内共用的 LongRangeStream 编码，可以引用之前各块的内容。
+// 块之间互不依赖的算法（CBlockCompress）在不逐块选择算法时攒满一批块并行编码，再按顺序写出。
+// 设置了选择策略时按条目的第一块判断内容是否值得压缩，不值得时该条目各块都原样存放
+class PayloadWriter {
+public:
+    PayloadWriter(std::ofstream& out, ICompress* codec, CMetrics* metrics,
+                  const CFilterChain& filters = CFilterChain(), bool detect = false)
+        : m_out(out), m_codec(codec), m_metrics(metrics), m_filters(filters), m_detect(detect) {}
+
+    // 自适应级别：所有写出都经 meter 向 adaptive 上报耗时；codecs 不为空时压缩条目的每一块由 adaptive 选择算法
+    void setAdaptive(CAdaptiveLevel* adaptive, DeviceWriteMeter* meter, CodecCache* codecs){
+        m_adaptive = adaptive;
+        m_meter = meter;
+        m_codecs = codecs;
+    }
+
+    // 一批同时编码的块数；只对块之间互不依赖的算法生效
+    void setParallelBlocks(size_t blocks){
+        m_batchLimit = dynamic_cast<CBlockCompress*>(m_codec) ? std::max<size_t>(blocks, 1) : 1;
+    }
+
+    // 条目原始内容的长度，用来限制长距离匹配哈希表的大小
+    void setEntrySize(uint64_t size){ m_entrySize = size; }
+
+    // 按第一块的内容判断是否压缩（魔数、字节熵），第一块来自数据区间，稀疏文件的空洞不参与判断
+    void setPolicy(const CCodecPolicy* policy){ m_policy = policy; }
+
+    // 第一块判定为不值得压缩，各块原样存放
+    bool isStoredRaw() const { return m_storeRaw; }
+
+    bool write(const char* data, size_t len){
+        if(!m_codec){
+            CStageTimer writeTimer(Stage::Write, m_metrics);
+            const auto writeStart = std::chrono::steady_clock::now();
+            m_out.write(data, len);
+            reportWrite(len, writeStart);
+            writeTimer.addBytes(len);
+            m_stored += len;
+            return static_cast<bool>(m_out);
+        }
+        while(len > 0){
+            const size_t take = std::min(len, PACK_BLOCK_SIZE - m_block.size());
+            m_block.insert(m_block.end(), data, data + take);
+            data += take;
+            len -= take;
+            if(m_block.size() == PACK_BLOCK_SIZE && !completeBlock()){
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool finish(){
+        if(!m_block.empty() && !completeBlock()){
+            return false;
+        }
+        return m_batch.empty() || flushBatch();
+    }
+
+    uint64_t getStoredLength() const { return m_stored; }
+
+private:
+    // 一块的编码结果；codec 为 None 时原样写出原始数据
+    struct EncodedBlock {
+        uint8_t codec = static_cast<uint8_t>(CompressType::None);
+        std::vector<char> header;  // 过滤器链头
+        std::vector<char> payload;
+    };
+
+    // 攒满一块：逐块编码时立即编码写出，否则放入批次，批次满了再一起编码。
+    // 自适应选择算法时每块的算法取决于之前各块的实测结果，只能逐块编码
+    bool completeBlock(){
+        if(m_policy){
+            m_storeRaw = m_policy->chooseForData(m_block.data(), m_block.size()) == CompressType::None;
+            m_policy = nullptr;
+        }
+        if(m_storeRaw){
+            const bool ok = writeBlock(m_block, EncodedBlock());
+            m_block.clear();
+            return ok;
+        }
+        if(m_batchLimit <= 1 || m_codecs){
+            return flushBlock();
+        }
+        m_batch.push_back(std::move(m_block));
+        m_block = std::vector<char>();
+        return m_batch.size() < m_batchLimit || flushBatch();
+    }
+
+    // 用互不依赖的算法编码一块，可在多个线程上同时调用
+    static void encodeIndependent(ICompress* codec, const CFilterChain& filters, const std::vector<char>& block,
+                                  EncodedBlock& out){
+        out.codec = static_cast<uint8_t>(codec->getCompressType());
+        out.header.clear();
+        const std::vector<char>* input = &block;
+        std::vector<char> filteredBlock;
+        if(!filters.empty()){
+            CStageTimer filterTimer(Stage::Compress);
+            std::vector<uint8_t> filtered;
+            filters.encode(reinterpret_cast<const uint8_t*>(block.data()), block.size(), filtered);
+            filteredBlock.assign(filtered.begin(), filtered.end());
+            filters.writeHeader(out.header);
+            out.codec |= PACK_BLOCK_FILTERED;
+            input = &filteredBlock;
+        }
+        if(!codec->compressData(*input, out.payload) || out.header.size() + out.payload.size() >= block.size()){
+            out.codec = static_cast<uint8_t>(CompressType::None);
+            out.header.clear();
+        }
+    }
+
+    bool flushBatch(){
+        if(m_detect){
+            m_filters = CFilterChain::detect(reinterpret_cast<const uint8_t*>(m_batch[0].data()), m_batch[0].size());
+            m_detect = false;
+        }
+        m_batchEncoded.resize(m_batch.size());
+        // 第一块在当前线程上编码，其余各块各占一个线程
+        std::vector<std::future<void>> workers;
+        for(size_t i = 1; i < m_batch.size(); ++i){
+            workers.push_back(std::async(std::launch::async, [this, i]{
+                CMetrics::Bind bindMetrics(m_metrics);
+                encodeIndependent(m_codec, m_filters, m_batch[i], m_batchEncoded[i]);
+            }));
+        }
+        encodeIndependent(m_codec, m_filters, m_batch[0], m_batchEncoded[0]);
+        for(auto& worker : workers){
+            worker.get();
+        }
+        bool ok = true;
+        for(size_t i = 0; i < m_batch.size() && ok; ++i){
+            ok = writeBlock(m_batch[i], m_batchEncoded[i]);
+        }
+        m_batch.clear();
+        return ok;
+    }
+
+    bool flushBlock(){
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(m_block.data());
+        if(m_detect){
+            m_filters = CFilterChain::detect(raw, m_block.size());
+            m_detect = false;
+        }
+        ICompress* codec = m_codec;
+        int level = 0;
+        const bool adaptiveBlock = m_adaptive && m_codecs;
+        if(adaptiveBlock){
+            level = m_adaptive->nextLevel();
+            codec = level > 0 ? m_codecs->get(CAdaptiveLevel::codecForLevel(level)) : nullptr;
+        }
+        const auto compressStart = adaptiveBlock ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        EncodedBlock& encoded = m_current;
+        encoded.codec = static_cast<uint8_t>(CompressType::None);
+        encoded.header.clear();
+        if(codec && codec->getCompressType() == CompressType::LongRange){
+            // 条目中第一个 LongRange 块开始记录历史；该块没有变小而原样存放时放弃，由下一个 LongRange 块重新开始
+            std::unique_ptr<LongRangeStream> started;
+            LongRangeStream* stream = m_longRange.get();
+            if(!stream){
+                started = std::make_unique<LongRangeStream>(m_position, PACK_LONG_RANGE_WINDOW, m_entrySize);
+                stream = started.get();
+            }
+            stream->encodeBlock(raw, m_block.size(), encoded.payload);
+            if(encoded.payload.size() < m_block.size()){
+                encoded.codec = static_cast<uint8_t>(CompressType::LongRange) | PACK_BLOCK_LINKED;
+                if(started) m_longRange = std::move(started);
+            }
+        }else if(codec){
+            encodeIndependent(codec, m_filters, m_block, encoded);
+        }
+        // 其他方式存放的块也计入长距离匹配的历史（LongRange 块编码时已经计入）
+        if(m_longRange && !(codec && codec->getCompressType() == CompressType::LongRange)){
+            m_longRange->append(raw, m_block.size());
+        }
+        if(adaptiveBlock){
+            const uint64_t storedLen = encoded.codec == static_cast<uint8_t>(CompressType::None) ? m_block.size() :
+                encoded.header.size() + encoded.payload.size();
+            m_adaptive->recordCompress(level, m_block.size(), storedLen, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - compressStart).count()));
+        }
+        const bool ok = writeBlock(m_block, encoded);
+        m_block.clear();
+        return ok;
+    }
+
+    // 写出一块：块头（算法、原始长度、存放长度）之后是过滤器链头与编码数据，或原始数据
+    bool writeBlock(const std::vector<char>& block, const EncodedBlock& encoded){
+        const bool stored = encoded.codec == static_cast<uint8_t>(CompressType::None);
+        const std::vector<char>& payload = stored ? block : encoded.payload;
+        const uint8_t blockCodec = encoded.codec;
+        const uint32_t rawLen = block.size();
+        const uint32_t storedLen = encoded.header.size() + payload.size();
+        CStageTimer writeTimer(Stage::Write, m_metrics);
+        const auto writeStart = std::chrono::steady_clock::now();
+        m_out.write(reinterpret_cast<const char*>(&blockCodec), sizeof(blockCodec));
+        m_out.write(reinterpret_cast<const char*>(&rawLen), sizeof(rawLen));
+        m_out.write(reinterpret_cast<const char*>(&storedLen), sizeof(storedLen));
+        m_out.write(encoded.header.data(), encoded.header.size());
+        m_out.write(payload.data(), payload.size());
+        const uint64_t blockLen = sizeof(blockCodec) + sizeof(rawLen) + sizeof(storedLen) + storedLen;
+        reportWrite(blockLen, writeStart);
+        writeTimer.addBytes(storedLen);
+        m_stored += blockLen;
+        m_position += rawLen;
+        return static_cast<bool>(m_out);
+    }
+
+    // 把一次写出的耗时计入设备写出速度的测量
+    void reportWrite(uint64_t bytes, std::chrono::steady_clock::time_point start){
+        if(m_meter){
+            m_meter->record(bytes, start);
+        }
+    }
+
+    std::ofstream& m_out;
+    ICompress* m_codec;
+    CMetrics* m_metrics;
+    CFilterChain m_filters;
+    bool m_detect;
+    std::vector<char> m_block;
+    EncodedBlock m_current;
+    size_t m_batchLimit = 1;                  // 一批同时编码的块数，1 表示逐块编码
+    std::vector<std::vector<char>> m_batch;
+    std::vector<EncodedBlock> m_batchEncoded;
+    CAdaptiveLevel* m_adaptive = nullptr;
+    DeviceWriteMeter* m_meter = nullptr;
+    CodecCache* m_codecs = nullptr;
+    const CCodecPolicy* m_policy = nullptr;
+    bool m_storeRaw = false;
+    std::unique_ptr<LongRangeStream> m_longRange;
+    uint64_t m_entrySize = 0;
+    uint64_t m_position = 0;  // 本块在条目原始内容中的偏移
+    uint64_t m_stored = 0;
+};
+
+// 读取条目内容：未压缩时直接读取包，压缩时逐块解码。只顺序读取，包可以来自不可定位的流
+class PayloadReader {
+public:
+    PayloadReader(std::istream& in, bool blocked, CodecCache& codecs)
+        : m_in(in), m_blocked(blocked), m_codecs(codecs) {}
+
+    // 读取最多 len 字节，返回实际读取的字节数；0 表示数据不足或已损坏
+    size_t read(char* dest, size_t len){
+        if(!m_blocked){
+            m_in.read(dest, len);
+            m_consumed += static_cast<uint64_t>(m_in.gcount());
+            return static_cast<size_t>(m_in.gcount());
+        }
+        if(m_pos == m_block.size() && !nextBlock()){
+            return 0;
+        }
+        const size_t n = std::min(len, m_block.size() - m_pos);
+        std::memcpy(dest, m_block.data() + m_pos, n);
+        m_pos += n;
+        return n;
+    }
+
+    // 已从包中读取的字节数（含块头）
+    uint64_t getConsumed() const { return m_consumed; }
+
+private:
+    bool nextBlock(){
+        uint8_t blockCodec = 0;
+        uint32_t rawLen = 0;
+        uint32_t storedLen = 0;
+        m_in.read(reinterpret_cast<char*>(&blockCodec), sizeof(blockCodec));
+        m_in.read(reinterpret_cast<char*>(&rawLen), sizeof(rawLen));
+        m_in.read(reinterpret_cast<char*>(&storedLen), sizeof(storedLen));
+        if(!m_in || rawLen == 0 || rawLen > PACK_BLOCK_SIZE || storedLen > 2 * PACK_BLOCK_SIZE){
+            return false;
+        }
+        m_encoded.resize(storedLen);
+        m_in.read(m_encoded.data(), storedLen);
+        m_consumed += sizeof(blockCodec) + sizeof(rawLen) + sizeof(storedLen) + static_cast<uint64_t>(m_in.gcount());
+        if(static_cast<uint32_t>(m_in.gcount()) != storedLen){
+            return false;
+        }
+        // 过滤过的块：数据以过滤器链头开始，解压后再逆变换
+        CFilterChain filters;
+        if(blockCodec & PACK_BLOCK_FILTERED){
+            size_t consumed = 0;
+            if(!CFilterChain::readHeader(reinterpret_cast<const uint8_t*>(m_encoded.data()), m_encoded.size(),
+                                         filters, consumed)){
+                return false;
+            }
+            m_encoded.erase(m_encoded.begin(), m_encoded.begin() + consumed);
+            blockCodec &= ~PACK_BLOCK_FILTERED;
+        }
+        // 引用之前各块的 LongRange 块：条目中第一个这样的块开始记录历史，之后的每一块都要计入
+        if(blockCodec & PACK_BLOCK_LINKED){
+            if(blockCodec != (static_cast<uint8_t>(CompressType::LongRange) | PACK_BLOCK_LINKED) || !filters.empty()){
+                return false;
+            }
+            if(!m_longRange){
+                m_longRange = std::make_unique<LongRangeStream>(m_position, PACK_LONG_RANGE_WINDOW);
+            }
+            if(!m_longRange->decodeBlock(m_encoded.data(), m_encoded.size(), m_block) || m_block.size() != rawLen){
+                return false;
+            }
+            m_position += rawLen;
+            m_pos = 0;
+            return true;
+        }
+        if(blockCodec == static_cast<uint8_t>(CompressType::None)){
+            m_block.swap(m_encoded);
+        }else{
+            ICompress* codec = m_codecs.get(static_cast<CompressType>(blockCodec));
+            if(!codec || !codec->decompressData(m_encoded, m_block)){
+                return false;
+            }
+        }
+        if(!filters.empty()){
+            m_filtered.clear();
+            if(!filters.decode(reinterpret_cast<const uint8_t*>(m_block.data()), m_block.size(), m_filtered)){
+                return false;
+            }
+            m_block.assign(m_filtered.begin(), m_filtered.end());
+        }
+        if(m_block.size() != rawLen){
+            return false;
+        }
+        if(m_longRange){
+            m_longRange->append(reinterpret_cast<const uint8_t*>(m_block.data()), m_block.size());
+        }
+        m_position += rawLen;
+        m_pos = 0;
+        return true;
+    }
+
+    std::istream& m_in;
+    bool m_blocked;
+    CodecCache& m_codecs;
+    std::vector<char> m_block;
+    std::vector<char> m_encoded;
+    std::vector<uint8_t> m_filtered;
+    std::unique_ptr<LongRangeStream> m_longRange;
+    uint64_t m_position = 0;  // 下一块在条目原始内容中的偏移
+    size_t m_pos = 0;
+    uint64_t m_consumed = 0;
+};
+
+// 包头与元数据区
+struct PackIndex {
+    uint8_t version = 0;
+    uint32_t contentStart = 0;
+    std::shared_ptr<const CDictionary> dictionary;
     std::vector<FileMeta> metas;
-    // 包头长度 = 是否打包（1字节） + 算法类型(1字节) + 文件数量(4字节) + 内容区起始位置(4字节)
-    size_t headerLen = 1 + 1 + 4 + 4;
+};
+
+// 顺序读取包头与元数据区；读完后流位于内容区起始处（元数据区紧接包头）
+bool readPackIndex(std::istream& in, const std::string& srcPath, PackIndex& index){
+    // 检查是否是打包文件
+    in.read(reinterpret_cast<char*>(&index.version), sizeof(index.version));
+    if(!in || (index.version != PACK_FORMAT_V1 && index.version != PACK_FORMAT_V2 && index.version != PACK_FORMAT_V3)){
+        // 不是打包文件，返回错误信息
+        LOG_ERROR("Error: File " << srcPath << " is not packed.");
+        return false;
+    }
 
+    // 读取包头
+    // 读取打包算法类型(1字节)
+    PackType type;
+    in.read(reinterpret_cast<char*>(&type), sizeof(type));
+    if(type != PackType::Basic){
+        // 匹配失败，返回错误信息
+        LOG_ERROR("Error: Packing algorithm type in " << srcPath << " is not Basic.");
+        return false;
+    }
+
+    // 读取文件数量（4字节）
+    uint32_t fileCount = 0;
+    in.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
+
+    // 读取头信息长度（4字节）
+    in.read(reinterpret_cast<char*>(&index.contentStart), sizeof(index.contentStart));
+    // 每个条目的元信息至少 21 字节
+    if(!in || fileCount > index.contentStart / 21){
+        LOG_ERROR("Error: Corrupted header in " << srcPath << ".");
+        return false;
+    }
+    index.metas.resize(fileCount);
+
+    // v3：读取共享字典
+    if(index.version >= PACK_FORMAT_V3){
+        uint32_t dictionaryLen = 0;
+        in.read(reinterpret_cast<char*>(&dictionaryLen), sizeof(dictionaryLen));
+        std::vector<char> dictionaryBytes(in && dictionaryLen <= index.contentStart ? dictionaryLen : 0);
+        in.read(dictionaryBytes.data(), dictionaryBytes.size());
+        if(in && dictionaryBytes.size() == dictionaryLen){
+            index.dictionary = CDictionary::deserialize(dictionaryBytes.data(), dictionaryBytes.size());
+        }
+        if(!index.dictionary){
+            LOG_ERROR("Error: Corrupted dictionary in " << srcPath << ".");
+            return false;
+        }
+    }
+
+    // 读取文件元信息
+    for(auto& meta : index.metas){
+        in.read(reinterpret_cast<char*>(&meta.nameLen), sizeof(meta.nameLen));
+        if(!in || meta.nameLen > index.contentStart){
+            LOG_ERROR("Error: Corrupted metadata in " << srcPath << ".");
+            return false;
+        }
+        meta.name.resize(meta.nameLen);
+        in.read(&meta.name[0], meta.nameLen);
+        in.read(reinterpret_cast<char*>(&meta.size), sizeof(meta.size));
+        in.read(reinterpret_cast<char*>(&meta.offset), sizeof(meta.offset));
+        in.read(reinterpret_cast<char*>(&meta.type), sizeof(meta.type));
+        if(index.version < PACK_FORMAT_V2){
+            continue;
+        }
+        in.read(reinterpret_cast<char*>(&meta.flags), sizeof(meta.flags));
+        if(meta.flags & META_FLAG_SPARSE){
+            uint32_t extentCount = 0;
+            in.read(reinterpret_cast<char*>(&extentCount), sizeof(extentCount));
+            if(!in || extentCount > index.contentStart / 16){
+                LOG_ERROR("Error: Corrupted extent map for " << meta.name << " in " << srcPath << ".");
+                return false;
+            }
+            meta.extents.resize(extentCount);
+            for(auto& extent : meta.extents){
+                in.read(reinterpret_cast<char*>(&extent.offset), sizeof(extent.offset));
+                in.read(reinterpret_cast<char*>(&extent.length), sizeof(extent.length));
+            }
+        }
+        if(meta.hasLinkTarget()){
+            uint32_t targetLen = 0;
+            in.read(reinterpret_cast<char*>(&targetLen), sizeof(targetLen));
+            if(!in || targetLen > index.contentStart){
+                LOG_ERROR("Error: Corrupted link target for " << meta.name << " in " << srcPath << ".");
+                return false;
+            }
+            meta.linkTarget.resize(targetLen);
+            in.read(&meta.linkTarget[0], targetLen);
+        }
+        if(meta.flags & META_FLAG_COMPRESSED){
+            in.read(reinterpret_cast<char*>(&meta.codec), sizeof(meta.codec));
+            in.read(reinterpret_cast<char*>(&meta.storedLength), sizeof(meta.storedLength));
+        }
+        if(meta.flags & META_FLAG_CHECKSUM){
+            in.read(reinterpret_cast<char*>(&meta.contentHash.low), sizeof(meta.contentHash.low));
+            in.read(reinterpret_cast<char*>(&meta.contentHash.high), sizeof(meta.contentHash.high));
+        }
+    }
+    if(!in){
+        LOG_ERROR("Error: Corrupted metadata in " << srcPath << ".");
+        return false;
+    }
+    return true;
+}
+}
+
+
+// 计算条目在包内的名字：前缀 + 相对源根的路径
+static std::string makeEntryName(const std::string& file, const PackSource& source){
+    // 计算相对于根目录的路径
+    std::string relativePath = file;
+    if (!source.rootPath.empty()) {
+        try {
+            // 按字面计算，不解析路径中的符号链接（否则链接条目会得到其目标的名字）
+            const std::filesystem::path filePath = std::filesystem::absolute(file).lexically_normal();
+            const std::filesystem::path rootPath = std::filesystem::absolute(source.rootPath).lexically_normal();
+            relativePath = filePath.lexically_relative(rootPath).string();
+            // 对于根目录本身，使用空字符串或"."表示当前目录
+            if (relativePath.empty() || relativePath == "..") {
+                relativePath = ".";
+            }
+        } catch (...) {
+            // 如果无法计算相对路径，使用原始路径
+            relativePath = file;
+        }
+    }
+    if (source.prefix.empty()) {
+        return relativePath;
+    }
+    // 有前缀时，源根本身就存放为前缀目录/文件
+    if (relativePath == ".") {
+        return source.prefix;
+    }
+    return (std::filesystem::path(source.prefix) / relativePath).string();
+}
+
+// 条目名与硬链接目标只能是包内的相对路径：不能是绝对路径，也不能含有 ".."
+static bool isSafeEntryPath(const std::string& name){
+    const std::filesystem::path path(name);
+    if(path.has_root_name() || path.has_root_directory()){
+        return false;
+    }
+    return std::none_of(path.begin(), path.end(), [](const std::filesystem::path& part){ return part == ".."; });
+}
+
+// 条目在 destDir 之下的某一级父目录是否为符号链接，是时写入该条目会落到 destDir 之外
+static bool hasSymlinkParent(const std::filesystem::path& destDir, const std::string& name){
+    std::filesystem::path current = destDir;
+    std::error_code ec;
+    for(const auto& part : std::filesystem::path(name).parent_path()){
+        current /= part;
+        if(std::filesystem::is_symlink(current, ec)){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+std::string myPack::pack(const std::vector<std::string>& files, const std::string& destPath) {
     // 尝试从文件列表中确定根目录
-    std::string rootPath = "";
+    PackSource source;
     if (!files.empty()) {
-        rootPath = std::filesystem::path(files[0]).parent_path().string();
+        source.rootPath = std::filesystem::path(files[0]).parent_path().string();
     }
+    source.files = files;
+    return pack(std::vector<PackSource>{source}, destPath);
+}
+
+
+std::string myPack::pack(const std::vector<PackSource>& sources, const std::string& destPath) {
+    CMetrics* metrics = CMetrics::current();
+    CStageTimer packTimer(Stage::Pack, metrics);
+    std::vector<FileMeta> metas;
+    std::vector<std::string> fullPaths;  // 与 metas 一一对应的源文件完整路径
+    // 包头长度 = 是否打包（1字节） + 算法类型(1字节) + 文件数量(4字节) + 内容区起始位置(4字节)
+    size_t headerLen = 1 + 1 + 4 + 4;
 
     // 元数据区长度
     size_t metaLen = 0;
     // 记录当前偏移量，初始为内容区起始位置s
     uint64_t currentOffset = 0;
-    for(const auto& file : files){
-        // 计算相对于根目录的路径
-        std::string relativePath = file;
-        if (!rootPath.empty()) {
-            try {
-                relativePath = std::filesystem::relative(std::filesystem::path(file), std::filesystem::path(rootPath)).string();
-                // 对于根目录本身，使用空字符串或"."表示当前目录
-                if (relativePath.empty() || relativePath == "..") {
-                    relativePath = ".";
-                }
-            } catch (...) {
-                // 如果无法计算相对路径，使用原始路径
-                relativePath = file;
-            }
-        }
-
-        metaLen += 4; // 文件名长度
-        metaLen += relativePath.size(); // 文件名内容
-        metaLen += 8; // 文件大小
-        metaLen += 8; // 文件偏移量
-        metaLen += 1; // 文件类型
-
-        // 记录文件类型
-        FileType type = getFileType(file);
-        // 判断文件大小，目录文件大小为0
-        uint64_t size = (type == FileType::Regular) ? 
-                        (std::filesystem::exists(file) ? std::filesystem::file_size(file) : 0) : 0;
-        // 记录文件名长度
-        uint32_t nameLen = relativePath.size();
-        // 记录文件类型
-        metas.push_back({nameLen, relativePath, size, currentOffset, type});
-        currentOffset += size;
+    size_t fileTotal = 0;
+    // 已经存放过内容的硬链接文件：(设备号, inode) -> 包内条目名
+    std::map<FileIdentity, std::string> hardLinks;
+    for(const auto& source : sources){
+        fileTotal += source.files.size();
+        for(const auto& file : source.files){
+            const std::string relativePath = makeEntryName(file, source);
+
+            metaLen += 4; // 文件名长度
+            metaLen += relativePath.size(); // 文件名内容
+            metaLen += 8; // 文件大小
+            metaLen += 8; // 文件偏移量
+            metaLen += 1; // 文件类型
+            metaLen += 2; // 标志位
+
+            // 记录文件类型（源根本身是链接时跟随它，备份其指向的内容）
+            FileType type = getFileType(file, m_followSymlinks || file == source.rootPath);
+            // 判断文件大小，目录文件大小为0
+            uint64_t size = (type == FileType::Regular) ? 
+                            (std::filesystem::exists(file) ? std::filesystem::file_size(file) : 0) : 0;
+            // 记录文件名长度
+            uint32_t nameLen = relativePath.size();
+            // 记录文件类型（偏移量在去重之后统一分配）
+            FileMeta meta{nameLen, relativePath, size, 0, type};
+            FileIdentity identity;
+            if(type == FileType::SymbolicLink){
+                // 符号链接只记录目标，不读取其指向的内容
+                std::error_code ec;
+                meta.linkTarget = std::filesystem::read_symlink(file, ec).string();
+                if(ec){
+                    LOG_WARN("Warning: Failed to read symbolic link " << file << ": " << ec.message());
+                }
+            }
+            else if(type == FileType::Regular && getHardLinkIdentity(file, identity)){
+                // 同一文件的其他硬链接已经存放过内容时，只引用该条目
+                auto inserted = hardLinks.emplace(identity, relativePath);
+                if(!inserted.second){
+                    meta.flags |= META_FLAG_HARDLINK;
+                    meta.linkTarget = inserted.first->second;
+                }
+            }
+            if(meta.hasLinkTarget()){
+                metaLen += 4 + meta.linkTarget.size(); // 目标长度 + 目标
+            }
+            // 含空洞的文件只存放数据区间
+            else if(type == FileType::Regular && size > 0){
+                std::vector<FileExtent> extents = CSparseFile::mapDataExtents(file, size);
+                if(!CSparseFile::isDense(extents, size)){
+                    meta.flags |= META_FLAG_SPARSE;
+                    meta.extents = std::move(extents);
+                    metaLen += 4 + meta.extents.size() * 16; // 区间数 + 区间表
+                }
+            }
+            metas.push_back(std::move(meta));
+            fullPaths.push_back(file);
+        }
+    }
+
+    // 内容相同的文件共用第一份内容（偏移量在写出内容时分配）
+    const std::vector<size_t> duplicateOf = m_deduplicate ?
+        findDuplicates(metas, fullPaths, metrics) : std::vector<size_t>(metas.size(), SIZE_MAX);
+    size_t duplicateCount = 0;
+    for(size_t i = 0; i < metas.size(); ++i){
+        if(duplicateOf[i] != SIZE_MAX){
+            metas[i].flags |= META_FLAG_DUPLICATE;
+            ++duplicateCount;
+        }
+    }
+    if(duplicateCount > 0){
+        LOG_INFO("Deduplicated " << duplicateCount << " file(s) with identical content.");
+    }
+    // 有内容的普通文件记录内容哈希，重复条目沿用第一份的哈希
+    for(auto& meta : metas){
+        if(meta.type == FileType::Regular && !meta.hasLinkTarget() && meta.payloadSize() > 0){
+            meta.flags |= META_FLAG_CHECKSUM;
+            metaLen += 16; // 内容哈希
+        }
+    }
+
+    // 按条目选择压缩算法：已经压缩过的数据原样存放，重复条目沿用第一份的选择
+    CompressType preferred = CompressType::None;
+    if(!m_entryCompressType.empty()){
+        try{
+            preferred = CompressFactory::stringToCompressType(m_entryCompressType);
+        }catch(const std::exception& e){
+            LOG_ERROR("Error: " << e.what());
+            return "";
+        }
+    }
+    const CCodecPolicy policy(preferred);
+    // 压缩前的过滤器链："auto" 表示按各条目的内容选择
+    const bool detectFilters = m_entryFilters == "auto";
+    CFilterChain filters;
+    if(!detectFilters && !CFilterChain::parse(m_entryFilters, filters)){
+        LOG_ERROR("Error: Invalid filter chain: " << m_entryFilters);
+        return "";
+    }
+    // 使用字典时，小文件（首选算法为 Dictionary 时为全部文件）改用字典压缩，其余条目使用 dictionaryFallback
+    const bool useDictionary = preferred == CompressType::Dictionary || (m_useDictionary && preferred != CompressType::None);
+    const CompressType dictionaryFallback = (preferred == CompressType::Dictionary) ? CompressType::Huffman4X : preferred;
+    std::vector<size_t> dictionaryEntries;
+    size_t compressedCount = 0;
+    size_t storedRawCount = 0;
+    for(size_t i = 0; preferred != CompressType::None && i < metas.size(); ++i){
+        FileMeta& meta = metas[i];
+        if(meta.type != FileType::Regular || meta.hasLinkTarget() || meta.payloadSize() == 0){
+            continue;
+        }
+        CompressType codec = CompressType::None;
+        if(duplicateOf[i] != SIZE_MAX){
+            codec = metas[duplicateOf[i]].codec;
+        }else{
+            // 这里只按大小与扩展名初选，内容在写出时按第一块判断，不为抽样单独读取文件
+            codec = policy.preselect(fullPaths[i], meta.payloadSize());
+            if(codec != CompressType::None && useDictionary){
+                // 稀疏文件只存放数据区间，不参与
+                const bool small = !(meta.flags & META_FLAG_SPARSE) &&
+                    (preferred == CompressType::Dictionary || meta.payloadSize() <= PACK_DICT_FILE_LIMIT);
+                codec = small ? CompressType::Dictionary : dictionaryFallback;
+                if(small) dictionaryEntries.push_back(i);
+            }
+        }
+        if(codec == CompressType::None){
+            ++storedRawCount;
+            continue;
+        }
+        meta.flags |= META_FLAG_COMPRESSED;
+        meta.codec = codec;
+        metaLen += 1 + 8; // 压缩算法 + 存放长度
+        ++compressedCount;
+    }
+
+    // 从小文件中抽样训练字典，字典在包内只存放一份；小文件太少或训练失败时改用 dictionaryFallback
+    std::shared_ptr<const CDictionary> dictionary;
+    if(!dictionaryEntries.empty() &&
+       (preferred == CompressType::Dictionary || dictionaryEntries.size() >= PACK_DICT_MIN_SAMPLES)){
+        CStageTimer trainTimer(Stage::Compress, metrics);
+        uint64_t candidateBytes = 0;
+        for(size_t i : dictionaryEntries){
+            candidateBytes += std::min(metas[i].payloadSize(), PACK_DICT_FILE_LIMIT);
+        }
+        // 样本总量超出预算时按间隔抽取
+        const size_t stride = static_cast<size_t>(candidateBytes / PACK_DICT_SAMPLE_BUDGET + 1);
+        std::vector<std::vector<char>> samples;
+        size_t sampleBytes = 0;
+        for(size_t k = 0; k < dictionaryEntries.size(); k += stride){
+            const size_t i = dictionaryEntries[k];
+            if(m_rateLimiter){
+                m_rateLimiter->acquire(static_cast<size_t>(std::min(metas[i].payloadSize(), PACK_DICT_FILE_LIMIT)));
+            }
+            std::vector<char> sample;
+            if(readDictionarySample(fullPaths[i], PACK_DICT_FILE_LIMIT, sample)){
+                sampleBytes += sample.size();
+                samples.push_back(std::move(sample));
+            }
+        }
+        trainTimer.addBytes(sampleBytes);
+        dictionary = CDictionary::train(samples, std::min(CDictionary::kDefaultMaxSize, sampleBytes / 4));
+        if(dictionary){
+            LOG_INFO("Trained a " << dictionary->getContent().size() << "-byte dictionary from " << samples.size()
+                     << " sample(s) for " << dictionaryEntries.size() << " small file(s).");
+        }
+    }
+    if(!dictionary){
+        for(auto& meta : metas){
+            if(meta.codec == CompressType::Dictionary) meta.codec = dictionaryFallback;
+        }
+    }
+    std::vector<char> dictionaryBytes;
+    if(dictionary){
+        dictionary->serialize(dictionaryBytes);
+        headerLen += 4 + dictionaryBytes.size(); // 字典长度 + 字典
     }
+
     uint32_t contentStart = headerLen + metaLen;
+    packTimer.addFiles(metas.size());
 
 
     const std::string baseName = "backup_" + std::to_string(time(nullptr)) + "." + getPackTypeName();
@@ -73,11 +972,11 @@ std::string myPack::pack(const std::vector<std::string>& files, const std::strin
     // 接下来写入包头（包括打包算法，当前包包含的文件数量，文件的元信息）
     std::ofstream out(destPackBase, std::ios::binary);
     if(!out){
-        std::cerr << "Error: Failed to open file " << destPackBase << " for writing.\n";
+        LOG_ERROR("Error: Failed to open file " << destPackBase << " for writing.");
         return "";
     }
-    // 写入是否打包（1字节）
-    uint8_t isPacked = 1;
+    // 写入是否打包（1字节），同时表示格式版本
+    uint8_t isPacked = dictionary ? PACK_FORMAT_V3 : PACK_FORMAT_V2;
     out.write(reinterpret_cast<const char*>(&isPacked), sizeof(isPacked));
 
     // 写入打包算法（1字节）
@@ -91,88 +990,278 @@ std::string myPack::pack(const std::vector<std::string>& files, const std::strin
     // 写入头信息长度（4字节）
     out.write(reinterpret_cast<const char*>(&contentStart), sizeof(contentStart));
 
+    // v3：写入共享字典
+    if(dictionary){
+        uint32_t dictionaryLen = dictionaryBytes.size();
+        out.write(reinterpret_cast<const char*>(&dictionaryLen), sizeof(dictionaryLen));
+        out.write(dictionaryBytes.data(), dictionaryLen);
+    }
+
+    // 压缩后的长度要写完内容才知道：先写内容，再回到元数据区写入文件元信息
+    out.seekp(contentStart, std::ios::beg);
+    CodecCache codecs;
+    codecs.setDictionary(dictionary);
+    // 自适应级别：按实测的压缩与写出速度为压缩条目的每一块选择算法
+    CAdaptiveLevel adaptive(CAdaptiveLevel::maxLevelForConfig(m_compressionLevel));
+    const bool useAdaptive = m_adaptiveCompression && preferred != CompressType::None;
+    std::unique_ptr<DeviceWriteMeter> writeMeter;
+    const size_t parallelBlocks = m_threadCount ? m_threadCount : std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+    if(useAdaptive){
+        writeMeter = std::make_unique<DeviceWriteMeter>(out, destPackBase, adaptive, metrics);
+    }
+    for(size_t i = 0; i < metas.size(); ++i){
+        FileMeta& meta = metas[i];
+        if(meta.flags & META_FLAG_DUPLICATE){
+            meta.offset = metas[duplicateOf[i]].offset;
+            meta.storedLength = metas[duplicateOf[i]].storedLength;
+            meta.contentHash = metas[duplicateOf[i]].contentHash;
+            continue;
+        }
+        meta.offset = currentOffset;
+        // 只写入普通文件的内容，硬链接的内容已经随第一个链接写入
+        if(meta.type != FileType::Regular || meta.hasLinkTarget() || meta.payloadSize() == 0) continue;
+
+        CFileLatencyTimer fileTimer(metrics);
+        std::filesystem::path fullFilePath = fullPaths[i];
+        std::ifstream in(fullFilePath, std::ios::binary);
+        if(!in){
+            LOG_ERROR("Error: Failed to open file " << fullFilePath.string() << " for reading.");
+            return "";
+        }
+        ICompress* codec = nullptr;
+        if(meta.flags & META_FLAG_COMPRESSED){
+            codec = codecs.get(meta.codec);
+            if(!codec){
+                return "";
+            }
+        }
+        // 字典压缩的小文件依赖与字典相同的原始字节，不过滤
+        const bool filtered = codec && meta.codec != CompressType::Dictionary;
+        PayloadWriter writer(out, codec, metrics, filtered ? filters : CFilterChain(), filtered && detectFilters);
+        writer.setEntrySize(meta.payloadSize());
+        writer.setParallelBlocks(parallelBlocks);
+        if(codec){
+            writer.setPolicy(&policy);
+        }
+        // 字典压缩的小文件保持字典算法，但它们和不压缩的条目一样上报写出速度
+        if(useAdaptive){
+            writer.setAdaptive(&adaptive, writeMeter.get(), filtered ? &codecs : nullptr);
+        }
+        // 分块读取，避免大文件一次性占用内存，同时便于限速
+        const size_t MAX_BUFFER_SIZE = 1024 * 1024; // 1MB
+        std::vector<char> buffer(std::min<uint64_t>(MAX_BUFFER_SIZE, meta.payloadSize()));
+        // 普通文件整体作为一个区间，稀疏文件跳过空洞只读取数据区间
+        const std::vector<FileExtent> extents = (meta.flags & META_FLAG_SPARSE) ?
+            meta.extents : std::vector<FileExtent>{{0, meta.size}};
+        CXXHash128 contentHash;
+        for(const auto& extent : extents){
+            in.seekg(extent.offset, std::ios::beg);
+            uint64_t remainingSize = extent.length;
+            while(remainingSize > 0){
+                const size_t toRead = static_cast<size_t>(std::min<uint64_t>(buffer.size(), remainingSize));
+                if(m_rateLimiter){
+                    m_rateLimiter->acquire(toRead);
+                }
+                size_t bytesRead = 0;
+                {
+                    CStageTimer readTimer(Stage::Read, metrics);
+                    in.read(buffer.data(), toRead);
+                    bytesRead = static_cast<size_t>(in.gcount());
+                    readTimer.addBytes(bytesRead);
+                }
+                if(bytesRead == 0){
+                    LOG_ERROR("Error: Unexpected end of file while reading " << fullFilePath.string() << ".");
+                    return "";
+                }
+                contentHash.update(buffer.data(), bytesRead);
+                if(!writer.write(buffer.data(), bytesRead)){
+                    LOG_ERROR("Error: Failed to write file " << destPackBase << ".");
+                    return "";
+                }
+                remainingSize -= bytesRead;
+            }
+        }
+        if(!writer.finish()){
+            LOG_ERROR("Error: Failed to write file " << destPackBase << ".");
+            return "";
+        }
+        if(writer.isStoredRaw()){
+            --compressedCount;
+            ++storedRawCount;
+        }
+        meta.storedLength = writer.getStoredLength();
+        meta.contentHash = contentHash.digest();
+        currentOffset += meta.storedLength;
+        if(metrics){
+            metrics->addFiles(Stage::Read);
+            if(codec) metrics->addFiles(Stage::Compress);
+        }
+    }
+    packTimer.addBytes(currentOffset);
+    if(preferred != CompressType::None){
+        LOG_INFO("Compressing " << compressedCount << " file(s) with " << m_entryCompressType << ", storing "
+                 << storedRawCount << " incompressible file(s) as-is.");
+    }
+    if(useAdaptive){
+        const auto& counts = adaptive.getBlockCounts();
+        std::string summary;
+        for(int level = 0; level <= adaptive.getMaxLevel(); ++level){
+            summary += " " + (level == 0 ? std::string("None") :
+                CompressFactory::compressTypeToString(CAdaptiveLevel::codecForLevel(level))) + "=" + std::to_string(counts[level]);
+        }
+        LOG_INFO("Adaptive compression blocks:" << summary);
+    }
+
     // 写入文件元信息
+    out.seekp(headerLen, std::ios::beg);
     for(const auto& meta : metas){
         out.write(reinterpret_cast<const char*>(&meta.nameLen), sizeof(meta.nameLen));
         out.write(meta.name.c_str(), meta.nameLen);
         out.write(reinterpret_cast<const char*>(&meta.size), sizeof(meta.size));
         out.write(reinterpret_cast<const char*>(&meta.offset), sizeof(meta.offset));
         out.write(reinterpret_cast<const char*>(&meta.type), sizeof(meta.type)); 
+        out.write(reinterpret_cast<const char*>(&meta.flags), sizeof(meta.flags));
+        if(meta.flags & META_FLAG_SPARSE){
+            uint32_t extentCount = meta.extents.size();
+            out.write(reinterpret_cast<const char*>(&extentCount), sizeof(extentCount));
+            for(const auto& extent : meta.extents){
+                out.write(reinterpret_cast<const char*>(&extent.offset), sizeof(extent.offset));
+                out.write(reinterpret_cast<const char*>(&extent.length), sizeof(extent.length));
+            }
+        }
+        if(meta.hasLinkTarget()){
+            uint32_t targetLen = meta.linkTarget.size();
+            out.write(reinterpret_cast<const char*>(&targetLen), sizeof(targetLen));
+            out.write(meta.linkTarget.data(), targetLen);
+        }
+        if(meta.flags & META_FLAG_COMPRESSED){
+            out.write(reinterpret_cast<const char*>(&meta.codec), sizeof(meta.codec));
+            out.write(reinterpret_cast<const char*>(&meta.storedLength), sizeof(meta.storedLength));
+        }
+        if(meta.flags & META_FLAG_CHECKSUM){
+            out.write(reinterpret_cast<const char*>(&meta.contentHash.low), sizeof(meta.contentHash.low));
+            out.write(reinterpret_cast<const char*>(&meta.contentHash.high), sizeof(meta.contentHash.high));
+        }
     }
 
-    // 写入文件内容（按顺序排列）（这里只写入普通文件的内容）
-    for(const auto& meta : metas){
-        // 只写入普通文件的内容
-        if(meta.type != FileType::Regular) continue;
+    out.close();
+    if(!out){
+        LOG_ERROR("Error: Failed to write file " << destPackBase << ".");
+        return "";
+    }
+    LOG_INFO("Packing " << fileTotal << " files from " << sources.size() << " source(s) to " << destPackBase << " using " << getPackTypeName() << "Packer.");
+    return destPackBase;
+}
 
-        std::filesystem::path fullFilePath = std::filesystem::path(rootPath) / meta.name;
-        std::ifstream in(fullFilePath, std::ios::binary);
-        if(!in){
-            std::cerr << "Error: Failed to open file " << fullFilePath.string() << " for reading.\n";
-            return "";
+std::vector<size_t> myPack::findDuplicates(const std::vector<FileMeta>& metas,
+                                           const std::vector<std::string>& fullPaths, CMetrics* metrics){
+    std::vector<size_t> duplicateOf(metas.size(), SIZE_MAX);
+
+    // 只有大小相同的普通文件才可能重复；稀疏文件、硬链接与空文件不参与
+    std::unordered_map<uint64_t, std::vector<size_t>> bySize;
+    for(size_t i = 0; i < metas.size(); ++i){
+        if(metas[i].type == FileType::Regular && metas[i].flags == 0 && metas[i].size > 0){
+            bySize[metas[i].size].push_back(i);
         }
-        std::vector<char> buffer(meta.size);
-        in.read(buffer.data(), meta.size);
-        out.write(buffer.data(), meta.size);
+    }
+    std::vector<size_t> candidates;
+    for(const auto& group : bySize){
+        if(group.second.size() > 1){
+            candidates.insert(candidates.end(), group.second.begin(), group.second.end());
+        }
+    }
+    if(candidates.empty()){
+        return duplicateOf;
     }
 
-    out.close();
-    std::cout << "Packing " << files.size() << " files to " << destPackBase << " using " << getPackTypeName() << "Packer.\n";
-    return destPackBase;
+    // 并发计算候选文件的哈希
+    std::vector<Hash128> hashes(metas.size());
+    std::vector<char> hashed(metas.size(), 0);
+    std::atomic<size_t> next{0};
+    auto worker = [&](){
+        for(size_t n = next++; n < candidates.size(); n = next++){
+            const size_t i = candidates[n];
+            if(m_rateLimiter){
+                m_rateLimiter->acquire(metas[i].size);
+            }
+            CStageTimer readTimer(Stage::Read, metrics);
+            if(CXXHash128::hashFile(fullPaths[i], hashes[i])){
+                hashed[i] = 1;
+                readTimer.addBytes(metas[i].size);
+            }
+        }
+    };
+    const size_t workerCount = std::min<size_t>(candidates.size(), std::max(1u, std::min(8u, std::thread::hardware_concurrency())));
+    std::vector<std::future<void>> tasks;
+    for(size_t t = 1; t < workerCount; ++t){
+        tasks.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for(auto& task : tasks){
+        task.get();
+    }
+
+    // 按 (大小, 哈希) 归并，保留包内顺序中的第一个作为存放内容的条目
+    std::map<std::pair<uint64_t, Hash128>, size_t> firstByContent;
+    for(size_t i = 0; i < metas.size(); ++i){
+        if(!hashed[i]){
+            continue;
+        }
+        auto inserted = firstByContent.emplace(std::make_pair(metas[i].size, hashes[i]), i);
+        if(!inserted.second){
+            duplicateOf[i] = inserted.first->second;
+        }
+    }
+    return duplicateOf;
 }
 
 bool myPack::unpack(const std::string& srcPath, const std::string& destDir) {
+    CMetrics* metrics = CMetrics::current();
+    CStageTimer unpackTimer(Stage::Unpack, metrics);
     std::ifstream in(srcPath, std::ios::binary);
     if(!in){
-        std::cerr << "Error: Failed to open file " << srcPath << " for reading.\n";
+        LOG_ERROR("Error: Failed to open file " << srcPath << " for reading.");
         return false;
     }
 
-    // 检查是否是打包文件
-    uint8_t isPacked;
-    in.read(reinterpret_cast<char*>(&isPacked), sizeof(isPacked));
-    if(isPacked != 1){
-        // 不是打包文件，返回错误信息
-        std::cerr << "Error: File " << srcPath << " is not packed.\n";
+    PackIndex index;
+    if(!readPackIndex(in, srcPath, index)){
         return false;
     }
-
-    // 读取包头
-    // 读取打包算法类型(1字节)
-    PackType type;
-    in.read(reinterpret_cast<char*>(&type), sizeof(type));
-    if(type != PackType::Basic){
-        // 匹配失败，返回错误信息
-        std::cerr << "Error: Packing algorithm type in " << srcPath << " is not Basic.\n";
-        return false;
+    const uint32_t fileCount = static_cast<uint32_t>(index.metas.size());
+    const uint32_t contentStart = index.contentStart;
+    const std::vector<FileMeta>& metas = index.metas;
+    // 包中的名字不可信：拒绝会写到 destDir 之外的条目
+    for(const auto& meta : metas){
+        if(!isSafeEntryPath(meta.name) || ((meta.flags & META_FLAG_HARDLINK) && !isSafeEntryPath(meta.linkTarget))){
+            LOG_ERROR("Error: Unsafe entry " << meta.name << " in " << srcPath << ", refusing to unpack.");
+            return false;
+        }
     }
+    LOG_INFO("Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << ".");
 
-    // 读取文件数量（4字节）
-    uint32_t fileCount;
-    in.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
-    std::vector<FileMeta> metas(fileCount);
-    std::cout << "Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << ".\n";
-
-    // 读取头信息长度（4字节）
-    uint32_t contentStart;
-    in.read(reinterpret_cast<char*>(&contentStart), sizeof(contentStart));
-
-    // 读取文件元信息
-    for(auto& meta : metas){
-        in.read(reinterpret_cast<char*>(&meta.nameLen), sizeof(meta.nameLen));
-        meta.name.resize(meta.nameLen);
-        in.read(&meta.name[0], meta.nameLen);
-        in.read(reinterpret_cast<char*>(&meta.size), sizeof(meta.size));
-        in.read(reinterpret_cast<char*>(&meta.offset), sizeof(meta.offset));
-        in.read(reinterpret_cast<char*>(&meta.type), sizeof(meta.type));
-    }
+    // 已解出的内容：内容区偏移 -> 解出的文件，重复内容从这里复制而不再读取包
+    std::unordered_map<uint64_t, std::filesystem::path> restoredContent;
+    // 损坏的内容（内容区偏移）与损坏的文件数：损坏的条目不影响其余条目的还原，全部解出后返回失败
+    std::unordered_set<uint64_t> damagedContent;
+    size_t damagedCount = 0;
+    // 本次已解出的普通文件：条目名 -> 是否完好，硬链接只能指向其中的条目
+    std::unordered_map<std::string, bool> restoredEntries;
+    // 符号链接在全部文件与目录解出后再创建，之后的条目不会经由链接写到 destDir 之外
+    std::vector<const FileMeta*> symlinks;
+    CCopyEngine copyEngine;
+    CodecCache codecs;
+    codecs.setDictionary(index.dictionary);
 
     // 遍历构建目录结构，根据不同文件类型区分进行构建
     for(const auto& meta : metas){
         switch(meta.type){
             // 普通文件
             case FileType::Regular:{
+                CFileLatencyTimer fileTimer(metrics);
+                unpackTimer.addBytes(meta.size);
                 // 定义到对应的文件内容offset（必须是当前流位置开始，也就是元数据区末尾）
+                in.clear();
                 in.seekg(meta.offset + contentStart, std::ios::beg);
                 // 写入
                 std::filesystem::path outPath = std::filesystem::path(destDir) / meta.name;
@@ -180,38 +1269,117 @@ bool myPack::unpack(const std::string& srcPath, const std::string& destDir) {
                 // 确保目标目录存在
                 if(!std::filesystem::exists(outPath.parent_path())){
                     // 输出目录路径
-                    std::cout << "Unpacking directory " << meta.name << " to " << outPath.parent_path() << ".\n";
+                    LOG_DEBUG("Unpacking directory " << meta.name << " to " << outPath.parent_path() << ".");
                     std::filesystem::create_directories(outPath.parent_path());
                 }
 
+                // 硬链接：链接到已经解出的条目，无法链接时（如跨设备）复制一份
+                if(meta.flags & META_FLAG_HARDLINK){
+                    auto target = restoredEntries.find(meta.linkTarget);
+                    if(target == restoredEntries.end() || !target->second){
+                        LOG_ERROR("Error: Hard link target " << meta.linkTarget << " of " << meta.name <<
+                                  (target == restoredEntries.end() ? " was not restored." : " is damaged."));
+                        restoredEntries[meta.name] = false;
+                        ++damagedCount;
+                        break;
+                    }
+                    const std::filesystem::path targetPath = std::filesystem::path(destDir) / meta.linkTarget;
+                    std::error_code ec;
+                    std::filesystem::remove(outPath, ec);
+                    std::filesystem::create_hard_link(targetPath, outPath, ec);
+                    if(ec && !std::filesystem::copy_file(targetPath, outPath, std::filesystem::copy_options::overwrite_existing, ec)){
+                        LOG_ERROR("Error: Failed to restore hard link " << outPath << " to " << targetPath << ": " << ec.message());
+                        return false;
+                    }
+                    restoredEntries[meta.name] = true;
+                    break;
+                }
+
+                // 重复内容：复制已经解出的那一份
+                if(meta.flags & META_FLAG_DUPLICATE){
+                    if(damagedContent.count(meta.offset)){
+                        LOG_ERROR("Error: Shared content of " << meta.name << " is damaged.");
+                        restoredEntries[meta.name] = false;
+                        ++damagedCount;
+                        break;
+                    }
+                    auto restored = restoredContent.find(meta.offset);
+                    if(restored != restoredContent.end() && copyEngine.copyFile(restored->second.string(), outPath.string())){
+                        restoredEntries[meta.name] = true;
+                        break;
+                    }
+                    LOG_ERROR("Error: Shared content of " << meta.name << " was not restored.");
+                    return false;
+                }
+
                 std::ofstream out(outPath, std::ios::binary);
 
                 if(!out){
-                    std::cerr << "Error: Failed to open file " << outPath << " for writing.\n";
+                    LOG_ERROR("Error: Failed to open file " << outPath << " for writing.");
                     return false;
                 }
 
                 const size_t MAX_BUFFER_SIZE = 1024 * 1024; // 1MB
-                size_t remainingSize = meta.size;
+                const bool sparse = (meta.flags & META_FLAG_SPARSE) != 0;
                 
-                // 合理性检查：如果文件大小异常大，记录警告
-                if(meta.size > 1024 * 1024 * 1024) { // 大于1GB
-                    std::cerr << "Warning: Unexpectedly large file size (" << meta.size << ") for " << meta.name << ".\n";
+                // 合理性检查：如果文件大小异常大，记录警告（稀疏文件按实际存放的数据量判断）
+                if(meta.storedSize() > 1024 * 1024 * 1024) { // 大于1GB
+                    LOG_WARN("Warning: Unexpectedly large file size (" << meta.size << ") for " << meta.name << ".");
                 }
                 
-                std::vector<char> buffer(std::min(MAX_BUFFER_SIZE, remainingSize));
-                while(remainingSize > 0) {
-                    size_t toRead = std::min(buffer.size(), remainingSize);
-                    in.read(buffer.data(), toRead);
-                    size_t bytesRead = in.gcount();
-                    if(bytesRead == 0 && remainingSize > 0) {
-                        std::cerr << "Error: Unexpected end of file while reading " << meta.name << ".\n";
-                        return false;
+                // 内容区中各区间的数据连续存放；写出时跳到区间偏移，跳过的部分成为空洞
+                std::vector<char> buffer(static_cast<size_t>(std::min<uint64_t>(MAX_BUFFER_SIZE, meta.payloadSize())));
+                PayloadReader reader(in, (meta.flags & META_FLAG_COMPRESSED) != 0, codecs);
+                const std::vector<FileExtent> extents = sparse ?
+                    meta.extents : std::vector<FileExtent>{{0, meta.size}};
+                const bool verify = (meta.flags & META_FLAG_CHECKSUM) != 0;
+                CXXHash128 contentHash;
+                bool intact = true;
+                for(size_t e = 0; intact && e < extents.size(); ++e){
+                    const FileExtent& extent = extents[e];
+                    if(sparse){
+                        out.seekp(extent.offset, std::ios::beg);
+                    }
+                    uint64_t remainingSize = extent.length;
+                    while(remainingSize > 0) {
+                        size_t toRead = static_cast<size_t>(std::min<uint64_t>(buffer.size(), remainingSize));
+                        size_t bytesRead = reader.read(buffer.data(), toRead);
+                        if(bytesRead == 0 && remainingSize > 0) {
+                            LOG_ERROR("Error: Unexpected end of file or corrupted data while reading " << meta.name << ".");
+                            intact = false;
+                            break;
+                        }
+                        if(verify){
+                            contentHash.update(buffer.data(), bytesRead);
+                        }
+                        out.write(buffer.data(), bytesRead);
+                        remainingSize -= bytesRead;
                     }
-                    out.write(buffer.data(), bytesRead);
-                    remainingSize -= bytesRead;
                 }
                 out.close();
+                if(intact && verify && contentHash.digest() != meta.contentHash){
+                    LOG_ERROR("Error: Checksum mismatch for " << meta.name << ", the restored file is damaged.");
+                    intact = false;
+                }
+                restoredEntries[meta.name] = intact;
+                if(!intact){
+                    damagedContent.insert(meta.offset);
+                    ++damagedCount;
+                    break;
+                }
+                // 末尾的空洞不会被写出，按逻辑长度补齐
+                if(sparse && !CSparseFile::setLength(outPath.string(), meta.size)){
+                    return false;
+                }
+                if(meta.size > 0){
+                    restoredContent[meta.offset] = outPath;
+                }
+                break;
+            }
+
+            // 符号链接：记下条目，全部解出后再创建
+            case FileType::SymbolicLink:{
+                symlinks.push_back(&meta);
                 break;
             }
 
@@ -221,21 +1389,137 @@ bool myPack::unpack(const std::string& srcPath, const std::string& destDir) {
                 std::filesystem::path outPath = std::filesystem::path(destDir) / meta.name;
 
                 if(!std::filesystem::create_directory(outPath)){
-                    std::cerr << "Error: Failed to create directory " << outPath << ".\n";
+                    LOG_ERROR("Error: Failed to create directory " << outPath << ".");
                     return false;
                 }
                 break;
             }
 
             default:{
-                std::cerr << "Error: Unknown file type " << static_cast<int>(meta.type) << " in " << srcPath << ".\n";
+                LOG_ERROR("Error: Unknown file type " << static_cast<int>(meta.type) << " in " << srcPath << ".");
                 break;
             }
         }
     }
 
+    // 按记录的目标重新创建符号链接；父目录已经是链接的条目会经由链接写到 destDir 之外，跳过
+    for(const FileMeta* link : symlinks){
+        std::filesystem::path outPath = std::filesystem::path(destDir) / link->name;
+        if(hasSymlinkParent(destDir, link->name)){
+            LOG_WARN("Warning: Skipped symbolic link " << outPath << ", a parent directory is a symbolic link.");
+            continue;
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(outPath.parent_path(), ec);
+        std::filesystem::remove(outPath, ec);
+        // Windows 上指向目录的链接需要单独创建；目标此时已经解出
+        if(std::filesystem::is_directory(outPath.parent_path() / link->linkTarget, ec)){
+            std::filesystem::create_directory_symlink(link->linkTarget, outPath, ec);
+        }
+        else{
+            std::filesystem::create_symlink(link->linkTarget, outPath, ec);
+        }
+        if(ec){
+            // 没有创建链接的权限时只跳过该条目
+            LOG_WARN("Warning: Failed to create symbolic link " << outPath << " -> " << link->linkTarget << ": " << ec.message());
+        }
+    }
+
     in.close();
-    std::cout << "Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << " using BasicPacker.\n";
+    unpackTimer.addFiles(fileCount);
+    if(damagedCount > 0){
+        LOG_ERROR("Error: " << damagedCount << " damaged file(s) in " << srcPath << ".");
+        return false;
+    }
+    LOG_INFO("Unpacking " << fileCount << " files from " << srcPath << " to " << destDir << " using BasicPacker.");
     return true;
 }
 
+bool myPack::verify(std::istream& in, const std::string& srcPath) {
+    CMetrics* metrics = CMetrics::current();
+    CStageTimer verifyTimer(Stage::Verify, metrics);
+    PackIndex index;
+    if(!readPackIndex(in, srcPath, index)){
+        return false;
+    }
+
+    // 存放了内容的条目按内容区中的位置顺序读取，重复条目与链接不占内容区
+    std::vector<const FileMeta*> stored;
+    for(const auto& meta : index.metas){
+        if(meta.type == FileType::Regular && !(meta.flags & META_FLAG_DUPLICATE) && meta.storedSize() > 0){
+            stored.push_back(&meta);
+        }
+    }
+    std::stable_sort(stored.begin(), stored.end(), [](const FileMeta* a, const FileMeta* b){
+        return a->offset < b->offset;
+    });
+
+    CodecCache codecs;
+    codecs.setDictionary(index.dictionary);
+    std::unordered_set<uint64_t> damagedContent;
+    size_t damagedCount = 0;
+    uint64_t position = 0;  // 相对内容区起始处
+    uint64_t verifiedBytes = 0;
+    std::vector<char> buffer(1024 * 1024);
+    for(const FileMeta* meta : stored){
+        // 条目之间不应有间隙，旧包中可能存在的间隙直接跳过
+        if(meta->offset < position){
+            LOG_ERROR("Error: Overlapping content of " << meta->name << " in " << srcPath << ", cannot continue verifying.");
+            return false;
+        }
+        if(meta->offset > position){
+            in.ignore(static_cast<std::streamsize>(meta->offset - position));
+            position = meta->offset;
+        }
+
+        PayloadReader reader(in, (meta->flags & META_FLAG_COMPRESSED) != 0, codecs);
+        const bool checksum = (meta->flags & META_FLAG_CHECKSUM) != 0;
+        CXXHash128 contentHash;
+        bool intact = true;
+        for(uint64_t remaining = meta->payloadSize(); remaining > 0;){
+            const size_t n = reader.read(buffer.data(), static_cast<size_t>(std::min<uint64_t>(buffer.size(), remaining)));
+            if(n == 0){
+                LOG_ERROR("Error: Unexpected end of file or corrupted data while reading " << meta->name << ".");
+                intact = false;
+                break;
+            }
+            if(checksum){
+                contentHash.update(buffer.data(), n);
+            }
+            remaining -= n;
+        }
+        if(intact && checksum && contentHash.digest() != meta->contentHash){
+            LOG_ERROR("Error: Checksum mismatch for " << meta->name << ", the entry is damaged.");
+            intact = false;
+        }
+        verifiedBytes += meta->payloadSize();
+        position += reader.getConsumed();
+        if(!intact){
+            damagedContent.insert(meta->offset);
+            ++damagedCount;
+            // 损坏的块可能没有读完，按记录的存放长度跳到下一个条目
+            const uint64_t end = meta->offset + meta->storedSize();
+            if(position > end || !in){
+                LOG_ERROR("Error: Damaged data in " << srcPath << " cannot be skipped, stopped verifying.");
+                return false;
+            }
+            in.ignore(static_cast<std::streamsize>(end - position));
+            position = end;
+        }
+    }
+    // 与损坏条目共用内容的重复条目同样损坏
+    for(const auto& meta : index.metas){
+        if((meta.flags & META_FLAG_DUPLICATE) && damagedContent.count(meta.offset)){
+            LOG_ERROR("Error: Shared content of " << meta.name << " is damaged.");
+            ++damagedCount;
+        }
+    }
+    verifyTimer.addBytes(verifiedBytes);
+    verifyTimer.addFiles(index.metas.size());
+    if(damagedCount > 0){
+        LOG_ERROR("Error: " << damagedCount << " damaged file(s) in " << srcPath << ".");
+        return false;
+    }
+    LOG_INFO("Verified " << index.metas.size() << " files (" << verifiedBytes << " bytes) in " << srcPath << ".");
+    return true;
+}
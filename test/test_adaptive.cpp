@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "CAdaptiveLevel.h"
+#include "myPack.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 模拟的各级别每字节压缩耗时（纳秒）与压缩率
+constexpr double kCompressNanos[] = {0, 1, 3, 20, 60};
+constexpr double kRatio[] = {1, 0.6, 0.55, 0.35, 0.3};
+
+// 按给定的写出速度模拟 blocks 块，返回最后一半块中最常用的级别
+int simulate(CAdaptiveLevel& adaptive, double writeNanosPerByte, int blocks) {
+    constexpr uint64_t kBlock = 1 << 20;
+    std::vector<int> used(CAdaptiveLevel::kMaxLevel + 1, 0);
+    for (int i = 0; i < blocks; ++i) {
+        const int level = adaptive.nextLevel();
+        const uint64_t stored = static_cast<uint64_t>(kBlock * kRatio[level]);
+        adaptive.recordCompress(level, kBlock, stored, static_cast<uint64_t>(kBlock * kCompressNanos[level]));
+        adaptive.recordWrite(stored, static_cast<uint64_t>(stored * writeNanosPerByte));
+        if (i >= blocks / 2) ++used[level];
+    }
+    int best = 0;
+    for (int level = 1; level <= CAdaptiveLevel::kMaxLevel; ++level) {
+        if (used[level] > used[best]) best = level;
+    }
+    return best;
+}
+
+}  // namespace
+
+// 写出慢时提高级别，压缩成为瓶颈时降级直至不压缩，并随设备速度的变化重新选择
+TEST(AdaptiveLevelTest, TracksWriteSpeed) {
+    CAdaptiveLevel slowDevice;
+    EXPECT_EQ(simulate(slowDevice, 100, 200), 3);   // 估计耗时 100 / 61 / 58 / 55 / 90
+    CAdaptiveLevel balanced;
+    EXPECT_EQ(simulate(balanced, 5, 200), 1);       // 5 / 4 / 5.75 / 21.75 / 61.5
+    CAdaptiveLevel fastDevice;
+    EXPECT_EQ(simulate(fastDevice, 0.5, 200), 0);   // 压缩总比直接写出慢
+    EXPECT_GT(fastDevice.getBlockCounts()[1], 0u);  // 仍会定期试探
+
+    // 同一任务中设备变快或变慢
+    EXPECT_EQ(simulate(slowDevice, 0.5, 200), 0);
+    EXPECT_EQ(simulate(slowDevice, 100, 400), 3);
+
+    // 配置的压缩级别限制可用的最慢算法
+    CAdaptiveLevel capped(CAdaptiveLevel::maxLevelForConfig(1));
+    EXPECT_EQ(capped.getMaxLevel(), 1);
+    EXPECT_EQ(simulate(capped, 100, 200), 1);
+    EXPECT_EQ(CAdaptiveLevel::codecForLevel(0), CompressType::None);
+    EXPECT_EQ(CAdaptiveLevel::codecForLevel(CAdaptiveLevel::maxLevelForConfig(9)), CompressType::BWT);
+    EXPECT_LT(capped.estimateCost(2), 0);
+}
+
+// 自适应打包时同一条目的各块可以使用不同算法，解包按块还原
+TEST(AdaptiveLevelTest, PackRoundTrip) {
+    namespace fs = std::filesystem;
+    const std::string root = "test_adaptive_pack";
+    fs::remove_all(root);
+    std::string text;
+    for (unsigned i = 0; text.size() < 5 * PACK_BLOCK_SIZE / 2; ++i) {
+        text += "line " + std::to_string(i) + ": request served in " + std::to_string(i % 97) + " ms\n";
+    }
+    const std::vector<std::string> files = {root + "/src/app.log", root + "/src/small.txt"};
+    const std::vector<std::string> contents = {text, text.substr(0, 4000)};
+    for (size_t i = 0; i < files.size(); ++i) {
+        ASSERT_TRUE(CreateTestFile(files[i], contents[i]));
+    }
+    fs::create_directories(root + "/pack");
+    myPack packer;
+    packer.setEntryCompression("Huffman4X");
+    packer.setAdaptiveCompression(true, 9);
+    const std::string packed = packer.pack({{root + "/src", "", files}}, root + "/pack");
+    ASSERT_FALSE(packed.empty());
+
+    myPack unpacker;
+    ASSERT_TRUE(unpacker.unpack(packed, root + "/out"));
+    std::vector<char> content;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const std::string restored = root + "/out/" + fs::path(files[i]).filename().string();
+        ASSERT_TRUE(ReadTestFile(restored, content)) << restored;
+        EXPECT_TRUE(std::string(content.begin(), content.end()) == contents[i]) << restored;
+    }
+    fs::remove_all(root);
+}
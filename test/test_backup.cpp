@@ -49,4 +49,172 @@ TEST(BackupTest, BasicBackup) {
     // 测试清理
     CleanupTestFile(sourcePath);
     CleanupTestFile(destPath);
-}
\ No newline at end of file
+}
+
+// 测试多源打包：多个源写入同一个包，每个源存放在各自的前缀下
+TEST(BackupTest, MultiSourcePackedBackup) {
+    const std::string testRoot = "test_multi_source";
+    const std::string destDir = testRoot + "/repo";
+    const std::string restoreDir = testRoot + "/restore";
+    std::filesystem::remove_all(testRoot);
+
+    // 两个源目录同名（data），需要通过前缀区分
+    ASSERT_TRUE(CreateTestFile(testRoot + "/a/data/one.txt", "content from a"));
+    ASSERT_TRUE(CreateTestFile(testRoot + "/b/data/two.txt", "content from b"));
+    ASSERT_TRUE(CreateTestFile(testRoot + "/c/notes.txt", "a single file source"));
+
+    auto config = std::make_shared<CConfig>();
+    config->addSourcePath(testRoot + "/a/data");
+    config->addSourcePath(testRoot + "/b/data");
+    config->addSourcePath(testRoot + "/c/notes.txt");
+    config->setDestinationPath(destDir);
+    config->setRecursiveSearch(true).setPackingEnabled(true).setPackType("Basic").setThreadCount(2);
+
+    CBackup backup;
+    std::string packedPath = backup.doBackup(config);
+    ASSERT_FALSE(packedPath.empty()) << "Multi-source backup failed";
+
+    BackupEntry entry("data", "", destDir, std::filesystem::path(packedPath).filename().string(),
+                      "2025-01-01 00:00", false, true, false);
+    std::filesystem::create_directories(restoreDir);
+    ASSERT_TRUE(backup.doRecovery(entry, restoreDir, ""));
+
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(restoreDir + "/data/one.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "content from a");
+    ASSERT_TRUE(ReadTestFile(restoreDir + "/data_2/two.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "content from b");
+    ASSERT_TRUE(ReadTestFile(restoreDir + "/notes.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "a single file source");
+
+    std::filesystem::remove_all(testRoot);
+}
+
+// 快照模式：未变化的文件硬链接到上一次快照，变化的文件重新拷贝
+TEST(BackupTest, SnapshotLinksUnchangedFiles) {
+    namespace fs = std::filesystem;
+    const std::string testRoot = "test_snapshot";
+    const std::string destDir = testRoot + "/repo";
+    const std::string restoreDir = testRoot + "/restore";
+    fs::remove_all(testRoot);
+
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/same.txt", "unchanged content"));
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/sub/changed.txt", "version 1"));
+
+    auto config = std::make_shared<CConfig>();
+    config->setSourcePath(testRoot + "/src");
+    config->setDestinationPath(destDir);
+    config->setRecursiveSearch(true).setSnapshotEnabled(true).setSnapshotCompareHash(true);
+
+    CBackup backup;
+    const std::string first = backup.doBackup(config);
+    ASSERT_FALSE(first.empty());
+
+    // 内容与大小都变化，并推后修改时间
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/sub/changed.txt", "version 2 is longer"));
+    fs::last_write_time(testRoot + "/src/sub/changed.txt",
+                        fs::last_write_time(testRoot + "/src/sub/changed.txt") + std::chrono::seconds(5));
+    const std::string second = backup.doBackup(config);
+    ASSERT_FALSE(second.empty());
+    ASSERT_NE(second, first);
+    EXPECT_EQ(findLatestSnapshot(destDir), second);
+
+    EXPECT_GE(fs::hard_link_count(second + "/src/same.txt"), 2u);
+    EXPECT_EQ(fs::hard_link_count(second + "/src/sub/changed.txt"), 1u);
+    EXPECT_TRUE(fs::exists(second + "/" + SNAPSHOT_MANIFEST_NAME));
+
+    BackupEntry entry("src", "", destDir, fs::path(second).filename().string(),
+                      "2025-01-01 00:00", false, false, false);
+    ASSERT_TRUE(backup.doRecovery(entry, restoreDir, ""));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(restoreDir + "/src/same.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "unchanged content");
+    ASSERT_TRUE(ReadTestFile(restoreDir + "/src/sub/changed.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "version 2 is longer");
+    EXPECT_FALSE(fs::exists(restoreDir + "/" + SNAPSHOT_MANIFEST_NAME));
+
+    // 第一次快照中的旧版本不受影响
+    ASSERT_TRUE(ReadTestFile(first + "/src/sub/changed.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "version 1");
+
+    fs::remove_all(testRoot);
+}
+
+// 校验：逐层按流解密、解压并核对包内每个条目的哈希，不解出文件；损坏的备份报告失败
+TEST(BackupTest, VerifyDetectsCorruption) {
+    namespace fs = std::filesystem;
+    const std::string testRoot = "test_verify";
+    const std::string destDir = testRoot + "/repo";
+    fs::remove_all(testRoot);
+
+    std::string text;
+    for (int i = 0; text.size() < 300000; ++i) {
+        text += "record " + std::to_string(i) + " checksum " + std::to_string(i * 7919 % 1000) + "\n";
+    }
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/log.txt", text));
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/sub/note.txt", "short note"));
+
+    auto config = std::make_shared<CConfig>();
+    config->setSourcePath(testRoot + "/src");
+    config->setDestinationPath(destDir);
+    config->setRecursiveSearch(true).setPackingEnabled(true).setPackType("Basic");
+    config->setCompressionEnabled(true).setCompressionType("Huffman4X");
+    config->setEncryptionEnabled(true).setEncryptionKey("secret").setEncryptType("SimXOR");
+
+    CBackup backup;
+    const std::string packed = backup.doBackup(config);
+    ASSERT_FALSE(packed.empty());
+    const BackupEntry entry("src", "", destDir, fs::path(packed).filename().string(),
+                            "2025-01-01 00:00", true, true, true);
+
+    std::vector<VerifyResult> results = backup.verifyBackups({entry}, "secret");
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].ok);
+    EXPECT_EQ(results[0].bytes, fs::file_size(packed));
+    EXPECT_FALSE(backup.doVerify(entry, ""));
+
+    // 修改一个字节
+    {
+        std::fstream file(packed, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-100, std::ios::end);
+        const char byte = static_cast<char>(file.get());
+        file.seekp(-100, std::ios::end);
+        file.put(static_cast<char>(byte ^ 0x5A));
+    }
+    VerifyResult damaged;
+    EXPECT_FALSE(backup.doVerify(entry, "secret", &damaged));
+    EXPECT_FALSE(damaged.ok);
+
+    // 缺少记录中标明的加密层，或最内层不是可识别的包头时同样失败
+    config->setEncryptionEnabled(false);
+    const std::string plain = backup.doBackup(config);
+    ASSERT_FALSE(plain.empty());
+    const std::string plainName = fs::path(plain).filename().string();
+    EXPECT_TRUE(backup.doVerify(BackupEntry("src", "", destDir, plainName, "2025-01-01 00:00", false, true, true), ""));
+    const BackupEntry wrongEntry("src", "", destDir, plainName, "2025-01-01 00:00", true, true, true);
+    EXPECT_FALSE(backup.doVerify(wrongEntry, "secret"));
+    {
+        std::fstream file(plain, std::ios::in | std::ios::out | std::ios::binary);
+        file.put(static_cast<char>(0x7F));
+    }
+    VerifyResult unknown;
+    EXPECT_FALSE(backup.doVerify(BackupEntry("src", "", destDir, plainName, "2025-01-01 00:00", false, true, true), "",
+                                 &unknown));
+    EXPECT_FALSE(unknown.ok);
+    EXPECT_GT(unknown.seconds, 0.0);
+
+    // 快照目录按清单核对
+    config = std::make_shared<CConfig>();
+    config->setSourcePath(testRoot + "/src");
+    config->setDestinationPath(destDir);
+    config->setRecursiveSearch(true).setSnapshotEnabled(true).setSnapshotCompareHash(true);
+    const std::string snapshot = backup.doBackup(config);
+    ASSERT_FALSE(snapshot.empty());
+    const BackupEntry snapshotEntry("src", "", destDir, fs::path(snapshot).filename().string(),
+                                    "2025-01-01 00:00", false, false, false);
+    EXPECT_TRUE(backup.doVerify(snapshotEntry, ""));
+    ASSERT_TRUE(CreateTestFile(snapshot + "/src/sub/note.txt", "short nose"));
+    EXPECT_FALSE(backup.doVerify(snapshotEntry, ""));
+
+    fs::remove_all(testRoot);
+}
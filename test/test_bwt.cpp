@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "BWTCompress.h"
+#include "HuffmanCompress.h"
+#include "CompressFactory.h"
+#include "CConfig.h"
+#include "testUtils.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string makeLogText(size_t size) {
+    std::mt19937 rng(5);
+    static const char* levels[] = {"INFO", "WARN", "DEBUG"};
+    std::string text;
+    while (text.size() < size) {
+        text += "2024-05-0" + std::to_string(rng() % 9 + 1) + " [" + levels[rng() % 3] + "] backup of /data/file_" +
+                std::to_string(rng() % 500) + ".db finished in " + std::to_string(rng() % 1000) + " ms\n";
+    }
+    text.resize(size);
+    return text;
+}
+
+}  // namespace
+
+// SA-IS 的结果与朴素排序一致，BWT 正逆变换互逆
+TEST(BwtTest, SuffixArrayAndTransform) {
+    std::mt19937 rng(9);
+    for (const std::string& text : {std::string("banana"), std::string("mississippi"), std::string(50, 'a'),
+                                    std::string("abababababababab"), makeLogText(3000)}) {
+        std::vector<int32_t> s(text.begin(), text.end());
+        for (int32_t& v : s) v &= 0xFF;
+        std::vector<int32_t> expected(s.size());
+        for (size_t i = 0; i < s.size(); ++i) expected[i] = static_cast<int32_t>(i);
+        std::sort(expected.begin(), expected.end(), [&](int32_t a, int32_t b) {
+            return std::lexicographical_compare(s.begin() + a, s.end(), s.begin() + b, s.end());
+        });
+        EXPECT_EQ(BwtCodec::suffixArray(s, 255), expected) << text.substr(0, 20);
+
+        uint32_t primary = 0;
+        const auto bwt = BwtCodec::forward(reinterpret_cast<const uint8_t*>(text.data()), text.size(), primary);
+        std::vector<uint8_t> restored;
+        ASSERT_TRUE(BwtCodec::inverse(bwt, primary, restored));
+        EXPECT_EQ(std::string(restored.begin(), restored.end()), text);
+    }
+    // "banana" 的 BWT（结束符不输出）
+    uint32_t primary = 0;
+    const std::string banana = "banana";
+    const auto bwt = BwtCodec::forward(reinterpret_cast<const uint8_t*>(banana.data()), banana.size(), primary);
+    EXPECT_EQ(std::string(bwt.begin(), bwt.end()), "annbaa");
+    EXPECT_EQ(primary, 4u);
+}
+
+// 多块并行压缩与解压，压缩率明显高于 Huffman，且可通过配置选择
+TEST(BwtTest, CompressRoundTripAndRatio) {
+    const std::string text = makeLogText(BWTCompress::kBlockSize * 2 + 12345);
+    const std::vector<char> source(text.begin(), text.end());
+    BWTCompress bwt(4);
+    std::vector<char> compressed, restored;
+    ASSERT_TRUE(bwt.compressData(source, compressed));
+    ASSERT_TRUE(bwt.decompressData(compressed, restored));
+    EXPECT_TRUE(restored == source);
+
+    std::vector<char> huffman;
+    ASSERT_TRUE(HuffmanCompress().compressData(source, huffman));
+    EXPECT_LT(compressed.size() * 2, huffman.size());
+
+    for (const std::string& small : {std::string(), std::string("x"), std::string(100000, '\0')}) {
+        std::vector<char> c, r;
+        ASSERT_TRUE(bwt.compressData(std::vector<char>(small.begin(), small.end()), c));
+        ASSERT_TRUE(bwt.decompressData(c, r));
+        EXPECT_EQ(std::string(r.begin(), r.end()), small);
+    }
+
+    compressed[compressed.size() / 3] ^= 0x11;
+    EXPECT_FALSE(bwt.decompressData(compressed, restored));
+
+    CConfig config;
+    config.setCompressionType("BWT");
+    EXPECT_TRUE(CompressFactory::isCompressTypeSupported(config.getCompressionType()));
+    const std::string sourceFile = "test_bwt_source.log";
+    const std::string restoredFile = "test_bwt_restored.log";
+    ASSERT_TRUE(CreateTestFile(sourceFile, text.substr(0, 300000)));
+    auto compressor = CompressFactory::createCompress(config.getCompressionType());
+    const std::string compressedFile = compressor->compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty());
+    ASSERT_TRUE(compressor->decompressFile(compressedFile, restoredFile));
+    std::vector<char> fileContent;
+    ASSERT_TRUE(ReadTestFile(restoredFile, fileContent));
+    EXPECT_EQ(std::string(fileContent.begin(), fileContent.end()), text.substr(0, 300000));
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(restoredFile);
+}
@@ -1,12 +1,15 @@
 ﻿#include <gtest/gtest.h>
 
 #include "HuffmanCompress.h"  // 包含您的压缩功能头文件
+#include "Huffman4XCompress.h"
+#include "CompressFactory.h"
 
 #include <fstream>
 #include <filesystem>
 #include <vector>
 #include <string>
 #include <cstring>
+#include <sstream>
 #include "testUtils.h"
 
 // 测试用例：测试基本的压缩和解压功能
@@ -110,4 +113,118 @@ TEST(CompressionTest, CRC32Check) {
     // 清理测试文件
     CleanupTestFile(sourceFile);
     CleanupTestFile(compressedFile);
-}
\ No newline at end of file
+}
+// 内存数据的压缩与解压
+TEST(CompressionTest, CompressDataRoundTrip) {
+    HuffmanCompress huffman;
+    for (const std::string& text : {std::string(), std::string("a"), std::string(5000, 'z'),
+                                    std::string("The quick brown fox jumps over the lazy dog. ") + std::string(300, '!')}) {
+        const std::vector<char> source(text.begin(), text.end());
+        std::vector<char> compressed, restored;
+        ASSERT_TRUE(huffman.compressData(source, compressed));
+        ASSERT_TRUE(huffman.decompressData(compressed, restored));
+        EXPECT_TRUE(restored == source) << "size " << text.size();
+    }
+
+    // 截断的数据应当解压失败
+    const std::string text(4096, 'q');
+    std::vector<char> compressed, restored;
+    ASSERT_TRUE(huffman.compressData(std::vector<char>(text.begin(), text.end()), compressed));
+    compressed.resize(compressed.size() / 2);
+    EXPECT_FALSE(huffman.decompressData(compressed, restored));
+}
+
+// 四路 Huffman：内存数据与文件都能还原，且与单流 Huffman 的压缩率相当
+TEST(CompressionTest, Huffman4XRoundTrip) {
+    std::string text;
+    for (size_t i = 0; text.size() < Huffman4XCompress::kBlockSize * 2 + 77; ++i) {
+        text += "entry " + std::to_string(i % 113) + " restored from pack\n";
+    }
+    std::string binary(5000, '\0');
+    for (size_t i = 0; i < binary.size(); ++i) {
+        binary[i] = static_cast<char>((i * 2654435761u) >> 13);
+    }
+    Huffman4XCompress huf4x;
+    for (const std::string& data : {std::string(), std::string("abc"), std::string(4000, 'r'), std::string(text, 0, 101),
+                                    binary, text}) {
+        const std::vector<char> source(data.begin(), data.end());
+        std::vector<char> compressed, restored;
+        ASSERT_TRUE(huf4x.compressData(source, compressed));
+        ASSERT_TRUE(huf4x.decompressData(compressed, restored));
+        EXPECT_TRUE(restored == source) << "size " << data.size();
+    }
+
+    const std::vector<char> source(text.begin(), text.end());
+    std::vector<char> fourStreams, singleStream;
+    ASSERT_TRUE(huf4x.compressData(source, fourStreams));
+    ASSERT_TRUE(HuffmanCompress().compressData(source, singleStream));
+    EXPECT_LT(fourStreams.size(), singleStream.size() * 21 / 20);
+
+    // 损坏的比特流应当解压失败
+    std::vector<char> restored;
+    fourStreams[fourStreams.size() / 2] ^= 0x40;
+    EXPECT_FALSE(huf4x.decompressData(fourStreams, restored));
+
+    const std::string sourceFile = "test_huf4x_source.txt";
+    const std::string restoredFile = "test_huf4x_restored.txt";
+    ASSERT_TRUE(CreateTestFile(sourceFile, text));
+    auto compressor = CompressFactory::createCompress("Huffman4X");
+    const std::string compressedFile = compressor->compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty());
+    EXPECT_EQ(CompressFactory::getCompressType(compressedFile), "Huffman4X");
+    ASSERT_TRUE(compressor->decompressFile(compressedFile, restoredFile));
+    std::vector<char> fileContent;
+    ASSERT_TRUE(ReadTestFile(restoredFile, fileContent));
+    EXPECT_EQ(std::string(fileContent.begin(), fileContent.end()), text);
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(restoredFile);
+}
+
+// 单遍模式：跨多个块的文件与来自流的输入都能还原；两遍模式仍然可用
+TEST(CompressionTest, SinglePassBlockedFormat) {
+    std::string content;
+    for (size_t i = 0; content.size() < HUFF_TABLE_BLOCK_SIZE + 4321; ++i) {
+        // 后半部分换成不同的分布，块内词频表各不相同
+        content += (content.size() < HUFF_TABLE_BLOCK_SIZE) ? "aaaab" : std::to_string(i * 7919);
+    }
+    const std::string sourceFile = "test_single_pass.txt";
+    const std::string restoredFile = "test_single_pass_restored.txt";
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    for (bool singlePass : {true, false}) {
+        HuffmanCompress huffman;
+        huffman.setSinglePass(singlePass);
+        const std::string compressedFile = huffman.compressFile(sourceFile);
+        ASSERT_FALSE(compressedFile.empty());
+        Head header;
+        std::ifstream in(compressedFile, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(Head));
+        EXPECT_EQ((header.reservedBits & HUFF_FLAG_BLOCKED) != 0, singlePass);
+        EXPECT_EQ(header.originalSize, content.size());
+        in.close();
+
+        ASSERT_TRUE(huffman.decompressFile(compressedFile, restoredFile));
+        std::vector<char> restored;
+        ASSERT_TRUE(ReadTestFile(restoredFile, restored));
+        EXPECT_TRUE(std::string(restored.begin(), restored.end()) == content) << "singlePass " << singlePass;
+        CleanupTestFile(compressedFile);
+        CleanupTestFile(restoredFile);
+    }
+
+    // 流式输入
+    const std::string streamFile = "test_single_pass_stream.huff";
+    {
+        std::istringstream in(content.substr(0, 5000));
+        std::ofstream out(streamFile, std::ios::binary);
+        ASSERT_TRUE(HuffmanCompress().compressStream(in, out));
+    }
+    ASSERT_TRUE(HuffmanCompress().decompressFile(streamFile, restoredFile));
+    std::vector<char> restored;
+    ASSERT_TRUE(ReadTestFile(restoredFile, restored));
+    EXPECT_EQ(std::string(restored.begin(), restored.end()), content.substr(0, 5000));
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(streamFile);
+    CleanupTestFile(restoredFile);
+}
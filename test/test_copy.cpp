@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "CCopyEngine.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static std::string readAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+class CopyEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::filesystem::remove_all(m_root);
+        std::filesystem::create_directories(m_root);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(m_root);
+    }
+    std::string path(const std::string& name) const { return m_root + "/" + name; }
+
+    const std::string m_root = "test_copy_dir";
+};
+
+// 默认方式：按块拷贝，内容一致
+TEST_F(CopyEngineTest, CopiesInChunks) {
+    const std::string content = MakeRandomData(300 * 1024 + 17, 1);
+    ASSERT_TRUE(CreateTestFile(path("src.bin"), content));
+
+    CCopyEngine engine(64 * 1024);
+    ASSERT_TRUE(engine.copyFile(path("src.bin"), path("dst.bin")));
+    EXPECT_NE(engine.getLastMethod(), CopyMethod::None);
+    EXPECT_EQ(readAll(path("dst.bin")), content);
+}
+
+// 禁用引用拷贝与内核拷贝后退回缓冲区拷贝，且覆盖已存在的更长目标
+TEST_F(CopyEngineTest, BufferedFallbackOverwrites) {
+    const std::string content = MakeRandomData(100 * 1024, 2);
+    ASSERT_TRUE(CreateTestFile(path("src.bin"), content));
+    ASSERT_TRUE(CreateTestFile(path("dst.bin"), MakeRandomData(200 * 1024, 3)));
+
+    CCopyEngine engine(4096);
+    engine.setReflinkEnabled(false);
+    engine.setKernelCopyEnabled(false);
+    ASSERT_TRUE(engine.copyFile(path("src.bin"), path("dst.bin")));
+    EXPECT_EQ(engine.getLastMethod(), CopyMethod::Buffered);
+    EXPECT_EQ(readAll(path("dst.bin")), content);
+}
+
+// 空文件与不存在的源文件
+TEST_F(CopyEngineTest, EmptyAndMissingSource) {
+    ASSERT_TRUE(CreateTestFile(path("empty.bin"), ""));
+    CCopyEngine engine;
+    ASSERT_TRUE(engine.copyFile(path("empty.bin"), path("empty_copy.bin")));
+    EXPECT_TRUE(std::filesystem::exists(path("empty_copy.bin")));
+    EXPECT_EQ(std::filesystem::file_size(path("empty_copy.bin")), 0u);
+
+    EXPECT_FALSE(engine.copyFile(path("missing.bin"), path("missing_copy.bin")));
+    EXPECT_EQ(engine.getLastMethod(), CopyMethod::None);
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include "CDeltaEngine.h"
+#include "CBackup.h"
+#include "CBackupRecorder.h"
+#include "CConfig.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string readAll(const std::string& path) {
+    std::vector<char> content;
+    return ReadTestFile(path, content) ? std::string(content.begin(), content.end()) : std::string();
+}
+
+}  // namespace
+
+// 插入、覆盖、删除少量数据后，差量只包含变化部分且能重建出新文件
+TEST(DeltaTest, RoundTripReusesUnchangedBlocks) {
+    namespace fs = std::filesystem;
+    const std::string root = "test_delta_engine";
+    fs::remove_all(root);
+    const std::string base = MakeRandomData(600000, 1);
+    std::string target = base;
+    target.insert(1000, "inserted bytes shift everything after them");
+    target.replace(300000, 5000, MakeRandomData(5000, 2));
+    target.erase(450000, 777);
+    target += "appended tail";
+    ASSERT_TRUE(CreateTestFile(root + "/base.bin", base));
+    ASSERT_TRUE(CreateTestFile(root + "/target.bin", target));
+
+    DeltaSignature signature;
+    ASSERT_TRUE(CDeltaEngine::computeSignature(root + "/base.bin", 4096, signature, 4));
+    EXPECT_EQ(signature.blocks.size(), (base.size() + 4095) / 4096);
+    EXPECT_EQ(signature.blocks[3].weak,
+              CDeltaEngine::weakChecksum(reinterpret_cast<const uint8_t*>(base.data()) + 3 * 4096, 4096));
+
+    DeltaStats stats;
+    ASSERT_TRUE(CDeltaEngine::createDelta(root + "/target.bin", signature, "base.bin", root + "/target.bkdelta", &stats));
+    EXPECT_EQ(stats.copiedBytes + stats.insertedBytes, target.size());
+    EXPECT_LT(stats.insertedBytes, 30000u);
+    EXPECT_LT(stats.deltaSize, 32000u);
+
+    DeltaHeader header;
+    ASSERT_TRUE(CDeltaEngine::readDeltaHeader(root + "/target.bkdelta", header));
+    EXPECT_EQ(header.baseRef, "base.bin");
+    EXPECT_EQ(header.targetSize, target.size());
+    ASSERT_TRUE(CDeltaEngine::applyDelta(root + "/base.bin", root + "/target.bkdelta", root + "/out.bin"));
+    EXPECT_EQ(readAll(root + "/out.bin"), target);
+
+    // 与基准无关的数据、空文件也能正确重建
+    for (const std::string& other : {MakeRandomData(9000, 3), std::string()}) {
+        ASSERT_TRUE(CreateTestFile(root + "/other.bin", other));
+        ASSERT_TRUE(CDeltaEngine::createDelta(root + "/other.bin", signature, "base.bin", root + "/other.bkdelta", &stats));
+        EXPECT_EQ(stats.copiedBytes, 0u);
+        ASSERT_TRUE(CDeltaEngine::applyDelta(root + "/base.bin", root + "/other.bkdelta", root + "/out.bin"));
+        EXPECT_EQ(readAll(root + "/out.bin"), other);
+    }
+
+    // 基准变化后拒绝重建
+    ASSERT_TRUE(CreateTestFile(root + "/base.bin", base.substr(1)));
+    EXPECT_FALSE(CDeltaEngine::applyDelta(root + "/base.bin", root + "/target.bkdelta", root + "/out.bin"));
+    fs::remove_all(root);
+}
+
+// 快照模式下变化的大文件只保存差量，签名缓存复用，删除基准快照前差量被重建为完整文件
+TEST(DeltaTest, SnapshotStoresDeltaAgainstPreviousVersion) {
+    namespace fs = std::filesystem;
+    const std::string testRoot = "test_delta_snapshot";
+    const std::string destDir = testRoot + "/repo";
+    fs::remove_all(testRoot);
+
+    std::string content = MakeRandomData(400000, 4);
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/big.bin", content));
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/small.txt", "small file"));
+
+    auto config = std::make_shared<CConfig>();
+    config->setSourcePath(testRoot + "/src");
+    config->setDestinationPath(destDir);
+    config->setRecursiveSearch(true).setSnapshotEnabled(true).setDeltaEnabled(true).setDeltaMinSize(100000);
+    config->setThreadCount(2);
+
+    CBackup backup;
+    const std::string first = backup.doBackup(config);
+    ASSERT_FALSE(first.empty());
+    EXPECT_TRUE(fs::exists(first + "/src/big.bin"));
+
+    auto modify = [&](size_t offset, const std::string& data, int seconds) {
+        content.replace(offset, data.size(), data);
+        ASSERT_TRUE(CreateTestFile(testRoot + "/src/big.bin", content));
+        fs::last_write_time(testRoot + "/src/big.bin",
+                            fs::last_write_time(testRoot + "/src/big.bin") + std::chrono::seconds(seconds));
+    };
+    modify(200000, "changed in the second run", 5);
+    const std::string second = backup.doBackup(config);
+    ASSERT_FALSE(second.empty());
+    EXPECT_FALSE(fs::exists(second + "/src/big.bin"));
+    ASSERT_TRUE(fs::exists(second + "/src/big.bin.bkdelta"));
+    EXPECT_LT(fs::file_size(second + "/src/big.bin.bkdelta"), 40000u);
+    const std::string firstName = fs::path(first).filename().string();
+    const std::string cachePath = destDir + "/" + DELTA_SIGNATURE_DIR_NAME + "/" + firstName + "/src/big.bin.bksig";
+    ASSERT_TRUE(fs::exists(cachePath));
+    const auto cacheTime = fs::last_write_time(cachePath);
+
+    // 第三次仍以第一次的完整版本为基准（不形成差量链），并复用缓存的签名
+    modify(300000, "changed in the third run", 10);
+    const std::string third = backup.doBackup(config);
+    ASSERT_FALSE(third.empty());
+    ASSERT_TRUE(fs::exists(third + "/src/big.bin.bkdelta"));
+    DeltaHeader header;
+    ASSERT_TRUE(CDeltaEngine::readDeltaHeader(third + "/src/big.bin.bkdelta", header));
+    EXPECT_EQ(header.baseRef, firstName + "/src/big.bin");
+    EXPECT_EQ(fs::last_write_time(cachePath), cacheTime);
+
+    // 未变化时链接上一次的差量文件
+    const std::string fourth = backup.doBackup(config);
+    ASSERT_FALSE(fourth.empty());
+    EXPECT_GE(fs::hard_link_count(fourth + "/src/big.bin.bkdelta"), 2u);
+
+    BackupEntry entry("src", "", destDir, fs::path(fourth).filename().string(), "2025-01-01 00:00", false, false, false);
+    ASSERT_TRUE(backup.doRecovery(entry, testRoot + "/restore", ""));
+    EXPECT_EQ(readAll(testRoot + "/restore/src/big.bin"), content);
+    EXPECT_FALSE(fs::exists(testRoot + "/restore/src/big.bin.bkdelta"));
+    EXPECT_EQ(readAll(testRoot + "/restore/src/small.txt"), "small file");
+
+    // 清单中的差量文件缺失时还原失败，而不是少还原一个文件
+    const std::string thirdDelta = third + "/src/big.bin.bkdelta";
+    fs::rename(thirdDelta, thirdDelta + ".moved");
+    BackupEntry thirdEntry("src", "", destDir, fs::path(third).filename().string(), "2025-01-01 00:00", false, false,
+                           false);
+    EXPECT_FALSE(backup.doRecovery(thirdEntry, testRoot + "/restore_missing", ""));
+
+    // 依赖基准快照的差量无法重建时，基准快照与它的记录都保留
+    CBackupRecorder recorder(testRoot + "/records.json");
+    const BackupEntry firstEntry("src", "", destDir, firstName, "2025-01-01 00:00", false, false, false);
+    recorder.addBackupRecord(firstEntry);
+    const size_t recordCount = recorder.getBackupRecords().size();
+    EXPECT_FALSE(recorder.deleteBackupRecord(firstEntry));
+    EXPECT_EQ(recorder.getBackupRecords().size(), recordCount);
+    EXPECT_TRUE(fs::exists(first));
+    fs::rename(thirdDelta + ".moved", thirdDelta);
+
+    // 删除基准快照前，依赖它的差量都重建为完整文件
+    ASSERT_TRUE(detachSnapshotDeltas(destDir, firstName));
+    fs::remove_all(first);
+    EXPECT_FALSE(fs::exists(cachePath));
+    EXPECT_TRUE(fs::exists(fourth + "/src/big.bin"));
+    EXPECT_FALSE(fs::exists(fourth + "/src/big.bin.bkdelta"));
+    fs::remove_all(testRoot + "/restore");
+    ASSERT_TRUE(backup.doRecovery(entry, testRoot + "/restore", ""));
+    EXPECT_EQ(readAll(testRoot + "/restore/src/big.bin"), content);
+    fs::remove_all(testRoot);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include "DictCompress.h"
+#include "HuffmanCompress.h"
+#include "myPack.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 结构相同、取值不同的小 JSON 文件，类似源码树中的配置与清单
+std::string makeConfig(unsigned id, std::mt19937& rng) {
+    static const char* const kNames[] = {"alpha", "beta", "gamma", "delta", "omega", "sigma"};
+    std::string s = "{\n  \"id\": " + std::to_string(id) + ",\n";
+    s += "  \"name\": \"service-" + std::string(kNames[rng() % 6]) + "-" + std::to_string(rng() % 1000) + "\",\n";
+    s += "  \"enabled\": " + std::string(rng() % 2 ? "true" : "false") + ",\n";
+    s += "  \"endpoints\": [\n";
+    for (unsigned i = 0, n = 3 + rng() % 5; i < n; ++i) {
+        s += "    {\"host\": \"10.0." + std::to_string(rng() % 256) + "." + std::to_string(rng() % 256) +
+             "\", \"port\": " + std::to_string(1024 + rng() % 60000) +
+             ", \"protocol\": \"https\", \"timeout_ms\": " + std::to_string(rng() % 5000) +
+             ", \"retries\": " + std::to_string(rng() % 5) + "},\n";
+    }
+    s += "  ],\n  \"logging\": {\"level\": \"" + std::string(kNames[rng() % 6]) +
+         "\", \"format\": \"json\", \"rotate_daily\": true, \"max_files\": " + std::to_string(rng() % 30) + "}\n}\n";
+    return s;
+}
+
+std::vector<char> toVector(const std::string& s) {
+    return std::vector<char>(s.begin(), s.end());
+}
+
+}  // namespace
+
+// 字典训练、序列化与压缩往返；小文件用字典压缩明显优于逐个 Huffman
+TEST(DictionaryTest, TrainedDictionaryCompressesSmallFiles) {
+    std::mt19937 rng(7);
+    std::vector<std::vector<char>> samples;
+    for (unsigned i = 0; i < 200; ++i) samples.push_back(toVector(makeConfig(i, rng)));
+    auto dictionary = CDictionary::train(samples);
+    ASSERT_NE(dictionary, nullptr);
+    EXPECT_GT(dictionary->getContent().size(), 0u);
+    EXPECT_LE(dictionary->getContent().size(), CDictionary::kDefaultMaxSize);
+
+    std::vector<char> serialized;
+    dictionary->serialize(serialized);
+    auto loaded = CDictionary::deserialize(serialized.data(), serialized.size());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getId(), dictionary->getId());
+    EXPECT_EQ(loaded->getContent(), dictionary->getContent());
+    serialized.pop_back();
+    EXPECT_EQ(CDictionary::deserialize(serialized.data(), serialized.size()), nullptr);
+
+    // 压缩与解压使用各自恢复的字典，模拟包内只存放一份字典
+    DictCompress encoder(dictionary);
+    DictCompress decoder(loaded);
+    HuffmanCompress huffman;
+    size_t rawTotal = 0, dictTotal = 0, huffmanTotal = 0;
+    std::vector<char> encoded, decoded;
+    for (unsigned i = 0; i < 50; ++i) {
+        const std::vector<char> file = toVector(makeConfig(1000 + i, rng));
+        ASSERT_TRUE(encoder.compressData(file, encoded));
+        ASSERT_TRUE(decoder.decompressData(encoded, decoded));
+        ASSERT_EQ(decoded, file);
+        rawTotal += file.size();
+        dictTotal += encoded.size();
+        ASSERT_TRUE(huffman.compressData(file, encoded));
+        huffmanTotal += encoded.size();
+    }
+    EXPECT_LT(dictTotal * 3, rawTotal);
+    EXPECT_LT(dictTotal * 2, huffmanTotal);
+
+    // 空数据、极短数据、随机数据与超过字典内容的长重复都能往返
+    std::string noise(5000, '\0');
+    for (char& c : noise) c = static_cast<char>(rng());
+    std::string repeated;
+    while (repeated.size() < 300000) repeated += makeConfig(7, rng);
+    for (const std::string& data : {std::string(), std::string("ab"), noise, repeated}) {
+        ASSERT_TRUE(encoder.compressData(toVector(data), encoded));
+        ASSERT_TRUE(decoder.decompressData(encoded, decoded));
+        EXPECT_EQ(std::string(decoded.begin(), decoded.end()), data);
+    }
+    EXPECT_LE(encoded.size(), repeated.size() / 4);
+
+    // 没有字典或字典不一致时拒绝解压，没有字典时也无法压缩
+    DictCompress missing;
+    EXPECT_FALSE(missing.compressData(toVector(repeated), encoded));
+    samples.pop_back();
+    DictCompress other(CDictionary::train(samples));
+    ASSERT_TRUE(encoder.compressData(toVector(makeConfig(1, rng)), encoded));
+    EXPECT_FALSE(other.decompressData(encoded, decoded));
+    EXPECT_FALSE(missing.decompressData(encoded, decoded));
+}
+
+// 打包时从小文件训练字典，包内只存放一份（v3），大文件仍使用首选算法
+TEST(DictionaryTest, PackTrainsDictionaryForSmallEntries) {
+    namespace fs = std::filesystem;
+    const std::string root = "test_dictionary_pack";
+    fs::remove_all(root);
+    std::mt19937 rng(11);
+    std::vector<std::string> files;
+    std::vector<std::string> contents;
+    for (unsigned i = 0; i < 60; ++i) {
+        contents.push_back(makeConfig(i, rng));
+        files.push_back(root + "/src/conf" + std::to_string(i) + ".json");
+        ASSERT_TRUE(CreateTestFile(files.back(), contents.back()));
+    }
+    std::string large;
+    while (large.size() < 300000) large += makeConfig(99, rng);
+    contents.push_back(large);
+    files.push_back(root + "/src/large.json");
+    ASSERT_TRUE(CreateTestFile(files.back(), large));
+    const std::vector<PackSource> sources = {{root + "/src", "", files}};
+
+    auto packWith = [&](bool dictionary, const std::string& dest) {
+        fs::create_directories(dest);
+        myPack packer;
+        packer.setEntryCompression("Huffman4X");
+        packer.setDictionaryEnabled(dictionary);
+        return packer.pack(sources, dest);
+    };
+    const std::string plain = packWith(false, root + "/plain");
+    const std::string withDictionary = packWith(true, root + "/dict");
+    ASSERT_FALSE(plain.empty());
+    ASSERT_FALSE(withDictionary.empty());
+    std::vector<char> packed;
+    ASSERT_TRUE(ReadTestFile(withDictionary, packed));
+    EXPECT_EQ(static_cast<uint8_t>(packed[0]), PACK_FORMAT_V3);
+    ASSERT_TRUE(ReadTestFile(plain, packed));
+    EXPECT_EQ(static_cast<uint8_t>(packed[0]), PACK_FORMAT_V2);
+    EXPECT_LT(fs::file_size(withDictionary), fs::file_size(plain));
+
+    myPack unpacker;
+    ASSERT_TRUE(unpacker.unpack(withDictionary, root + "/out"));
+    std::vector<char> content;
+    for (size_t i = 0; i < files.size(); ++i) {
+        const std::string restored = root + "/out/" + fs::path(files[i]).filename().string();
+        ASSERT_TRUE(ReadTestFile(restored, content)) << restored;
+        EXPECT_EQ(std::string(content.begin(), content.end()), contents[i]) << restored;
+    }
+    fs::remove_all(root);
+}
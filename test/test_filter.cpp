@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include "CCodecPolicy.h"
+#include "CFilter.h"
+#include "myPack.h"
+#include "testUtils.h"
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 混合随机字节、0 字节游程、E8/E9 跳转与缓慢变化的 32 位整数，覆盖各过滤器的分支
+std::vector<uint8_t> makeMixedData(size_t size, std::mt19937& rng) {
+    std::vector<uint8_t> data;
+    uint32_t counter = 1000;
+    while (data.size() < size) {
+        switch (rng() % 4) {
+            case 0:
+                for (unsigned i = 0, n = rng() % 300; i < n; ++i) data.push_back(static_cast<uint8_t>(rng()));
+                break;
+            case 1:
+                data.insert(data.end(), rng() % 2000, 0);
+                break;
+            case 2: {
+                data.push_back(rng() % 2 ? 0xE8 : 0xE9);
+                const int32_t rel = static_cast<int32_t>(rng() % 0x2000000) - 0x1000000;
+                const uint8_t* p = reinterpret_cast<const uint8_t*>(&rel);
+                data.insert(data.end(), p, p + 4);
+                break;
+            }
+            default:
+                for (unsigned i = 0, n = rng() % 200; i < n; ++i) {
+                    counter += rng() % 16;
+                    const uint8_t* p = reinterpret_cast<const uint8_t*>(&counter);
+                    data.insert(data.end(), p, p + 4);
+                }
+                break;
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+// 把数据随机切成若干段依次送入流式过滤器
+std::vector<uint8_t> runSplit(IFilterStream& stream, const std::vector<uint8_t>& data, std::mt19937& rng, bool& ok) {
+    std::vector<uint8_t> out;
+    for (size_t offset = 0; offset < data.size();) {
+        const size_t n = std::min<size_t>(data.size() - offset, rng() % 5000);
+        stream.update(data.data() + offset, n, out);
+        offset += n;
+    }
+    ok = stream.finish(out);
+    return out;
+}
+
+// 4 字节小端递增计数器组成的数值表
+std::string makeNumericTable(size_t count) {
+    std::string table;
+    uint32_t value = 0x12345678;
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < count; ++i) {
+        value += 100 + rng() % 8;
+        table.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return table;
+}
+
+}  // namespace
+
+// 各过滤器整段与任意分段的变换结果一致，逆变换还原原始数据
+TEST(FilterTest, StreamingRoundTrip) {
+    std::mt19937 rng(3);
+    const std::vector<uint8_t> data = makeMixedData(300000, rng);
+    for (const char* text : {"delta", "delta:2", "delta:3", "delta:4", "delta:8", "delta:16", "delta:37",
+                             "zrle", "x86", "delta:4,zrle", "x86,delta:2,zrle"}) {
+        CFilterChain chain;
+        ASSERT_TRUE(CFilterChain::parse(text, chain)) << text;
+        std::vector<uint8_t> encoded, decoded;
+        chain.encode(data.data(), data.size(), encoded);
+        ASSERT_TRUE(chain.decode(encoded.data(), encoded.size(), decoded)) << text;
+        ASSERT_EQ(decoded, data) << text;
+
+        if (chain.getFilters().size() != 1) continue;
+        const FilterSpec& spec = chain.getFilters()[0];
+        bool ok = false;
+        EXPECT_EQ(runSplit(*CFilterChain::createEncoder(spec), data, rng, ok), encoded) << text;
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(runSplit(*CFilterChain::createDecoder(spec), encoded, rng, ok), data) << text;
+        EXPECT_TRUE(ok);
+    }
+
+    // 空输入
+    CFilterChain chain;
+    ASSERT_TRUE(CFilterChain::parse("delta:4,zrle,x86", chain));
+    std::vector<uint8_t> encoded, decoded;
+    chain.encode(nullptr, 0, encoded);
+    EXPECT_TRUE(encoded.empty());
+    EXPECT_TRUE(chain.decode(nullptr, 0, decoded));
+    EXPECT_TRUE(decoded.empty());
+}
+
+// 链描述与链头的解析；无效描述与损坏的链头被拒绝
+TEST(FilterTest, ParseAndHeader) {
+    CFilterChain chain;
+    ASSERT_TRUE(CFilterChain::parse("x86,delta:4,zrle", chain));
+    EXPECT_EQ(chain.toString(), "x86,delta:4,zrle");
+    ASSERT_TRUE(CFilterChain::parse("delta", chain));
+    EXPECT_EQ(chain.toString(), "delta:1");
+    ASSERT_TRUE(CFilterChain::parse("", chain));
+    EXPECT_TRUE(chain.empty());
+    for (const char* bad : {"delta:0", "delta:256", "delta:x", "lzma", "zrle:2", "zrle,zrle,zrle,zrle,zrle"}) {
+        EXPECT_FALSE(CFilterChain::parse(bad, chain)) << bad;
+    }
+
+    ASSERT_TRUE(CFilterChain::parse("delta:3,zrle", chain));
+    std::vector<char> header;
+    chain.writeHeader(header);
+    header.push_back('x');
+    CFilterChain loaded;
+    size_t consumed = 0;
+    ASSERT_TRUE(CFilterChain::readHeader(reinterpret_cast<const uint8_t*>(header.data()), header.size(), loaded, consumed));
+    EXPECT_EQ(consumed, header.size() - 1);
+    EXPECT_EQ(loaded.toString(), "delta:3,zrle");
+    header[1] = 9;  // 未知过滤器
+    EXPECT_FALSE(CFilterChain::readHeader(reinterpret_cast<const uint8_t*>(header.data()), header.size(), loaded, consumed));
+    EXPECT_FALSE(CFilterChain::readHeader(reinterpret_cast<const uint8_t*>(header.data()), 2, loaded, consumed));
+}
+
+// 各过滤器把目标数据的规律转成重复字节；损坏的游程被拒绝
+TEST(FilterTest, FiltersExposeRedundancy) {
+    // 调用同一函数的 CALL 指令转换后地址字节相同
+    std::vector<uint8_t> code;
+    const uint32_t target = 0x4000;
+    for (unsigned i = 0; i < 64; ++i) {
+        code.insert(code.end(), {0x90, 0x90, 0x90});
+        code.push_back(0xE8);
+        const uint32_t rel = target - static_cast<uint32_t>(code.size() + 4);
+        code.insert(code.end(), reinterpret_cast<const uint8_t*>(&rel), reinterpret_cast<const uint8_t*>(&rel) + 4);
+    }
+    CFilterChain x86({{FilterType::X86, 0}});
+    std::vector<uint8_t> encoded, decoded;
+    x86.encode(code.data(), code.size(), encoded);
+    ASSERT_EQ(encoded.size(), code.size());
+    for (size_t pos = 4; pos < encoded.size(); pos += 8) {
+        uint32_t address;
+        std::memcpy(&address, encoded.data() + pos, sizeof(address));
+        EXPECT_EQ(address, target) << pos;
+    }
+
+    // 数值表差分后只剩少数几种字节，0 字节游程压缩为几个字节
+    const std::string table = makeNumericTable(10000);
+    CFilterChain delta({{FilterType::Delta, 4}});
+    encoded.clear();
+    delta.encode(reinterpret_cast<const uint8_t*>(table.data()), table.size(), encoded);
+    EXPECT_LT(CCodecPolicy::entropy(reinterpret_cast<const char*>(encoded.data()), encoded.size()) + 3,
+              CCodecPolicy::entropy(table.data(), table.size()));
+    const std::vector<uint8_t> zeros(1 << 20, 0);
+    CFilterChain zrle({{FilterType::ZeroRle, 0}});
+    encoded.clear();
+    zrle.encode(zeros.data(), zeros.size(), encoded);
+    EXPECT_LE(encoded.size(), 8u);
+
+    // 游程长度被截断
+    encoded.back() |= 0x80;
+    EXPECT_FALSE(zrle.decode(encoded.data(), encoded.size(), decoded));
+
+    // 自动选择：可执行文件头 -> x86，数值表 -> delta:4，随机数据不过滤
+    code.insert(code.begin(), {0x7F, 'E', 'L', 'F'});
+    EXPECT_EQ(CFilterChain::detect(code.data(), code.size()).toString(), "x86");
+    EXPECT_EQ(CFilterChain::detect(reinterpret_cast<const uint8_t*>(table.data()), table.size()).toString(), "delta:4");
+    std::mt19937 rng(9);
+    std::vector<uint8_t> noise(100000);
+    for (uint8_t& b : noise) b = static_cast<uint8_t>(rng());
+    EXPECT_TRUE(CFilterChain::detect(noise.data(), noise.size()).empty());
+}
+
+// 打包时先过滤再压缩，过滤器链记录在块内，解包自动还原
+TEST(FilterTest, PackAppliesFilterChain) {
+    namespace fs = std::filesystem;
+    const std::string root = "test_filter_pack";
+    fs::remove_all(root);
+    // 超过一个块的数值表与带 0 填充的数据
+    const std::string table = makeNumericTable(PACK_BLOCK_SIZE / 4 + 50000);
+    std::mt19937 rng(13);
+    const std::vector<uint8_t> mixed = makeMixedData(200000, rng);
+    const std::vector<std::string> files = {root + "/src/table.bin", root + "/src/mixed.bin"};
+    const std::vector<std::string> contents = {table, std::string(mixed.begin(), mixed.end())};
+    for (size_t i = 0; i < files.size(); ++i) {
+        ASSERT_TRUE(CreateTestFile(files[i], contents[i]));
+    }
+    const std::vector<PackSource> sources = {{root + "/src", "", files}};
+
+    auto packWith = [&](const std::string& filters, const std::string& dest) {
+        fs::create_directories(dest);
+        myPack packer;
+        packer.setEntryCompression("Huffman4X");
+        packer.setEntryFilters(filters);
+        return packer.pack(sources, dest);
+    };
+    const std::string plain = packWith("", root + "/plain");
+    const std::string delta = packWith("delta:4", root + "/delta");
+    const std::string detected = packWith("auto", root + "/auto");
+    ASSERT_FALSE(plain.empty());
+    ASSERT_FALSE(delta.empty());
+    ASSERT_FALSE(detected.empty());
+    EXPECT_LT(fs::file_size(delta) * 2, fs::file_size(plain));
+    EXPECT_LT(fs::file_size(detected) * 2, fs::file_size(plain));
+    EXPECT_TRUE(packWith("delta:0", root + "/bad").empty());
+
+    for (const std::string& packed : {delta, detected}) {
+        const std::string out = root + "/out_" + fs::path(packed).parent_path().filename().string();
+        myPack unpacker;
+        ASSERT_TRUE(unpacker.unpack(packed, out));
+        std::vector<char> content;
+        for (size_t i = 0; i < files.size(); ++i) {
+            const std::string restored = out + "/" + fs::path(files[i]).filename().string();
+            ASSERT_TRUE(ReadTestFile(restored, content)) << restored;
+            EXPECT_TRUE(std::string(content.begin(), content.end()) == contents[i]) << restored;
+        }
+    }
+    fs::remove_all(root);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "FSECompress.h"
+#include "Huffman4XCompress.h"
+#include "BWTCompress.h"
+#include "HuffmanCompress.h"
+#include "CompressFactory.h"
+#include "testUtils.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 类似文本的语料：偏斜的字母分布
+std::string makeText(size_t size) {
+    static const char* words[] = {"backup ", "restore ", "the ", "file ", "pack ", "of ", "and ", "a ",
+                                  "compress ", "stream\n", "entropy ", "table "};
+    std::mt19937 rng(7);
+    std::string text;
+    while (text.size() < size) {
+        text += words[rng() % 12];
+    }
+    text.resize(size);
+    return text;
+}
+
+}  // namespace
+
+// 各种分布的内存数据都能还原，包括空数据、单一字节、随机数据与跨块数据
+TEST(FseTest, CompressDataRoundTrip) {
+    FSECompress fse;
+    std::string skewed(3000, 'a');
+    for (size_t i = 0; i < skewed.size(); i += 97) skewed[i] = 'b';
+    skewed += "z";  // 出现一次的稀有符号
+    for (const std::string& text : {std::string(), std::string("xy"), std::string(70000, 'z'), skewed,
+                                    makeText(1000), MakeRandomData(5000, 11),
+                                    makeText(FSECompress::kBlockSize * 2 + 333)}) {
+        const std::vector<char> source(text.begin(), text.end());
+        std::vector<char> compressed, restored;
+        ASSERT_TRUE(fse.compressData(source, compressed));
+        ASSERT_TRUE(fse.decompressData(compressed, restored));
+        EXPECT_TRUE(restored == source) << "size " << text.size();
+    }
+
+    // 截断或损坏的数据应当解压失败
+    const std::string text = makeText(20000);
+    std::vector<char> compressed, restored;
+    ASSERT_TRUE(fse.compressData(std::vector<char>(text.begin(), text.end()), compressed));
+    std::vector<char> truncated(compressed.begin(), compressed.begin() + compressed.size() / 2);
+    EXPECT_FALSE(fse.decompressData(truncated, restored));
+    compressed[compressed.size() - 10] ^= 0x5A;
+    EXPECT_FALSE(fse.decompressData(compressed, restored));
+}
+
+// 文本压缩得比 Huffman 更小，随机数据按原样存放只多出头部开销
+TEST(FseTest, CompressesTighterThanHuffman) {
+    const std::string text = makeText(200 * 1024);
+    const std::vector<char> source(text.begin(), text.end());
+    FSECompress fse;
+    HuffmanCompress huffman;
+    std::vector<char> fseOut, huffmanOut;
+    ASSERT_TRUE(fse.compressData(source, fseOut));
+    ASSERT_TRUE(huffman.compressData(source, huffmanOut));
+    EXPECT_LT(fseOut.size(), huffmanOut.size());
+
+    const std::string random = MakeRandomData(FSECompress::kBlockSize, 11);
+    std::vector<char> randomOut;
+    ASSERT_TRUE(fse.compressData(std::vector<char>(random.begin(), random.end()), randomOut));
+    EXPECT_LE(randomOut.size(), random.size() + sizeof(BlockHead) + 16);
+}
+
+// 文件接口与工厂注册
+TEST(FseTest, CompressFileRoundTrip) {
+    const std::string sourceFile = "test_fse_source.txt";
+    const std::string restoredFile = "test_fse_restored.txt";
+    const std::string content = makeText(FSECompress::kBlockSize * 3 + 17);
+    ASSERT_TRUE(CreateTestFile(sourceFile, content));
+
+    auto compressor = CompressFactory::createCompress("FSE");
+    ASSERT_NE(compressor, nullptr);
+    EXPECT_EQ(compressor->getCompressType(), CompressType::FSE);
+    const std::string compressedFile = compressor->compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty());
+    EXPECT_LT(std::filesystem::file_size(compressedFile), content.size());
+    EXPECT_TRUE(CompressFactory::isCompressedFile(compressedFile));
+    EXPECT_EQ(CompressFactory::getCompressType(compressedFile), "FSE");
+
+    ASSERT_TRUE(compressor->decompressFile(compressedFile, restoredFile));
+    std::vector<char> restored;
+    ASSERT_TRUE(ReadTestFile(restoredFile, restored));
+    EXPECT_EQ(std::string(restored.begin(), restored.end()), content);
+
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(restoredFile);
+}
+
+// 块头记录的原始长度超过分块大小时解码失败，不按损坏的长度分配内存
+TEST(FseTest, DecodersRejectOversizedLength) {
+    using DecodeFn = bool (*)(const uint8_t*, size_t, size_t, std::vector<uint8_t>&, size_t&);
+    using EncodeFn = void (*)(const uint8_t*, size_t, std::vector<uint8_t>&);
+    const struct {
+        const char* name;
+        EncodeFn encode;
+        DecodeFn decode;
+        std::string data;
+    } codecs[] = {
+        {"fse-rle", FseCodec::compressBlock, FseCodec::decompressBlock, std::string(1000, 'a')},
+        {"fse", FseCodec::compressBlock, FseCodec::decompressBlock, makeText(1000)},
+        {"huf4x-rle", Huffman4XCodec::compressBlock, Huffman4XCodec::decompressBlock, std::string(1000, 'a')},
+        {"huf4x", Huffman4XCodec::compressBlock, Huffman4XCodec::decompressBlock, makeText(1000)},
+        {"bwt", BwtCodec::compressBlock, BwtCodec::decompressBlock, makeText(1000)},
+    };
+    for (const auto& codec : codecs) {
+        std::vector<uint8_t> encoded;
+        codec.encode(reinterpret_cast<const uint8_t*>(codec.data.data()), codec.data.size(), encoded);
+        std::vector<uint8_t> out;
+        size_t consumed = 0;
+        ASSERT_TRUE(codec.decode(encoded.data(), encoded.size(), codec.data.size(), out, consumed)) << codec.name;
+        EXPECT_FALSE(codec.decode(encoded.data(), encoded.size(), codec.data.size() - 1, out, consumed)) << codec.name;
+
+        // 长度字段（模式字节之后的 4 字节）损坏为接近 4GB
+        encoded[4] = 0xFF;
+        out.clear();
+        EXPECT_FALSE(codec.decode(encoded.data(), encoded.size(), FSECompress::kBlockSize, out, consumed)) << codec.name;
+        EXPECT_TRUE(out.empty()) << codec.name;
+    }
+
+    // 文件头中的分块大小同样不可超过算法的分块大小
+    FSECompress fse;
+    const std::string text = makeText(5000);
+    std::vector<char> compressed, restored;
+    ASSERT_TRUE(fse.compressData(std::vector<char>(text.begin(), text.end()), compressed));
+    compressed[offsetof(BlockHead, blockSize) + 3] = 0x7F;
+    EXPECT_FALSE(fse.decompressData(compressed, restored));
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "CHash.h"
+
+#include <string>
+#include <vector>
+
+static uint64_t xxh64(const std::string& s, uint64_t seed = 0) {
+    return CXXHash64::hash(s.data(), s.size(), seed);
+}
+
+// 与 xxHash 参考实现的输出比对
+TEST(HashTest, XXH64ReferenceVectors) {
+    EXPECT_EQ(xxh64(""), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(xxh64("a"), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(xxh64("abc"), 0x44BC2CF5AD770999ULL);
+
+    std::string repeated;
+    for (int i = 0; i < 5; ++i) repeated += "0123456789abcdef";
+    EXPECT_EQ(xxh64(repeated), 0x0D4CC7D5057880DFULL);
+    EXPECT_EQ(xxh64("The quick brown fox jumps over the lazy dog", 7), 0x73229526FB86A735ULL);
+}
+
+// 分段追加与一次性计算结果相同
+TEST(HashTest, XXH64StreamingMatchesOneShot) {
+    std::string data;
+    for (int r = 0; r < 4; ++r) {
+        for (int i = 0; i < 256; ++i) data.push_back(static_cast<char>(i));
+    }
+    data += "tail";
+    EXPECT_EQ(xxh64(data), 0xD45352830E83DF92ULL);
+
+    for (size_t step : {1u, 3u, 31u, 33u, 100u}) {
+        CXXHash64 state;
+        for (size_t pos = 0; pos < data.size(); pos += step) {
+            state.update(data.data() + pos, std::min(step, data.size() - pos));
+        }
+        EXPECT_EQ(state.digest(), 0xD45352830E83DF92ULL) << "step " << step;
+    }
+}
+
+// 每个字节为 (i * 7 + 3) & 0xFF 的测试数据
+static std::string makePattern(size_t len) {
+    std::string data(len, '\0');
+    for (size_t i = 0; i < len; ++i) data[i] = static_cast<char>((i * 7 + 3) & 0xFF);
+    return data;
+}
+
+// 与 XXH3-128 参考实现的输出比对，覆盖各长度区间（0、1~3、4~8、9~16、17~128、129~240 与长输入）
+TEST(HashTest, XXH3_128ReferenceVectors) {
+    auto xxh128 = [](const std::string& s) { return CXXHash128::hash(s.data(), s.size()).toHex(); };
+    EXPECT_EQ(xxh128(""), "99aa06d3014798d86001c324468d497f");
+    EXPECT_EQ(xxh128("a"), "a96faf705af16834e6c632b61e964e1f");
+    EXPECT_EQ(xxh128("abc"), "06b05ab6733a618578af5f94892f3950");
+    EXPECT_EQ(xxh128("The quick brown fox jumps over the lazy dog"), "ddd650205ca3e7fa24a1cc2e3a8a7651");
+    EXPECT_EQ(xxh128(makePattern(12)), "f7314c62630bc633381c69c9c2498dfa");
+    EXPECT_EQ(xxh128(makePattern(100)), "2207ed96998d91f20cc97f05750182b2");
+    EXPECT_EQ(xxh128(makePattern(200)), "32200a52a918beaf380142cdd5843bbd");
+    EXPECT_EQ(xxh128(makePattern(1000)), "6bcc7eff62da44c26c4f14bd97bd9e82");
+    EXPECT_EQ(xxh128(makePattern(5000)), "c98ae385d09887cc799aaddd7339581d");
+}
+
+// 分段追加与一次性计算结果相同，包括跨越内部缓冲区与条带块边界的分段
+TEST(HashTest, XXH3_128StreamingMatchesOneShot) {
+    for (size_t len : {0u, 5u, 240u, 241u, 256u, 257u, 1024u, 1025u, 5000u}) {
+        const std::string data = makePattern(len);
+        const Hash128 expected = CXXHash128::hash(data.data(), data.size());
+        for (size_t step : {1u, 63u, 64u, 65u, 256u, 300u, 4096u}) {
+            CXXHash128 state;
+            for (size_t pos = 0; pos < data.size(); pos += step) {
+                state.update(data.data() + pos, std::min(step, data.size() - pos));
+            }
+            EXPECT_EQ(state.digest(), expected) << "len " << len << " step " << step;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "CHistogram.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+CHistogram::Counts naiveCount(const std::vector<uint8_t>& data) {
+    CHistogram::Counts counts{};
+    for (uint8_t b : data) {
+        ++counts[b];
+    }
+    return counts;
+}
+
+}  // namespace
+
+// 各实现与逐字节计数的结果一致：随机数据、长串重复字节、不足一个向量的尾部
+TEST(HistogramTest, KernelsMatchNaiveCount) {
+    std::mt19937 rng(3);
+    std::vector<uint8_t> data(100000 + 29);
+    for (size_t i = 0; i < data.size(); ++i) {
+        // 前半部分随机，后半部分是长串重复字节夹杂零星变化
+        data[i] = i < data.size() / 2 ? static_cast<uint8_t>(rng()) : static_cast<uint8_t>((i / 4096) + (i % 1000 == 0));
+    }
+    const CHistogram::Counts expected = naiveCount(data);
+
+    for (HistogramKernel kernel : {HistogramKernel::Scalar, HistogramKernel::Avx2Runs}) {
+        for (size_t offset : {size_t(0), size_t(1), size_t(7)}) {
+            CHistogram::Counts counts{};
+            if (!CHistogram::countWith(kernel, data.data(), offset, counts)) {
+                break;  // CPU 不支持该实现
+            }
+            ASSERT_TRUE(CHistogram::countWith(kernel, data.data() + offset, data.size() - offset, counts));
+            EXPECT_EQ(counts, expected) << CHistogram::kernelName(kernel) << " offset " << offset;
+        }
+    }
+
+    // count() 在已有计数上累加
+    CHistogram::Counts counts{};
+    CHistogram::count(data.data(), data.size(), counts);
+    CHistogram::count(data.data(), 0, counts);
+    CHistogram::count(data.data(), data.size(), counts);
+    for (size_t s = 0; s < 256; ++s) {
+        EXPECT_EQ(counts[s], expected[s] * 2);
+    }
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "CLogger.h"
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+
+// 截获日志输出，测试结束时恢复默认输出与级别
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_previousLevel = CLogger::instance().getLevel();
+        CLogger::instance().setSink([this](LogLevel level, const std::string& message) {
+            m_messages.emplace_back(level, message);
+        });
+    }
+    void TearDown() override {
+        CLogger::instance().setSink(nullptr);
+        CLogger::instance().setLevel(m_previousLevel);
+    }
+
+    LogLevel m_previousLevel = LogLevel::Info;
+    std::vector<std::pair<LogLevel, std::string>> m_messages;
+};
+
+// 低于当前级别的消息不输出，且不会格式化
+TEST_F(LoggerTest, FiltersByLevel) {
+    CLogger::instance().setLevel(LogLevel::Info);
+    int formatted = 0;
+    auto count = [&]() { ++formatted; return "x"; };
+    LOG_DEBUG("debug " << count());
+    LOG_INFO("info " << 1);
+    LOG_ERROR("error " << 2);
+    CLogger::instance().flush();
+
+    EXPECT_EQ(formatted, 0);
+    ASSERT_EQ(m_messages.size(), 2u);
+    EXPECT_EQ(m_messages[0].first, LogLevel::Info);
+    EXPECT_EQ(m_messages[0].second, "info 1");
+    EXPECT_EQ(m_messages[1].first, LogLevel::Error);
+    EXPECT_EQ(m_messages[1].second, "error 2");
+}
+
+// 消息按放入顺序写出，开启 Debug 后逐文件信息可见
+TEST_F(LoggerTest, PreservesOrder) {
+    CLogger::instance().setLevel(LogLevel::Debug);
+    const uint64_t droppedBefore = CLogger::instance().getDroppedCount();
+    for (int i = 0; i < 1000; ++i) {
+        LOG_DEBUG("file " << i);
+    }
+    CLogger::instance().flush();
+
+    const uint64_t dropped = CLogger::instance().getDroppedCount() - droppedBefore;
+    size_t fileMessages = 0;
+    int last = -1;
+    for (const auto& message : m_messages) {
+        if (message.second.rfind("file ", 0) != 0) continue;
+        const int index = std::stoi(message.second.substr(5));
+        EXPECT_GT(index, last);
+        last = index;
+        ++fileMessages;
+    }
+    // 缓冲区足够大，正常情况下不会丢弃
+    EXPECT_EQ(fileMessages + dropped, 1000u);
+}
+
+// 缓冲区满时丢弃 Debug 消息，但 Error 等待空间，不会丢弃
+TEST_F(LoggerTest, NeverDropsErrors) {
+    CLogger::instance().setLevel(LogLevel::Debug);
+    // 输出函数在第一条消息处阻塞，期间放入的消息塞满缓冲区
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    CLogger::instance().setSink([this, gate](LogLevel level, const std::string& message) {
+        if (message == "blocker") gate.wait();
+        m_messages.emplace_back(level, message);
+    });
+    const uint64_t droppedBefore = CLogger::instance().getDroppedCount();
+    LOG_INFO("blocker");
+    for (size_t i = 0; i < 2 * CLogger::kDefaultCapacity; ++i) {
+        LOG_DEBUG("file " << i);
+    }
+    std::thread errorThread([] { LOG_ERROR("backup failed"); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    release.set_value();
+    errorThread.join();
+    CLogger::instance().flush();
+
+    EXPECT_GT(CLogger::instance().getDroppedCount(), droppedBefore);
+    size_t errors = 0;
+    for (const auto& message : m_messages) {
+        if (message.first == LogLevel::Error && message.second == "backup failed") ++errors;
+    }
+    EXPECT_EQ(errors, 1u);
+}
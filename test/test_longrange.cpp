@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "LongRangeCompress.h"
+#include "CompressFactory.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// 相隔多个分段的重复片段被找出，只有一份计入压缩结果
+TEST(LongRangeTest, FindsRepeatsAcrossSegments) {
+    const std::string chunk = MakeRandomData(300000, 1);
+    std::string source = chunk + MakeRandomData(9 * 1024 * 1024, 2);
+    source += chunk;                       // 距离约 9MB，跨过两个分段
+    source += "x" + chunk.substr(1000);    // 错开对齐的重复
+    source += std::string(100000, '\0');
+
+    const std::string sourceFile = "test_longrange_source.bin";
+    const std::string restoredFile = "test_longrange_restored.bin";
+    ASSERT_TRUE(CreateTestFile(sourceFile, source));
+    auto compressor = CompressFactory::createCompress("LongRange");
+    const std::string compressedFile = compressor->compressFile(sourceFile);
+    ASSERT_FALSE(compressedFile.empty());
+    EXPECT_LT(std::filesystem::file_size(compressedFile), source.size() - 2 * chunk.size() + 50000);
+    ASSERT_TRUE(compressor->decompressFile(compressedFile, restoredFile));
+    std::vector<char> restored;
+    ASSERT_TRUE(ReadTestFile(restoredFile, restored));
+    EXPECT_TRUE(std::string(restored.begin(), restored.end()) == source);
+    CleanupTestFile(sourceFile);
+    CleanupTestFile(compressedFile);
+    CleanupTestFile(restoredFile);
+}
+
+// 内存数据往返、极小的内存预算、损坏检测
+TEST(LongRangeTest, DataRoundTrip) {
+    const std::string text = "SELECT * FROM orders WHERE id = 42;\n";
+    std::string source;
+    while (source.size() < 200000) source += text + std::to_string(source.size() % 977) + "\n";
+    source += source.substr(0, 50000);
+
+    for (size_t budget : {size_t(0), size_t(1) << 20, LongRangeCompress::kDefaultMemoryBudget}) {
+        LongRangeCompress codec(budget);
+        std::vector<char> compressed, restored;
+        ASSERT_TRUE(codec.compressData(std::vector<char>(source.begin(), source.end()), compressed));
+        EXPECT_LT(compressed.size(), source.size() / 2);
+        ASSERT_TRUE(codec.decompressData(compressed, restored));
+        EXPECT_TRUE(std::string(restored.begin(), restored.end()) == source);
+
+        compressed[compressed.size() / 2] ^= 0x20;
+        EXPECT_FALSE(codec.decompressData(compressed, restored));
+    }
+
+    LongRangeCompress codec;
+    for (const std::string& small : {std::string(), std::string("y"), std::string(70, 'z'), MakeRandomData(5000, 3)}) {
+        std::vector<char> c, r;
+        ASSERT_TRUE(codec.compressData(std::vector<char>(small.begin(), small.end()), c));
+        ASSERT_TRUE(codec.decompressData(c, r));
+        EXPECT_EQ(std::string(r.begin(), r.end()), small);
+    }
+}
+
+// 分块编码的流：后面的块引用前面块中的内容，解码端按同样的顺序重建；超出窗口的内容不被引用
+TEST(LongRangeTest, StreamMatchesAcrossBlocks) {
+    constexpr size_t kBlock = 1024 * 1024;
+    const std::string chunk = MakeRandomData(300000, 1);
+    std::string source = chunk + MakeRandomData(3 * kBlock, 2) + chunk;
+    source += MakeRandomData(4 * kBlock - source.size() % kBlock, 3);
+
+    for (size_t window : {size_t(8) * kBlock, size_t(2) * kBlock}) {
+        LongRangeStream encoder(0, window, source.size());
+        LongRangeStream decoder(0, window);
+        uint64_t stored = 0;
+        std::string restored;
+        std::vector<char> encoded, decoded;
+        for (size_t offset = 0; offset < source.size(); offset += kBlock) {
+            const size_t len = std::min(kBlock, source.size() - offset);
+            encoder.encodeBlock(reinterpret_cast<const uint8_t*>(source.data()) + offset, len, encoded);
+            stored += encoded.size();
+            ASSERT_TRUE(decoder.decodeBlock(encoded.data(), encoded.size(), decoded));
+            restored.append(decoded.begin(), decoded.end());
+        }
+        EXPECT_TRUE(restored == source) << "window " << window;
+        if (window > 4 * kBlock) {
+            EXPECT_LT(stored, source.size() - chunk.size() + 10000);
+        } else {
+            EXPECT_GT(stored, source.size());
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "CBackup.h"
+#include "CMetrics.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <nlohmann/json.hpp>
+
+// 未绑定统计对象时计时器不记录任何数据
+TEST(MetricsTest, TimerIsNoOpWhenUnbound) {
+    CMetrics metrics;
+    {
+        CStageTimer timer(Stage::Compress);
+        timer.addBytes(100);
+    }
+    EXPECT_EQ(metrics.getStage(Stage::Compress).calls, 0u);
+    EXPECT_EQ(CMetrics::current(), nullptr);
+
+    // 绑定但未启用时同样不记录
+    metrics.setEnabled(false);
+    {
+        CMetrics::Bind bind(&metrics);
+        EXPECT_EQ(CMetrics::current(), nullptr);
+        CStageTimer timer(Stage::Compress);
+        timer.addBytes(100);
+    }
+    EXPECT_EQ(metrics.getStage(Stage::Compress).bytes, 0u);
+}
+
+// 绑定后计时器按阶段累计，直方图按微秒对数分桶
+TEST(MetricsTest, RecordsStagesAndHistogram) {
+    CMetrics metrics;
+    {
+        CMetrics::Bind bind(&metrics);
+        CStageTimer timer(Stage::Read);
+        timer.addBytes(4096);
+        timer.addFiles(2);
+    }
+    EXPECT_EQ(CMetrics::current(), nullptr);  // 析构后恢复之前的绑定
+    const auto read = metrics.getStage(Stage::Read);
+    EXPECT_EQ(read.calls, 1u);
+    EXPECT_EQ(read.bytes, 4096u);
+    EXPECT_EQ(read.files, 2u);
+
+    metrics.recordFileLatency(500);          // 0us -> 桶0
+    metrics.recordFileLatency(5000);         // 5us -> 桶2
+    metrics.recordFileLatency(3000000);      // 3000us -> 桶11
+    const auto histogram = metrics.getLatencyHistogram();
+    EXPECT_EQ(histogram[0], 1u);
+    EXPECT_EQ(histogram[2], 1u);
+    EXPECT_EQ(histogram[11], 1u);
+
+    metrics.reset();
+    EXPECT_EQ(metrics.getStage(Stage::Read).calls, 0u);
+}
+
+// 启用统计的备份任务输出包含各阶段数据的JSON报告
+TEST(MetricsTest, BackupWritesReport) {
+    const std::string testRoot = "test_metrics_dir";
+    std::filesystem::remove_all(testRoot);
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/a.txt", std::string(10000, 'a')));
+    ASSERT_TRUE(CreateTestFile(testRoot + "/src/sub/b.txt", "hello metrics"));
+
+    const std::string reportPath = testRoot + "/report.json";
+    auto config = std::make_shared<CConfig>(testRoot + "/src", testRoot + "/dest");
+    config->setRecursiveSearch(true).setPackingEnabled(true).setPackType("Basic")
+          .setCompressionEnabled(true).setCompressionType("Huffman")
+          .setMetricsEnabled(true).setMetricsReportPath(reportPath);
+
+    CBackup backup;
+    ASSERT_FALSE(backup.doBackup(config).empty());
+
+    auto metrics = backup.getMetrics();
+    EXPECT_EQ(metrics->getStage(Stage::Walk).files, 4u);
+    EXPECT_EQ(metrics->getStage(Stage::Read).bytes, 10000u + 13u);
+    EXPECT_EQ(metrics->getStage(Stage::Read).files, 2u);
+    EXPECT_EQ(metrics->getStage(Stage::Compress).files, 1u);
+
+    ASSERT_TRUE(std::filesystem::exists(reportPath));
+    std::ifstream in(reportPath);
+    const nlohmann::json report = nlohmann::json::parse(in);
+    EXPECT_TRUE(report["stages"].contains("pack"));
+    EXPECT_TRUE(report["stages"].contains("compress"));
+    EXPECT_FALSE(report["file_latency_histogram"].empty());
+
+    std::filesystem::remove_all(testRoot);
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
 #include "myPack.h"
+#include "CCodecPolicy.h"
+#include "CLogger.h"
 #include "testUtils.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -149,4 +152,371 @@ TEST(myPackTest, UnpackNonExistentFile) {
     } catch (...) {
         // 清理失败时忽略错误
     }
-}
\ No newline at end of file
+}
+// 稀疏文件：只存放数据区间，解包后内容一致
+TEST(myPackTest, SparseFileRoundTrip) {
+    const std::string testDir = "test_sparse_dir";
+    const std::string packDestDir = "test_sparse_pack_dest";
+    const std::string unpackDestDir = "test_sparse_unpack_dest";
+    std::filesystem::remove_all(testDir);
+    std::filesystem::create_directories(testDir);
+    std::filesystem::create_directories(packDestDir);
+    std::filesystem::create_directories(unpackDestDir);
+
+    // 头部、中间各一段数据，末尾留空洞
+    const std::string sparseFile = testDir + "/disk.img";
+    const uint64_t logicalSize = 8 * 1024 * 1024;
+    {
+        std::ofstream out(sparseFile, std::ios::binary);
+        out << "header";
+        out.seekp(3 * 1024 * 1024);
+        out << "middle";
+    }
+    ASSERT_TRUE(CSparseFile::setLength(sparseFile, logicalSize));
+
+    // 扫描全零块的结果与文件系统无关
+    const std::vector<FileExtent> scanned = CSparseFile::scanZeroBlocks(sparseFile, logicalSize);
+    ASSERT_EQ(scanned.size(), 2u);
+    EXPECT_EQ(scanned[0], (FileExtent{0, CSparseFile::kBlockSize}));
+    EXPECT_EQ(scanned[1], (FileExtent{3 * 1024 * 1024, CSparseFile::kBlockSize}));
+
+    myPack packer;
+    const std::string packedFilePath = packer.pack(std::vector<std::string>{sparseFile}, packDestDir);
+    ASSERT_FALSE(packedFilePath.empty());
+    // 文件系统支持空洞时，包中不包含空洞部分
+    const std::vector<FileExtent> mapped = CSparseFile::mapDataExtents(sparseFile, logicalSize);
+    if (!CSparseFile::isDense(mapped, logicalSize)) {
+        EXPECT_LT(std::filesystem::file_size(packedFilePath), logicalSize / 2);
+    }
+
+    ASSERT_TRUE(packer.unpack(packedFilePath, unpackDestDir));
+    const std::string restored = unpackDestDir + "/disk.img";
+    ASSERT_EQ(std::filesystem::file_size(restored), logicalSize);
+    std::vector<char> original, content;
+    ASSERT_TRUE(ReadTestFile(sparseFile, original));
+    ASSERT_TRUE(ReadTestFile(restored, content));
+    EXPECT_TRUE(original == content);
+
+    std::filesystem::remove_all(testDir);
+    std::filesystem::remove_all(packDestDir);
+    std::filesystem::remove_all(unpackDestDir);
+}
+
+#ifndef _WIN32
+// 硬链接的内容只存放一次，符号链接按链接本身存放
+TEST(myPackTest, HardLinksAndSymlinks) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_links_dir";
+    const std::string packDestDir = "test_links_pack_dest";
+    const std::string unpackDestDir = "test_links_unpack_dest";
+    fs::remove_all(testDir);
+    fs::remove_all(unpackDestDir);
+    fs::create_directories(packDestDir);
+    fs::create_directories(unpackDestDir);
+
+    const std::string content(64 * 1024, 'x');
+    ASSERT_TRUE(CreateTestFile(testDir + "/a.bin", content));
+    fs::create_directories(testDir + "/sub");
+    fs::create_hard_link(testDir + "/a.bin", testDir + "/sub/b.bin");
+    fs::create_symlink("a.bin", testDir + "/link.bin");
+    fs::create_directory_symlink("sub", testDir + "/sublink");
+
+    const std::vector<std::string> files = {testDir + "/a.bin", testDir + "/link.bin", testDir + "/sub",
+                                            testDir + "/sub/b.bin", testDir + "/sublink"};
+    myPack packer;
+    const std::string packedFilePath = packer.pack(files, packDestDir);
+    ASSERT_FALSE(packedFilePath.empty());
+    // 两个硬链接只存放一份内容
+    EXPECT_LT(fs::file_size(packedFilePath), content.size() + 1024);
+
+    ASSERT_TRUE(packer.unpack(packedFilePath, unpackDestDir));
+    std::vector<char> restored;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/sub/b.bin", restored));
+    EXPECT_EQ(std::string(restored.begin(), restored.end()), content);
+    EXPECT_TRUE(fs::equivalent(unpackDestDir + "/a.bin", unpackDestDir + "/sub/b.bin"));
+    ASSERT_TRUE(fs::is_symlink(unpackDestDir + "/link.bin"));
+    EXPECT_EQ(fs::read_symlink(unpackDestDir + "/link.bin"), fs::path("a.bin"));
+    ASSERT_TRUE(fs::is_symlink(unpackDestDir + "/sublink"));
+    EXPECT_EQ(fs::read_symlink(unpackDestDir + "/sublink"), fs::path("sub"));
+
+    fs::remove_all(testDir);
+    fs::remove_all(packDestDir);
+    fs::remove_all(unpackDestDir);
+}
+
+// 包中的符号链接在全部文件解出后才创建：链接目录之下的条目不会经由链接写到解包目录之外
+TEST(myPackTest, SymlinkedParentsStayInsideDestination) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_link_escape_dir";
+    const std::string unpackDestDir = "test_link_escape_unpack_dest";
+    fs::remove_all(testDir);
+    fs::remove_all(unpackDestDir);
+    fs::create_directories(testDir + "/outside");
+    fs::create_directories(testDir + "/pack");
+
+    // 以 src 为源根打包：先是指向源根之外的目录链接 evil，再是经由它的普通文件 evil/x.txt
+    ASSERT_TRUE(CreateTestFile(testDir + "/src/keep.txt", "keep"));
+    fs::create_directory_symlink(fs::absolute(testDir + "/outside"), testDir + "/src/evil");
+    ASSERT_TRUE(CreateTestFile(testDir + "/src/evil/x.txt", "payload"));
+    const std::vector<PackSource> sources = {{testDir + "/src", "", {testDir + "/src/evil", testDir + "/src/evil/x.txt",
+                                                                     testDir + "/src/keep.txt"}}};
+    myPack packer;
+    const std::string packedFilePath = packer.pack(sources, testDir + "/pack");
+    ASSERT_FALSE(packedFilePath.empty());
+    fs::remove(testDir + "/outside/x.txt");
+
+    ASSERT_TRUE(packer.unpack(packedFilePath, unpackDestDir));
+    EXPECT_FALSE(fs::exists(testDir + "/outside/x.txt"));
+    EXPECT_FALSE(fs::is_symlink(unpackDestDir + "/evil"));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/evil/x.txt", content));
+    EXPECT_EQ(std::string(content.begin(), content.end()), "payload");
+
+    fs::remove_all(testDir);
+    fs::remove_all(unpackDestDir);
+}
+#endif
+
+// 内容相同的文件只存放一份，解包后每个文件都完整
+TEST(myPackTest, DeduplicatesIdenticalFiles) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_dedup_dir";
+    const std::string packDestDir = "test_dedup_pack_dest";
+    const std::string unpackDestDir = "test_dedup_unpack_dest";
+    fs::remove_all(testDir);
+    fs::remove_all(unpackDestDir);
+    fs::create_directories(packDestDir);
+    fs::create_directories(unpackDestDir);
+
+    const std::string shared(200 * 1024, 's');
+    std::string other = shared;
+    other.back() = 'o';  // 大小相同但内容不同
+    ASSERT_TRUE(CreateTestFile(testDir + "/a/lib.so", shared));
+    ASSERT_TRUE(CreateTestFile(testDir + "/b/lib.so", shared));
+    ASSERT_TRUE(CreateTestFile(testDir + "/c/lib.so", shared));
+    ASSERT_TRUE(CreateTestFile(testDir + "/d/other.so", other));
+
+    // 以 testDir 为源根，条目名保留子目录
+    const std::vector<PackSource> files = {{testDir, "", {testDir + "/a/lib.so", testDir + "/b/lib.so",
+                                                          testDir + "/c/lib.so", testDir + "/d/other.so"}}};
+    myPack packer;
+    const std::string packedFilePath = packer.pack(files, packDestDir);
+    ASSERT_FALSE(packedFilePath.empty());
+    EXPECT_LT(fs::file_size(packedFilePath), 2 * shared.size() + 1024);
+
+    ASSERT_TRUE(packer.unpack(packedFilePath, unpackDestDir));
+    std::vector<char> content;
+    for (const char* name : {"/a/lib.so", "/b/lib.so", "/c/lib.so"}) {
+        ASSERT_TRUE(ReadTestFile(unpackDestDir + name, content)) << name;
+        EXPECT_TRUE(std::string(content.begin(), content.end()) == shared) << name;
+    }
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/d/other.so", content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == other);
+
+    // 关闭去重时每份都存放
+    myPack plainPacker;
+    plainPacker.setDeduplicationEnabled(false);
+    fs::create_directories(packDestDir + "/plain");
+    const std::string plainPath = plainPacker.pack(files, packDestDir + "/plain");
+    ASSERT_FALSE(plainPath.empty());
+    EXPECT_GT(fs::file_size(plainPath), 4 * shared.size());
+
+    fs::remove_all(testDir);
+    fs::remove_all(packDestDir);
+    fs::remove_all(unpackDestDir);
+}
+
+// 按条目压缩：文本被压缩，已压缩格式与高熵数据原样存放
+TEST(myPackTest, PerEntryCodecSelection) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_codec_dir";
+    const std::string packDestDir = "test_codec_pack_dest";
+    const std::string unpackDestDir = "test_codec_unpack_dest";
+    fs::remove_all(testDir);
+    fs::remove_all(unpackDestDir);
+    fs::create_directories(packDestDir);
+    fs::create_directories(unpackDestDir);
+
+    std::string text;
+    while (text.size() < 3 * PACK_BLOCK_SIZE / 2) text += "log line: request served in 12 ms\n";
+    std::string noise(256 * 1024, '\0');
+    uint32_t state = 12345;
+    for (char& c : noise) {
+        state = state * 1664525u + 1013904223u;
+        c = static_cast<char>(state >> 24);
+    }
+    ASSERT_TRUE(CreateTestFile(testDir + "/app.log", text));
+    ASSERT_TRUE(CreateTestFile(testDir + "/photo.jpg", text));   // 扩展名即判定为已压缩
+    ASSERT_TRUE(CreateTestFile(testDir + "/blob.bin", noise));   // 高熵数据
+    // 稀疏文件：按数据区间中的内容判断，空洞不参与
+    {
+        std::ofstream out(testDir + "/disk.img", std::ios::binary);
+        out.seekp(PACK_BLOCK_SIZE);
+        out.write(noise.data(), noise.size());
+    }
+    ASSERT_TRUE(CSparseFile::setLength(testDir + "/disk.img", 4 * PACK_BLOCK_SIZE));
+    const bool sparse = !CSparseFile::isDense(CSparseFile::mapDataExtents(testDir + "/disk.img", 4 * PACK_BLOCK_SIZE),
+                                              4 * PACK_BLOCK_SIZE);
+
+    CCodecPolicy policy(CompressType::Huffman);
+    EXPECT_EQ(policy.choose(testDir + "/app.log", text.size()), CompressType::Huffman);
+    EXPECT_EQ(policy.choose(testDir + "/photo.jpg", text.size()), CompressType::None);
+    EXPECT_EQ(policy.choose(testDir + "/blob.bin", noise.size()), CompressType::None);
+    EXPECT_TRUE(CCodecPolicy::hasCompressedMagic("PK\x03\x04rest", 8));
+    EXPECT_GT(CCodecPolicy::entropy(noise.data(), noise.size()), 7.9);
+
+    const std::vector<PackSource> sources = {{testDir, "", {testDir + "/app.log", testDir + "/photo.jpg", testDir + "/blob.bin",
+                                                            testDir + "/disk.img"}}};
+    myPack packer;
+    packer.setEntryCompression("Huffman");
+    std::vector<std::string> messages;
+    CLogger::instance().setSink([&](LogLevel, const std::string& message) { messages.push_back(message); });
+    const std::string packedFilePath = packer.pack(sources, packDestDir);
+    CLogger::instance().flush();
+    CLogger::instance().setSink(nullptr);
+    ASSERT_FALSE(packedFilePath.empty());
+    // photo.jpg 与 app.log 内容相同，沿用其算法；稀疏文件的空洞被跳过时，它与 blob.bin 一样按内容判定为原样存放
+    const std::string summary = std::string("Compressing ") + (sparse ? "2" : "3") + " file(s) with Huffman, storing " +
+                                (sparse ? "2" : "1") + " incompressible file(s) as-is.";
+    EXPECT_NE(std::find(messages.begin(), messages.end(), summary), messages.end()) << summary;
+    // 文本压缩后变小，其余按原大小存放
+    EXPECT_LT(fs::file_size(packedFilePath), 2 * text.size() + 2 * noise.size());
+
+    ASSERT_TRUE(packer.unpack(packedFilePath, unpackDestDir));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/app.log", content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == text);
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/photo.jpg", content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == text);
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/blob.bin", content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == noise);
+    ASSERT_TRUE(ReadTestFile(unpackDestDir + "/disk.img", content));
+    ASSERT_EQ(content.size(), 4 * PACK_BLOCK_SIZE);
+    EXPECT_TRUE(std::string(content.begin() + PACK_BLOCK_SIZE, content.begin() + PACK_BLOCK_SIZE + noise.size()) == noise);
+
+    fs::remove_all(testDir);
+    fs::remove_all(packDestDir);
+    fs::remove_all(unpackDestDir);
+}
+
+// 每个条目记录内容哈希：包内容损坏时指出损坏的文件，其余文件照常还原
+TEST(myPackTest, DetectsDamagedEntries) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_checksum_dir";
+    const std::string packDestDir = "test_checksum_pack_dest";
+    fs::remove_all(testDir);
+    fs::remove_all(packDestDir);
+
+    std::string good;
+    while (good.size() < 100 * 1024) good += "intact entry " + std::to_string(good.size()) + "\n";
+    std::string damaged;
+    while (damaged.size() < 300 * 1024) damaged += "damaged entry " + std::to_string(damaged.size() % 977) + "\n";
+    ASSERT_TRUE(CreateTestFile(testDir + "/good.txt", good));
+    ASSERT_TRUE(CreateTestFile(testDir + "/damaged.txt", damaged));
+    ASSERT_TRUE(CreateTestFile(testDir + "/copy.txt", damaged));  // 与 damaged.txt 共用内容
+    const std::vector<PackSource> sources = {{testDir, "", {testDir + "/good.txt", testDir + "/damaged.txt",
+                                                            testDir + "/copy.txt"}}};
+
+    for (const char* codec : {"", "Huffman4X"}) {
+        const std::string dest = packDestDir + "/" + (*codec ? codec : "plain");
+        fs::create_directories(dest);
+        myPack packer;
+        packer.setEntryCompression(codec);
+        const std::string packedFilePath = packer.pack(sources, dest);
+        ASSERT_FALSE(packedFilePath.empty()) << codec;
+        ASSERT_TRUE(packer.unpack(packedFilePath, dest + "/ok")) << codec;
+
+        // 最后存放的是 damaged.txt 的内容，改动其中一个字节
+        {
+            std::fstream file(packedFilePath, std::ios::in | std::ios::out | std::ios::binary);
+            const std::streamoff pos = static_cast<std::streamoff>(fs::file_size(packedFilePath)) - 1000;
+            file.seekg(pos);
+            char byte = 0;
+            file.get(byte);
+            file.seekp(pos);
+            file.put(static_cast<char>(byte ^ 0x20));
+        }
+        EXPECT_FALSE(packer.unpack(packedFilePath, dest + "/bad")) << codec;
+        std::vector<char> content;
+        ASSERT_TRUE(ReadTestFile(dest + "/bad/good.txt", content)) << codec;
+        EXPECT_TRUE(std::string(content.begin(), content.end()) == good) << codec;
+    }
+
+    fs::remove_all(testDir);
+    fs::remove_all(packDestDir);
+}
+
+// LongRange 条目的匹配跨越 1MB 的块：相隔数 MB 的重复片段只存放一份，解包与校验按块重建
+TEST(myPackTest, LongRangeEntriesMatchAcrossBlocks) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_longrange_pack_dir";
+    fs::remove_all(testDir);
+    auto makeLines = [](size_t size, unsigned seed) {
+        const std::string digits = MakeRandomData(size, seed);
+        std::string text;
+        for (size_t i = 0; text.size() < size; ++i) {
+            text += "row " + std::to_string(static_cast<uint8_t>(digits[i])) + " value " +
+                    std::to_string(static_cast<uint8_t>(digits[i + 1]) * 31) + "\n";
+        }
+        return text;
+    };
+    const std::string chunk = makeLines(400 * 1024, 1);
+    const std::string once = chunk + makeLines(3 * PACK_BLOCK_SIZE, 2);
+    const std::string twice = once + chunk;
+    ASSERT_TRUE(CreateTestFile(testDir + "/once/data.txt", once));
+    ASSERT_TRUE(CreateTestFile(testDir + "/twice/data.txt", twice));
+
+    myPack packer;
+    packer.setEntryCompression("LongRange");
+    fs::create_directories(testDir + "/packs");
+    const std::vector<PackSource> onceSources = {{testDir + "/once", "", {testDir + "/once/data.txt"}}};
+    const std::string packedOnce = packer.pack(onceSources, testDir + "/packs");
+    ASSERT_FALSE(packedOnce.empty());
+    fs::rename(packedOnce, testDir + "/once.pack");
+    const std::vector<PackSource> twiceSources = {{testDir + "/twice", "", {testDir + "/twice/data.txt"}}};
+    const std::string packedTwice = packer.pack(twiceSources, testDir + "/packs");
+    ASSERT_FALSE(packedTwice.empty());
+    EXPECT_LT(fs::file_size(packedTwice), fs::file_size(testDir + "/once.pack") + 10000);
+
+    std::ifstream in(packedTwice, std::ios::binary);
+    EXPECT_TRUE(packer.verify(in, packedTwice));
+    ASSERT_TRUE(packer.unpack(packedTwice, testDir + "/out"));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(testDir + "/out/data.txt", content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == twice);
+    fs::remove_all(testDir);
+}
+
+// 并行编码各块与逐块编码得到相同的包，解包后内容一致
+TEST(myPackTest, ParallelBlockEncodingMatchesSerial) {
+    namespace fs = std::filesystem;
+    const std::string testDir = "test_parallel_pack_dir";
+    fs::remove_all(testDir);
+    std::string text;
+    for (size_t i = 0; text.size() < 5 * PACK_BLOCK_SIZE / 2; ++i) {
+        text += "sample " + std::to_string(i % 613) + " temperature " + std::to_string(i * 7 % 311) + "\n";
+    }
+    ASSERT_TRUE(CreateTestFile(testDir + "/src/data.txt", text));
+    const std::vector<PackSource> sources = {{testDir + "/src", "", {testDir + "/src/data.txt"}}};
+
+    std::vector<std::string> packs;
+    for (unsigned threads : {1u, 4u}) {
+        const std::string dest = testDir + "/threads" + std::to_string(threads);
+        fs::create_directories(dest);
+        myPack packer;
+        packer.setEntryCompression("BWT");
+        packer.setEntryFilters("auto");
+        packer.setThreadCount(threads);
+        const std::string packed = packer.pack(sources, dest);
+        ASSERT_FALSE(packed.empty()) << threads;
+        ASSERT_TRUE(packer.unpack(packed, dest + "/out")) << threads;
+        std::vector<char> content;
+        ASSERT_TRUE(ReadTestFile(dest + "/out/data.txt", content)) << threads;
+        EXPECT_TRUE(std::string(content.begin(), content.end()) == text) << threads;
+        ASSERT_TRUE(ReadTestFile(packed, content));
+        packs.emplace_back(content.begin(), content.end());
+    }
+    EXPECT_LT(packs[0].size(), text.size() / 4);
+    EXPECT_TRUE(packs[0] == packs[1]);
+    fs::remove_all(testDir);
+}
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include "CBackup.h"
+#include "CConfig.h"
+#include "CParityFile.h"
+#include "CReedSolomon.h"
+#include "testUtils.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void flipByte(const std::string& path, uint64_t offset) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(offset));
+    const char byte = static_cast<char>(file.get());
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.put(static_cast<char>(byte ^ 0x10));
+}
+
+}  // namespace
+
+// GF(2^8) 运算与各实现的 mulAdd 一致（含不足一个向量的尾部）
+TEST(ReedSolomonTest, KernelsMatchScalar) {
+    for (unsigned a = 1; a < 256; ++a) {
+        EXPECT_EQ(CReedSolomon::mul(static_cast<uint8_t>(a), CReedSolomon::inverse(static_cast<uint8_t>(a))), 1);
+    }
+    EXPECT_EQ(CReedSolomon::mul(0x80, 2), 0x1D);
+
+    const std::vector<uint8_t> src = MakeRandomData<std::vector<uint8_t>>(1000 + 13, 1);
+    const std::vector<uint8_t> base = MakeRandomData<std::vector<uint8_t>>(src.size(), 2);
+    for (unsigned c : {0u, 1u, 2u, 0x53u, 0xFFu}) {
+        std::vector<uint8_t> expected = base;
+        for (size_t i = 0; i < src.size(); ++i) {
+            expected[i] ^= CReedSolomon::mul(static_cast<uint8_t>(c), src[i]);
+        }
+        for (GaloisKernel kernel : {GaloisKernel::Scalar, GaloisKernel::Avx2}) {
+            std::vector<uint8_t> dst = base;
+            if (!CReedSolomon::mulAddWith(kernel, static_cast<uint8_t>(c), src.data(), dst.data(), dst.size())) {
+                continue;  // CPU 不支持该实现
+            }
+            EXPECT_EQ(dst, expected) << CReedSolomon::kernelName(kernel) << " c=" << c;
+        }
+    }
+}
+
+// 任意不超过校验分片数的分片缺失都能重建，更多时失败且不修改分片
+TEST(ReedSolomonTest, ReconstructsAnyErasures) {
+    constexpr unsigned k = 10;
+    constexpr unsigned m = 4;
+    constexpr size_t len = 333;
+    const CReedSolomon coder(k, m);
+    std::vector<std::vector<uint8_t>> original(k + m);
+    std::vector<uint8_t*> shards(k + m);
+    for (unsigned i = 0; i < k + m; ++i) {
+        original[i] = MakeRandomData<std::vector<uint8_t>>(len, 100 + i);
+        shards[i] = original[i].data();
+    }
+    coder.encode(shards.data(), shards.data() + k, len);
+
+    const std::vector<std::vector<unsigned>> erasures = {{0}, {13}, {0, 1, 2, 3}, {2, 5, 11, 12}, {9, 10, 11, 12}};
+    for (const auto& lost : erasures) {
+        std::vector<std::vector<uint8_t>> copy = original;
+        std::vector<bool> present(k + m, true);
+        for (unsigned i = 0; i < k + m; ++i) {
+            shards[i] = copy[i].data();
+        }
+        for (unsigned i : lost) {
+            present[i] = false;
+            std::fill(copy[i].begin(), copy[i].end(), 0xEE);
+        }
+        ASSERT_TRUE(coder.reconstruct(shards.data(), present, len));
+        EXPECT_EQ(copy, original) << "lost " << lost.size() << " shard(s) starting at " << lost[0];
+    }
+
+    std::vector<std::vector<uint8_t>> copy = original;
+    std::vector<bool> present(k + m, true);
+    for (unsigned i = 0; i < k + m; ++i) {
+        shards[i] = copy[i].data();
+    }
+    for (unsigned i : {1u, 3u, 5u, 7u, 9u}) {
+        present[i] = false;
+    }
+    EXPECT_FALSE(coder.reconstruct(shards.data(), present, len));
+    EXPECT_EQ(copy, original);
+    EXPECT_THROW(CReedSolomon(200, 56), std::invalid_argument);
+}
+
+// 校验文件定位并就地修复归档中的位翻转、截断，以及校验文件自身损坏的分片
+TEST(ParityFileTest, RepairsDamagedArchive) {
+    namespace fs = std::filesystem;
+    const std::string root = "test_parity_file";
+    fs::remove_all(root);
+    const std::string archive = root + "/archive.bin";
+    const std::vector<uint8_t> bytes = MakeRandomData<std::vector<uint8_t>>(300000 + 77, 7);
+    const std::string data(bytes.begin(), bytes.end());
+    ASSERT_TRUE(CreateTestFile(archive, data));
+
+    const std::string parity = CParityFile::create(archive, 8, 2);
+    ASSERT_EQ(parity, CParityFile::parityPath(archive));
+    const uint32_t shardSize = CParityFile::chooseShardSize(data.size(), 8);
+    EXPECT_EQ(shardSize, 37568u);
+    ParityReport report;
+    EXPECT_TRUE(CParityFile::check(archive, report));
+    EXPECT_EQ(report.stripes, 1u);
+
+    // 同一条带中两个数据分片与一个校验分片损坏：超出修复能力
+    flipByte(archive, 10);
+    flipByte(archive, shardSize * 3 + 5);
+    flipByte(parity, fs::file_size(parity) - 1);
+    EXPECT_FALSE(CParityFile::check(archive, report));
+    EXPECT_EQ(report.damagedShards, 3u);
+    EXPECT_FALSE(CParityFile::repair(archive, &report));
+    EXPECT_EQ(report.unrecoverableStripes, 1u);
+
+    // 恢复校验分片后可以修复
+    flipByte(parity, fs::file_size(parity) - 1);
+    ASSERT_TRUE(CParityFile::repair(archive, &report));
+    EXPECT_EQ(report.repairedShards, 2u);
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(archive, content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == data);
+
+    // 截断的归档与损坏的校验分片
+    fs::resize_file(archive, data.size() - 1000);
+    flipByte(parity, fs::file_size(parity) - shardSize - 1);
+    EXPECT_FALSE(CParityFile::check(archive, report));
+    ASSERT_TRUE(CParityFile::repair(archive, &report));
+    EXPECT_EQ(report.repairedShards, 2u);
+    ASSERT_TRUE(ReadTestFile(archive, content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == data);
+    EXPECT_TRUE(CParityFile::check(archive, report));
+
+    // 头或哈希表损坏时校验文件不可用
+    flipByte(parity, 20);
+    EXPECT_FALSE(CParityFile::repair(archive, &report));
+    fs::remove_all(root);
+}
+
+// 打包并加密的备份附带校验文件，归档损坏后还原前自动修复
+TEST(ParityFileTest, BackupRestoresAfterRepair) {
+    namespace fs = std::filesystem;
+    const std::string root = "test_parity_backup";
+    const std::string destDir = root + "/repo";
+    fs::remove_all(root);
+    std::string text;
+    for (int i = 0; text.size() < 200000; ++i) {
+        text += "entry " + std::to_string(i) + " of the cold storage volume\n";
+    }
+    ASSERT_TRUE(CreateTestFile(root + "/src/data.txt", text));
+
+    auto config = std::make_shared<CConfig>();
+    config->setSourcePath(root + "/src");
+    config->setDestinationPath(destDir);
+    config->setRecursiveSearch(true).setPackingEnabled(true).setPackType("Basic");
+    config->setEncryptionEnabled(true).setEncryptionKey("secret").setEncryptType("SimXOR");
+    config->setParityEnabled(true).setParityShards(4, 1);
+
+    CBackup backup;
+    const std::string archive = backup.doBackup(config);
+    ASSERT_FALSE(archive.empty());
+    ASSERT_TRUE(fs::exists(CParityFile::parityPath(archive)));
+
+    flipByte(archive, fs::file_size(archive) / 2);
+    const BackupEntry entry("src", "", destDir, fs::path(archive).filename().string(),
+                            "2025-01-01 00:00", true, true, false);
+    fs::create_directories(root + "/restore");
+    ASSERT_TRUE(backup.doRecovery(entry, root + "/restore", "secret"));
+    std::vector<char> content;
+    ASSERT_TRUE(ReadTestFile(root + "/restore/src/data.txt", content));
+    EXPECT_TRUE(std::string(content.begin(), content.end()) == text);
+    ParityReport report;
+    EXPECT_TRUE(CParityFile::check(archive, report));
+    fs::remove_all(root);
+}
@@ -147,4 +147,26 @@ TEST(RecorderTest, ModifyBackupRecord){// 清理之前的文件
     EXPECT_EQ(recorder.findBackupRecordsByFileName("file2.txt").size(), 1);
     EXPECT_EQ(recorder.findBackupRecordsByFileName("file2.txt")[0], modifiedEntry1);
     EXPECT_EQ(recorder.getBackupRecords().size(), 4);
-}
\ No newline at end of file
+}
+// 下标查找与版本号测试
+TEST(RecorderTest, FindIndicesAndRevision){
+    CleanupTestFile(defaultPath);
+
+    CBackupRecorder recorder;
+    const uint64_t initialRevision = recorder.getRevision();
+
+    recorder.addBackupRecord(BackupEntry("report.txt", "./report.txt", "./backup", "backup1", "2023-12-01 12:00", false, false, false));
+    recorder.addBackupRecord(BackupEntry("photo.png", "./photo.png", "./backup", "backup2", "2023-12-02 12:00", false, false, false));
+    recorder.addBackupRecord(BackupEntry("report_v2.txt", "./report_v2.txt", "./backup", "backup3", "2023-12-03 12:00", false, false, false));
+    EXPECT_EQ(recorder.getRevision(), initialRevision + 3);
+
+    EXPECT_EQ(recorder.findBackupRecordIndicesByFileName("report"), (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(recorder.findBackupRecordIndicesByBackupTime("2023-12-02 00:00", "2023-12-03 23:59"), (std::vector<size_t>{1, 2}));
+
+    // 查询不改变版本号，修改与删除会改变
+    const uint64_t revision = recorder.getRevision();
+    recorder.findBackupRecordsByFileName("photo");
+    EXPECT_EQ(recorder.getRevision(), revision);
+    EXPECT_TRUE(recorder.modifyBackupRecord(1, BackupEntry("photo.jpg", "./photo.jpg", "./backup", "backup2", "2023-12-02 12:00", false, false, false)));
+    EXPECT_GT(recorder.getRevision(), revision);
+}
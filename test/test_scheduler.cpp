@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "CBackupScheduler.h"
+#include "testUtils.h"
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 测试多个任务按截止时间顺序执行
+TEST(SchedulerTest, RunsJobsByDeadline) {
+    const std::string testRoot = "test_scheduler_dir";
+    std::filesystem::remove_all(testRoot);
+
+    CBackupScheduler scheduler(1);  // 单线程额度，任务只能逐个执行
+    const auto now = std::chrono::system_clock::now();
+    std::vector<size_t> ids;
+    for (int i = 0; i < 3; ++i) {
+        const std::string srcDir = testRoot + "/src" + std::to_string(i);
+        ASSERT_TRUE(CreateTestFile(srcDir + "/file.txt", "content of job " + std::to_string(i)));
+
+        BackupJob job;
+        job.config = std::make_shared<CConfig>(srcDir, testRoot + "/dest" + std::to_string(i));
+        job.config->setRecursiveSearch(true).setPackingEnabled(true).setPackType("Basic");
+        // 后提交的任务截止时间更早
+        job.deadline = now + std::chrono::hours(3 - i);
+        ids.push_back(scheduler.submit(job));
+    }
+    EXPECT_EQ(scheduler.getPendingCount(), 3u);
+
+    scheduler.runAll();
+
+    auto results = scheduler.getResults();
+    ASSERT_EQ(results.size(), 3u);
+    for (const auto& result : results) {
+        EXPECT_EQ(result.status, JobStatus::Succeeded) << result.errorMessage;
+        EXPECT_TRUE(std::filesystem::exists(result.destPath));
+    }
+    // 截止时间最早的任务（最后提交的）最先开始
+    EXPECT_LE(results[ids[2]].startTime, results[ids[1]].startTime);
+    EXPECT_LE(results[ids[1]].startTime, results[ids[0]].startTime);
+
+    std::filesystem::remove_all(testRoot);
+}
+
+// 测试失败的任务不会影响其他任务
+TEST(SchedulerTest, ReportsFailedJob) {
+    CBackupScheduler scheduler(2);
+    BackupJob job;
+    job.config = std::make_shared<CConfig>();
+    job.config->setDestinationPath("test_scheduler_missing_dest");
+    size_t id = scheduler.submit(job);  // 没有源路径，配置无效
+    scheduler.runAll();
+    EXPECT_EQ(scheduler.getJobStatus(id), JobStatus::Failed);
+    std::filesystem::remove_all("test_scheduler_missing_dest");
+}
+
+// 测试限速器会限制吞吐
+TEST(SchedulerTest, RateLimiterThrottles) {
+    CRateLimiter limiter(200 * 1024);  // 200KB/s，初始额度为一秒
+    const auto start = std::chrono::steady_clock::now();
+    limiter.acquire(300 * 1024);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GE(elapsed, 0.4);
+    EXPECT_EQ(limiter.getTotalBytes(), 300u * 1024);
+}